@@ -8,9 +8,9 @@
 
 constexpr unsigned CAN_TIMEOUT_MS = 100;          // 100
 constexpr uint8_t RPM_MSG_PERIOD_MS = 150;        // 150
-constexpr uint8_t HYDRAULIC_MSG_PERIOD_MS = 165;  // 165
 constexpr uint8_t APPS_MSG_PERIOD_MS = 250;       // 250
 constexpr float WHEEL_PRECISION = 1e-2;           // 1e-2
+constexpr float WHEEL_RPM_MAX = 3000;             // 3000, top of the packed wheel speeds
 
 //-----------------------------------------------------------------------------
 // CAN Message IDs
@@ -37,19 +37,21 @@ constexpr uint8_t AS_FINISHED = 4;   // 4
 constexpr uint8_t AS_EMERGENCY = 5;  // 5
 
 constexpr uint8_t AS_CU_EMERGENCY_SIGNAL = 0x43;  // 0x43
-constexpr uint8_t STATE_MSG = 0x31;               // 0x31
-constexpr uint8_t MISSION_MSG = 0x32;             // 0x32
 constexpr uint8_t LEFT_WHEEL_MSG = 0x33;          // 0x33
 constexpr uint8_t DBG_LOG_MSG = 0x34;             // 0x34
 constexpr uint8_t DBG_LOG_MSG_2 = 0x35;           // 0x35
+constexpr uint8_t DBG_PROFILE_MSG = 0x36;         // 0x36
+constexpr uint8_t DBG_HEARTBEAT_MSG = 0x37;       // 0x37
+
+// Packed by tools/frame_planner.py, see tools/frame_plan.txt
+constexpr uint8_t MASTER_STATUS_MSG = 0x38;  // 0x38, state, mission, ASMS and SOC
+constexpr uint8_t MASTER_WHEELS_MSG = 0x39;  // 0x39, rear wheel speeds
 
 //-----------------------------------------------------------------------------
 // Logging Status IDs
 //-----------------------------------------------------------------------------
-constexpr uint8_t DRIVING_STATE = 0x40;    // 0x40
 constexpr uint16_t DRIVING_CONTROL = 0x501;  // 0x501
 constexpr uint16_t SYSTEM_STATUS = 0x502;    // 0x502
-constexpr uint16_t SOC_MSG = 0x60;           // 0x60
 
 //-----------------------------------------------------------------------------
 // Steering System
@@ -69,10 +71,9 @@ constexpr uint16_t SET_ORIGIN_CUBEM_ID = 0x55D;  // 0x55D
 /** ID for steering angle messages (standardized) */
 constexpr uint16_t STEERING_ID = 0x295D;  // 0x295D
 
-constexpr uint8_t FR_RPM = 0x10;       // 0x10
-constexpr uint8_t FL_RPM = 0x11;       // 0x11
-constexpr uint8_t APPS_HIGHER = 0x20;  // 0x20
-constexpr uint8_t APPS_LOWER = 0x21;   // 0x21
+// Packed by tools/frame_planner.py, see tools/frame_plan.txt
+constexpr uint8_t DASH_WHEELS_BRAKE_MSG = 0x50;  // 0x50, front wheel speeds and hydraulic line
+constexpr uint8_t DASH_PEDALS_STATE_MSG = 0x51;  // 0x51, APPS, driving state, implausibility
 
 /** Payload to reset steering angle sensor to zero */
 constexpr uint8_t SET_ORIGIN_BOSCH_STEERING_ANGLE_RESET = 0x05;  // 0x05
@@ -92,6 +93,9 @@ constexpr uint16_t BAMO_RESPONSE_ID = 0x181;  // 0x181
 /** Command code for torque commands to Bamocar */
 constexpr uint8_t TORQUE_COMMAND_BAMO_BYTE = 0x90;  // 0x90
 
+/** Mode register of the Bamocar, its disable bit switches the drive off */
+constexpr uint8_t BAMOCAR_DISABLE_CODE = 0x51;  // 0x51
+
 /** Message code for battery voltage */
 constexpr uint8_t BAMOCAR_BATTERY_VOLTAGE_CODE = 0xEB;  // 0xEB
 
@@ -116,12 +120,6 @@ constexpr uint16_t IMU_ACC = 0x175;  // 0x175
 /** IMU gyroscope data ID */
 constexpr uint16_t IMU_GYRO = 0x179;  // 0x179
 
-/** Right wheel speed sensor code */
-constexpr uint8_t RIGHT_WHEEL_CODE = 0x11;  // 0x11
-
-/** Left wheel speed sensor code */
-constexpr uint8_t LEFT_WHEEL_CODE = 0x12;  // 0x12
-
 //-----------------------------------------------------------------------------
 // Hydraulic System
 //-----------------------------------------------------------------------------
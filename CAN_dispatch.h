@@ -0,0 +1,132 @@
+#pragma once
+
+#include <FlexCAN_T4.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Compile-time CAN ID -> handler table shared by the receive paths
+ * @details A board lists the frames it consumes once, as {ID, extended, handler} routes. At
+ * compile time the routes are placed in a perfect hash: finding the handler of a frame is one
+ * multiply, one shift and one compare, whatever the number or spread of the IDs. The same routes
+ * program the FlexCAN FIFO filters, so a frame is accepted by the hardware if and only if
+ * something handles it.
+ */
+namespace can_dispatch {
+
+/**
+ * @brief Deliberately not constexpr: reaching one while building a table fails compilation
+ */
+void duplicate_can_id_in_dispatch_table();
+void no_perfect_hash_for_dispatch_table();
+
+template <class Handler>
+struct Route {
+  uint32_t id;
+  bool extended;
+  Handler handler;
+};
+
+/**
+ * @brief Standard and extended IDs overlap numerically, the IDE bit keeps them apart
+ */
+constexpr uint32_t key_of(const uint32_t id, const bool extended) {
+  return (id & 0x1FFF'FFFF) | (extended ? 0x8000'0000 : 0);
+}
+
+constexpr uint32_t EMPTY_KEY = 0xFFFF'FFFF;  ///< Has reserved bits set, never a real key
+
+/**
+ * @brief Smallest power of two holding the routes with at least half the slots free
+ */
+constexpr unsigned slot_bits(const std::size_t routes) {
+  unsigned bits = 1;
+  while ((std::size_t{1} << bits) < 2 * routes) bits++;
+  return bits;
+}
+
+template <class Handler, std::size_t N>
+class DispatchTable {
+public:
+  static constexpr unsigned BITS = slot_bits(N);
+  static constexpr std::size_t SLOTS = std::size_t{1} << BITS;
+
+  explicit constexpr DispatchTable(const std::array<Route<Handler>, N> &routes) {
+    for (std::size_t i = 0; i < N; i++) {
+      order_[i] = key_of(routes[i].id, routes[i].extended);
+      for (std::size_t j = 0; j < i; j++) {
+        if (order_[j] == order_[i]) duplicate_can_id_in_dispatch_table();
+      }
+    }
+    // Multiplicative hashing: try odd multipliers until every key lands in its own slot
+    uint32_t multiplier = 0x9E37'79B1;
+    for (int attempt = 0; !place(routes, multiplier); attempt++) {
+      if (attempt == 100'000) no_perfect_hash_for_dispatch_table();
+      multiplier += 0x0001'0002;
+    }
+    multiplier_ = multiplier;
+  }
+
+  /**
+   * @return the handler registered for the frame, nullptr if there is none
+   */
+  [[nodiscard]] constexpr const Handler *find(const uint32_t id, const bool extended) const {
+    const uint32_t key = key_of(id, extended);
+    const uint32_t slot = slot_of(key, multiplier_);
+    return keys_[slot] == key ? &handlers_[slot] : nullptr;
+  }
+
+  [[nodiscard]] const Handler *find(const CAN_message_t &msg) const {
+    return find(msg.id, msg.flags.extended);
+  }
+
+  /**
+   * @brief Accepts exactly the routed IDs in the FIFO, one filter per route in declaration order
+   * @details The bus must have been set up with at least N FIFO filters (setRFFN).
+   */
+  template <class Bus>
+  void program_filters(Bus &bus) const {
+    bus.setFIFOFilter(REJECT_ALL);
+    for (std::size_t i = 0; i < N; i++) {
+      const bool extended = order_[i] & 0x8000'0000;
+      bus.setFIFOFilter(static_cast<uint8_t>(i), order_[i] & 0x1FFF'FFFF, extended ? EXT : STD);
+    }
+  }
+
+  [[nodiscard]] static constexpr std::size_t size() { return N; }
+
+private:
+  std::array<uint32_t, SLOTS> keys_{};
+  std::array<Handler, SLOTS> handlers_{};
+  std::array<uint32_t, N> order_{};
+  uint32_t multiplier_ = 0;
+
+  static constexpr uint32_t slot_of(const uint32_t key, const uint32_t multiplier) {
+    return static_cast<uint32_t>(key * multiplier) >> (32 - BITS);
+  }
+
+  constexpr bool place(const std::array<Route<Handler>, N> &routes, const uint32_t multiplier) {
+    for (std::size_t slot = 0; slot < SLOTS; slot++) {
+      keys_[slot] = EMPTY_KEY;
+      handlers_[slot] = Handler{};
+    }
+    for (std::size_t i = 0; i < N; i++) {
+      const uint32_t slot = slot_of(order_[i], multiplier);
+      if (keys_[slot] != EMPTY_KEY) return false;
+      keys_[slot] = order_[i];
+      handlers_[slot] = routes[i].handler;
+    }
+    return true;
+  }
+};
+
+template <class Handler, std::size_t N>
+constexpr DispatchTable<Handler, N> make_table(const Route<Handler> (&routes)[N]) {
+  std::array<Route<Handler>, N> list{};
+  for (std::size_t i = 0; i < N; i++) list[i] = routes[i];
+  return DispatchTable<Handler, N>(list);
+}
+
+}  // namespace can_dispatch
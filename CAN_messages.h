@@ -0,0 +1,1584 @@
+#pragma once
+
+// Generated by tools/dbc_codegen.py from conf.dbc, do not edit by hand
+
+#include <array>
+#include <cstdint>
+
+#include "CAN_IDs.h"
+
+/**
+ * @brief Raw signal values and constexpr pack()/unpack() for every message in the DBC
+ * @details LEN is the number of payload bytes the signals use, which is what the boards
+ * put on the bus. Multiplexed messages have one nested struct per multiplexer value.
+ */
+namespace can_db {
+
+// master_msgs, sent by Master
+struct MasterMsgs {
+  static constexpr uint32_t ID = ::MASTER_ID;
+  static constexpr bool EXTENDED = false;
+
+  struct M52 {
+    static constexpr uint8_t MUX = 0x34;
+    static constexpr uint8_t LEN = 8;
+
+    uint32_t hydraulic_line_pressure = 0;  ///< adc
+    bool emergency_signal = false;  ///< bool
+    bool pneumatic_pressure = false;  ///< bool
+    bool engage_ebs_timestamp = false;  ///< bool
+    bool release_ebs_timestamp = false;  ///< bool
+    bool steer_dead = false;  ///< bool
+    bool pc_dead = false;  ///< bool
+    bool inverson_dead = false;  ///< bool
+    bool res_dead = false;  ///< bool
+    uint8_t checkup_state = 0;
+    bool tsms_state = false;  ///< bool
+    bool ts_on = false;  ///< bool
+    bool asms_on_log = false;  ///< bool
+    uint8_t mission_log = 0;
+    uint8_t master_state_log = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x34),
+          static_cast<uint8_t>(hydraulic_line_pressure >> 24),
+          static_cast<uint8_t>((hydraulic_line_pressure >> 16) & 0xFF),
+          static_cast<uint8_t>((hydraulic_line_pressure >> 8) & 0xFF),
+          static_cast<uint8_t>(hydraulic_line_pressure & 0xFF),
+          static_cast<uint8_t>((emergency_signal << 7) | (pneumatic_pressure << 6) | (engage_ebs_timestamp << 5) | (release_ebs_timestamp << 4) | (steer_dead << 3) | (pc_dead << 2) | (inverson_dead << 1) | res_dead),
+          static_cast<uint8_t>((checkup_state & 0xF) | (tsms_state << 5) | (ts_on << 6) | (asms_on_log << 7)),
+          static_cast<uint8_t>((mission_log & 0xF) | ((master_state_log & 0xF) << 4))
+      };
+    }
+
+    [[nodiscard]] static constexpr M52 unpack(const uint8_t *buf) {
+      M52 msg;
+      msg.hydraulic_line_pressure = static_cast<uint32_t>((static_cast<uint32_t>(buf[1]) << 24) | (static_cast<uint32_t>(buf[2]) << 16) | (static_cast<uint32_t>(buf[3]) << 8) | static_cast<uint32_t>(buf[4]));
+      msg.emergency_signal = ((buf[5] >> 7) & 0x1) != 0;
+      msg.pneumatic_pressure = ((buf[5] >> 6) & 0x1) != 0;
+      msg.engage_ebs_timestamp = ((buf[5] >> 5) & 0x1) != 0;
+      msg.release_ebs_timestamp = ((buf[5] >> 4) & 0x1) != 0;
+      msg.steer_dead = ((buf[5] >> 3) & 0x1) != 0;
+      msg.pc_dead = ((buf[5] >> 2) & 0x1) != 0;
+      msg.inverson_dead = ((buf[5] >> 1) & 0x1) != 0;
+      msg.res_dead = (buf[5] & 0x1) != 0;
+      msg.checkup_state = static_cast<uint8_t>(buf[6] & 0xF);
+      msg.tsms_state = ((buf[6] >> 5) & 0x1) != 0;
+      msg.ts_on = ((buf[6] >> 6) & 0x1) != 0;
+      msg.asms_on_log = ((buf[6] >> 7) & 0x1) != 0;
+      msg.mission_log = static_cast<uint8_t>(buf[7] & 0xF);
+      msg.master_state_log = static_cast<uint8_t>((buf[7] >> 4) & 0xF);
+      return msg;
+    }
+  };
+
+  struct M53 {
+    static constexpr uint8_t MUX = 0x35;
+    static constexpr uint8_t LEN = 8;
+
+    bool pneumatic_line_1 = false;  ///< bool
+    bool pneumatic_line_2 = false;  ///< bool
+    uint32_t dcvoltage = 0;
+    bool master_sdc_closed = false;  ///< bool
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x35),
+          static_cast<uint8_t>(dcvoltage >> 24),
+          static_cast<uint8_t>((dcvoltage >> 16) & 0xFF),
+          static_cast<uint8_t>((dcvoltage >> 8) & 0xFF),
+          static_cast<uint8_t>(dcvoltage & 0xFF),
+          static_cast<uint8_t>(pneumatic_line_1),
+          static_cast<uint8_t>(pneumatic_line_2),
+          static_cast<uint8_t>(master_sdc_closed)
+      };
+    }
+
+    [[nodiscard]] static constexpr M53 unpack(const uint8_t *buf) {
+      M53 msg;
+      msg.pneumatic_line_1 = (buf[5] & 0x1) != 0;
+      msg.pneumatic_line_2 = (buf[6] & 0x1) != 0;
+      msg.dcvoltage = static_cast<uint32_t>((static_cast<uint32_t>(buf[1]) << 24) | (static_cast<uint32_t>(buf[2]) << 16) | (static_cast<uint32_t>(buf[3]) << 8) | static_cast<uint32_t>(buf[4]));
+      msg.master_sdc_closed = (buf[7] & 0x1) != 0;
+      return msg;
+    }
+  };
+
+  struct M54 {
+    static constexpr uint8_t MUX = 0x36;
+    static constexpr uint8_t LEN = 8;
+
+    uint8_t profile_stage = 0;
+    uint16_t profile_max_us = 0;  ///< us
+    uint16_t profile_p99_us = 0;  ///< us
+    uint16_t profile_mean_us = 0;  ///< us
+
+    [[nodiscard]] constexpr float profile_max_us_physical() const {
+      return static_cast<float>(profile_max_us) * 0.1f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr float profile_p99_us_physical() const {
+      return static_cast<float>(profile_p99_us) * 0.1f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr float profile_mean_us_physical() const {
+      return static_cast<float>(profile_mean_us) * 0.1f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x36),
+          static_cast<uint8_t>(profile_stage),
+          static_cast<uint8_t>(profile_max_us & 0xFF),
+          static_cast<uint8_t>(profile_max_us >> 8),
+          static_cast<uint8_t>(profile_p99_us & 0xFF),
+          static_cast<uint8_t>(profile_p99_us >> 8),
+          static_cast<uint8_t>(profile_mean_us & 0xFF),
+          static_cast<uint8_t>(profile_mean_us >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M54 unpack(const uint8_t *buf) {
+      M54 msg;
+      msg.profile_stage = static_cast<uint8_t>(buf[1]);
+      msg.profile_max_us = static_cast<uint16_t>(static_cast<uint16_t>(buf[2]) | (static_cast<uint16_t>(buf[3]) << 8));
+      msg.profile_p99_us = static_cast<uint16_t>(static_cast<uint16_t>(buf[4]) | (static_cast<uint16_t>(buf[5]) << 8));
+      msg.profile_mean_us = static_cast<uint16_t>(static_cast<uint16_t>(buf[6]) | (static_cast<uint16_t>(buf[7]) << 8));
+      return msg;
+    }
+  };
+
+  struct M55 {
+    static constexpr uint8_t MUX = 0x37;
+    static constexpr uint8_t LEN = 8;
+
+    uint8_t heartbeat_node = 0;
+    uint8_t heartbeat_alive = 0;
+    uint16_t heartbeat_max_gap_ms = 0;  ///< ms
+    uint16_t heartbeat_mean_period_ms = 0;  ///< ms
+    uint8_t heartbeat_jitter_ms = 0;  ///< ms
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x37),
+          static_cast<uint8_t>(heartbeat_node),
+          static_cast<uint8_t>(heartbeat_alive),
+          static_cast<uint8_t>(heartbeat_max_gap_ms & 0xFF),
+          static_cast<uint8_t>(heartbeat_max_gap_ms >> 8),
+          static_cast<uint8_t>(heartbeat_mean_period_ms & 0xFF),
+          static_cast<uint8_t>(heartbeat_mean_period_ms >> 8),
+          static_cast<uint8_t>(heartbeat_jitter_ms)
+      };
+    }
+
+    [[nodiscard]] static constexpr M55 unpack(const uint8_t *buf) {
+      M55 msg;
+      msg.heartbeat_node = static_cast<uint8_t>(buf[1]);
+      msg.heartbeat_alive = static_cast<uint8_t>(buf[2]);
+      msg.heartbeat_max_gap_ms = static_cast<uint16_t>(static_cast<uint16_t>(buf[3]) | (static_cast<uint16_t>(buf[4]) << 8));
+      msg.heartbeat_mean_period_ms = static_cast<uint16_t>(static_cast<uint16_t>(buf[5]) | (static_cast<uint16_t>(buf[6]) << 8));
+      msg.heartbeat_jitter_ms = static_cast<uint8_t>(buf[7]);
+      return msg;
+    }
+  };
+
+  struct M56 {
+    static constexpr uint8_t MUX = 0x38;
+    static constexpr uint8_t LEN = 3;
+
+    uint8_t master_state = 0;
+    uint8_t mission = 0;
+    bool asms_on = false;  ///< bool
+    uint8_t lv_soc = 0;  ///< percentage
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x38),
+          static_cast<uint8_t>((master_state & 0x7) | ((mission & 0x7) << 3) | (asms_on << 6) | ((lv_soc & 0x1) << 7)),
+          static_cast<uint8_t>((lv_soc >> 1) & 0x3F)
+      };
+    }
+
+    [[nodiscard]] static constexpr M56 unpack(const uint8_t *buf) {
+      M56 msg;
+      msg.master_state = static_cast<uint8_t>(buf[1] & 0x7);
+      msg.mission = static_cast<uint8_t>((buf[1] >> 3) & 0x7);
+      msg.asms_on = ((buf[1] >> 6) & 0x1) != 0;
+      msg.lv_soc = static_cast<uint8_t>(static_cast<uint8_t>((buf[1] >> 7) & 0x1) | (static_cast<uint8_t>(buf[2] & 0x3F) << 1));
+      return msg;
+    }
+  };
+
+  struct M57 {
+    static constexpr uint8_t MUX = 0x39;
+    static constexpr uint8_t LEN = 6;
+
+    uint32_t rl_rpm = 0;  ///< rpm
+    uint32_t rr_rpm = 0;  ///< rpm
+
+    [[nodiscard]] constexpr float rl_rpm_physical() const {
+      return static_cast<float>(rl_rpm) * 0.01f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr float rr_rpm_physical() const {
+      return static_cast<float>(rr_rpm) * 0.01f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x39),
+          static_cast<uint8_t>(rl_rpm & 0xFF),
+          static_cast<uint8_t>((rl_rpm >> 8) & 0xFF),
+          static_cast<uint8_t>(((rl_rpm >> 16) & 0x7) | ((rr_rpm & 0x1F) << 3)),
+          static_cast<uint8_t>((rr_rpm >> 5) & 0xFF),
+          static_cast<uint8_t>((rr_rpm >> 13) & 0x3F)
+      };
+    }
+
+    [[nodiscard]] static constexpr M57 unpack(const uint8_t *buf) {
+      M57 msg;
+      msg.rl_rpm = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3] & 0x7) << 16));
+      msg.rr_rpm = static_cast<uint32_t>(static_cast<uint32_t>((buf[3] >> 3) & 0x1F) | (static_cast<uint32_t>(buf[4]) << 5) | (static_cast<uint32_t>(buf[5] & 0x3F) << 13));
+      return msg;
+    }
+  };
+
+  [[nodiscard]] static constexpr uint8_t mux(const uint8_t *buf) {
+    return static_cast<uint8_t>(buf[0]);
+  }
+};
+
+// res_activate, sent by Master
+struct ResActivate {
+  static constexpr uint32_t ID = ::RES_ACTIVATE;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 2;
+
+  uint8_t node_id = 0;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        0,
+        static_cast<uint8_t>(node_id)
+    };
+  }
+
+  [[nodiscard]] static constexpr ResActivate unpack(const uint8_t *buf) {
+    ResActivate msg;
+    msg.node_id = static_cast<uint8_t>(buf[1]);
+    return msg;
+  }
+};
+
+// dash_msgs, sent by Dash
+struct DashMsgs {
+  static constexpr uint32_t ID = ::DASH_ID;
+  static constexpr bool EXTENDED = false;
+
+  struct M80 {
+    static constexpr uint8_t MUX = 0x50;
+    static constexpr uint8_t LEN = 7;
+
+    uint32_t fr_rpm = 0;  ///< rpm
+    uint32_t fl_rpm = 0;  ///< rpm
+    uint16_t hydraulic_line = 0;
+
+    [[nodiscard]] constexpr float fr_rpm_physical() const {
+      return static_cast<float>(fr_rpm) * 0.01f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr float fl_rpm_physical() const {
+      return static_cast<float>(fl_rpm) * 0.01f + 0.0f;
+    }
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x50),
+          static_cast<uint8_t>(fr_rpm & 0xFF),
+          static_cast<uint8_t>((fr_rpm >> 8) & 0xFF),
+          static_cast<uint8_t>(((fr_rpm >> 16) & 0x7) | ((fl_rpm & 0x1F) << 3)),
+          static_cast<uint8_t>((fl_rpm >> 5) & 0xFF),
+          static_cast<uint8_t>(((fl_rpm >> 13) & 0x3F) | ((hydraulic_line & 0x3) << 6)),
+          static_cast<uint8_t>((hydraulic_line >> 2) & 0xFF)
+      };
+    }
+
+    [[nodiscard]] static constexpr M80 unpack(const uint8_t *buf) {
+      M80 msg;
+      msg.fr_rpm = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3] & 0x7) << 16));
+      msg.fl_rpm = static_cast<uint32_t>(static_cast<uint32_t>((buf[3] >> 3) & 0x1F) | (static_cast<uint32_t>(buf[4]) << 5) | (static_cast<uint32_t>(buf[5] & 0x3F) << 13));
+      msg.hydraulic_line = static_cast<uint16_t>(static_cast<uint16_t>((buf[5] >> 6) & 0x3) | (static_cast<uint16_t>(buf[6]) << 2));
+      return msg;
+    }
+  };
+
+  struct M81 {
+    static constexpr uint8_t MUX = 0x51;
+    static constexpr uint8_t LEN = 4;
+
+    uint16_t apps_higher = 0;
+    uint16_t apps_lower = 0;
+    uint8_t current_state = 0;
+    bool implausibility = false;  ///< bool
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x51),
+          static_cast<uint8_t>(apps_higher & 0xFF),
+          static_cast<uint8_t>(((apps_higher >> 8) & 0x3) | ((apps_lower & 0x3F) << 2)),
+          static_cast<uint8_t>(((apps_lower >> 6) & 0xF) | ((current_state & 0x7) << 4) | (implausibility << 7))
+      };
+    }
+
+    [[nodiscard]] static constexpr M81 unpack(const uint8_t *buf) {
+      M81 msg;
+      msg.apps_higher = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2] & 0x3) << 8));
+      msg.apps_lower = static_cast<uint16_t>(static_cast<uint16_t>((buf[2] >> 2) & 0x3F) | (static_cast<uint16_t>(buf[3] & 0xF) << 6));
+      msg.current_state = static_cast<uint8_t>((buf[3] >> 4) & 0x7);
+      msg.implausibility = ((buf[3] >> 7) & 0x1) != 0;
+      return msg;
+    }
+  };
+
+  [[nodiscard]] static constexpr uint8_t mux(const uint8_t *buf) {
+    return static_cast<uint8_t>(buf[0]);
+  }
+};
+
+// bamocar_rx, sent by Dash
+struct BamocarRx {
+  static constexpr uint32_t ID = ::BAMO_COMMAND_ID;
+  static constexpr bool EXTENDED = false;
+
+  struct M52 {
+    static constexpr uint8_t MUX = 0x34;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t speed_limit = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x34),
+          static_cast<uint8_t>(speed_limit & 0xFF),
+          static_cast<uint8_t>(speed_limit >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M52 unpack(const uint8_t *buf) {
+      M52 msg;
+      msg.speed_limit = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  struct M53 {
+    static constexpr uint8_t MUX = 0x35;
+    static constexpr uint8_t LEN = 5;
+
+    uint32_t acc_ramp = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x35),
+          static_cast<uint8_t>(acc_ramp & 0xFF),
+          static_cast<uint8_t>((acc_ramp >> 8) & 0xFF),
+          static_cast<uint8_t>((acc_ramp >> 16) & 0xFF),
+          static_cast<uint8_t>(acc_ramp >> 24)
+      };
+    }
+
+    [[nodiscard]] static constexpr M53 unpack(const uint8_t *buf) {
+      M53 msg;
+      msg.acc_ramp = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3]) << 16) | (static_cast<uint32_t>(buf[4]) << 24));
+      return msg;
+    }
+  };
+
+  struct M61 {
+    static constexpr uint8_t MUX = 0x3D;
+    static constexpr uint8_t LEN = 2;
+
+    uint8_t value_request = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x3D),
+          static_cast<uint8_t>(value_request)
+      };
+    }
+
+    [[nodiscard]] static constexpr M61 unpack(const uint8_t *buf) {
+      M61 msg;
+      msg.value_request = static_cast<uint8_t>(buf[1]);
+      return msg;
+    }
+  };
+
+  struct M81 {
+    static constexpr uint8_t MUX = 0x51;
+    static constexpr uint8_t LEN = 2;
+
+    uint8_t enable_or_disable = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x51),
+          static_cast<uint8_t>(enable_or_disable)
+      };
+    }
+
+    [[nodiscard]] static constexpr M81 unpack(const uint8_t *buf) {
+      M81 msg;
+      msg.enable_or_disable = static_cast<uint8_t>(buf[1]);
+      return msg;
+    }
+  };
+
+  struct M142 {
+    static constexpr uint8_t MUX = 0x8E;
+    static constexpr uint8_t LEN = 4;
+
+    uint32_t clear_errors = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x8E),
+          static_cast<uint8_t>(clear_errors & 0xFF),
+          static_cast<uint8_t>((clear_errors >> 8) & 0xFF),
+          static_cast<uint8_t>((clear_errors >> 16) & 0xFF)
+      };
+    }
+
+    [[nodiscard]] static constexpr M142 unpack(const uint8_t *buf) {
+      M142 msg;
+      msg.clear_errors = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3]) << 16));
+      return msg;
+    }
+  };
+
+  struct M144 {
+    static constexpr uint8_t MUX = 0x90;
+    static constexpr uint8_t LEN = 3;
+
+    int16_t torque = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x90),
+          static_cast<uint8_t>(static_cast<uint16_t>(torque) & 0xFF),
+          static_cast<uint8_t>(static_cast<uint16_t>(torque) >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M144 unpack(const uint8_t *buf) {
+      M144 msg;
+      msg.torque = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8)));
+      return msg;
+    }
+  };
+
+  struct M196 {
+    static constexpr uint8_t MUX = 0xC4;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t device_current_max = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0xC4),
+          static_cast<uint8_t>(device_current_max & 0xFF),
+          static_cast<uint8_t>(device_current_max >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M196 unpack(const uint8_t *buf) {
+      M196 msg;
+      msg.device_current_max = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  struct M197 {
+    static constexpr uint8_t MUX = 0xC5;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t device_current_cnt = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0xC5),
+          static_cast<uint8_t>(device_current_cnt & 0xFF),
+          static_cast<uint8_t>(device_current_cnt >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M197 unpack(const uint8_t *buf) {
+      M197 msg;
+      msg.device_current_cnt = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  struct M237 {
+    static constexpr uint8_t MUX = 0xED;
+    static constexpr uint8_t LEN = 5;
+
+    uint32_t decc_ramp = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0xED),
+          static_cast<uint8_t>(decc_ramp & 0xFF),
+          static_cast<uint8_t>((decc_ramp >> 8) & 0xFF),
+          static_cast<uint8_t>((decc_ramp >> 16) & 0xFF),
+          static_cast<uint8_t>(decc_ramp >> 24)
+      };
+    }
+
+    [[nodiscard]] static constexpr M237 unpack(const uint8_t *buf) {
+      M237 msg;
+      msg.decc_ramp = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3]) << 16) | (static_cast<uint32_t>(buf[4]) << 24));
+      return msg;
+    }
+  };
+
+  [[nodiscard]] static constexpr uint8_t mux(const uint8_t *buf) {
+    return static_cast<uint8_t>(buf[0]);
+  }
+};
+
+// BMS_THERMISTOR_ID, sent by Cell_0
+struct BmsThermistorId {
+  static constexpr uint32_t ID = ::BMS_THERMISTOR_ID;
+  static constexpr bool EXTENDED = true;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t thermistor_module_number = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+  uint8_t number_of_thermistors = 0;
+  uint8_t highest_thermistor_id = 0;
+  uint8_t lowest_thermistor_id = 0;
+  uint8_t checksum = 0;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(thermistor_module_number),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp)),
+        static_cast<uint8_t>(number_of_thermistors),
+        static_cast<uint8_t>(highest_thermistor_id),
+        static_cast<uint8_t>(lowest_thermistor_id),
+        static_cast<uint8_t>(checksum)
+    };
+  }
+
+  [[nodiscard]] static constexpr BmsThermistorId unpack(const uint8_t *buf) {
+    BmsThermistorId msg;
+    msg.thermistor_module_number = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.number_of_thermistors = static_cast<uint8_t>(buf[4]);
+    msg.highest_thermistor_id = static_cast<uint8_t>(buf[5]);
+    msg.lowest_thermistor_id = static_cast<uint8_t>(buf[6]);
+    msg.checksum = static_cast<uint8_t>(buf[7]);
+    return msg;
+  }
+};
+
+// bamocar_tx, sent by Bamocar
+struct BamocarTx {
+  static constexpr uint32_t ID = ::BAMO_RESPONSE_ID;
+  static constexpr bool EXTENDED = false;
+
+  struct M32 {
+    static constexpr uint8_t MUX = 0x20;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t motor_current = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x20),
+          static_cast<uint8_t>(motor_current & 0xFF),
+          static_cast<uint8_t>(motor_current >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M32 unpack(const uint8_t *buf) {
+      M32 msg;
+      msg.motor_current = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  struct M48 {
+    static constexpr uint8_t MUX = 0x30;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t speed = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x30),
+          static_cast<uint8_t>(speed & 0xFF),
+          static_cast<uint8_t>(speed >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M48 unpack(const uint8_t *buf) {
+      M48 msg;
+      msg.speed = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  struct M143 {
+    static constexpr uint8_t MUX = 0x8F;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t error_bitmap = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0x8F),
+          static_cast<uint8_t>(error_bitmap & 0xFF),
+          static_cast<uint8_t>(error_bitmap >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M143 unpack(const uint8_t *buf) {
+      M143 msg;
+      msg.error_bitmap = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  struct M226 {
+    static constexpr uint8_t MUX = 0xE2;
+    static constexpr uint8_t LEN = 5;
+
+    uint32_t ready_sig = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0xE2),
+          static_cast<uint8_t>(ready_sig & 0xFF),
+          static_cast<uint8_t>((ready_sig >> 8) & 0xFF),
+          static_cast<uint8_t>((ready_sig >> 16) & 0xFF),
+          static_cast<uint8_t>(ready_sig >> 24)
+      };
+    }
+
+    [[nodiscard]] static constexpr M226 unpack(const uint8_t *buf) {
+      M226 msg;
+      msg.ready_sig = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3]) << 16) | (static_cast<uint32_t>(buf[4]) << 24));
+      return msg;
+    }
+  };
+
+  struct M232 {
+    static constexpr uint8_t MUX = 0xE8;
+    static constexpr uint8_t LEN = 5;
+
+    uint32_t enable_sig = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0xE8),
+          static_cast<uint8_t>(enable_sig & 0xFF),
+          static_cast<uint8_t>((enable_sig >> 8) & 0xFF),
+          static_cast<uint8_t>((enable_sig >> 16) & 0xFF),
+          static_cast<uint8_t>(enable_sig >> 24)
+      };
+    }
+
+    [[nodiscard]] static constexpr M232 unpack(const uint8_t *buf) {
+      M232 msg;
+      msg.enable_sig = static_cast<uint32_t>(static_cast<uint32_t>(buf[1]) | (static_cast<uint32_t>(buf[2]) << 8) | (static_cast<uint32_t>(buf[3]) << 16) | (static_cast<uint32_t>(buf[4]) << 24));
+      return msg;
+    }
+  };
+
+  struct M235 {
+    static constexpr uint8_t MUX = 0xEB;
+    static constexpr uint8_t LEN = 3;
+
+    uint16_t dc_voltage = 0;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {
+          static_cast<uint8_t>(0xEB),
+          static_cast<uint8_t>(dc_voltage & 0xFF),
+          static_cast<uint8_t>(dc_voltage >> 8)
+      };
+    }
+
+    [[nodiscard]] static constexpr M235 unpack(const uint8_t *buf) {
+      M235 msg;
+      msg.dc_voltage = static_cast<uint16_t>(static_cast<uint16_t>(buf[1]) | (static_cast<uint16_t>(buf[2]) << 8));
+      return msg;
+    }
+  };
+
+  [[nodiscard]] static constexpr uint8_t mux(const uint8_t *buf) {
+    return static_cast<uint8_t>(buf[0]);
+  }
+};
+
+// CELL_TEMPS_BOARD_0, sent by Cell_0
+struct CellTempsBoard0 {
+  static constexpr uint32_t ID = ::CELL_TEMPS_BASE_ID;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  uint8_t board_id = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp))
+    };
+  }
+
+  [[nodiscard]] static constexpr CellTempsBoard0 unpack(const uint8_t *buf) {
+    CellTempsBoard0 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    return msg;
+  }
+};
+
+// CELL_TEMPS_BOARD_1, sent by Cell_1
+struct CellTempsBoard1 {
+  static constexpr uint32_t ID = 0x111;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  uint8_t board_id = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp))
+    };
+  }
+
+  [[nodiscard]] static constexpr CellTempsBoard1 unpack(const uint8_t *buf) {
+    CellTempsBoard1 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    return msg;
+  }
+};
+
+// CELL_TEMPS_BOARD_2, sent by Cell_2
+struct CellTempsBoard2 {
+  static constexpr uint32_t ID = 0x112;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  uint8_t board_id = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp))
+    };
+  }
+
+  [[nodiscard]] static constexpr CellTempsBoard2 unpack(const uint8_t *buf) {
+    CellTempsBoard2 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    return msg;
+  }
+};
+
+// CELL_TEMPS_BOARD_3, sent by Cell_3
+struct CellTempsBoard3 {
+  static constexpr uint32_t ID = 0x113;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  uint8_t board_id = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp))
+    };
+  }
+
+  [[nodiscard]] static constexpr CellTempsBoard3 unpack(const uint8_t *buf) {
+    CellTempsBoard3 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    return msg;
+  }
+};
+
+// CELL_TEMPS_BOARD_4, sent by Cell_4
+struct CellTempsBoard4 {
+  static constexpr uint32_t ID = 0x114;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  uint8_t board_id = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp))
+    };
+  }
+
+  [[nodiscard]] static constexpr CellTempsBoard4 unpack(const uint8_t *buf) {
+    CellTempsBoard4 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    return msg;
+  }
+};
+
+// CELL_TEMPS_BOARD_5, sent by Cell_5
+struct CellTempsBoard5 {
+  static constexpr uint32_t ID = 0x115;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  uint8_t board_id = 0;
+  int8_t min_temp = 0;  ///< C
+  int8_t max_temp = 0;  ///< C
+  int8_t avg_temp = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(static_cast<uint8_t>(min_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(max_temp)),
+        static_cast<uint8_t>(static_cast<uint8_t>(avg_temp))
+    };
+  }
+
+  [[nodiscard]] static constexpr CellTempsBoard5 unpack(const uint8_t *buf) {
+    CellTempsBoard5 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.min_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[1]));
+    msg.max_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.avg_temp = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    return msg;
+  }
+};
+
+// ALL_TEMPS_BOARD_0, sent by Cell_0
+struct AllTempsBoard0 {
+  static constexpr uint32_t ID = ::ALL_TEMPS_ID;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t board_id = 0;
+  uint8_t msg_index = 0;
+  int8_t temp_0 = 0;  ///< C
+  int8_t temp_1 = 0;  ///< C
+  int8_t temp_2 = 0;  ///< C
+  int8_t temp_3 = 0;  ///< C
+  int8_t temp_4 = 0;  ///< C
+  int8_t temp_5 = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(msg_index),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_0)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_1)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_2)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_3)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_4)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_5))
+    };
+  }
+
+  [[nodiscard]] static constexpr AllTempsBoard0 unpack(const uint8_t *buf) {
+    AllTempsBoard0 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.msg_index = static_cast<uint8_t>(buf[1]);
+    msg.temp_0 = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.temp_1 = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.temp_2 = static_cast<int8_t>(static_cast<uint8_t>(buf[4]));
+    msg.temp_3 = static_cast<int8_t>(static_cast<uint8_t>(buf[5]));
+    msg.temp_4 = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.temp_5 = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// ALL_TEMPS_BOARD_1, sent by Cell_1
+struct AllTempsBoard1 {
+  static constexpr uint32_t ID = 0x281;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t board_id = 0;
+  uint8_t msg_index = 0;
+  int8_t temp_0 = 0;  ///< C
+  int8_t temp_1 = 0;  ///< C
+  int8_t temp_2 = 0;  ///< C
+  int8_t temp_3 = 0;  ///< C
+  int8_t temp_4 = 0;  ///< C
+  int8_t temp_5 = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(msg_index),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_0)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_1)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_2)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_3)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_4)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_5))
+    };
+  }
+
+  [[nodiscard]] static constexpr AllTempsBoard1 unpack(const uint8_t *buf) {
+    AllTempsBoard1 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.msg_index = static_cast<uint8_t>(buf[1]);
+    msg.temp_0 = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.temp_1 = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.temp_2 = static_cast<int8_t>(static_cast<uint8_t>(buf[4]));
+    msg.temp_3 = static_cast<int8_t>(static_cast<uint8_t>(buf[5]));
+    msg.temp_4 = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.temp_5 = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// ALL_TEMPS_BOARD_2, sent by Cell_2
+struct AllTempsBoard2 {
+  static constexpr uint32_t ID = 0x282;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t board_id = 0;
+  uint8_t msg_index = 0;
+  int8_t temp_0 = 0;  ///< C
+  int8_t temp_1 = 0;  ///< C
+  int8_t temp_2 = 0;  ///< C
+  int8_t temp_3 = 0;  ///< C
+  int8_t temp_4 = 0;  ///< C
+  int8_t temp_5 = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(msg_index),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_0)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_1)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_2)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_3)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_4)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_5))
+    };
+  }
+
+  [[nodiscard]] static constexpr AllTempsBoard2 unpack(const uint8_t *buf) {
+    AllTempsBoard2 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.msg_index = static_cast<uint8_t>(buf[1]);
+    msg.temp_0 = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.temp_1 = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.temp_2 = static_cast<int8_t>(static_cast<uint8_t>(buf[4]));
+    msg.temp_3 = static_cast<int8_t>(static_cast<uint8_t>(buf[5]));
+    msg.temp_4 = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.temp_5 = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// ALL_TEMPS_BOARD_3, sent by Cell_3
+struct AllTempsBoard3 {
+  static constexpr uint32_t ID = 0x283;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t board_id = 0;
+  uint8_t msg_index = 0;
+  int8_t temp_0 = 0;  ///< C
+  int8_t temp_1 = 0;  ///< C
+  int8_t temp_2 = 0;  ///< C
+  int8_t temp_3 = 0;  ///< C
+  int8_t temp_4 = 0;  ///< C
+  int8_t temp_5 = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(msg_index),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_0)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_1)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_2)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_3)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_4)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_5))
+    };
+  }
+
+  [[nodiscard]] static constexpr AllTempsBoard3 unpack(const uint8_t *buf) {
+    AllTempsBoard3 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.msg_index = static_cast<uint8_t>(buf[1]);
+    msg.temp_0 = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.temp_1 = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.temp_2 = static_cast<int8_t>(static_cast<uint8_t>(buf[4]));
+    msg.temp_3 = static_cast<int8_t>(static_cast<uint8_t>(buf[5]));
+    msg.temp_4 = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.temp_5 = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// ALL_TEMPS_BOARD_4, sent by Cell_4
+struct AllTempsBoard4 {
+  static constexpr uint32_t ID = 0x284;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t board_id = 0;
+  uint8_t msg_index = 0;
+  int8_t temp_0 = 0;  ///< C
+  int8_t temp_1 = 0;  ///< C
+  int8_t temp_2 = 0;  ///< C
+  int8_t temp_3 = 0;  ///< C
+  int8_t temp_4 = 0;  ///< C
+  int8_t temp_5 = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(msg_index),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_0)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_1)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_2)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_3)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_4)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_5))
+    };
+  }
+
+  [[nodiscard]] static constexpr AllTempsBoard4 unpack(const uint8_t *buf) {
+    AllTempsBoard4 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.msg_index = static_cast<uint8_t>(buf[1]);
+    msg.temp_0 = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.temp_1 = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.temp_2 = static_cast<int8_t>(static_cast<uint8_t>(buf[4]));
+    msg.temp_3 = static_cast<int8_t>(static_cast<uint8_t>(buf[5]));
+    msg.temp_4 = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.temp_5 = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// ALL_TEMPS_BOARD_5, sent by Cell_5
+struct AllTempsBoard5 {
+  static constexpr uint32_t ID = 0x285;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t board_id = 0;
+  uint8_t msg_index = 0;
+  int8_t temp_0 = 0;  ///< C
+  int8_t temp_1 = 0;  ///< C
+  int8_t temp_2 = 0;  ///< C
+  int8_t temp_3 = 0;  ///< C
+  int8_t temp_4 = 0;  ///< C
+  int8_t temp_5 = 0;  ///< C
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(board_id),
+        static_cast<uint8_t>(msg_index),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_0)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_1)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_2)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_3)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_4)),
+        static_cast<uint8_t>(static_cast<uint8_t>(temp_5))
+    };
+  }
+
+  [[nodiscard]] static constexpr AllTempsBoard5 unpack(const uint8_t *buf) {
+    AllTempsBoard5 msg;
+    msg.board_id = static_cast<uint8_t>(buf[0]);
+    msg.msg_index = static_cast<uint8_t>(buf[1]);
+    msg.temp_0 = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.temp_1 = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.temp_2 = static_cast<int8_t>(static_cast<uint8_t>(buf[4]));
+    msg.temp_3 = static_cast<int8_t>(static_cast<uint8_t>(buf[5]));
+    msg.temp_4 = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.temp_5 = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// STEERING_MOTOR_COMMAND, sent by ASCU
+struct SteeringMotorCommand {
+  static constexpr uint32_t ID = ::STEERING_COMMAND_CUBEM_ID;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 4;
+
+  int32_t steering_angle = 0;  ///< degrees
+
+  [[nodiscard]] constexpr float steering_angle_physical() const {
+    return static_cast<float>(steering_angle) * 0.0001f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(static_cast<uint32_t>(steering_angle) & 0xFF),
+        static_cast<uint8_t>((static_cast<uint32_t>(steering_angle) >> 8) & 0xFF),
+        static_cast<uint8_t>((static_cast<uint32_t>(steering_angle) >> 16) & 0xFF),
+        static_cast<uint8_t>(static_cast<uint32_t>(steering_angle) >> 24)
+    };
+  }
+
+  [[nodiscard]] static constexpr SteeringMotorCommand unpack(const uint8_t *buf) {
+    SteeringMotorCommand msg;
+    msg.steering_angle = static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint32_t>(buf[0]) | (static_cast<uint32_t>(buf[1]) << 8) | (static_cast<uint32_t>(buf[2]) << 16) | (static_cast<uint32_t>(buf[3]) << 24)));
+    return msg;
+  }
+};
+
+// AS_CU, sent by ASCU
+struct AsCu {
+  static constexpr uint32_t ID = ::AS_CU_ID;
+  static constexpr bool EXTENDED = false;
+
+  struct M65 {
+    static constexpr uint8_t MUX = 0x41;
+    static constexpr uint8_t LEN = 1;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {static_cast<uint8_t>(0x41)};
+    }
+
+    [[nodiscard]] static constexpr M65 unpack(const uint8_t *buf) {
+      (void)buf;
+      M65 msg;
+      return msg;
+    }
+  };
+
+  struct M66 {
+    static constexpr uint8_t MUX = 0x42;
+    static constexpr uint8_t LEN = 1;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {static_cast<uint8_t>(0x42)};
+    }
+
+    [[nodiscard]] static constexpr M66 unpack(const uint8_t *buf) {
+      (void)buf;
+      M66 msg;
+      return msg;
+    }
+  };
+
+  struct M67 {
+    static constexpr uint8_t MUX = 0x43;
+    static constexpr uint8_t LEN = 1;
+
+    [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+      return {static_cast<uint8_t>(0x43)};
+    }
+
+    [[nodiscard]] static constexpr M67 unpack(const uint8_t *buf) {
+      (void)buf;
+      M67 msg;
+      return msg;
+    }
+  };
+
+  [[nodiscard]] static constexpr uint8_t mux(const uint8_t *buf) {
+    return static_cast<uint8_t>(buf[0]);
+  }
+};
+
+// STEERING_MOTOR_SET_ORIGIN, sent by ASCU
+struct SteeringMotorSetOrigin {
+  static constexpr uint32_t ID = ::SET_ORIGIN_CUBEM_ID;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 1;
+
+  uint8_t origin_command = 0;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {static_cast<uint8_t>(origin_command)};
+  }
+
+  [[nodiscard]] static constexpr SteeringMotorSetOrigin unpack(const uint8_t *buf) {
+    SteeringMotorSetOrigin msg;
+    msg.origin_command = static_cast<uint8_t>(buf[0]);
+    return msg;
+  }
+};
+
+// BOSCH_STEERING_ANGLE_SET_ORIGIN, sent by ASCU
+struct BoschSteeringAngleSetOrigin {
+  static constexpr uint32_t ID = ::SET_ORIGIN_BOSCH_STEERING_ANGLE_ID;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 1;
+
+  uint8_t command_code = 0;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {static_cast<uint8_t>(command_code)};
+  }
+
+  [[nodiscard]] static constexpr BoschSteeringAngleSetOrigin unpack(const uint8_t *buf) {
+    BoschSteeringAngleSetOrigin msg;
+    msg.command_code = static_cast<uint8_t>(buf[0]);
+    return msg;
+  }
+};
+
+// STEERING_CUBEM_STATE, sent by SteeringController
+struct SteeringCubemState {
+  static constexpr uint32_t ID = ::STEERING_ID;
+  static constexpr bool EXTENDED = true;
+  static constexpr uint8_t LEN = 8;
+
+  int16_t cubem_steering_angle = 0;  ///< degrees
+  int16_t cubem_steering_speed = 0;  ///< RPM
+  int16_t cubem_motor_current = 0;  ///< Amperes
+  int8_t cubem_motor_temperature = 0;  ///< C
+  int8_t cubem_motor_error = 0;
+
+  [[nodiscard]] constexpr float cubem_steering_angle_physical() const {
+    return static_cast<float>(cubem_steering_angle) * 0.1f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr float cubem_steering_speed_physical() const {
+    return static_cast<float>(cubem_steering_speed) * 0.1f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr float cubem_motor_current_physical() const {
+    return static_cast<float>(cubem_motor_current) * 0.01f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>((static_cast<uint16_t>(cubem_steering_angle) & 0x1) << 7),
+        static_cast<uint8_t>((static_cast<uint16_t>(cubem_steering_angle) >> 1) & 0xFF),
+        static_cast<uint8_t>(((static_cast<uint16_t>(cubem_steering_angle) >> 9) & 0x7F) | ((static_cast<uint16_t>(cubem_steering_speed) & 0x1) << 7)),
+        static_cast<uint8_t>((static_cast<uint16_t>(cubem_steering_speed) >> 1) & 0xFF),
+        static_cast<uint8_t>(((static_cast<uint16_t>(cubem_steering_speed) >> 9) & 0x7F) | ((static_cast<uint16_t>(cubem_motor_current) & 0x1) << 7)),
+        static_cast<uint8_t>((static_cast<uint16_t>(cubem_motor_current) >> 1) & 0xFF),
+        static_cast<uint8_t>(((static_cast<uint16_t>(cubem_motor_current) >> 9) & 0x7F) | static_cast<uint8_t>(cubem_motor_temperature)),
+        static_cast<uint8_t>(static_cast<uint8_t>(cubem_motor_error))
+    };
+  }
+
+  [[nodiscard]] static constexpr SteeringCubemState unpack(const uint8_t *buf) {
+    SteeringCubemState msg;
+    msg.cubem_steering_angle = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>((buf[0] >> 7) & 0x1) | (static_cast<uint16_t>(buf[1]) << 1) | (static_cast<uint16_t>(buf[2] & 0x7F) << 9)));
+    msg.cubem_steering_speed = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>((buf[2] >> 7) & 0x1) | (static_cast<uint16_t>(buf[3]) << 1) | (static_cast<uint16_t>(buf[4] & 0x7F) << 9)));
+    msg.cubem_motor_current = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>((buf[4] >> 7) & 0x1) | (static_cast<uint16_t>(buf[5]) << 1) | (static_cast<uint16_t>(buf[6] & 0x7F) << 9)));
+    msg.cubem_motor_temperature = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.cubem_motor_error = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    return msg;
+  }
+};
+
+// BOSCH_STEERING_ANGLE, sent by BoschSteeringSensor
+struct BoschSteeringAngle {
+  static constexpr uint32_t ID = ::STEERING_BOSCH_ID;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint16_t bosch_steering_angle_value = 0;  ///< degrees
+  bool bosch_steering_angle_sign = false;
+  uint16_t bosch_steering_speed_value = 0;  ///< degrees/s
+  bool bosch_steering_speed_sign = false;
+  bool bosch_status_bit = false;
+  uint8_t bosch_CRC = 0;
+
+  [[nodiscard]] constexpr float bosch_steering_angle_value_physical() const {
+    return static_cast<float>(bosch_steering_angle_value) * 0.1f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr float bosch_steering_speed_value_physical() const {
+    return static_cast<float>(bosch_steering_speed_value) * 0.1f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        0,
+        static_cast<uint8_t>((bosch_steering_angle_value & 0x1) << 7),
+        static_cast<uint8_t>(((bosch_steering_angle_value >> 1) & 0xFF) | bosch_steering_angle_sign),
+        static_cast<uint8_t>(((bosch_steering_angle_value >> 9) & 0x3F) | ((bosch_steering_speed_value & 0x1) << 7)),
+        static_cast<uint8_t>(((bosch_steering_speed_value >> 1) & 0xFF) | bosch_steering_speed_sign),
+        static_cast<uint8_t>((bosch_steering_speed_value >> 9) & 0x3F),
+        static_cast<uint8_t>(bosch_status_bit << 5),
+        static_cast<uint8_t>(bosch_CRC)
+    };
+  }
+
+  [[nodiscard]] static constexpr BoschSteeringAngle unpack(const uint8_t *buf) {
+    BoschSteeringAngle msg;
+    msg.bosch_steering_angle_value = static_cast<uint16_t>(static_cast<uint16_t>((buf[1] >> 7) & 0x1) | (static_cast<uint16_t>(buf[2]) << 1) | (static_cast<uint16_t>(buf[3] & 0x3F) << 9));
+    msg.bosch_steering_angle_sign = (buf[2] & 0x1) != 0;
+    msg.bosch_steering_speed_value = static_cast<uint16_t>(static_cast<uint16_t>((buf[3] >> 7) & 0x1) | (static_cast<uint16_t>(buf[4]) << 1) | (static_cast<uint16_t>(buf[5] & 0x3F) << 9));
+    msg.bosch_steering_speed_sign = (buf[4] & 0x1) != 0;
+    msg.bosch_status_bit = ((buf[6] >> 5) & 0x1) != 0;
+    msg.bosch_CRC = static_cast<uint8_t>(buf[7]);
+    return msg;
+  }
+};
+
+// DV_driving_dynamics_1, sent by ASCU
+struct DvDrivingDynamics1 {
+  static constexpr uint32_t ID = 0x500;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  uint8_t Speed_actual = 0;  ///< km/h
+  uint8_t Speed_target = 0;  ///< km/h
+  int8_t Steering_angle_actual = 0;
+  int8_t Steering_angle_target = 0;
+  uint8_t Brake_hydr_target = 0;  ///< %
+  int8_t Motor_moment_actual = 0;  ///< %
+  int8_t Motor_moment_target = 0;  ///< %
+  uint8_t Brake_hydr_actual = 0;  ///< %
+
+  [[nodiscard]] constexpr float Steering_angle_actual_physical() const {
+    return static_cast<float>(Steering_angle_actual) * 0.5f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr float Steering_angle_target_physical() const {
+    return static_cast<float>(Steering_angle_target) * 0.5f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(Speed_actual),
+        static_cast<uint8_t>(Speed_target),
+        static_cast<uint8_t>(static_cast<uint8_t>(Steering_angle_actual)),
+        static_cast<uint8_t>(static_cast<uint8_t>(Steering_angle_target)),
+        static_cast<uint8_t>(Brake_hydr_actual),
+        static_cast<uint8_t>(Brake_hydr_target),
+        static_cast<uint8_t>(static_cast<uint8_t>(Motor_moment_actual)),
+        static_cast<uint8_t>(static_cast<uint8_t>(Motor_moment_target))
+    };
+  }
+
+  [[nodiscard]] static constexpr DvDrivingDynamics1 unpack(const uint8_t *buf) {
+    DvDrivingDynamics1 msg;
+    msg.Speed_actual = static_cast<uint8_t>(buf[0]);
+    msg.Speed_target = static_cast<uint8_t>(buf[1]);
+    msg.Steering_angle_actual = static_cast<int8_t>(static_cast<uint8_t>(buf[2]));
+    msg.Steering_angle_target = static_cast<int8_t>(static_cast<uint8_t>(buf[3]));
+    msg.Brake_hydr_target = static_cast<uint8_t>(buf[5]);
+    msg.Motor_moment_actual = static_cast<int8_t>(static_cast<uint8_t>(buf[6]));
+    msg.Motor_moment_target = static_cast<int8_t>(static_cast<uint8_t>(buf[7]));
+    msg.Brake_hydr_actual = static_cast<uint8_t>(buf[4]);
+    return msg;
+  }
+};
+
+// DV_driving_dynamics_2, sent by ASCU
+struct DvDrivingDynamics2 {
+  static constexpr uint32_t ID = ::DRIVING_CONTROL;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 6;
+
+  int16_t Acceleration_longitudinal = 0;  ///< m/s^2
+  int16_t Acceleration_lateral = 0;  ///< m/s^2
+  int16_t Yaw_rate = 0;  ///< /s
+
+  [[nodiscard]] constexpr float Yaw_rate_physical() const {
+    return static_cast<float>(Yaw_rate) * 0.125f + 0.0f;
+  }
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(static_cast<uint16_t>(Acceleration_longitudinal) & 0xFF),
+        static_cast<uint8_t>(static_cast<uint16_t>(Acceleration_longitudinal) >> 8),
+        static_cast<uint8_t>(static_cast<uint16_t>(Acceleration_lateral) & 0xFF),
+        static_cast<uint8_t>(static_cast<uint16_t>(Acceleration_lateral) >> 8),
+        static_cast<uint8_t>(static_cast<uint16_t>(Yaw_rate) & 0xFF),
+        static_cast<uint8_t>(static_cast<uint16_t>(Yaw_rate) >> 8)
+    };
+  }
+
+  [[nodiscard]] static constexpr DvDrivingDynamics2 unpack(const uint8_t *buf) {
+    DvDrivingDynamics2 msg;
+    msg.Acceleration_longitudinal = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>(buf[0]) | (static_cast<uint16_t>(buf[1]) << 8)));
+    msg.Acceleration_lateral = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>(buf[2]) | (static_cast<uint16_t>(buf[3]) << 8)));
+    msg.Yaw_rate = static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>(buf[4]) | (static_cast<uint16_t>(buf[5]) << 8)));
+    return msg;
+  }
+};
+
+// DV_system_status, sent by ASCU
+struct DvSystemStatus {
+  static constexpr uint32_t ID = ::SYSTEM_STATUS;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 5;
+
+  uint8_t AS_status = 0;
+  uint8_t ASB_EBS_state = 0;
+  uint8_t AMI_state = 0;
+  bool Steering_state = false;
+  uint8_t ASB_redundancy_state = 0;
+  uint8_t Lap_counter = 0;
+  uint8_t Cones_count_actual = 0;
+  uint16_t Cones_count_all = 0;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>((AS_status & 0x7) | ((ASB_EBS_state & 0x3) << 3) | ((AMI_state & 0x7) << 5)),
+        static_cast<uint8_t>(Steering_state | ((ASB_redundancy_state & 0x3) << 1) | ((Lap_counter & 0xF) << 3) | ((Cones_count_actual & 0x1) << 7)),
+        static_cast<uint8_t>(((Cones_count_actual >> 1) & 0x7F) | ((Cones_count_all & 0x1) << 7)),
+        static_cast<uint8_t>((Cones_count_all >> 1) & 0xFF),
+        static_cast<uint8_t>((Cones_count_all >> 9) & 0x7F)
+    };
+  }
+
+  [[nodiscard]] static constexpr DvSystemStatus unpack(const uint8_t *buf) {
+    DvSystemStatus msg;
+    msg.AS_status = static_cast<uint8_t>(buf[0] & 0x7);
+    msg.ASB_EBS_state = static_cast<uint8_t>((buf[0] >> 3) & 0x3);
+    msg.AMI_state = static_cast<uint8_t>((buf[0] >> 5) & 0x7);
+    msg.Steering_state = (buf[1] & 0x1) != 0;
+    msg.ASB_redundancy_state = static_cast<uint8_t>((buf[1] >> 1) & 0x3);
+    msg.Lap_counter = static_cast<uint8_t>((buf[1] >> 3) & 0xF);
+    msg.Cones_count_actual = static_cast<uint8_t>(static_cast<uint8_t>((buf[1] >> 7) & 0x1) | (static_cast<uint8_t>(buf[2] & 0x7F) << 1));
+    msg.Cones_count_all = static_cast<uint16_t>(static_cast<uint16_t>((buf[2] >> 7) & 0x1) | (static_cast<uint16_t>(buf[3]) << 1) | (static_cast<uint16_t>(buf[4] & 0x7F) << 9));
+    return msg;
+  }
+};
+
+// RES_STATE, sent by RES
+struct ResState {
+  static constexpr uint32_t ID = ::RES_STATE;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  bool emg_stop1 = false;
+  bool go_switch = false;
+  bool go_button = false;
+  bool emg_stop2 = false;
+  uint8_t radio_quality = 0;
+  bool signal_loss = false;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        static_cast<uint8_t>(emg_stop1 | (go_switch << 1) | (go_button << 2)),
+        0,
+        0,
+        static_cast<uint8_t>(emg_stop2 << 7),
+        0,
+        0,
+        static_cast<uint8_t>(radio_quality),
+        static_cast<uint8_t>(signal_loss << 6)
+    };
+  }
+
+  [[nodiscard]] static constexpr ResState unpack(const uint8_t *buf) {
+    ResState msg;
+    msg.emg_stop1 = (buf[0] & 0x1) != 0;
+    msg.go_switch = ((buf[0] >> 1) & 0x1) != 0;
+    msg.go_button = ((buf[0] >> 2) & 0x1) != 0;
+    msg.emg_stop2 = ((buf[3] >> 7) & 0x1) != 0;
+    msg.radio_quality = static_cast<uint8_t>(buf[6]);
+    msg.signal_loss = ((buf[7] >> 6) & 0x1) != 0;
+    return msg;
+  }
+};
+
+// RES_READY, sent by RES
+struct ResReady {
+  static constexpr uint32_t ID = ::RES_READY;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 1;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {0};
+  }
+
+  [[nodiscard]] static constexpr ResReady unpack(const uint8_t *buf) {
+    (void)buf;
+    ResReady msg;
+    return msg;
+  }
+};
+
+// BMS_periodic, sent by BMS
+struct BmsPeriodic {
+  static constexpr uint32_t ID = ::BMS_ID_CCL;
+  static constexpr bool EXTENDED = false;
+  static constexpr uint8_t LEN = 8;
+
+  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {
+    return {
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0
+    };
+  }
+
+  [[nodiscard]] static constexpr BmsPeriodic unpack(const uint8_t *buf) {
+    (void)buf;
+    BmsPeriodic msg;
+    return msg;
+  }
+};
+
+}  // namespace can_db
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <FlexCAN_T4.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Prioritized, coalescing transmit queue shared by the boards' CAN senders
+ * @details Senders enqueue() frames instead of writing them, and loop() calls service() once per
+ * iteration to hand them to the controller, most urgent class first. Which class a frame belongs
+ * to is looked up in the board's constexpr rule table, by ID and first data byte, since most
+ * boards multiplex several signals on one ID behind a type byte.
+ *
+ * - A refused write() is not retried on the spot: the frame stays at the head of its class and
+ *   service() returns, the next call tries again. Nothing blocks or delays.
+ * - Periodic status frames coalesce: a frame whose signal is still waiting is overwritten with
+ *   the new value in place, so a busy bus delays the latest value instead of queueing old ones.
+ * - A frame may have a maximum age. One still waiting past it is dropped rather than sent late.
+ * - service() hands over at most `budget` frames per call. The controller keeps its own transmit
+ *   buffer in order, so this keeps a burst of debug frames from sitting in it ahead of the next
+ *   safety frame.
+ *
+ * Not for interrupt handlers: enqueue() and service() run in loop().
+ */
+namespace can_tx {
+
+/**
+ * @brief Transmit classes, most urgent first
+ */
+enum class Priority : uint8_t {
+  SAFETY,      ///< Emergency and activation frames, RES_ACTIVATE
+  CONTROL,     ///< Commands another node acts on, inverter torque and configuration
+  STATUS,      ///< Periodic state for the other boards and the dashboard
+  DIAGNOSTIC,  ///< Logs and statistics
+  COUNT
+};
+
+constexpr int16_t ANY_TYPE = -1;  ///< Rule type matching every frame of the ID
+
+struct Rule {
+  uint32_t id;
+  int16_t type;  ///< First data byte the rule applies to, or ANY_TYPE
+  Priority priority;
+  bool coalesce;        ///< Latest value wins while a frame of the same signal is waiting
+  uint16_t max_age_ms;  ///< Dropped if not sent within this long, 0 for no limit
+};
+
+/**
+ * @brief Class of the frames no rule matches
+ */
+constexpr Rule DEFAULT_RULE = {0, ANY_TYPE, Priority::STATUS, false, 0};
+
+enum class Result : uint8_t { QUEUED, COALESCED, FULL };
+
+struct Stats {
+  uint32_t sent = 0;
+  uint32_t coalesced = 0;   ///< Frames overwritten by a newer value of their signal before sending
+  uint32_t queue_full = 0;  ///< Frames refused by enqueue() because their class was full
+  uint32_t dropped = 0;     ///< Frames removed unsent after their max_age_ms
+  uint32_t retries = 0;     ///< Writes refused by the controller, tried again on a later service()
+};
+
+/**
+ * @tparam RULES entries in the rule table, first match wins, so typed rules go before an
+ * ANY_TYPE rule of the same ID
+ * @tparam DEPTH frames waiting per class, a power of two
+ */
+template <std::size_t RULES, std::size_t DEPTH = 16>
+class TxQueue {
+  static_assert(DEPTH > 0 && (DEPTH & (DEPTH - 1)) == 0, "the index is a mask");
+
+public:
+  static constexpr std::size_t CLASSES = static_cast<std::size_t>(Priority::COUNT);
+
+  explicit constexpr TxQueue(const std::array<Rule, RULES> &rules) : rules_(rules) {}
+
+  /**
+   * @brief Rule of a frame, DEFAULT_RULE if none matches
+   */
+  [[nodiscard]] constexpr const Rule &rule_of(const CAN_message_t &msg) const {
+    for (const Rule &rule : rules_) {
+      if (rule.id != msg.id) continue;
+      if (rule.type == ANY_TYPE || (msg.len > 0 && rule.type == msg.buf[0])) return rule;
+    }
+    return DEFAULT_RULE;
+  }
+
+  /**
+   * @brief Queues a frame for the next service()
+   * @param now_ms millis(), the start of the frame's max age
+   */
+  Result enqueue(const CAN_message_t &msg, const uint32_t now_ms) {
+    const Rule &rule = rule_of(msg);
+    Ring &ring = rings_[static_cast<std::size_t>(rule.priority)];
+    if (rule.coalesce) {
+      for (uint32_t i = ring.tail; i != ring.head; i++) {
+        Entry &entry = ring.entries[i & MASK];
+        if (entry.frame.id != msg.id) continue;
+        if (rule.type != ANY_TYPE && entry.frame.buf[0] != msg.buf[0]) continue;
+        entry = {msg, now_ms, rule.max_age_ms};
+        stats_.coalesced++;
+        return Result::COALESCED;
+      }
+    }
+    const uint32_t used = ring.head - ring.tail;
+    if (used == DEPTH) {
+      stats_.queue_full++;
+      return Result::FULL;
+    }
+    ring.entries[ring.head++ & MASK] = {msg, now_ms, rule.max_age_ms};
+    if (used + 1 > ring.high_water_mark) ring.high_water_mark = used + 1;
+    return Result::QUEUED;
+  }
+
+  /**
+   * @brief Writes waiting frames, most urgent class first, until `budget` frames were accepted,
+   * the controller refuses one or nothing is left
+   * @return frames the controller accepted
+   */
+  template <class Bus>
+  unsigned service(Bus &bus, const uint32_t now_ms, const unsigned budget) {
+    unsigned written = 0;
+    for (Ring &ring : rings_) {
+      while (ring.tail != ring.head && written < budget) {
+        const Entry &entry = ring.entries[ring.tail & MASK];
+        if (entry.max_age_ms != 0 && now_ms - entry.queued_ms > entry.max_age_ms) {
+          stats_.dropped++;
+        } else if (bus.write(entry.frame) == 1) {
+          stats_.sent++;
+          written++;
+        } else {
+          stats_.retries++;  // the controller is full, a less urgent frame would not fit either
+          return written;
+        }
+        ring.tail++;
+      }
+    }
+    return written;
+  }
+
+  /**
+   * @brief Frames waiting in one class
+   */
+  [[nodiscard]] std::size_t pending(const Priority priority) const {
+    const Ring &ring = rings_[static_cast<std::size_t>(priority)];
+    return ring.head - ring.tail;
+  }
+
+  /**
+   * @brief Frames waiting in every class
+   */
+  [[nodiscard]] std::size_t pending() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < CLASSES; i++) total += pending(static_cast<Priority>(i));
+    return total;
+  }
+
+  /**
+   * @brief Most frames ever waiting at once in one class
+   */
+  [[nodiscard]] uint32_t high_water_mark(const Priority priority) const {
+    return rings_[static_cast<std::size_t>(priority)].high_water_mark;
+  }
+
+  [[nodiscard]] static constexpr std::size_t depth() { return DEPTH; }
+
+  [[nodiscard]] const Stats &stats() const { return stats_; }
+
+  /**
+   * @brief Empties every class and zeroes the counters
+   */
+  void reset() {
+    for (Ring &ring : rings_) ring = Ring{};
+    stats_ = {};
+  }
+
+private:
+  static constexpr uint32_t MASK = DEPTH - 1;
+
+  struct Entry {
+    CAN_message_t frame;
+    uint32_t queued_ms;
+    uint16_t max_age_ms;
+  };
+
+  struct Ring {
+    std::array<Entry, DEPTH> entries{};
+    uint32_t head = 0;  ///< Next slot to fill
+    uint32_t tail = 0;  ///< Next frame to write
+    uint32_t high_water_mark = 0;
+  };
+
+  std::array<Rule, RULES> rules_;
+  std::array<Ring, CLASSES> rings_{};
+  Stats stats_;
+};
+
+}  // namespace can_tx
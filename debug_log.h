@@ -0,0 +1,239 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Deferred binary logging shared by the boards
+ * @details DEBUG_LOG("Hydraulic pressure: {} (limit {})", pressure, limit) formats nothing on the
+ * Teensy. The format string is reduced at compile time to a 32-bit ID (FNV-1a of its text) and
+ * only the ID, micros() and the arguments are copied into a RAM ring, a few dozen cycles. loop()
+ * drains the ring over USB when it has time (drain_to_serial()) and tools/log_decoder.py, which
+ * finds the format strings by scanning the sources, turns the stream back into text.
+ *
+ * Stream layout, little-endian: FRAME_START, length of the rest, ID (4), micros() (4), then per
+ * argument a type tag and its value. Placeholders are Python format fields: {}, {:x}, {:.2f}...
+ */
+namespace debug_log {
+
+constexpr uint8_t FRAME_START = 0xA5;
+constexpr uint32_t DROPPED_ID = 0;  ///< Records lost because the ring was full, one UINT argument
+constexpr std::size_t RING_SIZE = 4096;
+constexpr std::size_t MAX_ARGS = 8;
+
+/**
+ * @brief Argument tags, the letter is what the decoder expects
+ */
+enum ArgType : uint8_t { BOOL = 'b', INT = 'i', UINT = 'u', FLOAT = 'f', INT64 = 'I', UINT64 = 'U' };
+
+constexpr uint32_t id_of(const char *format) {
+  uint32_t hash = 2'166'136'261U;
+  for (; *format != '\0'; format++) {
+    hash ^= static_cast<uint8_t>(*format);
+    hash *= 16'777'619U;
+  }
+  return hash;
+}
+
+constexpr std::size_t placeholders(const char *format) {
+  std::size_t count = 0;
+  for (; *format != '\0'; format++) count += *format == '{';
+  return count;
+}
+
+template <class T>
+constexpr uint8_t tag_of() {
+  using U = std::decay_t<T>;
+  static_assert(std::is_arithmetic_v<U> || std::is_enum_v<U>,
+                "DEBUG_LOG arguments are numbers, bools or enums, put text in the format");
+  if constexpr (std::is_enum_v<U>) {
+    return tag_of<std::underlying_type_t<U>>();
+  } else if constexpr (std::is_same_v<U, bool>) {
+    return BOOL;
+  } else if constexpr (std::is_floating_point_v<U>) {
+    return FLOAT;
+  } else if constexpr (sizeof(U) > 4) {
+    return std::is_signed_v<U> ? INT64 : UINT64;
+  } else {
+    return std::is_signed_v<U> ? INT : UINT;
+  }
+}
+
+constexpr std::size_t size_of(const uint8_t tag) {
+  return tag == BOOL ? 1 : (tag == INT64 || tag == UINT64) ? 8 : 4;
+}
+
+/**
+ * @brief Byte ring between any number of writers on one core (loop() and interrupt handlers that
+ * may preempt each other) and the drain in loop()
+ * @details A writer reserves its bytes with a compare-and-swap and copies them in. The outermost
+ * writer, the one no other writer interrupted, then commits everything reserved so far, which is
+ * complete because nested handlers run to the end before it resumes. When the ring is full the
+ * record is dropped and counted, logging never waits.
+ */
+class Ring {
+public:
+  bool write(const uint8_t *record, const uint32_t length) {
+    writers_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t head = reserved_.load(std::memory_order_relaxed);
+    do {
+      if (head - tail_.load(std::memory_order_acquire) + length > RING_SIZE) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        finish_write();
+        return false;
+      }
+    } while (!reserved_.compare_exchange_weak(head, head + length, std::memory_order_relaxed));
+    const uint32_t start = head & MASK;
+    const uint32_t first = std::min<uint32_t>(length, RING_SIZE - start);
+    memcpy(&buffer_[start], record, first);
+    memcpy(&buffer_[0], record + first, length - first);
+    finish_write();
+    return true;
+  }
+
+  /**
+   * @brief Writes whole committed records to `out` (anything with write(const uint8_t*, size_t)),
+   * at most `budget` bytes, so it never blocks on a full USB buffer
+   * @return bytes written
+   */
+  template <class Out>
+  std::size_t drain(Out &out, const std::size_t budget) {
+    std::size_t sent = 0;
+    if (const uint32_t dropped = dropped_.load(std::memory_order_relaxed); dropped > 0) {
+      std::array<uint8_t, 16> notice{};
+      const std::size_t length = encode(notice.data(), DROPPED_ID, dropped);
+      if (length > budget) return 0;
+      out.write(notice.data(), length);
+      dropped_.fetch_sub(dropped, std::memory_order_relaxed);
+      sent += length;
+    }
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    const uint32_t committed = committed_.load(std::memory_order_acquire);
+    while (tail != committed) {
+      const uint32_t length = 2U + buffer_[(tail + 1) & MASK];
+      if (sent + length > budget) break;
+      const uint32_t start = tail & MASK;
+      const uint32_t first = std::min<uint32_t>(length, RING_SIZE - start);
+      out.write(&buffer_[start], first);
+      if (length > first) out.write(&buffer_[0], length - first);
+      tail += length;
+      sent += length;
+    }
+    tail_.store(tail, std::memory_order_release);
+    return sent;
+  }
+
+  [[nodiscard]] uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  [[nodiscard]] std::size_t pending() const {
+    return committed_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  void reset() {
+    reserved_ = 0;
+    committed_ = 0;
+    tail_ = 0;
+    dropped_ = 0;
+  }
+
+  /**
+   * @brief Frames one record into `out`, which must hold 10 bytes plus 9 per argument
+   * @return bytes used
+   */
+  template <class... Args>
+  static std::size_t encode(uint8_t *out, const uint32_t id, const Args &...args) {
+    uint8_t *cursor = out + 2;
+    put(cursor, &id, 4);
+    const auto now = static_cast<uint32_t>(micros());
+    put(cursor, &now, 4);
+    (put_arg(cursor, args), ...);
+    out[0] = FRAME_START;
+    out[1] = static_cast<uint8_t>(cursor - out - 2);
+    return cursor - out;
+  }
+
+private:
+  static constexpr uint32_t MASK = RING_SIZE - 1;
+  static_assert((RING_SIZE & MASK) == 0, "RING_SIZE must be a power of two");
+
+  std::array<uint8_t, RING_SIZE> buffer_{};
+  std::atomic<uint32_t> reserved_{0};   ///< End of the bytes claimed by writers
+  std::atomic<uint32_t> committed_{0};  ///< End of the bytes the drain may read
+  std::atomic<uint32_t> tail_{0};       ///< Start of the bytes not drained yet
+  std::atomic<uint32_t> dropped_{0};
+  std::atomic<uint32_t> writers_{0};  ///< Writers in progress, nested ones included
+
+  void finish_write() {
+    // A writer we interrupted commits when it finishes, ours included
+    if (writers_.fetch_sub(1, std::memory_order_relaxed) != 1) return;
+    const uint32_t reserved = reserved_.load(std::memory_order_relaxed);
+    uint32_t committed = committed_.load(std::memory_order_relaxed);
+    while (static_cast<int32_t>(reserved - committed) > 0 &&
+           !committed_.compare_exchange_weak(committed, reserved, std::memory_order_release)) {
+    }
+  }
+
+  static void put(uint8_t *&cursor, const void *value, const std::size_t size) {
+    memcpy(cursor, value, size);  // the Teensy and the host are both little-endian
+    cursor += size;
+  }
+
+  template <class T>
+  static void put_arg(uint8_t *&cursor, const T &value) {
+    constexpr uint8_t tag = tag_of<T>();
+    *cursor++ = tag;
+    if constexpr (tag == BOOL) {
+      *cursor++ = value ? 1 : 0;
+    } else if constexpr (tag == FLOAT) {
+      const auto narrowed = static_cast<float>(value);
+      put(cursor, &narrowed, 4);
+    } else if constexpr (tag == INT64 || tag == UINT64) {
+      const auto widened = static_cast<uint64_t>(value);
+      put(cursor, &widened, 8);
+    } else {
+      const auto widened = static_cast<uint32_t>(value);
+      put(cursor, &widened, 4);
+    }
+  }
+};
+
+inline Ring ring;
+
+/**
+ * @brief Body of DEBUG_LOG, `Format::text()` is the format string literal
+ */
+template <class Format, class... Args>
+void log(const Args &...args) {
+  static_assert(placeholders(Format::text()) == sizeof...(Args),
+                "DEBUG_LOG needs one argument per {} in the format");
+  static_assert(sizeof...(Args) <= MAX_ARGS, "DEBUG_LOG takes at most MAX_ARGS arguments");
+  constexpr uint32_t id = id_of(Format::text());
+  std::array<uint8_t, 10 + 9 * sizeof...(Args)> record;  // encode() writes what is copied
+  ring.write(record.data(), Ring::encode(record.data(), id, args...));
+}
+
+/**
+ * @brief Sends what fits in the USB buffer right now, call it from loop() when there is time
+ */
+inline void drain_to_serial() { ring.drain(Serial, Serial.availableForWrite()); }
+
+}  // namespace debug_log
+
+/**
+ * @brief Logs a line without formatting it, see debug_log; the format must be a string literal
+ * and every argument a number, bool or enum
+ */
+#define DEBUG_LOG(format, ...)                               \
+  do {                                                       \
+    struct DebugLogFormat {                                  \
+      static constexpr const char *text() { return format; } \
+    };                                                       \
+    ::debug_log::log<DebugLogFormat>(__VA_ARGS__);           \
+  } while (0)
@@ -5,35 +5,49 @@
 
 #include <string>
 
+#ifdef NATIVE
+#include <cstdio>
+#endif
+
 #include "../../CAN_IDs.h"
+#include "../../CAN_dispatch.h"
+#include "../../CAN_messages.h"
+#include "../../can_tx_queue.h"
+#include "comm/spscQueue.hpp"
 #include "comm/utils.hpp"
 #include "debugUtils.hpp"
 #include "enum_utils.hpp"
+#include "model/emergencyEvent.hpp"
 #include "model/systemData.hpp"
 #include "utils.hpp"
 #include "../utils.hpp"
 
 
-/**
- * @brief Array of standard CAN message codes to be used for FIFO filtering
- * Each Code struct contains a key and a corresponding message ID.
- */
-inline std::array<Code, 7> fifoCodes = {{{0, DASH_ID},
-                                         {1, BAMO_RESPONSE_ID},
-                                         {2, AS_CU_EMERGENCY_SIGNAL},
-                                         {3, MISSION_FINISHED},
-                                         {4, AS_CU_ID},
-                                         {5, RES_STATE},
-                                         {6, RES_READY}}};
+constexpr std::size_t RX_QUEUE_CAPACITY = 128;  ///< Frames buffered between the CAN ISR and loop()
+constexpr std::size_t TX_QUEUE_DEPTH = 16;      ///< Frames waiting per transmit class
+constexpr unsigned TX_FRAMES_PER_LOOP = 4;      ///< Frames handed to the controller per loop()
 
 /**
- * @brief Array of extended CAN message codes to be used for FIFO filtering
- * Contains the key and corresponding message ID for extended messages.
+ * @brief Transmit class of every frame the master sends, see can_tx_queue.h
+ * @details The MASTER_ID status frames are latest-value-wins, each frame behind its type byte.
+ * Loop profiles and heartbeats are one frame per stage or node and must all go out, so they do
+ * not coalesce; they are worthless after their one-second window.
  */
-inline std::array<Code, 1> fifoExtendedCodes = {{
-    {7, STEERING_ID},
+inline constexpr std::array<can_tx::Rule, 7> txRules = {{
+    {RES_ACTIVATE, can_tx::ANY_TYPE, can_tx::Priority::SAFETY, false, 0},
+    {MASTER_ID, MASTER_STATUS_MSG, can_tx::Priority::STATUS, true, 0},
+    {MASTER_ID, MASTER_WHEELS_MSG, can_tx::Priority::STATUS, true, 0},
+    {MASTER_ID, DBG_LOG_MSG, can_tx::Priority::DIAGNOSTIC, true, 0},
+    {MASTER_ID, DBG_LOG_MSG_2, can_tx::Priority::DIAGNOSTIC, true, 0},
+    {MASTER_ID, DBG_PROFILE_MSG, can_tx::Priority::DIAGNOSTIC, false, 1000},
+    {MASTER_ID, DBG_HEARTBEAT_MSG, can_tx::Priority::DIAGNOSTIC, false, 1000},
 }};
 
+static_assert(can_db::MasterMsgs::M56::MUX == MASTER_STATUS_MSG &&
+                  can_db::MasterMsgs::M57::MUX == MASTER_WHEELS_MSG &&
+                  can_db::DashMsgs::M80::MUX == DASH_WHEELS_BRAKE_MSG,
+              "CAN_IDs.h disagrees with the layout tools/frame_planner.py wrote to conf.dbc");
+
 /**
  * @brief Class that contains definitions of typical messages to send via CAN
  * It serves only as an example of the usage of the strategy pattern,
@@ -44,6 +58,12 @@ private:
   // Static FlexCAN_T4 object for CAN2 interface with RX and TX buffer sizes specified
   inline static FlexCAN_T4<CAN3, RX_SIZE_256, TX_SIZE_16> can3;
 
+  // Frames accepted by the FIFO, waiting to be decoded by process_received()
+  inline static SpscQueue<CAN_message_t, RX_QUEUE_CAPACITY> rx_queue_;
+
+  // Frames sent from loop(), waiting for process_transmit()
+  inline static can_tx::TxQueue<txRules.size(), TX_QUEUE_DEPTH> tx_queue_{txRules};
+
 public:
   // Pointer to SystemData instance for storing system-related data
   inline static SystemData *_systemData = nullptr;
@@ -60,17 +80,44 @@ public:
    */
   void init();
 
+  /**
+   * @brief FIFO interrupt handler, only queues the frame for process_received()
+   */
+  static void receive_isr(const CAN_message_t &msg);
+
+  /**
+   * @brief Decodes the frames queued since the last call, from the main loop
+   * @details Stops after one queue's worth of frames so a flooded bus cannot stall loop().
+   */
+  static void process_received();
+
+  /**
+   * @brief Receive queue, for its overflow and high-water-mark counters
+   */
+  static const SpscQueue<CAN_message_t, RX_QUEUE_CAPACITY> &rx_queue() { return rx_queue_; }
+
+  /**
+   * @brief Writes the queued frames to the bus, most urgent first, from the main loop
+   * @param budget frames handed to the controller at most, the rest wait for the next call
+   */
+  static void process_transmit(unsigned budget = TX_FRAMES_PER_LOOP);
+
+  /**
+   * @brief Transmit queue, for its coalescing, queue-full and drop counters
+   */
+  static const can_tx::TxQueue<txRules.size(), TX_QUEUE_DEPTH> &tx_queue() { return tx_queue_; }
+
   /**
    * @brief Parses the message received from the CAN bus
    */
   static void parse_message(const CAN_message_t &msg);
 
   /**
-   * @brief Sends a message to the CAN bus
+   * @brief Queues a message for the CAN bus, sent by the next process_transmit()
    * @param len Length of the message
    * @param buffer Buffer containing the message
    * @param id ID of the message
-   * @return 0 if successful
+   * @return 0 if queued, -1 if its transmit class was full
    */
   template <std::size_t N>
   static int send_message(unsigned len, const std::array<uint8_t, N> &buffer, unsigned id);
@@ -111,22 +158,15 @@ public:
   static void dash_callback(const uint8_t* buf);
 
   /**
-   * @brief Publish AS State to CAN
+   * @brief Callback for the cell temperatures of the cells master board, its alive signal
    */
-  static int publish_state(int state_id);
+  static void cells_callback();
 
   /**
-   * @brief Publish AS Mission to CAN
-   */
-  static int publish_mission(int mission_id);
-  /**
-   * @brief Publish SOC to CAN
+   * @brief Publish AS state, mission, SOC and ASMS to CAN, in one MASTER_STATUS_MSG frame
    */
-  static int publish_soc(uint8_t soc);
-  /**
-   * @brief Publish ASMS state to CAN
-   */
-  static int publish_asms_on(bool asms_on);
+  static int publish_status(int state_id, int mission_id, uint8_t soc, bool asms_on);
+
   /**
    * @brief Publish AS Mission to CAN
    */
@@ -134,28 +174,55 @@ public:
                                        uint8_t state_checkup);
 
   /**
-   * @brief Publish rl wheel rpm to CAN
+   * @brief Publish both rear wheel speeds to CAN, in one MASTER_WHEELS_MSG frame
    */
   static int publish_rpm();
+
+  /**
+   * @brief Publish worst case, p99 and mean of every loop stage since the last call, one
+   * DBG_PROFILE_MSG frame per stage, and start a new profiling window
+   */
+  static int publish_loop_profile();
+
+  /**
+   * @brief Publish the alive bitmask and the arrival statistics of every heartbeat since the last
+   * call, one DBG_HEARTBEAT_MSG frame per node, and start a new window
+   */
+  static int publish_heartbeats();
 };
 
+using ReceiveHandler = void (*)(const CAN_message_t &);
+
+/**
+ * @brief Every frame the master consumes, with its handler
+ * @details parse_message() looks frames up here and init() builds the FIFO filters from it, so a
+ * new frame only has to be added in this one place.
+ */
+inline constexpr auto receiveTable = can_dispatch::make_table<ReceiveHandler>({
+    {AS_CU_ID, false, [](const CAN_message_t &msg) { Communicator::pc_callback(msg.buf); }},
+    {RES_STATE, false, [](const CAN_message_t &msg) { Communicator::res_state_callback(msg.buf); }},
+    {RES_READY, false, [](const CAN_message_t &) { Communicator::res_ready_callback(); }},
+    {BAMO_RESPONSE_ID, false,
+     [](const CAN_message_t &msg) { Communicator::bamocar_callback(msg.buf); }},
+    {STEERING_ID, true, [](const CAN_message_t &) { Communicator::steering_callback(); }},
+    {DASH_ID, false, [](const CAN_message_t &msg) { Communicator::dash_callback(msg.buf); }},
+    {CELL_TEMPS_BASE_ID, false, [](const CAN_message_t &) { Communicator::cells_callback(); }},
+});
+
 inline Communicator::Communicator(SystemData *system_data) { _systemData = system_data; }
 
-void Communicator::init() {
+inline void Communicator::init() {
+  rx_queue_.reset();
+  tx_queue_.reset();
   can3.begin();
   can3.setBaudRate(1'000'000);
   can3.setRFFN(RFFN_32);
   can3.enableFIFO();
   can3.enableFIFOInterrupt();
 
-  can3.setFIFOFilter(REJECT_ALL);
-  for (auto &fifoCode : fifoCodes) can3.setFIFOFilter(fifoCode.key, fifoCode.code, STD);
-
-  for (auto &fifoExtendedCode : fifoExtendedCodes)
-    can3.setFIFOFilter(fifoExtendedCode.key, fifoExtendedCode.code, EXT);
-
+  receiveTable.program_filters(can3);
 
-  can3.onReceive(FIFO, parse_message);
+  can3.onReceive(FIFO, receive_isr);
 
   can3.mailboxStatus();
 }
@@ -169,20 +236,21 @@ inline void Communicator::res_state_callback(const uint8_t *buf) {
   bool emg_stop2 = buf[3] >> 7 & 0x01;
   bool go_switch = (buf[0] >> 1) & 0x01;
   bool go_button = (buf[0] >> 2) & 0x01;
-  // DEBUG_PRINT("RES GO: " + String(go_switch) + "   EMG 1: " + String(emg_stop1) + "   EMG 2: " + String(emg_stop2));
+  // DEBUG_PRINT("RES GO: {}   EMG 1: {}   EMG 2: {}", go_switch, emg_stop1, emg_stop2);
   
   if (go_button || go_switch)
     _systemData->r2d_logics_.process_go_signal();
   else if (!(emg_stop1 || emg_stop2)) { // If both are false 
     // DEBUG_PRINT("Received Emergency from RES");
     _systemData->failure_detection_.emergency_signal_ = true;
+    EmergencyEvent::raise();
   }
 
   _systemData->failure_detection_.radio_quality_ = buf[6];
   bool signal_loss = (buf[7] >> 6) & 0x01;
   if (!signal_loss) {
-    _systemData->failure_detection_.res_signal_loss_timestamp_
-        .reset();  // making sure we dont receive only signal loss for the defined time interval
+    _systemData->failure_detection_.kick(
+        FailureTimer::RES);  // making sure we dont receive only signal loss for the defined time interval
                    // DEBUG_PRINT("SIGNAL OKAY");
   } else {
     // Too many will violate the disconnection time limit
@@ -198,29 +266,29 @@ inline void Communicator::res_ready_callback() {
 }
 
 inline void Communicator::bamocar_callback(const uint8_t *buf) {
-  _systemData->failure_detection_.inversor_alive_timestamp_.reset();
+  _systemData->failure_detection_.kick(FailureTimer::INVERTER);
 
   if (buf[0] == BTB_READY) {
     if (buf[1] == false) {
       _systemData->failure_detection_.ts_on_ = false;
     }
   } else if (buf[0] == BAMOCAR_BATTERY_VOLTAGE_CODE) {
-    unsigned dc_voltage = (buf[2] << 8) | buf[1];
+    unsigned dc_voltage = can_db::BamocarTx::M235::unpack(buf).dc_voltage;
     _systemData->failure_detection_.dc_voltage_ = dc_voltage;
 
     // Voltage hysteresis:
     if (dc_voltage < DC_THRESHOLD) {
       // When voltage drops/is below threshold: 
       // Reset hold timer and check if voltage has been below threshold long enough
-      _systemData->failure_detection_.dc_voltage_hold_timestamp_.reset();
-      if (_systemData->failure_detection_.dc_voltage_drop_timestamp_.checkWithoutReset()) {
+      _systemData->failure_detection_.kick(FailureTimer::DC_VOLTAGE_HOLD);
+      if (_systemData->failure_detection_.expired(FailureTimer::DC_VOLTAGE_DROP)) {
         _systemData->failure_detection_.ts_on_ = false;
       }
     } else {
       // When voltage is above threshold:
       // Reset drop timer and check if voltage has been above threshold long enough
-      _systemData->failure_detection_.dc_voltage_drop_timestamp_.reset();
-      if (_systemData->failure_detection_.dc_voltage_hold_timestamp_.checkWithoutReset()) {
+      _systemData->failure_detection_.kick(FailureTimer::DC_VOLTAGE_DROP);
+      if (_systemData->failure_detection_.expired(FailureTimer::DC_VOLTAGE_HOLD)) {
         _systemData->failure_detection_.ts_on_ = true;
       }
     }
@@ -230,63 +298,59 @@ inline void Communicator::bamocar_callback(const uint8_t *buf) {
 inline void Communicator::pc_callback(const uint8_t *buf) {
   // DEBUG_PRINT("PC alive signal received");
   if (buf[0] == PC_ALIVE) {
-    _systemData->failure_detection_.pc_alive_timestamp_.reset();
+    _systemData->failure_detection_.kick(FailureTimer::PC);
   } else if (buf[0] == MISSION_FINISHED) {
     _systemData->mission_finished_ = true;
   } else if (buf[0] == AS_CU_EMERGENCY_SIGNAL) {
     DEBUG_PRINT("Received Emergency from AS CU");
     _systemData->failure_detection_.emergency_signal_ = true;
+    EmergencyEvent::raise();
   }
 }
 
 inline void Communicator::steering_callback() {
-  _systemData->failure_detection_.steer_alive_timestamp_.reset();
+  _systemData->failure_detection_.kick(FailureTimer::STEERING);
 }
 
 inline void Communicator::dash_callback(const uint8_t *buf) {
-  if (buf[0] == HYDRAULIC_LINE) {
-    _systemData->hardware_data_.hydraulic_line_front_pressure = (buf[2] << 8) | buf[1];
+  _systemData->failure_detection_.kick(FailureTimer::DASH);
+  if (buf[0] == DASH_WHEELS_BRAKE_MSG) {
+    _systemData->hardware_data_.hydraulic_line_front_pressure =
+        can_db::DashMsgs::M80::unpack(buf).hydraulic_line;
   }
 }
 
+inline void Communicator::cells_callback() {
+  _systemData->failure_detection_.kick(FailureTimer::CELLS);
+}
 
-inline void Communicator::parse_message(const CAN_message_t &msg) {
-  switch (msg.id) {
-    case AS_CU_ID:
-      pc_callback(msg.buf);
-    case RES_STATE:
-      res_state_callback(msg.buf);
-      break;
-    case RES_READY:
-      res_ready_callback();
-      break;
-    case BAMO_RESPONSE_ID:
-      bamocar_callback(msg.buf);
-      break;
-    case STEERING_ID:
-      steering_callback();
-      break;
-    case DASH_ID:
-      dash_callback(msg.buf);
-      break;
-    default:
-      break;
-  }
+
+inline void Communicator::receive_isr(const CAN_message_t &msg) { rx_queue_.push(msg); }
+
+inline void Communicator::process_received() {
+  CAN_message_t msg;
+  for (std::size_t i = 0; i < RX_QUEUE_CAPACITY && rx_queue_.pop(msg); i++) parse_message(msg);
 }
 
+inline void Communicator::process_transmit(const unsigned budget) {
+  tx_queue_.service(can3, millis(), budget);
+}
 
-inline int Communicator::publish_state(const int state_id) {
-  const std::array<uint8_t, 2> msg = {STATE_MSG, static_cast<uint8_t>(state_id)};
-  send_message(2, msg, MASTER_ID);
-  return 0;
+inline void Communicator::parse_message(const CAN_message_t &msg) {
+  if (const ReceiveHandler *handler = receiveTable.find(msg)) (*handler)(msg);
 }
 
-inline int Communicator::publish_mission(int mission_id) {
-  const std::array<uint8_t, 2> msg = {MISSION_MSG, static_cast<uint8_t>(mission_id)};
 
-  send_message(2, msg, MASTER_ID);
-  return 0;
+inline int Communicator::publish_status(const int state_id, const int mission_id,
+                                        const uint8_t soc, const bool asms_on) {
+  can_db::MasterMsgs::M56 status;
+  status.master_state = static_cast<uint8_t>(state_id);
+  status.mission = static_cast<uint8_t>(mission_id);
+  status.asms_on = asms_on;
+  status.lv_soc = soc;
+  return send_message(status.LEN, status.pack(), MASTER_ID);
 }
+
 inline int Communicator::publish_debug_morning_log(const SystemData &system_data, uint8_t state,
                                                    uint8_t state_checkup) {
   send_message(8, create_debug_message_1(system_data, state, state_checkup), MASTER_ID);
@@ -294,40 +358,35 @@ inline int Communicator::publish_debug_morning_log(const SystemData &system_data
   return 0;
 }
 
-inline int Communicator::publish_soc(uint8_t soc) {
-  const std::array<uint8_t, 2> msg = {SOC_MSG, soc};
-  send_message(2, msg, MASTER_ID);
+inline int Communicator::publish_loop_profile() {
+  const uint32_t cycles_per_us = profiler_cycles_per_us();
+  for (std::size_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    const auto stage = static_cast<LoopStage>(i);
+    send_message(8, create_profile_message(stage, LoopProfiler::window(stage), cycles_per_us),
+                 MASTER_ID);
+  }
+  LoopProfiler::start_window();
   return 0;
 }
 
-inline int Communicator::publish_asms_on(bool asms_on) {
-  const std::array<uint8_t, 2> msg = {ASMS, asms_on};
-  send_message(2, msg, MASTER_ID);
+inline int Communicator::publish_heartbeats() {
+  FailureDetection &failure_detection = _systemData->failure_detection_;
+  const uint8_t alive = failure_detection.alive();
+  for (std::size_t i = 0; i < FailureDetection::HEARTBEAT_COUNT; i++) {
+    send_message(8,
+                 create_heartbeat_message(static_cast<FailureTimer>(i),
+                                          failure_detection.deadlines_.stats(i), alive),
+                 MASTER_ID);
+    failure_detection.deadlines_.reset_stats(i);
+  }
   return 0;
 }
 
 inline int Communicator::publish_rpm() {
-  std::array<uint8_t, 5> rl_rpm_msg = {0};
-  std::array<uint8_t, 5> rr_rpm_msg = {0};
-
-  char rr_rpm_byte[4];
-  char rl_rpm_byte[4];
-  rpm_2_byte(_systemData->hardware_data_._left_wheel_rpm, rl_rpm_byte);
-  rpm_2_byte(_systemData->hardware_data_._right_wheel_rpm, rr_rpm_byte);
-
-  rl_rpm_msg[0] = LEFT_WHEEL_CODE;
-  for (int i = 0; i < 4; i++) {
-    rl_rpm_msg[i + 1] = rl_rpm_byte[i];
-  }
-
-  rr_rpm_msg[0] = RIGHT_WHEEL_CODE;
-  for (int i = 0; i < 4; i++) {
-    rr_rpm_msg[i + 1] = rr_rpm_byte[i];
-  }
-  send_message(5, rl_rpm_msg, MASTER_ID);
-  send_message(5, rr_rpm_msg, MASTER_ID);
-
-  return 0;
+  can_db::MasterMsgs::M57 wheels;
+  wheels.rl_rpm = wheel_centi_rpm(_systemData->hardware_data_._left_wheel_rpm);
+  wheels.rr_rpm = wheel_centi_rpm(_systemData->hardware_data_._right_wheel_rpm);
+  return send_message(wheels.LEN, wheels.pack(), MASTER_ID);
 }
 
 template <std::size_t N>
@@ -339,7 +398,18 @@ inline int Communicator::send_message(const unsigned len, const std::array<uint8
   for (unsigned i = 0; i < len; i++) {
     can_message.buf[i] = buffer[i];
   }
-  can3.write(can_message);
+  return tx_queue_.enqueue(can_message, millis()) == can_tx::Result::FULL ? -1 : 0;
+}
 
-  return 0;
+#ifdef NATIVE
+/**
+ * @brief Prints what the transmit queue sent, merged, refused and dropped
+ */
+inline void print_can_transmit(FILE *out) {
+  const can_tx::Stats &stats = Communicator::tx_queue().stats();
+  fprintf(out,
+          "CAN transmit: %u sent, %u coalesced, %u refused by a full queue, %u dropped as stale, "
+          "%u retries\n",
+          stats.sent, stats.coalesced, stats.queue_full, stats.dropped, stats.retries);
 }
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-capacity lock-free queue between one producer and one consumer
+ * @details Made for handing items from an interrupt handler to the main loop: push() only runs in
+ * the producer, pop() only in the consumer, and neither needs interrupts disabled. Head and tail
+ * are free-running counters, each written by one side only, and the capacity is a power of two so
+ * wrapping is a mask. When the queue is full push() drops the new item and counts an overflow.
+ * @tparam T item type, copied in and out
+ * @tparam Capacity number of slots, power of two
+ */
+template <class T, std::size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+public:
+  /**
+   * @brief Adds an item, producer side only
+   * @return false if the queue was full and the item was dropped
+   */
+  bool push(const T &item) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    const uint32_t tail = tail_.load(std::memory_order_acquire);
+    const uint32_t used = head - tail;
+    if (used == Capacity) {
+      overflows_.store(overflows_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    buffer_[head & MASK] = item;
+    head_.store(head + 1, std::memory_order_release);
+    if (used + 1 > high_water_mark_.load(std::memory_order_relaxed)) {
+      high_water_mark_.store(used + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Takes the oldest item, consumer side only
+   * @return false if the queue was empty
+   */
+  bool pop(T &item) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) return false;
+    item = buffer_[tail & MASK];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Items waiting, exact from the consumer side, a lower bound from the producer side
+   */
+  [[nodiscard]] std::size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  [[nodiscard]] static constexpr std::size_t capacity() { return Capacity; }
+
+  /**
+   * @brief Items dropped because the queue was full
+   */
+  [[nodiscard]] uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Most items ever waiting at once
+   */
+  [[nodiscard]] uint32_t high_water_mark() const {
+    return high_water_mark_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Empties the queue and zeroes the counters, only while the producer is stopped
+   */
+  void reset() {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    overflows_.store(0, std::memory_order_relaxed);
+    high_water_mark_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr uint32_t MASK = Capacity - 1;
+
+  std::array<T, Capacity> buffer_{};
+  std::atomic<uint32_t> head_{0};  ///< Next slot to write, producer owned
+  std::atomic<uint32_t> tail_{0};  ///< Next slot to read, consumer owned
+  std::atomic<uint32_t> overflows_{0};
+  std::atomic<uint32_t> high_water_mark_{0};
+};
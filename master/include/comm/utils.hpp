@@ -2,13 +2,15 @@
 #include <Arduino.h>
 
 #include "../../CAN_IDs.h"
+#include "../../CAN_messages.h"
 #include "model/systemData.hpp"
 #include "enum_utils.hpp"
+#include "loopProfiler.hpp"
 
 /**
  * @brief Function to create left wheel msg
  */
-void create_left_wheel_msg(std::array<uint8_t, 5> &msg, double value) {
+inline void create_left_wheel_msg(std::array<uint8_t, 5> &msg, double value) {
   value /= WHEEL_PRECISION;  // take precision off to send integer value
   if (value < 0) value = 0;
 
@@ -18,48 +20,81 @@ void create_left_wheel_msg(std::array<uint8_t, 5> &msg, double value) {
     msg[i + 1] = static_cast<int>(value) >> (8 * i);  // shift 8(byte) to msb each time
 }
 
-inline std::array<uint8_t, 8> create_debug_message_1(const SystemData& system_data, const uint8_t state, const uint8_t state_checkup) {
-    // Ensure boolean values are normalized to 0 or 1
-    auto normalize_bool = [](bool value) -> uint8_t { return value ? 1 : 0; };
-    
-    // Pack byte 5 flags with explicit normalization
-    uint8_t byte5 = (normalize_bool(system_data.failure_detection_.emergency_signal_) << 7) | 
-                    (normalize_bool(system_data.hardware_data_.pneumatic_line_pressure_) << 6) |
-                    (normalize_bool(system_data.r2d_logics_.engageEbsTimestamp.checkWithoutReset()) << 5) | 
-                    (normalize_bool(system_data.r2d_logics_.releaseEbsTimestamp.checkWithoutReset()) << 4) |
-                    (normalize_bool(system_data.failure_detection_.steer_dead_) << 3) | 
-                    (normalize_bool(system_data.failure_detection_.pc_dead_) << 2) |
-                    (normalize_bool(system_data.failure_detection_.inversor_dead_) << 1) | 
-                    normalize_bool(system_data.failure_detection_.res_dead_);
-    
-    // Pack byte 6 flags with explicit normalization
-    uint8_t byte6 = (normalize_bool(system_data.hardware_data_.asms_on_) << 7) | 
-                    (normalize_bool(system_data.failure_detection_.ts_on_) << 6) | 
-                    (normalize_bool(system_data.hardware_data_.tsms_sdc_closed_) << 5) |
-                    (state_checkup & 0x0F);
-    
-    return {
-        DBG_LOG_MSG,
-        static_cast<uint8_t>((system_data.hardware_data_._hydraulic_line_pressure >> 24) & 0xFF),
-        static_cast<uint8_t>((system_data.hardware_data_._hydraulic_line_pressure >> 16) & 0xFF),
-        static_cast<uint8_t>((system_data.hardware_data_._hydraulic_line_pressure >> 8) & 0xFF),
-        static_cast<uint8_t>(system_data.hardware_data_._hydraulic_line_pressure & 0xFF),
-        byte5,
-        byte6,
-        static_cast<uint8_t>((to_underlying(system_data.mission_) & 0x0F) | ((state & 0x0F) << 4))
-    };
+/**
+ * @brief Wheel speed in the raw unit of the packed wheel frames, WHEEL_PRECISION RPM, clamped to
+ * the 0 to WHEEL_RPM_MAX range their signals hold
+ */
+inline uint32_t wheel_centi_rpm(const double rpm) {
+  const double clamped = rpm < 0 ? 0 : (rpm > WHEEL_RPM_MAX ? WHEEL_RPM_MAX : rpm);
+  return static_cast<uint32_t>(clamped / WHEEL_PRECISION + 0.5);
 }
 
+/**
+ * @brief Debug log frame 1 (master_msgs mux DBG_LOG_MSG), layout generated from conf.dbc
+ */
+inline std::array<uint8_t, 8> create_debug_message_1(const SystemData& system_data, const uint8_t state, const uint8_t state_checkup) {
+    can_db::MasterMsgs::M52 msg;
+    msg.hydraulic_line_pressure = static_cast<uint32_t>(system_data.hardware_data_._hydraulic_line_pressure);
+    msg.emergency_signal = system_data.failure_detection_.emergency_signal_;
+    msg.pneumatic_pressure = system_data.hardware_data_.pneumatic_line_pressure_;
+    msg.engage_ebs_timestamp = system_data.r2d_logics_.expired(R2DTimer::ENGAGE_EBS);
+    msg.release_ebs_timestamp = system_data.r2d_logics_.expired(R2DTimer::RELEASE_EBS);
+    msg.steer_dead = system_data.failure_detection_.steer_dead_;
+    msg.pc_dead = system_data.failure_detection_.pc_dead_;
+    msg.inverson_dead = system_data.failure_detection_.inversor_dead_;
+    msg.res_dead = system_data.failure_detection_.res_dead_;
+    msg.checkup_state = state_checkup;
+    msg.tsms_state = system_data.hardware_data_.tsms_sdc_closed_;
+    msg.ts_on = system_data.failure_detection_.ts_on_;
+    msg.asms_on_log = system_data.hardware_data_.asms_on_;
+    msg.mission_log = to_underlying(system_data.mission_);
+    msg.master_state_log = state;
+    return msg.pack();
+}
+/**
+ * @brief Debug log frame 2 (master_msgs mux DBG_LOG_MSG_2), layout generated from conf.dbc
+ */
 inline std::array<uint8_t, 8> create_debug_message_2(const SystemData& system_data) {
-    // Ensure boolean values are normalized to 0 or 1
-    return {
-        DBG_LOG_MSG_2,
-        static_cast<uint8_t>((system_data.failure_detection_.dc_voltage_ >> 24) & 0xFF),
-        static_cast<uint8_t>((system_data.failure_detection_.dc_voltage_ >> 16) & 0xFF),
-        static_cast<uint8_t>((system_data.failure_detection_.dc_voltage_ >> 8) & 0xFF),
-        static_cast<uint8_t>(system_data.failure_detection_.dc_voltage_ & 0xFF),
-        static_cast<uint8_t>(system_data.hardware_data_.pneumatic_line_pressure_1_ & 0x01),
-        static_cast<uint8_t>(system_data.hardware_data_.pneumatic_line_pressure_2_ & 0x01),
-        static_cast<uint8_t>(system_data.hardware_data_.master_sdc_closed_ & 0x01)
+    can_db::MasterMsgs::M53 msg;
+    msg.dcvoltage = system_data.failure_detection_.dc_voltage_;
+    msg.pneumatic_line_1 = system_data.hardware_data_.pneumatic_line_pressure_1_;
+    msg.pneumatic_line_2 = system_data.hardware_data_.pneumatic_line_pressure_2_;
+    msg.master_sdc_closed = system_data.hardware_data_.master_sdc_closed_;
+    return msg.pack();
+}
+
+/**
+ * @brief Loop profile frame (master_msgs mux DBG_PROFILE_MSG) of one stage, times in 0.1 us
+ * saturating at 6553.5 us
+ */
+inline std::array<uint8_t, 8> create_profile_message(const LoopStage stage,
+                                                     const CycleHistogram& histogram,
+                                                     const uint32_t cycles_per_us) {
+    const auto tenth_us = [cycles_per_us](const uint32_t cycles) {
+        const uint64_t value = static_cast<uint64_t>(cycles) * 10 / cycles_per_us;
+        return static_cast<uint16_t>(std::min<uint64_t>(value, UINT16_MAX));
     };
-}
\ No newline at end of file
+    can_db::MasterMsgs::M54 msg;
+    msg.profile_stage = to_underlying(stage);
+    msg.profile_max_us = tenth_us(histogram.max());
+    msg.profile_p99_us = tenth_us(histogram.percentile(990));
+    msg.profile_mean_us = tenth_us(histogram.mean());
+    return msg.pack();
+}
+
+/**
+ * @brief Heartbeat frame (master_msgs mux DBG_HEARTBEAT_MSG) of one node, with the alive bitmask
+ * of all of them; times saturate at the width of their signal
+ */
+inline std::array<uint8_t, 8> create_heartbeat_message(const FailureTimer node,
+                                                       const DeadlineStats& stats,
+                                                       const uint8_t alive) {
+    can_db::MasterMsgs::M55 msg;
+    msg.heartbeat_node = to_underlying(node);
+    msg.heartbeat_alive = alive;
+    const auto saturate = [](const uint32_t ms, const uint32_t max) { return std::min(ms, max); };
+    msg.heartbeat_max_gap_ms = static_cast<uint16_t>(saturate(stats.max_gap_ms, UINT16_MAX));
+    msg.heartbeat_mean_period_ms = static_cast<uint16_t>(saturate(stats.mean_gap_ms(), UINT16_MAX));
+    msg.heartbeat_jitter_ms = static_cast<uint8_t>(saturate(stats.jitter_ms(), UINT8_MAX));
+    return msg.pack();
+}
@@ -1,31 +1,21 @@
 #pragma once
 
+// Tokenized: the format string stays in the source and only its ID and the arguments are
+// logged, tools/log_decoder.py prints the lines. See ../../debug_log.h
 #ifdef DEBUG
-#include <Arduino.h>
-#define DEBUG_PRINT(str)                                                       \
-  Serial.print(millis());                                                      \
-  Serial.print(": ");                                                          \
-  Serial.print(__PRETTY_FUNCTION__);                                           \
-  Serial.print(' ');                                                           \
-  Serial.print(__FILE__);                                                      \
-  Serial.print(':');                                                           \
-  Serial.print(__LINE__);                                                      \
-  Serial.print(' ');                                                           \
-  Serial.println(str);
-
-#define DEBUG_PRINT_VAR(var)                                                   \
-  Serial.print(millis());                                                      \
-  Serial.print(": ");                                                          \
-  Serial.print(__PRETTY_FUNCTION__);                                           \
-  Serial.print(' ');                                                           \
-  Serial.print(__FILE__);                                                      \
-  Serial.print(':');                                                           \
-  Serial.print(__LINE__);                                                      \
-  Serial.print(' ');                                                           \
-  Serial.print(#var);                                                          \
-  Serial.print(" = ");                                                         \
-  Serial.println(var);
+#include "../../debug_log.h"
+#define DEBUG_PRINT(...) DEBUG_LOG(__VA_ARGS__)
+#define DEBUG_PRINT_VAR(var) DEBUG_LOG(#var " = {}", var)
+#define DEBUG_DRAIN() debug_log::drain_to_serial()
 #else
 #define DEBUG_PRINT_VAR(var)
-#define DEBUG_PRINT(str)
+#define DEBUG_PRINT(...)
+#define DEBUG_DRAIN()
 #endif
+
+// Times the enclosing scope as a loop stage, on the car and in the native build
+#include "loopProfiler.hpp"
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_STAGE(stage) \
+  const LoopProbe PROFILE_CONCAT(profile_stage_, __LINE__) { LoopStage::stage }
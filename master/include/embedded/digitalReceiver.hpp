@@ -3,12 +3,31 @@
 
 #include <Bounce2.h>
 
+#include <model/emergencyEvent.hpp>
 #include <model/hardwareData.hpp>
 #include <model/structure.hpp>
 
+#include "../../moving_average.h"
+#include "../../running_median.h"
+#include "../../wheel_speed.h"
 #include "debugUtils.hpp"
+#include "enum_utils.hpp"
 #include "hardwareSettings.hpp"
 #include "utils.hpp"
+#include "verticalDebouncer.hpp"
+
+/**
+ * @brief Debounced digital inputs, bit i of the DigitalReceiver masks and DIGITAL_INPUT_PINS[i]
+ */
+enum class DigitalInput : uint8_t {
+  ASMS,
+  ASATS,  ///< Active low, the mask holds "pressed"
+  ATS,
+  TSMS_SDC,
+  WD_READY,
+  PNEUMATIC,  ///< Both EBS sensors high, sampled from the last two pins
+  COUNT
+};
 
 /**
  * @brief Class responsible for the reading of the digital
@@ -16,15 +35,23 @@
  */
 class DigitalReceiver {
 public:
-  inline static uint32_t last_wheel_pulse_rl =
-      0;  // Timestamp of the last pulse for left wheel RPM calculation
-  inline static uint32_t second_to_last_wheel_pulse_rl = 0;  // Timestamp of the second to last
-                                                             // pulse for left wheel RPM calculation
-  inline static uint32_t last_wheel_pulse_rr =
-      0;  // Timestamp of the last pulse for right wheel RPM calculation
-  inline static uint32_t second_to_last_wheel_pulse_rr =
-      0;  // Timestamp of the second to last pulse for right
-          // wheel RPM calculation
+  static constexpr std::size_t INPUT_COUNT = to_underlying(DigitalInput::COUNT);
+
+  /// Consecutive differing samples before each DigitalInput changes state
+  static constexpr std::array<uint8_t, INPUT_COUNT> DEBOUNCE_THRESHOLDS = {
+      CHANGE_COUNTER_LIMIT,  // ASMS
+      CHANGE_COUNTER_LIMIT,  // ASATS
+      CHANGE_COUNTER_LIMIT,  // ATS
+      CHANGE_COUNTER_LIMIT,  // TSMS_SDC
+      CHANGE_COUNTER_LIMIT,  // WD_READY
+      CHANGE_COUNTER_LIMIT,  // PNEUMATIC
+  };
+
+  using WheelSpeedSensor = WheelSpeed<PULSES_PER_ROTATION>;  ///< micros() pulse timestamps
+  inline static WheelSpeedSensor wheel_speed_rl{WHEEL_SPEED_WINDOW_US, WHEEL_SPEED_MAX_PULSES,
+                                                LIMIT_RPM_INTERVAL};  ///< Left wheel pulses
+  inline static WheelSpeedSensor wheel_speed_rr{WHEEL_SPEED_WINDOW_US, WHEEL_SPEED_MAX_PULSES,
+                                                LIMIT_RPM_INTERVAL};  ///< Right wheel pulses
 
   /**
    * @brief read all digital inputs
@@ -51,57 +78,42 @@ public:
     pinMode(WD_SDC_RELAY, INPUT);
 
     attachInterrupt(
-        digitalPinToInterrupt(RR_WSS),
-        []() {
-          second_to_last_wheel_pulse_rr = last_wheel_pulse_rr;
-          last_wheel_pulse_rr = micros();
-        },
-        RISING);
+        digitalPinToInterrupt(RR_WSS), []() { wheel_speed_rr.add_pulse(micros()); }, RISING);
     attachInterrupt(
-        digitalPinToInterrupt(RL_WSS),
-        []() {
-          second_to_last_wheel_pulse_rl = last_wheel_pulse_rl;
-          last_wheel_pulse_rl = micros();
-        },
-        RISING);
+        digitalPinToInterrupt(RL_WSS), []() { wheel_speed_rl.add_pulse(micros()); }, RISING);
   }
 
 private:
   SystemData* system_data_;  ///< Pointer to the system updatable data storage
 
-  std::deque<int> brake_readings;                 ///< Buffer for brake sensor readings
-  unsigned int asms_change_counter_ = 0;          ///< counter to avoid noise on asms
-  unsigned int aats_change_counter_ = 0;          ///< counter to avoid noise on aats
-  unsigned int sdc_change_counter_ = 0;           ///< counter to avoid noise on sdc
-  unsigned int pneumatic_change_counter_ = 0;     ///< counter to avoid noise on pneumatic line
+  HampelFilter<uint16_t, BRAKE_READINGS_SAMPLES> brake_outliers{
+      BRAKE_OUTLIER_MIN_DEVIATION};  ///< Drops ADC spikes before they reach the average
+  MovingAverage<uint16_t, BRAKE_READINGS_SAMPLES> brake_readings;  ///< Brake sensor, ADC counts
+  InputSnapshot<DIGITAL_INPUT_PINS.size()> inputs_{DIGITAL_INPUT_PINS};  ///< One read per port
+  VerticalDebouncer<INPUT_COUNT> debouncer_{DEBOUNCE_THRESHOLDS};  ///< All DigitalInput at once
   unsigned int mission_change_counter_ = 0;       ///< counter to avoid noise on mission change
-  unsigned int sdc_bspd_change_counter_ = 0;      ///< counter to avoid noise on sdc bspd
-  unsigned int ats_change_counter_ = 0;           ///< counter to avoid noise on ats
-  unsigned int wd_ready_change_counter_ = 0;      ///< counter to avoid noise on wd ready
   Mission last_tried_mission_ = Mission::MANUAL;  ///< Last attempted mission state
 
-  /**
-   * @brief Reads the pneumatic line pressure states and updates the HardwareData object.
-   * Debounces input changes to avoid spurious transitions.
-   */
-  void read_pneumatic_line();
+  static constexpr uint32_t bit(const DigitalInput input) {
+    return uint32_t{1} << to_underlying(input);
+  }
 
   /**
-   * @brief Reads the current mission state based on input pins and updates the mission object.
-   * Debounces input changes to avoid spurious transitions.
+   * @brief Samples every DigitalInput together, debounces them and updates the HardwareData
+   * object. An ASMS or SDC opening raises an EmergencyEvent.
    */
-  void read_mission();
+  void read_digital_inputs();
 
   /**
-   * @brief Reads the ASMS switch state and updates the HardwareData object.
-   * Debounces input changes to avoid spurious transitions.
+   * @brief The debounced states as last stored in the HardwareData object
    */
-  void read_asms_switch();
+  [[nodiscard]] uint32_t stored_inputs() const;
+
   /**
-   * @brief Reads the AATS state and updates the HardwareData object.
+   * @brief Reads the current mission state based on input pins and updates the mission object.
    * Debounces input changes to avoid spurious transitions.
    */
-  void read_asats_state();
+  void read_mission();
 
   /**
    * @brief Reads the wheel speed sensors and updates the HardwareData object.
@@ -109,12 +121,6 @@ private:
    */
   void read_wheel_speed_sensors();
 
-  /**
-   * @brief Reads the bspd pin and updates the HardwareData object.
-   * Debounces input changes to avoid spurious transitions.
-   */
-  void read_bspd_sdc();
-
   /**
    * @brief Reads the brake sensor and updates the HardwareData object.
    * Debounces input changes to avoid spurious transitions.
@@ -126,17 +132,6 @@ private:
    */
   void read_soc();
 
-  /**
-   * @brief Reads the ats and updates the HardwareData object.
-   * Debounces input changes to avoid spurious transitions.
-   */
-  void read_ats();
-
-  /**
-   * @brief Reads the watchdog ready pin and updates the HardwareData object.
-   */
-  void read_watchdog_ready();
-
   /**
    * @brief Reads the rpm of the wheels and updates the HardwareData object.
    */
@@ -144,15 +139,10 @@ private:
 };
 
 inline void DigitalReceiver::digital_reads() {
-  read_pneumatic_line();
+  read_digital_inputs();
   read_mission();
-  read_asms_switch();
-  read_asats_state();
   read_soc();
   read_brake_sensor();
-  read_ats();
-  read_bspd_sdc();
-  read_watchdog_ready();
   read_rpm();
 }
 
@@ -163,25 +153,48 @@ inline void DigitalReceiver::read_soc() {
   system_data_->hardware_data_.soc_ = static_cast<uint8_t>(mapped_value);
 }
 
-inline void DigitalReceiver::read_bspd_sdc() {
-  bool is_sdc_closed = digitalRead(SDC_TSMS_STATE_PIN);  // low when sdc/bspd open
-  debounce(is_sdc_closed, system_data_->hardware_data_.tsms_sdc_closed_, sdc_bspd_change_counter_);
-}
 inline void DigitalReceiver::read_brake_sensor() {
   int hydraulic_pressure = analogRead(BRAKE_SENSOR);
-  insert_value_queue(hydraulic_pressure, brake_readings);
-  system_data_->hardware_data_._hydraulic_line_pressure = average_queue(brake_readings);
+  brake_readings.add(brake_outliers.add(hydraulic_pressure));
+  system_data_->hardware_data_._hydraulic_line_pressure = brake_readings.average();
+}
+inline void DigitalReceiver::read_digital_inputs() {
+  HardwareData& hardware = system_data_->hardware_data_;
+  constexpr uint32_t SENSOR_1 = bit(DigitalInput::PNEUMATIC), SENSOR_2 = SENSOR_1 << 1;
+  uint32_t sample = inputs_.read() ^ bit(DigitalInput::ASATS);
+  hardware.pneumatic_line_pressure_1_ = (sample & SENSOR_1) != 0;  // raw, EBS_SENSOR2
+  hardware.pneumatic_line_pressure_2_ = (sample & SENSOR_2) != 0;  // raw, EBS_SENSOR1
+  if ((sample & SENSOR_2) == 0) sample &= ~SENSOR_1;
+  sample &= ~SENSOR_2;
+
+  debouncer_.set_state(stored_inputs());  // the model keeps the states, the debouncer the counts
+  const uint32_t changed = debouncer_.update(sample);
+  const uint32_t state = debouncer_.state();
+  hardware.asms_on_ = (state & bit(DigitalInput::ASMS)) != 0;
+  hardware.asats_pressed_ = (state & bit(DigitalInput::ASATS)) != 0;
+  hardware.ats_pressed_ = (state & bit(DigitalInput::ATS)) != 0;
+  hardware.tsms_sdc_closed_ = (state & bit(DigitalInput::TSMS_SDC)) != 0;  // low when sdc/bspd open
+  hardware.wd_ready_ = (state & bit(DigitalInput::WD_READY)) != 0;
+  hardware.pneumatic_line_pressure_ = (state & bit(DigitalInput::PNEUMATIC)) != 0;
+
+  if ((changed & ~state & (bit(DigitalInput::ASMS) | bit(DigitalInput::TSMS_SDC))) != 0) {
+    EmergencyEvent::raise();
+  }
+  if (hardware.asats_pressed_) {  // TODO: remove this, shitty workaround
+    system_data_->failure_detection_.emergency_signal_ = false;
+  }
 }
-inline void DigitalReceiver::read_pneumatic_line() {
-  bool pneumatic1 = digitalRead(EBS_SENSOR2);
-  bool pneumatic2 = digitalRead(EBS_SENSOR1);
-
-  system_data_->hardware_data_.pneumatic_line_pressure_1_ = pneumatic1;
-  system_data_->hardware_data_.pneumatic_line_pressure_2_ = pneumatic2;
-  bool latest_pneumatic_pressure = pneumatic1 && pneumatic2;
 
-  debounce(latest_pneumatic_pressure, system_data_->hardware_data_.pneumatic_line_pressure_,
-           pneumatic_change_counter_);
+inline uint32_t DigitalReceiver::stored_inputs() const {
+  const HardwareData& hardware = system_data_->hardware_data_;
+  uint32_t state = 0;
+  if (hardware.asms_on_) state |= bit(DigitalInput::ASMS);
+  if (hardware.asats_pressed_) state |= bit(DigitalInput::ASATS);
+  if (hardware.ats_pressed_) state |= bit(DigitalInput::ATS);
+  if (hardware.tsms_sdc_closed_) state |= bit(DigitalInput::TSMS_SDC);
+  if (hardware.wd_ready_) state |= bit(DigitalInput::WD_READY);
+  if (hardware.pneumatic_line_pressure_) state |= bit(DigitalInput::PNEUMATIC);
+  return state;
 }
 
 inline void DigitalReceiver::read_mission() {
@@ -206,43 +219,8 @@ inline void DigitalReceiver::read_mission() {
   DEBUG_PRINT_VAR(to_underlying(system_data_->mission_));
 }
 
-inline void DigitalReceiver::read_asms_switch() {
-  bool latest_asms_status = digitalRead(ASMS_IN_PIN);
-  debounce(latest_asms_status, system_data_->hardware_data_.asms_on_, asms_change_counter_);
-}
-
-inline void DigitalReceiver::read_asats_state() {
-  bool asats_pressed = !digitalRead(ASATS);
-  debounce(asats_pressed, system_data_->hardware_data_.asats_pressed_, aats_change_counter_);
-  if (system_data_->hardware_data_.asats_pressed_) {  // TODO: remove this, shitty workaround
-    system_data_->failure_detection_.emergency_signal_ = false;
-  }
-}
-
-inline void DigitalReceiver::read_ats() {
-  bool ats_pressed = digitalRead(ATS);
-  // DEBUG_PRINT_VAR(ats_pressed);
-  debounce(ats_pressed, system_data_->hardware_data_.ats_pressed_, ats_change_counter_);
-}
-
-inline void DigitalReceiver::read_watchdog_ready() {
-  bool wd_ready = digitalRead(WD_READY);
-  debounce(wd_ready, system_data_->hardware_data_.wd_ready_, wd_ready_change_counter_);
-}
-
 inline void DigitalReceiver::read_rpm() {
-  unsigned long time_interval_rr = (last_wheel_pulse_rr - second_to_last_wheel_pulse_rr);
-  unsigned long time_interval_rl = (last_wheel_pulse_rl - second_to_last_wheel_pulse_rl);
-  if (micros() - last_wheel_pulse_rr > LIMIT_RPM_INTERVAL) {
-    system_data_->hardware_data_.rr_wheel_rpm = 0.0;
-  } else {
-    system_data_->hardware_data_.rr_wheel_rpm =
-        1 / (time_interval_rr * MICRO_TO_SECONDS * PULSES_PER_ROTATION) * SECONDS_IN_MINUTE;
-  }
-  if (micros() - last_wheel_pulse_rl > LIMIT_RPM_INTERVAL) {
-    system_data_->hardware_data_.rl_wheel_rpm = 0.0;
-  } else {
-    system_data_->hardware_data_.rl_wheel_rpm =
-        1 / (time_interval_rl * MICRO_TO_SECONDS * PULSES_PER_ROTATION) * SECONDS_IN_MINUTE;
-  }
-}
\ No newline at end of file
+  const auto now = static_cast<uint32_t>(micros());
+  system_data_->hardware_data_.rr_wheel_rpm = wheel_speed_rr.centi_rpm(now) * 0.01f;
+  system_data_->hardware_data_.rl_wheel_rpm = wheel_speed_rl.centi_rpm(now) * 0.01f;
+}
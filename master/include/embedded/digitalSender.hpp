@@ -3,6 +3,7 @@
 #include <Arduino.h>
 
 #include "hardwareSettings.hpp"
+#include "outputShadow.hpp"
 #include "metro.h"
 
 /**
@@ -11,16 +12,15 @@
  * The DigitalSender class handles various operations such as controlling LEDs,
  * EBS valves, SDC state, and watchdog signals. It also manages different operational states
  * such as emergency, manual, ready, driving, and finish.
+ *
+ * Every write goes through OutputShadow, so a pin is only touched when its value changes. The
+ * brake light and BSPD signals are staged and reach the pins together on apply_staged_outputs().
  */
 class DigitalSender {
 private:
 public:
   // Array of valid output pins
-  static constexpr std::array<int, 9> validOutputPins = {
-      ASSI_BLUE_PIN, ASSI_YELLOW_PIN, EBS_VALVE_REAR_PIN, EBS_VALVE_FRONT_PIN, SDC_BSPD_OUT,
-      CLOSE_SDC,     BRAKE_LIGHT,     WD_SDC_CLOSE,    WD_ALIVE
-      // SDC_LOGIC_WATCHDOG_OUT_PIN
-  };
+  static constexpr std::array<int, 9> validOutputPins = OUTPUT_PINS;
 
   /**
    * @brief Constructor for the DigitalSender class.
@@ -31,6 +31,7 @@ public:
     for (const auto pin : validOutputPins) {
       pinMode(pin, OUTPUT);
     }
+    OutputShadow::invalidate();
     activate_ebs();
   }
   /**
@@ -83,21 +84,25 @@ public:
    */
   void blink_led(int pin);
   /**
-   * @brief Turns on the brake light.
+   * @brief Turns on the brake light, on the next apply_staged_outputs().
    */
   void turn_on_brake_light();
   /**
-   * @brief Turns off the brake light.
+   * @brief Turns off the brake light, on the next apply_staged_outputs().
    */
   void turn_off_brake_light();
   /**
-   * @brief Turns on the BSPD error signal.
+   * @brief Turns on the BSPD error signal, on the next apply_staged_outputs().
    */
   void bspd_error();
   /**
-   * @brief Turns off the BSPD error signal.
+   * @brief Turns off the BSPD error signal, on the next apply_staged_outputs().
    */
   void no_bspd_error();
+  /**
+   * @brief Writes the staged outputs that changed, in one go.
+   */
+  static void apply_staged_outputs();
   /**
    * @brief Toggles the watchdog signal.
    */
@@ -116,56 +121,72 @@ public:
   void turn_on_blue();
 };
 
-inline void DigitalSender::open_sdc() { DEBUG_PRINT("OPENING SDC"); digitalWrite(CLOSE_SDC, LOW); }
+inline void DigitalSender::open_sdc() {
+  DEBUG_PRINT("OPENING SDC");
+  OutputShadow::write(CLOSE_SDC, LOW);
+}
 
-inline void DigitalSender::close_sdc() { DEBUG_PRINT("CLOSING SDC"); digitalWrite(CLOSE_SDC, HIGH); }
+inline void DigitalSender::close_sdc() {
+  DEBUG_PRINT("CLOSING SDC");
+  OutputShadow::write(CLOSE_SDC, HIGH);
+}
 
 inline void DigitalSender::activate_ebs() {
-  digitalWrite(EBS_VALVE_REAR_PIN, HIGH);
-  digitalWrite(EBS_VALVE_FRONT_PIN, HIGH);
+  OutputShadow::write(EBS_VALVE_REAR_PIN, HIGH);
+  OutputShadow::write(EBS_VALVE_FRONT_PIN, HIGH);
 }
 
 inline void DigitalSender::deactivate_ebs() {
-  digitalWrite(EBS_VALVE_REAR_PIN, LOW);
-  digitalWrite(EBS_VALVE_FRONT_PIN, LOW);
+  OutputShadow::write(EBS_VALVE_REAR_PIN, LOW);
+  OutputShadow::write(EBS_VALVE_FRONT_PIN, LOW);
 }
 
-inline void DigitalSender::disable_ebs_actuator_REAR() { digitalWrite(EBS_VALVE_REAR_PIN, LOW); }
+inline void DigitalSender::disable_ebs_actuator_REAR() {
+  OutputShadow::write(EBS_VALVE_REAR_PIN, LOW);
+}
 
-inline void DigitalSender::enable_ebs_actuator_REAR() { digitalWrite(EBS_VALVE_REAR_PIN, HIGH); }
+inline void DigitalSender::enable_ebs_actuator_REAR() {
+  OutputShadow::write(EBS_VALVE_REAR_PIN, HIGH);
+}
 
-inline void DigitalSender::disable_ebs_actuator_FRONT() { digitalWrite(EBS_VALVE_FRONT_PIN, LOW); }
+inline void DigitalSender::disable_ebs_actuator_FRONT() {
+  OutputShadow::write(EBS_VALVE_FRONT_PIN, LOW);
+}
 
-inline void DigitalSender::enable_ebs_actuator_FRONT() { digitalWrite(EBS_VALVE_FRONT_PIN, HIGH); }
+inline void DigitalSender::enable_ebs_actuator_FRONT() {
+  OutputShadow::write(EBS_VALVE_FRONT_PIN, HIGH);
+}
 
 inline void DigitalSender::turn_off_assi() {
-  analogWrite(ASSI_YELLOW_PIN, LOW);
-  analogWrite(ASSI_BLUE_PIN, LOW);
+  OutputShadow::write_analog(ASSI_YELLOW_PIN, LOW);
+  OutputShadow::write_analog(ASSI_BLUE_PIN, LOW);
 }
 
-inline void DigitalSender::turn_on_yellow() { analogWrite(ASSI_YELLOW_PIN, 1023); }
+inline void DigitalSender::turn_on_yellow() { OutputShadow::write_analog(ASSI_YELLOW_PIN, 1023); }
 
-inline void DigitalSender::turn_on_blue() { analogWrite(ASSI_BLUE_PIN, 1023); }
+inline void DigitalSender::turn_on_blue() { OutputShadow::write_analog(ASSI_BLUE_PIN, 1023); }
 
 inline void DigitalSender::blink_led(const int pin) {
   static bool blink_state = false;
   blink_state = !blink_state;
-  analogWrite(pin, blink_state * 1023);
+  OutputShadow::write_analog(pin, blink_state * 1023);
 }
 
-inline void DigitalSender::turn_on_brake_light() { digitalWrite(BRAKE_LIGHT, HIGH); }
+inline void DigitalSender::turn_on_brake_light() { OutputShadow::stage(BRAKE_LIGHT, HIGH); }
+
+inline void DigitalSender::turn_off_brake_light() { OutputShadow::stage(BRAKE_LIGHT, LOW); }
 
-inline void DigitalSender::turn_off_brake_light() { digitalWrite(BRAKE_LIGHT, LOW); }
+inline void DigitalSender::bspd_error() { OutputShadow::stage(SDC_BSPD_OUT, HIGH); }
 
-inline void DigitalSender::bspd_error() { digitalWrite(SDC_BSPD_OUT, HIGH); }
+inline void DigitalSender::no_bspd_error() { OutputShadow::stage(SDC_BSPD_OUT, LOW); }
 
-inline void DigitalSender::no_bspd_error() { digitalWrite(SDC_BSPD_OUT, LOW); }
+inline void DigitalSender::apply_staged_outputs() { OutputShadow::commit(); }
 
 inline void DigitalSender::toggle_watchdog() {
   static volatile bool wd_state = false;
   wd_state = !wd_state;
-  digitalWrite(WD_ALIVE, wd_state);
-  // DEBUG_PRINT("Toggling watchdog: " + String(wd_state ? "ON" : "OFF"));
+  OutputShadow::write(WD_ALIVE, wd_state);
+  // DEBUG_PRINT("Toggling watchdog: {}", wd_state);
 }
 
-inline void DigitalSender::close_watchdog_sdc() { digitalWrite(WD_SDC_CLOSE, HIGH); }
\ No newline at end of file
+inline void DigitalSender::close_watchdog_sdc() { OutputShadow::write(WD_SDC_CLOSE, HIGH); }
\ No newline at end of file
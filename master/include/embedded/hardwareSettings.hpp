@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 constexpr int COMPONENT_TIMESTAMP_TIMEOUT = 500;
 constexpr int RES_TIMESTAMP_TIMEOUT = 200;
 constexpr int DC_VOLTAGE_TIMEOUT = 150;
@@ -8,21 +10,31 @@ constexpr int EBS_BUZZER_TIMEOUT = 8000;
 constexpr int LED_BLINK_INTERVAL = 500;
 constexpr int PROCESS_INTERVAL = 200;
 constexpr int SLOWER_PROCESS_INTERVAL = 500;
+constexpr int PROFILE_PUBLISH_INTERVAL = 1000;  ///< Loop profile window on CAN
+constexpr int HEARTBEAT_PUBLISH_INTERVAL = 1000;  ///< Heartbeat statistics window on CAN
 constexpr int INITIAL_CHECKUP_STEP_TIMEOUT = 500;
+constexpr int CHECKUP_STEP_BUDGET = 16;  ///< Initial checkup states run per loop() at most
 constexpr unsigned long READY_TIMEOUT_MS = 5000;
 constexpr unsigned long RELEASE_EBS_TIMEOUT_MS = 1000;
 constexpr unsigned long ENGAGE_EBS_TIMEOUT_MS = 5000;
 constexpr int WD_TIMEOUT_MS = 500;
+constexpr int EMERGENCY_CHECK_INTERVAL_US = 150'000;  ///< Backstop for EmergencyEvent
+constexpr int WATCHDOG_TOGGLE_PERIOD_US = 10'000;
+// TimerScheduler priorities, 0 runs first on a shared tick
+constexpr int EMERGENCY_CHECK_PRIORITY = 0;
+constexpr int WATCHDOG_TOGGLE_PRIORITY = 1;
 constexpr int BRAKE_PRESSURE_LOWER_THRESHOLD = 160;
 constexpr int BRAKE_PRESSURE_UPPER_THRESHOLD = 510;
+constexpr int BRAKE_READINGS_SAMPLES = 5;  ///< Window of the hydraulic pressure moving average
+constexpr int BRAKE_OUTLIER_MIN_DEVIATION = 20;  ///< ADC counts a reading may stray unrejected
 constexpr int LIMIT_RPM_INTERVAL = 500000;
+constexpr int WHEEL_SPEED_WINDOW_US = 40'000;  ///< Pulses within this much are averaged
+constexpr int WHEEL_SPEED_MAX_PULSES = 16;     ///< Intervals averaged at most at speed
 
 constexpr int ADC_MAX_VALUE = 1023;
 constexpr int SOC_PERCENT_MAX = 100;
 constexpr int MAX_MISSION = 7;
 constexpr int PULSES_PER_ROTATION = 48;  // TODO: adjust
-constexpr int SECONDS_IN_MINUTE = 60;
-constexpr float MICRO_TO_SECONDS = 1e-6f;
 
 // Number of consecutive different values of a digital input to consider change
 // (to avoid noise)
@@ -51,6 +63,13 @@ constexpr int BRAKE_LIGHT = 2;
 constexpr int WD_SDC_CLOSE = 40;  // high if bspd is high (sdc closed)?
 constexpr int WD_ALIVE = 15;
 
+/// Every output driven through DigitalSender, in the order OutputShadow keeps them
+constexpr std::array<int, 9> OUTPUT_PINS = {
+    ASSI_BLUE_PIN, ASSI_YELLOW_PIN, EBS_VALVE_REAR_PIN, EBS_VALVE_FRONT_PIN, SDC_BSPD_OUT,
+    CLOSE_SDC,     BRAKE_LIGHT,     WD_SDC_CLOSE,    WD_ALIVE
+    // SDC_LOGIC_WATCHDOG_OUT_PIN
+};
+
 /*
  * ==========
  * INPUT PINS
@@ -73,3 +92,8 @@ constexpr int ATS = 16;
 constexpr int ASATS = 20;
 constexpr int WD_READY = 37;
 constexpr int WD_SDC_RELAY = 33;
+
+/// Inputs DigitalReceiver samples together, in its DigitalInput order; the two EBS sensors come
+/// last and are debounced as one pneumatic line channel
+constexpr std::array<int, 7> DIGITAL_INPUT_PINS = {
+    ASMS_IN_PIN, ASATS, ATS, SDC_TSMS_STATE_PIN, WD_READY, EBS_SENSOR2, EBS_SENSOR1};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstdint>
+
+/**
+ * @brief Masks interrupts while it is alive and then restores the mask it found
+ * @details Unlike a bare noInterrupts() ... interrupts() pair it can be taken inside an interrupt
+ * handler or another critical section without unmasking interrupts on the way out.
+ */
+class InterruptLock {
+public:
+  InterruptLock() : was_enabled_(enabled()) { noInterrupts(); }
+
+  ~InterruptLock() {
+    if (was_enabled_) interrupts();
+  }
+
+  InterruptLock(const InterruptLock &) = delete;
+  InterruptLock &operator=(const InterruptLock &) = delete;
+
+private:
+  bool was_enabled_;
+
+  static bool enabled() {
+#ifdef NATIVE
+    return native_hal::interrupts_enabled;
+#else
+    uint32_t primask;
+    __asm__ volatile("mrs %0, primask" : "=r"(primask));
+    return primask == 0;
+#endif
+  }
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "hardwareSettings.hpp"
+#include "interruptLock.hpp"
+
+#ifdef NATIVE
+#include <cstdio>
+#endif
+
+/**
+ * @brief Last value written to every output in OUTPUT_PINS, so that only changes reach the pins
+ * @details write() and write_analog() drive the pin at once, unless the shadow says it is
+ * already there. stage() only records the wanted level; commit() then applies every staged level
+ * that differs from the shadow together, with one write per GPIO port set and clear register on
+ * the Teensy instead of a digitalWrite() per pin. Writes that the shadow made unnecessary are
+ * counted as skipped.
+ *
+ * The shadow trusts that nothing else drives these pins. invalidate() forgets it, so the next
+ * write to each pin goes through, e.g. after pinMode(). A pin may be written from loop() and from
+ * interrupt handlers alike (WD_ALIVE is toggled by both): write(), write_analog() and commit()
+ * compare, drive the pin and update the shadow under an InterruptLock, so a handler never sees
+ * a pin that is already driven but not yet in the shadow.
+ */
+class OutputShadow {
+public:
+  static constexpr std::size_t PIN_COUNT = OUTPUT_PINS.size();
+
+  /**
+   * @brief digitalWrite(pin, level), unless the pin is already at that level
+   */
+  static void write(const int pin, const bool level) {
+    const std::size_t i = slot_of(pin);
+    if (i == PIN_COUNT) {
+      digitalWrite(pin, level);
+      return;
+    }
+    const InterruptLock lock;
+    staged_[i] = UNKNOWN;  // an immediate write overrides a staged one
+    if (level_[i] == level) {
+      skipped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    digitalWrite(pin, level);
+    level_[i] = level;
+    duty_[i] = UNKNOWN;
+    writes_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief analogWrite(pin, duty), unless the pin already has that duty
+   */
+  static void write_analog(const int pin, const int duty) {
+    const std::size_t i = slot_of(pin);
+    if (i == PIN_COUNT) {
+      analogWrite(pin, duty);
+      return;
+    }
+    const InterruptLock lock;
+    if (duty_[i] == duty) {
+      skipped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    analogWrite(pin, duty);
+    duty_[i] = duty;
+    level_[i] = UNKNOWN;
+    writes_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Queues `level` for `pin`, the last level staged before commit() wins
+   */
+  static void stage(const int pin, const bool level) {
+    const std::size_t i = slot_of(pin);
+    if (i == PIN_COUNT) {
+      digitalWrite(pin, level);
+      return;
+    }
+    staged_[i] = level;
+  }
+
+  /**
+   * @brief Applies the staged levels that differ from the shadow
+   */
+  static void commit() {
+    const InterruptLock lock;
+#ifdef NATIVE
+    for (std::size_t i = 0; i < PIN_COUNT; i++) {
+      if (apply_staged(i)) digitalWrite(OUTPUT_PINS[i], level_[i]);
+    }
+#else
+    // Every pin lives in one GPIO port, so at most two registers per pin, usually far fewer
+    std::array<volatile uint32_t *, 2 * PIN_COUNT> registers{};
+    std::array<uint32_t, 2 * PIN_COUNT> masks{};
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < PIN_COUNT; i++) {
+      if (!apply_staged(i)) continue;
+      const int pin = OUTPUT_PINS[i];
+      volatile uint32_t *reg = level_[i] ? portSetRegister(pin) : portClearRegister(pin);
+      std::size_t j = 0;
+      while (j < used && registers[j] != reg) j++;
+      if (j == used) registers[used++] = reg;
+      masks[j] |= digitalPinToBitMask(pin);
+    }
+    for (std::size_t j = 0; j < used; j++) *registers[j] = masks[j];
+#endif
+  }
+
+  /**
+   * @brief Forgets every pin's value and staged level
+   */
+  static void invalidate() {
+    level_.fill(UNKNOWN);
+    duty_.fill(UNKNOWN);
+    staged_.fill(UNKNOWN);
+  }
+
+  [[nodiscard]] static uint32_t writes() { return writes_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Redundant writes avoided
+   */
+  [[nodiscard]] static uint32_t skipped() { return skipped_.load(std::memory_order_relaxed); }
+
+  static void reset_stats() {
+    writes_.store(0, std::memory_order_relaxed);
+    skipped_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr int8_t UNKNOWN = -1;
+
+  static std::array<int8_t, PIN_COUNT> level_;
+  static std::array<int, PIN_COUNT> duty_;
+  static std::array<int8_t, PIN_COUNT> staged_;
+  inline static std::atomic<uint32_t> writes_{0};
+  inline static std::atomic<uint32_t> skipped_{0};
+
+  template <class T>
+  static constexpr std::array<T, PIN_COUNT> filled() {
+    std::array<T, PIN_COUNT> values{};
+    for (auto &value : values) value = UNKNOWN;
+    return values;
+  }
+
+  static constexpr std::size_t slot_of(const int pin) {
+    std::size_t i = 0;
+    while (i < PIN_COUNT && OUTPUT_PINS[i] != pin) i++;
+    return i;
+  }
+
+  /**
+   * @brief Moves the staged level of slot `i` into the shadow
+   * @return True when the pin has to be written
+   */
+  static bool apply_staged(const std::size_t i) {
+    const int8_t staged = staged_[i];
+    if (staged == UNKNOWN) return false;
+    staged_[i] = UNKNOWN;
+    if (level_[i] == staged) {
+      skipped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    level_[i] = staged;
+    duty_[i] = UNKNOWN;
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+};
+
+inline std::array<int8_t, OutputShadow::PIN_COUNT> OutputShadow::level_ =
+    OutputShadow::filled<int8_t>();
+inline std::array<int, OutputShadow::PIN_COUNT> OutputShadow::duty_ = OutputShadow::filled<int>();
+inline std::array<int8_t, OutputShadow::PIN_COUNT> OutputShadow::staged_ =
+    OutputShadow::filled<int8_t>();
+
+#ifdef NATIVE
+/**
+ * @brief Prints how many output writes went to the pins and how many the shadow avoided
+ */
+inline void print_output_shadow(FILE *out) {
+  fprintf(out, "Outputs: %u pin writes, %u redundant writes skipped\n", OutputShadow::writes(),
+          OutputShadow::skipped());
+}
+#endif
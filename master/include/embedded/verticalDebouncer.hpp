@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief One sample of a set of digital inputs as a bitmask, bit i for pins[i]
+ * @details On the Teensy each GPIO port's pad status register is read once and the pins are
+ * picked out of the copies, instead of one digitalRead() per pin. The native build has no port
+ * registers and falls back to digitalRead().
+ */
+template <std::size_t PINS>
+class InputSnapshot {
+  static_assert(PINS > 0 && PINS <= 32, "one bit per pin in a 32-bit mask");
+
+public:
+  explicit InputSnapshot(const std::array<int, PINS> &pins) : pins_(pins) {
+#ifndef NATIVE
+    for (std::size_t i = 0; i < PINS; i++) {
+      volatile uint32_t *reg = portInputRegister(pins_[i]);
+      std::size_t j = 0;
+      while (j < ports_ && registers_[j] != reg) j++;
+      if (j == ports_) registers_[ports_++] = reg;
+      port_of_[i] = static_cast<uint8_t>(j);
+      masks_[i] = digitalPinToBitMask(pins_[i]);
+    }
+#endif
+  }
+
+  [[nodiscard]] uint32_t read() const {
+    uint32_t sample = 0;
+#ifdef NATIVE
+    for (std::size_t i = 0; i < PINS; i++) {
+      sample |= uint32_t{digitalRead(pins_[i]) != 0} << i;
+    }
+#else
+    std::array<uint32_t, PINS> levels{};
+    for (std::size_t j = 0; j < ports_; j++) levels[j] = *registers_[j];
+    for (std::size_t i = 0; i < PINS; i++) {
+      sample |= uint32_t{(levels[port_of_[i]] & masks_[i]) != 0} << i;
+    }
+#endif
+    return sample;
+  }
+
+private:
+  std::array<int, PINS> pins_;
+#ifndef NATIVE
+  std::array<volatile uint32_t *, PINS> registers_{};  ///< Distinct pad status registers
+  std::array<uint8_t, PINS> port_of_{};
+  std::array<uint32_t, PINS> masks_{};
+  std::size_t ports_ = 0;
+#endif
+};
+
+/**
+ * @brief Debounces up to 32 inputs at once with vertical counters
+ * @details Same rule as debounce() in utils.hpp, for every channel: a reading that differs from
+ * the stable state counts up, one that agrees resets the count, and the state flips once
+ * threshold consecutive readings differed. The counts are stored bit-sliced, counts_[b] holding
+ * bit b of every channel's count, so update() increments, compares against the per-channel
+ * thresholds and resets all channels with a few bitwise operations per counter bit, no branch
+ * and no loop over channels.
+ *
+ * A threshold is 1 to MAX_THRESHOLD samples; 0 behaves as 1, as it does in debounce().
+ */
+template <std::size_t CHANNELS, unsigned BITS = 3>
+class VerticalDebouncer {
+  static_assert(CHANNELS > 0 && CHANNELS <= 32, "one bit per channel in a 32-bit mask");
+  static_assert(BITS > 0 && BITS <= 8, "thresholds are stored in a uint8_t");
+
+public:
+  using Mask = uint32_t;
+  static constexpr unsigned MAX_THRESHOLD = (1U << BITS) - 1;
+
+  explicit constexpr VerticalDebouncer(const std::array<uint8_t, CHANNELS> &thresholds) {
+    for (std::size_t i = 0; i < CHANNELS; i++) set_threshold(i, thresholds[i]);
+  }
+
+  /**
+   * @brief Changes the consecutive readings channel `i` needs to flip, restarting its count
+   */
+  constexpr void set_threshold(const std::size_t i, unsigned samples) {
+    if (samples == 0) samples = 1;
+    if (samples > MAX_THRESHOLD) samples = MAX_THRESHOLD;
+    const Mask bit = Mask{1} << i;
+    for (unsigned b = 0; b < BITS; b++) {
+      counts_[b] &= ~bit;
+      threshold_[b] = (samples >> b & 1U) != 0 ? threshold_[b] | bit : threshold_[b] & ~bit;
+    }
+  }
+
+  /**
+   * @brief Feeds one reading of every channel
+   * @return The channels whose stable state flipped on this reading
+   */
+  constexpr Mask update(const Mask raw) {
+    const Mask differs = (raw ^ state_) & CHANNEL_MASK;
+    Mask carry = differs;  // +1 where the reading differs, the count is cleared where it agrees
+    Mask equal = differs;
+#pragma GCC unroll 8
+    for (unsigned b = 0; b < BITS; b++) {
+      const Mask count = counts_[b] & differs;
+      counts_[b] = count ^ carry;
+      carry &= count;
+      equal &= ~(counts_[b] ^ threshold_[b]);
+    }
+#pragma GCC unroll 8
+    for (unsigned b = 0; b < BITS; b++) counts_[b] &= ~equal;
+    state_ ^= equal;
+    return equal;
+  }
+
+  [[nodiscard]] constexpr Mask state() const { return state_; }
+
+  /**
+   * @brief Overrides the stable state, the counts carry on against the new one
+   */
+  constexpr void set_state(const Mask state) { state_ = state & CHANNEL_MASK; }
+
+private:
+  static constexpr Mask CHANNEL_MASK =
+      CHANNELS == 32 ? ~Mask{0} : (Mask{1} << CHANNELS) - 1;
+
+  std::array<Mask, BITS> counts_{};
+  std::array<Mask, BITS> threshold_{};
+  Mask state_ = 0;
+};
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <cstdlib>
 
 #include "debugUtils.hpp"
 #include "embedded/digitalSender.hpp"
 #include "embedded/hardwareSettings.hpp"
+#include "metro.h"
 #include "model/systemData.hpp"
+#include "timerScheduler.hpp"
 
 // Also known as Orchestrator
 /**
@@ -14,7 +18,6 @@
 class CheckupManager {
 private:
   SystemData *_system_data_;  ///< Pointer to the system data object containing system status and
-  TeensyTimerTool::PeriodicTimer watchdog_timer_;
   ///< sensor information.
   Metro _watchdog_toggle_timer_{WATCHDOG_TOGGLE_DURATION};  ///< Timer for watchdog toggle sequence
   Metro _watchdog_test_timer_{WATCHDOG_TEST_DURATION};      ///< Timer for watchdog verification
@@ -154,11 +157,61 @@ public:
    */
   [[nodiscard]] bool res_triggered() const;
 
+  /**
+   * @brief When a CheckupState was entered, relative to the start of the checkup, and how long
+   * the checkup stayed in it
+   */
+  struct CheckupStep {
+    uint32_t entered_us = 0;
+    uint32_t dwell_us = 0;
+    bool visited = false;
+  };
+
+  static constexpr std::size_t CHECKUP_STATE_COUNT =
+      static_cast<std::size_t>(CheckupState::CHECKUP_COMPLETE) + 1;
+
+  /**
+   * @brief The last visit to every CheckupState since reset_checkup_state()
+   */
+  [[nodiscard]] const std::array<CheckupStep, CHECKUP_STATE_COUNT> &checkup_timeline() const {
+    return checkup_timeline_;
+  }
+
+  /**
+   * @brief Steps initial_checkup_sequence() may take per call, 1 advances one state per loop()
+   */
+  void set_checkup_step_budget(const uint8_t budget) { checkup_step_budget_ = budget; }
+
+private:
+  /**
+   * @brief One step of the initial checkup: the current CheckupState, or EBS phase, acts once
+   */
+  CheckupError initial_checkup_step();
+
+  /**
+   * @brief Closes the timeline entry of the state being left and opens the next one
+   */
+  void record_checkup_step(CheckupState left);
+
+  /**
+   * @brief Whether the step of `state`, in `phase` for EBS_CHECKS, may drive an output. The
+   * checks after it have to see inputs sampled in a later loop().
+   */
+  static constexpr bool drives_outputs(CheckupState state, EbsPressureTestPhase phase);
+
+  uint8_t checkup_step_budget_ = CHECKUP_STEP_BUDGET;  ///< Steps per initial_checkup_sequence()
+  uint32_t checkup_started_us_ = 0;  ///< micros() of the last reset_checkup_state()
+  uint32_t checkup_entered_us_ = 0;  ///< micros() when checkup_state_ was entered
+  std::array<CheckupStep, CHECKUP_STATE_COUNT> checkup_timeline_{};
 };
 
 inline void CheckupManager::reset_checkup_state() {
   checkup_state_ = CheckupState::WAIT_FOR_ASMS;
   _system_data_->mission_finished_ = false;
+  checkup_started_us_ = static_cast<uint32_t>(micros());
+  checkup_entered_us_ = checkup_started_us_;
+  checkup_timeline_ = {};
+  checkup_timeline_[static_cast<std::size_t>(CheckupState::WAIT_FOR_ASMS)].visited = true;
 }
 
 inline bool CheckupManager::should_stay_manual_driving() const {
@@ -180,7 +233,72 @@ inline bool CheckupManager::should_stay_off() {
   return false;
 }
 
+/**
+ * Keeps stepping while the checkup makes progress, so checks whose inputs are already there no
+ * longer cost a loop() each. It stops when a step leaves both the CheckupState and the EBS phase
+ * unchanged (the checkup waits on an input or a timer), after a step that drives an output (the
+ * next check must see what the output did, e.g. each EBS valve configuration), on an error or
+ * success, or after checkup_step_budget_ steps.
+ */
 inline CheckupManager::CheckupError CheckupManager::initial_checkup_sequence() {
+  CheckupError result = CheckupError::WAITING_FOR_RESPONSE;
+  for (uint8_t step = 0; step < checkup_step_budget_; step++) {
+    const CheckupState state = checkup_state_;
+    const EbsPressureTestPhase phase = pressure_test_phase_;
+    result = initial_checkup_step();
+    if (checkup_state_ != state) record_checkup_step(state);
+    if (result != CheckupError::WAITING_FOR_RESPONSE ||
+        (checkup_state_ == state && pressure_test_phase_ == phase) ||
+        drives_outputs(state, phase)) {
+      break;
+    }
+  }
+  return result;
+}
+
+constexpr bool CheckupManager::drives_outputs(const CheckupState state,
+                                              const EbsPressureTestPhase phase) {
+  switch (state) {
+    case CheckupState::START_TOGGLING_WATCHDOG:
+    case CheckupState::TOGGLING_WATCHDOG:
+    case CheckupState::STOP_TOGGLING_WATCHDOG:
+    case CheckupState::CHECK_WATCHDOG:
+    case CheckupState::START_TOGGLING_WATCHDOG_AGAIN:
+    case CheckupState::CLOSE_SDC:
+      return true;
+    case CheckupState::EBS_CHECKS:
+      return phase == EbsPressureTestPhase::DISABLE_ACTUATOR_1 ||
+             phase == EbsPressureTestPhase::CHANGE_ACTUATORS ||
+             phase == EbsPressureTestPhase::ENABLE_ACTUATOR_2;
+    default:
+      return false;
+  }
+}
+
+inline void CheckupManager::record_checkup_step(const CheckupState left) {
+  const auto now = static_cast<uint32_t>(micros());
+  CheckupStep &previous = checkup_timeline_[static_cast<std::size_t>(left)];
+  previous.entered_us = checkup_entered_us_ - checkup_started_us_;
+  previous.dwell_us = now - checkup_entered_us_;
+  previous.visited = true;
+  CheckupStep &next = checkup_timeline_[static_cast<std::size_t>(checkup_state_)];
+  next = {now - checkup_started_us_, 0, true};
+  checkup_entered_us_ = now;
+
+  if (checkup_state_ != CheckupState::CHECKUP_COMPLETE) return;
+  DEBUG_PRINT("Initial checkup took {} us", now - checkup_started_us_);
+  for (std::size_t i = 0; i < CHECKUP_STATE_COUNT; i++) {
+    if (!checkup_timeline_[i].visited) continue;
+    DEBUG_PRINT(
+        "  {WAIT_FOR_ASMS|START_TOGGLING_WATCHDOG|TOGGLING_WATCHDOG|STOP_TOGGLING_WATCHDOG|"
+        "CHECK_WATCHDOG|START_TOGGLING_WATCHDOG_AGAIN|CHECK_EBS_STORAGE|CHECK_BRAKE_PRESSURE|"
+        "CLOSE_SDC|WAIT_FOR_ASATS|WAIT_FOR_TS|EBS_CHECKS|CHECK_TIMESTAMPS|CHECKUP_COMPLETE} "
+        "at {} us for {} us",
+        static_cast<uint32_t>(i), checkup_timeline_[i].entered_us, checkup_timeline_[i].dwell_us);
+  }
+}
+
+inline CheckupManager::CheckupError CheckupManager::initial_checkup_step() {
   switch (checkup_state_) {
     case CheckupState::WAIT_FOR_ASMS:
       if (_system_data_->hardware_data_.asms_on_) {
@@ -216,6 +334,7 @@ inline CheckupManager::CheckupError CheckupManager::initial_checkup_sequence() {
       break;
 
     case CheckupState::STOP_TOGGLING_WATCHDOG:
+      TimerScheduler::disable(DigitalSender::toggle_watchdog);
       _watchdog_test_timer_.reset();
       checkup_state_ = CheckupState::CHECK_WATCHDOG;
       DEBUG_PRINT("Stopping watchdog toggle, beginning verification");
@@ -235,18 +354,18 @@ inline CheckupManager::CheckupError CheckupManager::initial_checkup_sequence() {
       }
       break;
     case CheckupState::START_TOGGLING_WATCHDOG_AGAIN:
-      watchdog_timer_.begin([] { DigitalSender::toggle_watchdog(); }, 50'000);
+      TimerScheduler::enable(DigitalSender::toggle_watchdog);
       checkup_state_ = CheckupState::CHECK_EBS_STORAGE;
       break;
     case CheckupState::CHECK_EBS_STORAGE:
-    DEBUG_PRINT("EBS Storage - pressure: " + String(_system_data_->hardware_data_.pneumatic_line_pressure_));
+    DEBUG_PRINT("EBS Storage - pressure: {}", _system_data_->hardware_data_.pneumatic_line_pressure_);
       if (_system_data_->hardware_data_.pneumatic_line_pressure_) {
         checkup_state_ = CheckupState::CHECK_BRAKE_PRESSURE;
       }
       break;
     case CheckupState::CHECK_BRAKE_PRESSURE:
-    DEBUG_PRINT("Hydraulic Pressure: " + String(_system_data_->hardware_data_._hydraulic_line_pressure) + " - " +
-                String(_system_data_->hardware_data_.hydraulic_line_front_pressure));
+    DEBUG_PRINT("Hydraulic Pressure: {} - {}", _system_data_->hardware_data_._hydraulic_line_pressure,
+                _system_data_->hardware_data_.hydraulic_line_front_pressure);
       if (_system_data_->hardware_data_._hydraulic_line_pressure >= HYDRAULIC_BRAKE_THRESHOLD && 
         _system_data_->hardware_data_.hydraulic_line_front_pressure >= HYDRAULIC_BRAKE_THRESHOLD) {
         checkup_state_ = CheckupState::WAIT_FOR_ASATS;
@@ -428,13 +547,13 @@ bool CheckupManager::should_enter_emergency_in_driving_state() const {
 bool CheckupManager::failed_to_build_hydraulic_pressure_in_time() const {
   return _system_data_->hardware_data_._hydraulic_line_pressure < HYDRAULIC_BRAKE_THRESHOLD && 
          _system_data_->hardware_data_.hydraulic_line_front_pressure < HYDRAULIC_BRAKE_THRESHOLD &&
-         _system_data_->r2d_logics_.engageEbsTimestamp.checkWithoutReset();
+         _system_data_->r2d_logics_.expired(R2DTimer::ENGAGE_EBS);
 }
 
 bool CheckupManager::failed_to_reduce_hydraulic_pressure_in_time() const {
   return _system_data_->hardware_data_._hydraulic_line_pressure >= HYDRAULIC_BRAKE_THRESHOLD &&
          _system_data_->hardware_data_.hydraulic_line_front_pressure >= HYDRAULIC_BRAKE_THRESHOLD &&
-         _system_data_->r2d_logics_.releaseEbsTimestamp.checkWithoutReset();
+         _system_data_->r2d_logics_.expired(R2DTimer::RELEASE_EBS);
 }
 
 inline bool CheckupManager::should_stay_driving() const {
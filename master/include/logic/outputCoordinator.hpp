@@ -1,6 +1,8 @@
 #pragma once
 
-#include "TeensyTimerTool.h"
+#include <array>
+
+#include "../../periodic_scheduler.h"
 #include "comm/communicator.hpp"
 #include "debugUtils.hpp"
 #include "embedded/digitalSender.hpp"
@@ -9,6 +11,10 @@
 #include "model/systemData.hpp"
 #include "timings.hpp"
 
+class OutputCoordinator;
+
+using Publisher = PeriodicJob<void (*)(OutputCoordinator&)>;  ///< A periodic CAN frame
+
 class OutputCoordinator {
 private:
   Metro blink_timer_{LED_BLINK_INTERVAL};  ///< Timer for blinking LED
@@ -17,46 +23,40 @@ private:
   Communicator* communicator_;
   DigitalSender* digital_sender_;
 
-  Metro mission_timer_;
-  Metro state_timer_;
-  Metro process_timer_{PROCESS_INTERVAL};
-  Metro slower_process_timer_{SLOWER_PROCESS_INTERVAL};
+  uint8_t current_master_state_ = 0;   ///< Arguments of the process() call running the publishers
+  uint8_t current_checkup_state_ = 0;
 
   uint8_t previous_master_state_;
   uint8_t previous_checkup_state_;
   uint8_t previous_mission_;
 
 public:
+  static constexpr std::size_t PUBLISHER_COUNT = 5;
+  static const std::array<Publisher, PUBLISHER_COUNT> PUBLISHERS;
+
+  CooperativeScheduler<void (*)(OutputCoordinator&), PUBLISHER_COUNT> publishers_{
+      PUBLISHERS};  ///< Runs PUBLISHERS, with their release jitter and overruns
+
   OutputCoordinator(SystemData* system_data, Communicator* communicator,
                     DigitalSender* digital_sender)
       : system_data_(system_data),
         communicator_(communicator),
         digital_sender_(digital_sender),
-        mission_timer_(MISSION_PUBLISH_INTERVAL),
-        state_timer_(STATE_PUBLISH_INTERVAL),
         previous_master_state_(static_cast<uint8_t>(15)),
         previous_checkup_state_(static_cast<uint8_t>(15)),
         previous_mission_(static_cast<uint8_t>(15)) {}
 
   void init() {
-    mission_timer_.reset();
-    state_timer_.reset();
+    publishers_.start();
     DEBUG_PRINT("Output coordinator initialized...");
   }
 
   void process(uint8_t current_master_state, uint8_t current_checkup_state) {
     dash_ats_update(current_master_state);
     update_physical_outputs();
-    if (process_timer_.check()) {
-      send_soc();
-      send_asms();
-      send_mission_update();
-      send_state_update(current_master_state);
-    }
-    if (slower_process_timer_.check()) {
-      send_debug_on_state_change(current_master_state, current_checkup_state);
-      send_rpm();
-    }
+    current_master_state_ = current_master_state;
+    current_checkup_state_ = current_checkup_state;
+    publishers_.run(*this);
   }
 
   void blink_emergency_led() {
@@ -144,38 +144,24 @@ private:
                                             current_checkup_state);
   }
 
-  void send_soc() { Communicator::publish_soc(system_data_->hardware_data_.soc_); }
-
-  void send_asms() { Communicator::publish_asms_on(system_data_->hardware_data_.asms_on_); }
-
-  void send_mission_update() {
-    if (mission_timer_.check()) {
-      Communicator::publish_mission(to_underlying(system_data_->mission_));
-      mission_timer_.reset();
-    }
-  }
-
-  void send_state_update(uint8_t current_master_state) {
-    if (state_timer_.check()) {
-      Communicator::publish_state(current_master_state);
-      state_timer_.reset();
-    }
+  void send_status(uint8_t current_master_state) {
+    Communicator::publish_status(current_master_state, to_underlying(system_data_->mission_),
+                                 system_data_->hardware_data_.soc_,
+                                 system_data_->hardware_data_.asms_on_);
   }
 
   void update_physical_outputs() {
     brake_light_update();
     bsdp_sdc_update();
+    digital_sender_->apply_staged_outputs();
     // digital_sender_->turn_on_blue();
     // digital_sender_->turn_on_yellow();
   }
 
   void brake_light_update() {
     int brake_val = system_data_->hardware_data_._hydraulic_line_pressure;
-    // DEBUG_PRINT("Brake pressure: " + String(brake_val));
-    // DEBUG_PRINT("Brake pressure lower threshold: " +
-    //            String(BRAKE_PRESSURE_LOWER_THRESHOLD));
-    // DEBUG_PRINT("Brake pressure upper threshold: " +
-    //            String(BRAKE_PRESSURE_UPPER_THRESHOLD));
+    // DEBUG_PRINT("Brake pressure: {} (thresholds {} - {})", brake_val,
+    //             BRAKE_PRESSURE_LOWER_THRESHOLD, BRAKE_PRESSURE_UPPER_THRESHOLD);
 
     if (brake_val >= BRAKE_PRESSURE_LOWER_THRESHOLD &&
         brake_val <= BRAKE_PRESSURE_UPPER_THRESHOLD) {
@@ -195,10 +181,10 @@ private:
   }
   void dash_ats_update(uint8_t current_master_state) {
     DEBUG_PRINT("=== ATS Update Debug ===");
-    DEBUG_PRINT("ATS Pressed: " + String(system_data_->hardware_data_.ats_pressed_));
-    DEBUG_PRINT("Current Master State: " + String(current_master_state) +
-                " (AS_MANUAL=" + String(to_underlying(State::AS_MANUAL)) + ")");
-    DEBUG_PRINT("TSMS SDC Closed: " + String(system_data_->hardware_data_.tsms_sdc_closed_));
+    DEBUG_PRINT("ATS Pressed: {}", system_data_->hardware_data_.ats_pressed_);
+    DEBUG_PRINT("Current Master State: {} (AS_MANUAL={})", current_master_state,
+                to_underlying(State::AS_MANUAL));
+    DEBUG_PRINT("TSMS SDC Closed: {}", system_data_->hardware_data_.tsms_sdc_closed_);
 
     if (system_data_->hardware_data_.ats_pressed_ &&
         current_master_state == to_underlying(State::AS_MANUAL) &&
@@ -223,3 +209,26 @@ private:
   }
   void send_rpm() { Communicator::publish_rpm(); }
 };
+
+/**
+ * Periodic CAN frames, shortest period first. The phases spread them over the period so that no
+ * two are sent on the same loop() iteration, instead of every 200 and 500 ms frame at once.
+ */
+inline constexpr std::array<Publisher, OutputCoordinator::PUBLISHER_COUNT>
+    OutputCoordinator::PUBLISHERS = {{
+    {"status", PROCESS_INTERVAL, 0,
+     [](OutputCoordinator &oc) { oc.send_status(oc.current_master_state_); }},
+    {"debug_log", SLOWER_PROCESS_INTERVAL, 25,
+     [](OutputCoordinator &oc) {
+       oc.send_debug_on_state_change(oc.current_master_state_, oc.current_checkup_state_);
+     }},
+    {"rpm", SLOWER_PROCESS_INTERVAL, 75, [](OutputCoordinator &oc) { oc.send_rpm(); }},
+    {"loop_profile", PROFILE_PUBLISH_INTERVAL, 125,
+     [](OutputCoordinator &) { Communicator::publish_loop_profile(); }},
+    {"heartbeats", HEARTBEAT_PUBLISH_INTERVAL, 175,
+     [](OutputCoordinator &) { Communicator::publish_heartbeats(); }},
+}};
+
+static_assert(rate_monotonic_order(OutputCoordinator::PUBLISHERS));
+static_assert(min_release_gap_ms(OutputCoordinator::PUBLISHERS) >= 25,
+              "two publishers are released within 25 ms of each other");
@@ -1,35 +1,52 @@
 #pragma once
 
 #include <embedded/digitalSender.hpp>
+#include <enum_utils.hpp>
 #include <logic/checkupManager.hpp>
+#include <logic/stateMachine.hpp>
+#include <model/emergencyEvent.hpp>
 #include <model/structure.hpp>
+#include <timerScheduler.hpp>
 
-#include "TeensyTimerTool.h"
-using namespace TeensyTimerTool;
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief What makes ASState evaluate its transition table
+ */
+enum class ASEvent : uint8_t {
+  TICK,             ///< Every loop() iteration, calculate_state()
+  EMERGENCY_CHECK,  ///< An EmergencyEvent, raised where it is seen or by the emergency check task
+};
 
 /**
  * @brief The ASState class manages and transitions between different states of the vehicle system.
  *
- * The ASState class uses the CheckupManager to perform system checks and determine the appropriate
- * state transitions based on the vehicle's status and operational conditions. It interacts with
- * hardware components via the OutputCoordinator and Communicator interfaces to update the system
- * state and handle transitions.
+ * The transitions are the rows of ASState::TRANSITIONS, run by a StateMachine that timestamps each
+ * one and keeps per-edge latency statistics. Guards ask the CheckupManager whether the car may
+ * move on, actions drive the hardware through the OutputCoordinator and Communicator.
  */
 class ASState {
 private:
-  PeriodicTimer emergency_timer_;
   volatile bool timer_has_started = false;
+  uint32_t emergency_raised_us_ = 0;  ///< micros() of the last EmergencyEvent taken
+  SystemData *_system_data_;  ///< Pointer to the system data, for the trigger timestamps.
   OutputCoordinator *
       _output_coordinator_;  ///< Pointer to the OutputCoordinator object for hardware interactions.
   Communicator
       *_communicator_;  ///< Pointer to the Communicator object for communication operations.
 
-  inline static ASState *instance = nullptr;
-
 public:
+  using Row = Transition<ASState, State, ASEvent>;
+  static constexpr std::size_t TRANSITION_COUNT = 14;
+  static const std::array<Row, TRANSITION_COUNT> TRANSITIONS;
+
   CheckupManager
       _checkup_manager_;        ///< CheckupManager object for handling various checkup operations.
   State state_{State::AS_OFF};  ///< Current state of the vehicle system, initialized to OFF.
+  StateMachine<ASState, State, ASEvent, TRANSITION_COUNT> state_machine_{
+      TRANSITIONS};  ///< Runs TRANSITIONS on state_, with the transition timings.
 
   /**
    * @brief Constructor for the ASState class.
@@ -40,108 +57,142 @@ public:
    */
   explicit ASState(SystemData *system_data, Communicator *communicator,
                    OutputCoordinator *output_coordinator)
-      : _output_coordinator_(output_coordinator),
+      : _system_data_(system_data),
+        _output_coordinator_(output_coordinator),
         _communicator_(communicator),
-        _checkup_manager_(system_data) {
-    instance = this;
-  }
+        _checkup_manager_(system_data) {}
 
   /**
    * @brief Calculates the state of the vehicle.
    */
   void calculate_state();
   void timer_started() { timer_has_started = true; }
+
+  /**
+   * @brief The EMERGENCY_CHECK_INTERVAL_US TimerScheduler task
+   * @details Runs in the timer interrupt, so it only raises an EmergencyEvent. The guards read
+   * SystemData and the actions write outputs and the StateMachine statistics, all of which belong
+   * to loop(), so the EMERGENCY_CHECK rows run in the next calculate_state().
+   */
+  static void emergency_check_task();
+
+private:
+  /**
+   * @brief Runs the rows of the current state for `event`
+   * @return True when the state changed
+   */
+  bool dispatch(ASEvent event);
 };
 
+/**
+ * Rows of a state are evaluated in this order every iteration, rows that stay in their state run
+ * their action and let the evaluation go on (see Transition).
+ */
+inline constexpr std::array<ASState::Row, ASState::TRANSITION_COUNT> ASState::TRANSITIONS = {{
+    {State::AS_MANUAL, ASEvent::TICK,
+     [](ASState &as) { return !as._checkup_manager_.should_stay_manual_driving(); },
+     [](ASState &as) { as._output_coordinator_->enter_off_state(); }, State::AS_OFF},
+
+    {State::AS_OFF, ASEvent::TICK, [](ASState &as) { return !as.timer_has_started; },
+     [](ASState &as) {
+       TimerScheduler::add("emergency_check", emergency_check_task, EMERGENCY_CHECK_INTERVAL_US,
+                           EMERGENCY_CHECK_PRIORITY);
+       as.timer_started();
+     },
+     State::AS_OFF},
+    // If manual driving checkup fails, the car can't be in OFF state, so it goes back to MANUAL
+    {State::AS_OFF, ASEvent::TICK,
+     [](ASState &as) { return as._checkup_manager_.should_stay_manual_driving(); },
+     [](ASState &as) { as._output_coordinator_->enter_manual_state(); }, State::AS_MANUAL},
+    {State::AS_OFF, ASEvent::TICK, nullptr, [](ASState &as) { as._communicator_->reset_r2d(); },
+     State::AS_OFF},
+    {State::AS_OFF, ASEvent::TICK,
+     [](ASState &as) {
+       return !as._checkup_manager_.should_stay_off() &&
+              as._checkup_manager_.should_go_ready_from_off();  // recheck all states
+     },
+     [](ASState &as) { as._output_coordinator_->enter_ready_state(); }, State::AS_READY},
+
+    {State::AS_READY, ASEvent::TICK,
+     [](ASState &as) { return !as._checkup_manager_.should_stay_ready(); },
+     [](ASState &as) { as._output_coordinator_->enter_driving_state(); }, State::AS_DRIVING,
+     [](const ASState &as) { return as._system_data_->r2d_logics_.go_signal_us; }},
+
+    {State::AS_DRIVING, ASEvent::TICK, nullptr,
+     [](ASState &as) { as._output_coordinator_->blink_driving_led(); }, State::AS_DRIVING},
+    {State::AS_DRIVING, ASEvent::TICK,
+     [](ASState &as) { return !as._checkup_manager_.should_stay_driving(); },
+     [](ASState &as) { as._output_coordinator_->enter_finish_state(); }, State::AS_FINISHED},
+
+    {State::AS_FINISHED, ASEvent::TICK,
+     [](ASState &as) { return as._checkup_manager_.res_triggered(); },
+     [](ASState &as) {
+       as._output_coordinator_->enter_emergency_state();
+       as._checkup_manager_._ebs_sound_timestamp_.reset();
+     },
+     State::AS_EMERGENCY},
+    {State::AS_FINISHED, ASEvent::TICK,
+     [](ASState &as) { return !as._checkup_manager_.should_stay_mission_finished(); },
+     [](ASState &as) {
+       as._output_coordinator_->enter_off_state();
+       as._checkup_manager_.reset_checkup_state();
+     },
+     State::AS_OFF},
+
+    {State::AS_EMERGENCY, ASEvent::TICK, nullptr,
+     [](ASState &as) { as._output_coordinator_->blink_emergency_led(); }, State::AS_EMERGENCY},
+    {State::AS_EMERGENCY, ASEvent::TICK,
+     [](ASState &as) { return as._checkup_manager_.emergency_sequence_complete(); },
+     [](ASState &as) {
+       as._output_coordinator_->enter_off_state();
+       as._checkup_manager_.reset_checkup_state();
+     },
+     State::AS_OFF},
+
+    {State::AS_READY, ASEvent::EMERGENCY_CHECK,
+     [](ASState &as) { return as._checkup_manager_.should_enter_emergency_in_ready_state(); },
+     [](ASState &as) {
+       as._output_coordinator_->enter_emergency_state();
+       as._checkup_manager_._ebs_sound_timestamp_.reset();
+     },
+     State::AS_EMERGENCY, [](const ASState &as) { return as.emergency_raised_us_; }},
+    {State::AS_DRIVING, ASEvent::EMERGENCY_CHECK,
+     [](ASState &as) { return as._checkup_manager_.should_enter_emergency_in_driving_state(); },
+     [](ASState &as) {
+       as._output_coordinator_->enter_emergency_state();
+       as._checkup_manager_._ebs_sound_timestamp_.reset();
+     },
+     State::AS_EMERGENCY, [](const ASState &as) { return as.emergency_raised_us_; }},
+}};
+
+static_assert(reachable_states(ASState::TRANSITIONS, State::AS_OFF) == 0b111111,
+              "every AS state must be reachable from AS_OFF");
+static_assert((reachable_states(ASState::TRANSITIONS, State::AS_EMERGENCY) &
+               (1U << to_underlying(State::AS_OFF))) != 0,
+              "the car must be able to leave AS_EMERGENCY for AS_OFF");
+
+/**
+ * A pending EmergencyEvent is evaluated before the TICK rows, so an emergency raised by this
+ * iteration's digital reads or CAN frames wins over any other transition out of the state.
+ */
 inline void ASState::calculate_state() {
-  switch (state_) {
-    case State::AS_MANUAL:
-      if (_checkup_manager_.should_stay_manual_driving()) {
-        break;
-      }
-
-      DEBUG_PRINT("Entering OFF state from MANUAL");
-      _output_coordinator_->enter_off_state();
-
-      state_ = State::AS_OFF;
-      break;
-
-    case State::AS_OFF:
-
-      if (!timer_has_started) {
-        emergency_timer_.begin(
-            [] {
-              instance->timer_started();
-              if (instance->_checkup_manager_.should_enter_emergency(instance->state_)) {
-                instance->_output_coordinator_->enter_emergency_state();
-                instance->_checkup_manager_._ebs_sound_timestamp_.reset();
-                instance->state_ = State::AS_EMERGENCY;
-              }
-            },
-            150'000);
-      }
-      // If manual driving checkup fails, the car can't be in OFF state, so it goes back to MANUAL
-      if (_checkup_manager_.should_stay_manual_driving()) {
-        DEBUG_PRINT("Entering MANUAL state from OFF");
-        _output_coordinator_->enter_manual_state();
-        state_ = State::AS_MANUAL;
-        break;
-      }
-      _communicator_->reset_r2d();
-      if (_checkup_manager_.should_stay_off()) break;
-      if (!_checkup_manager_.should_go_ready_from_off()) break;  // recheck all states
-
-      DEBUG_PRINT("Entering READY state from OFF");
-      _output_coordinator_->enter_ready_state();
-      state_ = State::AS_READY;
-      DEBUG_PRINT("READY state entered...");
-      break;
-
-    case State::AS_READY:
-
-      if (_checkup_manager_.should_stay_ready()) {
-        break;
-      }
-      _output_coordinator_->enter_driving_state();
-      state_ = State::AS_DRIVING;
-      break;
-
-    case State::AS_DRIVING:
-      _output_coordinator_->blink_driving_led();
-      if (_checkup_manager_.should_stay_driving()) break;
-      _output_coordinator_->enter_finish_state();
-      state_ = State::AS_FINISHED;
-      break;
-
-    case State::AS_FINISHED:
-      if (_checkup_manager_.res_triggered()) {
-        DEBUG_PRINT("Entering EMERGENCY state from FINISHED");
-
-        _output_coordinator_->enter_emergency_state();
-        _checkup_manager_._ebs_sound_timestamp_.reset();
-        state_ = State::AS_EMERGENCY;
-        break;
-      }
-      if (_checkup_manager_.should_stay_mission_finished()) break;
-
-      DEBUG_PRINT("Entering OFF state from FINISHED");
-      _output_coordinator_->enter_off_state();
-      _checkup_manager_.reset_checkup_state();
-      state_ = State::AS_OFF;
-      break;
-
-    case State::AS_EMERGENCY:
-      _output_coordinator_->blink_emergency_led();
-
-      if (_checkup_manager_.emergency_sequence_complete()) {
-        DEBUG_PRINT("Entering OFF state from EMERGENCY");
-        _output_coordinator_->enter_off_state();
-        _checkup_manager_.reset_checkup_state();
-        state_ = State::AS_OFF;
-        break;
-      }
-      break;
-    default:
-      break;
+  uint32_t raised_us = 0;
+  if (EmergencyEvent::take(raised_us)) {
+    emergency_raised_us_ = raised_us;
+    // an event the guards did not act on is not what a later timer check reacts to
+    if (!dispatch(ASEvent::EMERGENCY_CHECK)) emergency_raised_us_ = state_machine_.entered_us() - 1;
   }
+  dispatch(ASEvent::TICK);
+}
+
+inline void ASState::emergency_check_task() { EmergencyEvent::raise(); }
+
+inline bool ASState::dispatch(const ASEvent event) {
+  [[maybe_unused]] const State previous = state_;
+  if (!state_machine_.dispatch(state_, *this, event)) return false;
+  DEBUG_PRINT(
+      "Entering {MANUAL|OFF|READY|DRIVING|FINISHED|EMERGENCY} state from "
+      "{MANUAL|OFF|READY|DRIVING|FINISHED|EMERGENCY} after {} us",
+      state_, previous, state_machine_.stats(state_machine_.recent(0).row).dwell.last_us);
+  return true;
 }
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief One row of a transition table: in `from`, on `event`, if `guard` holds, run `action`
+ * and go to `to`
+ * @details A null guard always holds and a null action does nothing. A row whose `to` is its own
+ * `from` is an internal transition: its action runs and the rows after it are still evaluated,
+ * which is how work done every iteration in a state, before or between its exits, is written.
+ * `trigger`, when set, returns the micros() of the outside event that enabled the guard (the RES
+ * GO frame, for instance), so the engine can tell how long the transition took to follow it.
+ */
+template <class Context, class StateEnum, class Event>
+struct Transition {
+  StateEnum from;
+  Event event;
+  bool (*guard)(Context &);
+  void (*action)(Context &);
+  StateEnum to;
+  uint32_t (*trigger)(const Context &) = nullptr;
+
+  [[nodiscard]] constexpr bool internal() const { return to == from; }
+};
+
+/**
+ * @brief Count, min, mean and max of a latency in microseconds
+ */
+struct LatencyStats {
+  uint32_t count = 0;
+  uint32_t min_us = UINT32_MAX;
+  uint32_t max_us = 0;
+  uint32_t last_us = 0;
+  uint64_t total_us = 0;
+
+  void add(const uint32_t us) {
+    count++;
+    min_us = std::min(min_us, us);
+    max_us = std::max(max_us, us);
+    last_us = us;
+    total_us += us;
+  }
+
+  [[nodiscard]] uint32_t mean_us() const {
+    return count == 0 ? 0 : static_cast<uint32_t>(total_us / count);
+  }
+};
+
+/**
+ * @brief What is known about one edge of the table
+ */
+struct EdgeStats {
+  LatencyStats dwell;    ///< Time spent in the source state before the edge was taken
+  LatencyStats trigger;  ///< Time from the row's trigger event to the edge, rows with a trigger
+};
+
+/**
+ * @brief Bitmask of the states reachable from `initial` over the edges of `table`, every guard
+ * assumed satisfiable
+ */
+template <class Row, std::size_t ROWS, class StateEnum>
+constexpr uint32_t reachable_states(const std::array<Row, ROWS> &table, const StateEnum initial) {
+  uint32_t reached = 1U << static_cast<uint32_t>(initial);
+  for (bool grew = true; grew;) {
+    grew = false;
+    for (const Row &row : table) {
+      const uint32_t to = 1U << static_cast<uint32_t>(row.to);
+      if ((reached & (1U << static_cast<uint32_t>(row.from))) != 0 && (reached & to) == 0) {
+        reached |= to;
+        grew = true;
+      }
+    }
+  }
+  return reached;
+}
+
+/**
+ * @brief Runs a constexpr transition table and times every transition it takes
+ * @details The current state is owned by the caller and passed to dispatch() by reference, so it
+ * can still be read, or set by a test, directly. A state changed behind the engine's back starts
+ * its dwell time at the next dispatch().
+ */
+template <class Context, class StateEnum, class Event, std::size_t ROWS>
+class StateMachine {
+public:
+  using Row = Transition<Context, StateEnum, Event>;
+  using Table = std::array<Row, ROWS>;
+
+  /**
+   * @brief A transition that was taken
+   */
+  struct Record {
+    uint8_t row;
+    uint32_t at_us;  ///< micros() when its action had run
+  };
+
+  static constexpr std::size_t HISTORY = 16;
+
+  explicit constexpr StateMachine(const Table &table) : table_(&table) {}
+
+  /**
+   * @brief Evaluates the rows of `state` for `event` in table order, the first enabled row that
+   * leaves the state is taken
+   * @return True when the state changed
+   */
+  bool dispatch(StateEnum &state, Context &context, const Event event) {
+    if (state != current_) enter(state, static_cast<uint32_t>(micros()));
+    for (std::size_t i = 0; i < ROWS; i++) {
+      const Row &row = (*table_)[i];
+      if (row.from != state || row.event != event) continue;
+      if (row.guard != nullptr && !row.guard(context)) continue;
+      if (row.action != nullptr) row.action(context);
+      if (row.internal()) continue;
+
+      const auto now = static_cast<uint32_t>(micros());
+      stats_[i].dwell.add(now - entered_us_);
+      if (row.trigger != nullptr) {
+        const uint32_t since = now - row.trigger(context);
+        if (since <= now - entered_us_) stats_[i].trigger.add(since);  // else it predates `from`
+      }
+      history_[taken_ % HISTORY] = {static_cast<uint8_t>(i), now};
+      taken_++;
+      state = row.to;
+      enter(state, now);
+      return true;
+    }
+    return false;
+  }
+
+  [[nodiscard]] const Table &table() const { return *table_; }
+  [[nodiscard]] const EdgeStats &stats(const std::size_t row) const { return stats_[row]; }
+  [[nodiscard]] uint32_t taken() const { return taken_; }
+  [[nodiscard]] uint32_t entered_us() const { return entered_us_; }
+
+  /**
+   * @brief The n-th most recent transition, 0 being the last one; n < min(taken(), HISTORY)
+   */
+  [[nodiscard]] const Record &recent(const std::size_t n) const {
+    return history_[(taken_ - 1 - n) % HISTORY];
+  }
+
+  void reset_stats() {
+    stats_ = {};
+    taken_ = 0;
+  }
+
+private:
+  const Table *table_;
+  StateEnum current_{};
+  uint32_t entered_us_ = 0;
+  std::array<EdgeStats, ROWS> stats_{};
+  std::array<Record, HISTORY> history_{};
+  uint32_t taken_ = 0;
+
+  void enter(const StateEnum state, const uint32_t now) {
+    current_ = state;
+    entered_us_ = now;
+  }
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef NATIVE
+#include <hostProfiler.h>
+
+#include <cstdio>
+#endif
+
+/**
+ * @brief Parts of loop() timed by the profiler, the numbering is the profile_stage of the
+ * DBG_PROFILE_MSG frame in conf.dbc
+ */
+enum class LoopStage : uint8_t {
+  DIGITAL_READS,
+  CAN_RECEIVE,
+  SYSTEM_DATA_COPY,
+  CALCULATE_STATE,
+  OUTPUT_PROCESS,
+  CAN_TRANSMIT,
+  LOOP,  ///< The whole iteration
+  COUNT
+};
+
+constexpr std::size_t LOOP_STAGE_COUNT = static_cast<std::size_t>(LoopStage::COUNT);
+
+constexpr std::array<const char *, LOOP_STAGE_COUNT> LOOP_STAGE_NAMES = {
+    "digital_reads", "can_receive", "system_data_copy", "calculate_state", "output_process",
+    "can_transmit", "loop"};
+
+/**
+ * @brief Free-running cycle counter: DWT CYCCNT on the Teensy, host nanoseconds in the native
+ * build
+ */
+inline uint32_t profiler_cycles() {
+#ifdef NATIVE
+  return static_cast<uint32_t>(native_hal::steady_ns());
+#else
+  return ARM_DWT_CYCCNT;
+#endif
+}
+
+inline uint32_t profiler_cycles_per_us() {
+#ifdef NATIVE
+  return 1000;
+#else
+  return F_CPU_ACTUAL / 1'000'000;
+#endif
+}
+
+/**
+ * @brief Durations in cycles, counted in power-of-two buckets
+ * @details Bucket b holds the durations of bit width b, i.e. [2^(b-1), 2^b), so recording is one
+ * count-leading-zeros and an increment, and percentiles are exact to within a factor of two.
+ */
+class CycleHistogram {
+public:
+  static constexpr std::size_t BUCKETS = 33;
+
+  void add(const uint32_t cycles) {
+    buckets_[bit_width(cycles)]++;
+    count_++;
+    total_ += cycles;
+    max_ = std::max(max_, cycles);
+  }
+
+  [[nodiscard]] uint32_t count() const { return count_; }
+  [[nodiscard]] uint32_t max() const { return max_; }
+  [[nodiscard]] uint32_t bucket(const std::size_t b) const { return buckets_[b]; }
+
+  [[nodiscard]] uint32_t mean() const {
+    return count_ == 0 ? 0 : static_cast<uint32_t>(total_ / count_);
+  }
+
+  /**
+   * @brief Upper bound of the bucket holding the given percentile, never above the maximum
+   * @param per_mille 990 for p99
+   */
+  [[nodiscard]] uint32_t percentile(const uint32_t per_mille) const {
+    const uint64_t rank = (static_cast<uint64_t>(count_) * per_mille + 999) / 1000;
+    uint64_t seen = 0;
+    for (std::size_t b = 0; b < BUCKETS; b++) {
+      seen += buckets_[b];
+      if (seen >= rank && seen > 0) return std::min(bucket_upper_bound(b), max_);
+    }
+    return max_;
+  }
+
+  /**
+   * @brief What was added since `earlier` was copied from this histogram, except the maximum
+   * which cannot be subtracted and is kept whole
+   */
+  [[nodiscard]] CycleHistogram since(const CycleHistogram &earlier) const {
+    CycleHistogram delta = *this;
+    for (std::size_t b = 0; b < BUCKETS; b++) delta.buckets_[b] -= earlier.buckets_[b];
+    delta.count_ -= earlier.count_;
+    delta.total_ -= earlier.total_;
+    return delta;
+  }
+
+  void set_max(const uint32_t max) { max_ = max; }
+
+private:
+  std::array<uint32_t, BUCKETS> buckets_{};
+  uint32_t count_ = 0;
+  uint64_t total_ = 0;
+  uint32_t max_ = 0;
+
+  /**
+   * @brief std::bit_width, which the C++17 debug environment does not have
+   */
+  static constexpr std::size_t bit_width(const uint32_t value) {
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+  }
+
+  static constexpr uint32_t bucket_upper_bound(const std::size_t b) {
+    return b >= 32 ? UINT32_MAX : (uint32_t{1} << b) - 1;
+  }
+};
+
+/**
+ * @brief Per-stage histograms of loop() since boot, plus a window that is summarised on CAN
+ * and restarted every PROFILE_PUBLISH_INTERVAL
+ */
+class LoopProfiler {
+public:
+  static void record(const LoopStage stage, const uint32_t cycles) {
+    const auto i = static_cast<std::size_t>(stage);
+    total_[i].add(cycles);
+    window_max_[i] = std::max(window_max_[i], cycles);
+  }
+
+  /**
+   * @brief Everything recorded since boot
+   */
+  [[nodiscard]] static const CycleHistogram &total(const LoopStage stage) {
+    return total_[static_cast<std::size_t>(stage)];
+  }
+
+  /**
+   * @brief Everything recorded since the last start_window()
+   */
+  [[nodiscard]] static CycleHistogram window(const LoopStage stage) {
+    const auto i = static_cast<std::size_t>(stage);
+    CycleHistogram window = total_[i].since(window_start_[i]);
+    window.set_max(window_max_[i]);
+    return window;
+  }
+
+  static void start_window() {
+    window_start_ = total_;
+    window_max_ = {};
+  }
+
+  static void reset() {
+    total_ = {};
+    start_window();
+  }
+
+private:
+  inline static std::array<CycleHistogram, LOOP_STAGE_COUNT> total_{};
+  inline static std::array<CycleHistogram, LOOP_STAGE_COUNT> window_start_{};
+  inline static std::array<uint32_t, LOOP_STAGE_COUNT> window_max_{};
+};
+
+/**
+ * @brief Records its own lifetime into a loop stage, see PROFILE_STAGE
+ */
+class LoopProbe {
+public:
+  explicit LoopProbe(const LoopStage stage) : stage_(stage), start_(profiler_cycles()) {}
+
+  ~LoopProbe() {
+    const uint32_t cycles = profiler_cycles() - start_;
+    LoopProfiler::record(stage_, cycles);
+#ifdef NATIVE
+    native_hal::stage(LOOP_STAGE_NAMES[static_cast<std::size_t>(stage_)]).add(cycles);
+#endif
+  }
+
+  LoopProbe(const LoopProbe &) = delete;
+  LoopProbe &operator=(const LoopProbe &) = delete;
+
+private:
+  LoopStage stage_;
+  uint32_t start_;
+};
+
+#ifdef NATIVE
+/**
+ * @brief Prints the since-boot p50, p99 and worst case of every stage and its non-empty buckets
+ */
+inline void print_loop_profile(FILE *out) {
+  const double per_us = profiler_cycles_per_us();
+  fprintf(out, "%-24s %10s %10s %10s %10s\n", "stage", "count", "p50_us", "p99_us", "max_us");
+  for (std::size_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    const CycleHistogram &histogram = LoopProfiler::total(static_cast<LoopStage>(i));
+    fprintf(out, "%-24s %10u %10.3f %10.3f %10.3f\n", LOOP_STAGE_NAMES[i], histogram.count(),
+            histogram.percentile(500) / per_us, histogram.percentile(990) / per_us,
+            histogram.max() / per_us);
+  }
+  for (std::size_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    const CycleHistogram &histogram = LoopProfiler::total(static_cast<LoopStage>(i));
+    fprintf(out, "\n%s, cycles (ns on the host):\n", LOOP_STAGE_NAMES[i]);
+    for (std::size_t b = 0; b < CycleHistogram::BUCKETS; b++) {
+      if (histogram.bucket(b) == 0) continue;
+      fprintf(out, "  < %-12llu %10u\n", 1ULL << b, histogram.bucket(b));
+    }
+  }
+}
+#endif
@@ -121,7 +121,7 @@ inline bool Metro::checkWithoutReset() const
     return 0;
 }
 
-void Metro::reset()
+inline void Metro::reset()
 {
 
     this->previous_millis = millis();
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Raised where an emergency condition is first seen (RES, AS CU, SDC or ASMS opening), so
+ * ASState evaluates its emergency transitions in the same loop() instead of at the next
+ * EMERGENCY_CHECK_INTERVAL_US timer tick
+ * @details Producers run in loop() before calculate_state(), or in the emergency timer interrupt,
+ * so an event waits at most for the rest of the current iteration. Raising again while one is
+ * pending keeps the first timestamp, the one the reaction latency is measured from.
+ */
+class EmergencyEvent {
+public:
+  static void raise() {
+    if (pending_.load(std::memory_order_acquire)) return;
+    raised_us_.store(static_cast<uint32_t>(micros()), std::memory_order_relaxed);
+    pending_.store(true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Consumes the pending event
+   * @param raised_us Set to the micros() of the raise when there was one
+   * @return True when an event was pending
+   */
+  static bool take(uint32_t &raised_us) {
+    if (!pending_.exchange(false, std::memory_order_acq_rel)) return false;
+    raised_us = raised_us_.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  [[nodiscard]] static bool pending() { return pending_.load(std::memory_order_acquire); }
+
+  static void clear() { pending_.store(false, std::memory_order_release); }
+
+private:
+  inline static std::atomic<bool> pending_{false};
+  inline static std::atomic<uint32_t> raised_us_{0};
+};
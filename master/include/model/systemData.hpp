@@ -7,6 +7,9 @@
 /**
  * @brief The whole model of the system:
  * holds all the data necessary
+ * @details Only loop() reads or writes it. Interrupt handlers hand their data over through
+ * queues and atomics (Communicator's receive queue, WheelSpeed, EmergencyEvent), so loop() can
+ * copy it without masking interrupts.
  */
 struct SystemData {
   R2DLogics r2d_logics_;
@@ -17,4 +20,12 @@ struct SystemData {
 
   bool ready_2_drive_{false};
   bool mission_finished_{false};
+
+  /**
+   * @brief Moves every deadline of the model to `now_ms`, the one clock sample of a loop()
+   */
+  void tick(const uint32_t now_ms) {
+    r2d_logics_.tick(now_ms);
+    failure_detection_.tick(now_ms);
+  }
 };
@@ -1,37 +1,50 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdlib>
 
 #include "Arduino.h"
 #include "debugUtils.hpp"
 #include "embedded/hardwareSettings.hpp"
-#include "metro.h"
+#include "enum_utils.hpp"
+#include "model/timingWheel.hpp"
+
+/**
+ * @brief Deadlines of the ready to drive sequence, timers of R2DLogics::deadlines_
+ */
+enum class R2DTimer : uint8_t {
+  READY,        ///< Time in ready before a GO counts
+  RELEASE_EBS,  ///< Since EBS was released on r2d, a small delay is tolerated before driving
+  ENGAGE_EBS,   ///< Since EBS was engaged on ready, while pneumatic line pressure is still low
+  COUNT
+};
 
 struct R2DLogics {
-  Metro readyTimestamp{READY_TIMEOUT_MS};
+  TimingWheel<to_underlying(R2DTimer::COUNT)> deadlines_{
+      {static_cast<uint32_t>(READY_TIMEOUT_MS), static_cast<uint32_t>(RELEASE_EBS_TIMEOUT_MS),
+       static_cast<uint32_t>(ENGAGE_EBS_TIMEOUT_MS)}};
+  bool r2d{false};
+  uint32_t go_signal_us{0};  ///< micros() of the GO that set r2d, for the READY -> DRIVING timing
 
-  /// Timestamp from when EBS is released on r2d,
-  /// used to tolerate a small delay before entering driving state
-  Metro releaseEbsTimestamp{RELEASE_EBS_TIMEOUT_MS};
+  [[nodiscard]] bool expired(const R2DTimer timer) const {
+    return deadlines_.expired(to_underlying(timer));
+  }
 
-  /// Timestamp from when EBS is activate on entering ready state,
-  /// used to tolerate a small delay in which pneumatic line pressure is low
-  Metro engageEbsTimestamp{ENGAGE_EBS_TIMEOUT_MS};
-  bool r2d{false};
+  void tick(const uint32_t now_ms) { deadlines_.tick(now_ms); }
 
   /**
    * @brief resets timestamps for ready
    */
   void enter_ready_state() {
-    readyTimestamp.reset();
-    engageEbsTimestamp.reset();
+    deadlines_.kick(to_underlying(R2DTimer::READY));
+    deadlines_.kick(to_underlying(R2DTimer::ENGAGE_EBS));
     r2d = false;
   }
 
   /**
    * @brief resets timestamps for driving
    */
-  void reset_ebs_timestamp() { releaseEbsTimestamp.reset(); }
+  void reset_ebs_timestamp() { deadlines_.kick(to_underlying(R2DTimer::RELEASE_EBS)); }
 
   /**
    * @brief Processes the go signal.
@@ -45,7 +58,8 @@ struct R2DLogics {
   }
   void process_go_signal() {
     //if 5 seconds have passed all good, VVVRRRUUUMMMMM 
-    if (readyTimestamp.check()) {
+    if (deadlines_.consume(to_underlying(R2DTimer::READY))) {
+      if (!r2d) go_signal_us = static_cast<uint32_t>(micros());
       r2d = true;
       return;
     }
@@ -54,15 +68,38 @@ struct R2DLogics {
   }
 };
 
+/**
+ * @brief Heartbeats and voltage hysteresis timers, timers of FailureDetection::deadlines_
+ * @details The heartbeats come first, their index is the node of the DBG_HEARTBEAT_MSG frame
+ */
+enum class FailureTimer : uint8_t {
+  PC,
+  STEERING,
+  INVERTER,
+  RES,
+  DASH,
+  CELLS,            ///< Cell temperature master board
+  DC_VOLTAGE_DROP,  ///< Voltage below threshold for more than this turns ts off
+  DC_VOLTAGE_HOLD,  ///< Voltage above threshold for this long turns ts on
+  COUNT
+};
+
 struct FailureDetection {
-  Metro pc_alive_timestamp_{COMPONENT_TIMESTAMP_TIMEOUT};
-  Metro steer_alive_timestamp_{COMPONENT_TIMESTAMP_TIMEOUT};
-  Metro inversor_alive_timestamp_{COMPONENT_TIMESTAMP_TIMEOUT};
-  Metro res_signal_loss_timestamp_{RES_TIMESTAMP_TIMEOUT};
-  Metro dc_voltage_drop_timestamp_{DC_VOLTAGE_TIMEOUT};  // timer to check if dc voltage drops below
-                                                         // threshold for more than 150ms
-  Metro dc_voltage_hold_timestamp_{
-      DC_VOLTAGE_HOLD};  // timer for ts on, only after enough voltage for 1 sec
+  using Deadlines = TimingWheel<to_underlying(FailureTimer::COUNT)>;
+
+  /// Nodes whose frames are monitored, FailureTimer::PC to FailureTimer::CELLS
+  static constexpr std::size_t HEARTBEAT_COUNT = to_underlying(FailureTimer::CELLS) + 1;
+  static constexpr Deadlines::Mask HEARTBEATS = (1U << HEARTBEAT_COUNT) - 1;
+
+  /// The heartbeats that the car cannot drive without, any of them expired is a component timeout
+  static constexpr Deadlines::Mask COMPONENTS =
+      1U << to_underlying(FailureTimer::PC) | 1U << to_underlying(FailureTimer::STEERING) |
+      1U << to_underlying(FailureTimer::INVERTER) | 1U << to_underlying(FailureTimer::RES);
+
+  Deadlines deadlines_{{COMPONENT_TIMESTAMP_TIMEOUT, COMPONENT_TIMESTAMP_TIMEOUT,
+                        COMPONENT_TIMESTAMP_TIMEOUT, RES_TIMESTAMP_TIMEOUT,
+                        COMPONENT_TIMESTAMP_TIMEOUT, COMPONENT_TIMESTAMP_TIMEOUT,
+                        DC_VOLTAGE_TIMEOUT, DC_VOLTAGE_HOLD}};
   bool steer_dead_{false};
   bool pc_dead_{false};
   bool inversor_dead_{false};
@@ -72,28 +109,54 @@ struct FailureDetection {
   double radio_quality_{0};
   unsigned dc_voltage_{0};
 
-  [[nodiscard]] bool has_any_component_timed_out() {  // no discard makes return value non ignorable
+  void kick(const FailureTimer timer) { deadlines_.kick(to_underlying(timer)); }
+
+  [[nodiscard]] bool expired(const FailureTimer timer) const {
+    return deadlines_.expired(to_underlying(timer));
+  }
 
-    steer_dead_ = steer_alive_timestamp_.checkWithoutReset();
-    pc_dead_ = pc_alive_timestamp_.checkWithoutReset();
-    inversor_dead_ = inversor_alive_timestamp_.checkWithoutReset();
-    res_dead_ = res_signal_loss_timestamp_.checkWithoutReset();
-    if (steer_dead_ || pc_dead_ || inversor_dead_ || res_dead_) {
-      DEBUG_PRINT("=== System Component Status Check ===");
+  /**
+   * @brief Moves the deadlines to `now_ms` and refreshes the dead flags, once per loop()
+   */
+  void tick(const uint32_t now_ms) {
+    const Deadlines::Mask newly_expired = deadlines_.tick(now_ms) & HEARTBEATS;
+    steer_dead_ = expired(FailureTimer::STEERING);
+    pc_dead_ = expired(FailureTimer::PC);
+    inversor_dead_ = expired(FailureTimer::INVERTER);
+    res_dead_ = expired(FailureTimer::RES);
+    if (newly_expired == 0) return;
+    DEBUG_PRINT("=== System Component Status Check ===");
+    if (newly_expired & 1U << to_underlying(FailureTimer::STEERING)) {
+      DEBUG_PRINT("Steering System: DEAD");
     }
-    if (steer_dead_) {
-      DEBUG_PRINT("Steering System: " + String(steer_dead_ ? "DEAD" : "ALIVE"));
+    if (newly_expired & 1U << to_underlying(FailureTimer::PC)) {
+      DEBUG_PRINT("PC Connection: DEAD");
     }
-    if (pc_dead_) {
-      DEBUG_PRINT("PC Connection: " + String(pc_dead_ ? "DEAD" : "ALIVE"));
+    if (newly_expired & 1U << to_underlying(FailureTimer::INVERTER)) {
+      DEBUG_PRINT("Inverter Status: DEAD");
     }
-    if (inversor_dead_) {
-      DEBUG_PRINT("Inverter Status: " + String(inversor_dead_ ? "DEAD" : "ALIVE"));
+    if (newly_expired & 1U << to_underlying(FailureTimer::RES)) {
+      DEBUG_PRINT("RES Signal: DEAD");
     }
-    if (res_dead_) {
-      DEBUG_PRINT("RES Signal: " + String(res_dead_ ? "DEAD" : "ALIVE"));
+    if (newly_expired & 1U << to_underlying(FailureTimer::DASH)) {
+      DEBUG_PRINT("Dash: DEAD");
     }
+    if (newly_expired & 1U << to_underlying(FailureTimer::CELLS)) {
+      DEBUG_PRINT("Cells: DEAD");
+    }
+  }
 
-    return steer_dead_ || pc_dead_ || inversor_dead_ || res_dead_;
+  /**
+   * @brief Packed alive bitmask of the heartbeats, bit i is FailureTimer i
+   */
+  [[nodiscard]] uint8_t alive() const {
+    return static_cast<uint8_t>(~deadlines_.expired() & HEARTBEATS);
+  }
+
+  /**
+   * @brief Any heartbeat expired as of the last tick
+   */
+  [[nodiscard]] bool has_any_component_timed_out() const {
+    return (deadlines_.expired() & COMPONENTS) != 0;
   }
 };
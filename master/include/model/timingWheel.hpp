@@ -0,0 +1,166 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Per-timer history of a TimingWheel, since construction or the last reset_stats()
+ */
+struct DeadlineStats {
+  uint32_t max_gap_ms = 0;   ///< Longest time between two kicks, or from a kick to its expiry
+  uint32_t near_misses = 0;  ///< Kicks that came after NEAR_MISS_PERCENT of the timeout
+  uint32_t expirations = 0;
+  uint32_t kicks = 0;
+  uint32_t min_gap_ms = UINT32_MAX;  ///< Shortest time between two kicks
+  uint64_t total_gap_ms = 0;         ///< Sum of the times between kicks
+
+  /**
+   * @brief Mean time between kicks, the period of a heartbeat
+   */
+  [[nodiscard]] uint32_t mean_gap_ms() const {
+    return kicks == 0 ? 0 : static_cast<uint32_t>(total_gap_ms / kicks);
+  }
+
+  /**
+   * @brief Peak to peak spread of the time between kicks
+   */
+  [[nodiscard]] uint32_t jitter_ms() const {
+    return kicks == 0 ? 0 : std::max(max_gap_ms, min_gap_ms) - min_gap_ms;
+  }
+};
+
+/**
+ * @brief Hashed timing wheel of up to 32 restartable timeouts, a deadline queue for the
+ * heartbeats and timestamps of the model
+ * @details Timer i has a fixed timeout. kick(i) restarts it: its bit moves from the wheel slot
+ * of its old deadline to the slot of the new one, O(1). tick() takes the one clock sample of a
+ * loop() iteration and visits only the slots the clock went past since the previous tick,
+ * usually none or one, expiring the timers in them whose deadline has come (a slot also holds
+ * deadlines one or more turns of the wheel away, those are left for later). The state is then a
+ * bitmask: expired() is a single read, and tick() returns the timers that expired on it, so
+ * callers can react to the transition once instead of polling each timer.
+ *
+ * Kicks are stamped with the time of the last tick, so within a loop() iteration everything
+ * agrees on one "now". The wheel holds no pointers, so the SystemData copies stay plain values.
+ */
+template <std::size_t TIMERS, std::size_t SLOTS = 64, uint32_t SLOT_MS = 16>
+class TimingWheel {
+  static_assert(TIMERS > 0 && TIMERS <= 32, "one bit per timer in a 32-bit mask");
+  static_assert(SLOTS > 0 && (SLOTS & (SLOTS - 1)) == 0, "the slot index is a mask");
+
+public:
+  using Mask = uint32_t;
+
+  /// A kick after this share of the timeout counts as a near miss
+  static constexpr uint32_t NEAR_MISS_PERCENT = 80;
+
+  /**
+   * @brief Every timer starts running now, as a Metro does when it is constructed
+   */
+  explicit TimingWheel(const std::array<uint32_t, TIMERS> &timeouts_ms)
+      : timeouts_ms_(timeouts_ms), now_ms_(static_cast<uint32_t>(millis())) {
+    for (std::size_t i = 0; i < TIMERS; i++) arm(i, now_ms_ + timeouts_ms_[i]);
+    last_kick_ms_.fill(now_ms_);
+  }
+
+  /**
+   * @brief Restarts timer `i` from the last tick, clearing its expiry
+   */
+  void kick(const std::size_t i) {
+    const uint32_t gap = now_ms_ - last_kick_ms_[i];
+    DeadlineStats &stats = stats_[i];
+    stats.kicks++;
+    stats.total_gap_ms += gap;
+    stats.min_gap_ms = std::min(stats.min_gap_ms, gap);
+    note_gap(i, gap);
+    const uint64_t limit = uint64_t{timeouts_ms_[i]} * NEAR_MISS_PERCENT;
+    if (gap < timeouts_ms_[i] && uint64_t{gap} * 100 > limit) stats.near_misses++;
+    last_kick_ms_[i] = now_ms_;
+    disarm(i);
+    arm(i, now_ms_ + timeouts_ms_[i]);
+  }
+
+  /**
+   * @brief Metro::check() for timer `i`: when expired, restarts it one timeout after its
+   * previous deadline rather than from now
+   * @return True when it was expired
+   */
+  bool consume(const std::size_t i) {
+    if ((expired_ & bit(i)) == 0) return false;
+    const uint32_t deadline_ms = deadline_ms_[i] + timeouts_ms_[i];
+    if (static_cast<int32_t>(now_ms_ - deadline_ms) >= 0) {
+      deadline_ms_[i] = deadline_ms;  // more than a timeout behind, still expired
+    } else {
+      arm(i, deadline_ms);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Moves the wheel to `now_ms`
+   * @return The timers that expired on this tick
+   */
+  Mask tick(const uint32_t now_ms) {
+    const uint32_t from = now_ms_ / SLOT_MS;
+    const uint32_t to = now_ms / SLOT_MS;
+    now_ms_ = now_ms;
+    Mask newly_expired = 0;
+    const uint32_t slots = to - from >= SLOTS ? SLOTS : to - from + 1;
+    for (uint32_t s = 0; s < slots; s++) {
+      const std::size_t slot = (from + s) & (SLOTS - 1);
+      for (Mask pending = slots_[slot]; pending != 0; pending &= pending - 1) {
+        const auto i = static_cast<std::size_t>(__builtin_ctz(pending));
+        if (static_cast<int32_t>(now_ms - deadline_ms_[i]) < 0) continue;  // a later turn
+        disarm(i);
+        expired_ |= bit(i);
+        newly_expired |= bit(i);
+        stats_[i].expirations++;
+        note_gap(i, now_ms - last_kick_ms_[i]);
+      }
+    }
+    return newly_expired;
+  }
+
+  [[nodiscard]] Mask expired() const { return expired_; }
+  [[nodiscard]] bool expired(const std::size_t i) const { return (expired_ & bit(i)) != 0; }
+  [[nodiscard]] uint32_t now_ms() const { return now_ms_; }
+  [[nodiscard]] const DeadlineStats &stats(const std::size_t i) const { return stats_[i]; }
+
+  /**
+   * @brief Starts a new statistics window for timer `i`, its deadline is left alone
+   */
+  void reset_stats(const std::size_t i) { stats_[i] = {}; }
+
+private:
+  std::array<uint32_t, TIMERS> timeouts_ms_;
+  std::array<uint32_t, TIMERS> deadline_ms_{};
+  std::array<uint32_t, TIMERS> last_kick_ms_{};
+  std::array<DeadlineStats, TIMERS> stats_{};
+  std::array<Mask, SLOTS> slots_{};  ///< Running timers by the slot of their deadline
+  Mask armed_ = 0;
+  Mask expired_ = 0;
+  uint32_t now_ms_;
+
+  static constexpr Mask bit(const std::size_t i) { return Mask{1} << i; }
+  static constexpr std::size_t slot_of(const uint32_t ms) { return (ms / SLOT_MS) & (SLOTS - 1); }
+
+  void arm(const std::size_t i, const uint32_t deadline_ms) {
+    deadline_ms_[i] = deadline_ms;
+    slots_[slot_of(deadline_ms)] |= bit(i);
+    armed_ |= bit(i);
+    expired_ &= ~bit(i);
+  }
+
+  void disarm(const std::size_t i) {
+    if ((armed_ & bit(i)) != 0) slots_[slot_of(deadline_ms_[i])] &= ~bit(i);
+    armed_ &= ~bit(i);
+  }
+
+  void note_gap(const std::size_t i, const uint32_t gap_ms) {
+    if (gap_ms > stats_[i].max_gap_ms) stats_[i].max_gap_ms = gap_ms;
+  }
+};
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+
+#include "TeensyTimerTool.h"
+#include "loopProfiler.hpp"
+
+#ifdef NATIVE
+#include <cstdio>
+#endif
+
+/**
+ * @brief Every periodic interrupt task of the board, run from a single hardware timer
+ * @details Tasks are kept sorted by priority, 0 first, and the timer ticks at the greatest common
+ * divisor of the enabled periods, so each tick runs the tasks released on it in priority order
+ * and nothing else can preempt them. Release times are kept on the ideal tick grid, never
+ * re-read from micros(), so periods do not drift; a task is identified by its callback.
+ *
+ * A release is a deadline miss when the task could not start before the next one was due (its
+ * tick came a whole period late, or never came) or when it finished after it. Tasks are added,
+ * enabled and disabled from loop(); those change the table under noInterrupts().
+ */
+class TimerScheduler {
+public:
+  using Callback = void (*)();
+
+  static constexpr std::size_t MAX_TASKS = 8;
+
+  struct TaskStats {
+    uint32_t releases = 0;
+    uint32_t deadline_misses = 0;
+    uint32_t max_lateness_us = 0;  ///< Worst start after the release time
+    CycleHistogram execution;      ///< Run time, in profiler_cycles()
+  };
+
+  /**
+   * @brief Registers `callback`, or changes its period and priority if it already is
+   * @return False when the table is full or the period is 0
+   */
+  static bool add(const char *name, const Callback callback, const uint32_t period_us,
+                  const uint8_t priority, const bool enabled = true) {
+    if (period_us == 0) return false;
+    noInterrupts();
+    Task *task = find(callback);
+    if (task == nullptr && count_ < MAX_TASKS) {
+      task = &tasks_[count_++];
+      *task = Task{};
+    }
+    if (task != nullptr) {
+      task->name = name;
+      task->callback = callback;
+      task->period_us = period_us;
+      task->priority = priority;
+      task->enabled = enabled;
+      task->next_release_us = grid_us_ + period_us;
+      sort();
+    }
+    interrupts();
+    if (task != nullptr) retune();
+    return task != nullptr;
+  }
+
+  static void enable(const Callback callback) { set_enabled(callback, true); }
+  static void disable(const Callback callback) { set_enabled(callback, false); }
+
+  [[nodiscard]] static bool enabled(const Callback callback) {
+    const Task *task = find(callback);
+    return task != nullptr && task->enabled;
+  }
+
+  /**
+   * @return Statistics of the task, nullptr if it was never added
+   */
+  [[nodiscard]] static const TaskStats *stats(const Callback callback) {
+    const Task *task = find(callback);
+    return task == nullptr ? nullptr : &task->stats;
+  }
+
+  /**
+   * @brief Period of the hardware timer, 0 while no task is enabled
+   */
+  [[nodiscard]] static uint32_t tick_us() { return tick_us_; }
+  [[nodiscard]] static uint32_t ticks() { return ticks_; }
+  [[nodiscard]] static std::size_t size() { return count_; }
+  [[nodiscard]] static const char *name(const std::size_t i) { return tasks_[i].name; }
+  [[nodiscard]] static const TaskStats &stats_at(const std::size_t i) { return tasks_[i].stats; }
+
+  /**
+   * @brief The timer interrupt: moves the grid one tick, or more if ticks were lost, and runs the
+   * tasks released up to it
+   */
+  static void tick() {
+    const auto now = static_cast<uint32_t>(micros());
+    grid_us_ += tick_us_;
+    const auto behind = static_cast<int32_t>(now - grid_us_);
+    if (behind >= static_cast<int32_t>(tick_us_)) {
+      grid_us_ += behind / tick_us_ * tick_us_;  // the interrupt was held off, ticks were lost
+    }
+    ticks_++;
+    for (std::size_t i = 0; i < count_; i++) {
+      Task &task = tasks_[i];
+      if (!task.enabled || static_cast<int32_t>(grid_us_ - task.next_release_us) < 0) continue;
+      const uint32_t skipped = (grid_us_ - task.next_release_us) / task.period_us;
+      task.stats.deadline_misses += skipped;
+      const uint32_t release_us = task.next_release_us + skipped * task.period_us;
+      task.next_release_us = release_us + task.period_us;
+
+      const auto start_us = static_cast<uint32_t>(micros());
+      const uint32_t start_cycles = profiler_cycles();
+      task.callback();
+      task.stats.execution.add(profiler_cycles() - start_cycles);
+      task.stats.releases++;
+      const int32_t lateness = static_cast<int32_t>(start_us - release_us);
+      if (lateness > 0 && static_cast<uint32_t>(lateness) > task.stats.max_lateness_us) {
+        task.stats.max_lateness_us = lateness;
+      }
+      const auto end_us = static_cast<uint32_t>(micros());
+      if (end_us - release_us > task.period_us) task.stats.deadline_misses++;  // overran its slot
+    }
+  }
+
+  static void reset_stats() {
+    noInterrupts();
+    for (std::size_t i = 0; i < count_; i++) tasks_[i].stats = {};
+    ticks_ = 0;
+    interrupts();
+  }
+
+  /**
+   * @brief Stops the timer and forgets every task
+   */
+  static void reset() {
+    timer_.stop();
+    count_ = 0;
+    tick_us_ = 0;
+    ticks_ = 0;
+  }
+
+private:
+  struct Task {
+    const char *name = "";
+    Callback callback = nullptr;
+    uint32_t period_us = 0;
+    uint8_t priority = 0;
+    bool enabled = false;
+    uint32_t next_release_us = 0;
+    TaskStats stats;
+  };
+
+  static std::array<Task, MAX_TASKS> tasks_;
+  inline static std::size_t count_ = 0;
+  inline static TeensyTimerTool::PeriodicTimer timer_;
+  inline static uint32_t tick_us_ = 0;
+  inline static uint32_t grid_us_ = 0;  ///< Ideal time of the last tick
+  inline static uint32_t ticks_ = 0;
+
+  static Task *find(const Callback callback) {
+    for (std::size_t i = 0; i < count_; i++) {
+      if (tasks_[i].callback == callback) return &tasks_[i];
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Insertion sort by priority, stable so equal priorities run in the order they were added
+   */
+  static void sort() {
+    for (std::size_t i = 1; i < count_; i++) {
+      for (std::size_t j = i; j > 0 && tasks_[j - 1].priority > tasks_[j].priority; j--) {
+        std::swap(tasks_[j - 1], tasks_[j]);
+      }
+    }
+  }
+
+  static void set_enabled(const Callback callback, const bool enabled) {
+    noInterrupts();
+    Task *task = find(callback);
+    const bool changed = task != nullptr && task->enabled != enabled;
+    if (changed) {
+      task->enabled = enabled;
+      task->next_release_us = grid_us_ + task->period_us;
+    }
+    interrupts();
+    if (changed) retune();
+  }
+
+  /**
+   * @brief Restarts the hardware timer when the greatest common divisor of the enabled periods
+   * changed, releases are moved onto the new grid
+   */
+  static void retune() {
+    uint32_t period_us = 0;
+    for (std::size_t i = 0; i < count_; i++) {
+      if (tasks_[i].enabled) period_us = std::gcd(period_us, tasks_[i].period_us);
+    }
+    if (period_us == tick_us_) return;
+
+    timer_.stop();
+    noInterrupts();
+    tick_us_ = period_us;
+    grid_us_ = static_cast<uint32_t>(micros());
+    for (std::size_t i = 0; i < count_; i++) {
+      tasks_[i].next_release_us = grid_us_ + tasks_[i].period_us;
+    }
+    interrupts();
+    if (period_us != 0) timer_.begin([] { tick(); }, period_us);
+  }
+};
+
+inline std::array<TimerScheduler::Task, TimerScheduler::MAX_TASKS> TimerScheduler::tasks_{};
+
+#ifdef NATIVE
+/**
+ * @brief Prints the releases, deadline misses, worst lateness and run time of every task
+ */
+inline void print_timer_tasks(FILE *out) {
+  const double per_us = profiler_cycles_per_us();
+  fprintf(out, "timer tick %u us\n", TimerScheduler::tick_us());
+  fprintf(out, "%-24s %10s %10s %10s %10s %10s\n", "task", "releases", "misses", "late_us",
+          "p99_us", "max_us");
+  for (std::size_t i = 0; i < TimerScheduler::size(); i++) {
+    const TimerScheduler::TaskStats &stats = TimerScheduler::stats_at(i);
+    fprintf(out, "%-24s %10u %10u %10u %10.3f %10.3f\n", TimerScheduler::name(i), stats.releases,
+            stats.deadline_misses, stats.max_lateness_us,
+            stats.execution.percentile(990) / per_us, stats.execution.max() / per_us);
+  }
+}
+#endif
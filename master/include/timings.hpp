@@ -2,7 +2,5 @@
 
 // timer constants
 constexpr auto LEFT_WHEEL_PUBLISH_INTERVAL = 1;  // 1 millisecond
-constexpr auto STATE_PUBLISH_INTERVAL = 40;      // 50 millisecond
-constexpr auto MISSION_PUBLISH_INTERVAL = 100;   // 100 millisecond
 constexpr auto CHECKUP_INTERVAL = 50; // 50 millisecond
 constexpr auto LOOP_DELAY = 5; // 1 millisecond
\ No newline at end of file
@@ -1,26 +1,7 @@
 #pragma once
 #include <cstdint>
-#include <deque>
-#include <numeric>
 
-void insert_value_queue(const int value, std::deque<int>& queue) {
-  queue.push_front(value);
-
-  if (queue.size() > 5) {
-    queue.pop_back();
-  }
-}
-
-int average_queue(const std::deque<int>& queue) {
-  int avg = 0;
-  if (!queue.empty()) {
-    const double sum = std::accumulate(queue.begin(), queue.end(), 0);
-    avg = static_cast<int>(sum / queue.size());
-  }
-  return avg;
-}
-
-bool check_sequence(const uint8_t* data, const std::array<uint8_t, 3>& expected) {
+inline bool check_sequence(const uint8_t* data, const std::array<uint8_t, 3>& expected) {
   return (data[1] == expected[0] && data[2] == expected[1] && data[3] == expected[2]);
 }
 
@@ -29,7 +10,7 @@ union float2bytes {
   char output[4];
 };
 
-void rpm_2_byte(const float rr_rpm, /* const */ char* rr_rpm_byte) {
+inline void rpm_2_byte(const float rr_rpm, /* const */ char* rr_rpm_byte) {
   float2bytes data;
   /*
   1st we multiply rpm by 100 to get a 2 decimal place value.
@@ -55,7 +36,7 @@ void rpm_2_byte(const float rr_rpm, /* const */ char* rr_rpm_byte) {
  * @param counter Reference to the counter for this specific input
  * @param counter_limit Number of consecutive different readings before accepting change
  */
-void debounce(const bool new_value, bool& stored_value, unsigned int& counter,
+inline void debounce(const bool new_value, bool& stored_value, unsigned int& counter,
               const unsigned int counter_limit) {
   if (new_value == stored_value) {
     counter = 0;
@@ -68,6 +49,6 @@ void debounce(const bool new_value, bool& stored_value, unsigned int& counter,
   }
 }
 
-void debounce(const bool new_value, bool& stored_value, unsigned int& counter) {
+inline void debounce(const bool new_value, bool& stored_value, unsigned int& counter) {
   debounce(new_value, stored_value, counter, CHANGE_COUNTER_LIMIT);
 }
\ No newline at end of file
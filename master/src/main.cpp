@@ -6,11 +6,12 @@
 #include "logic/outputCoordinator.hpp"
 #include "logic/stateLogic.hpp"
 #include "model/systemData.hpp"
+#include "timerScheduler.hpp"
 #include "timings.hpp"
 
 SystemData system_data;
 SystemData
-    system_data_copy;  // Copy of the model for Communicator (where interrupt updates are stored)
+    system_data_copy;  // Copy of the model for Communicator and DigitalReceiver (input updates)
 Communicator communicator = Communicator(&system_data_copy);  // CAN
 DigitalReceiver digital_receiver =
     DigitalReceiver(&system_data_copy);
@@ -18,35 +19,60 @@ DigitalSender digital_sender = DigitalSender();
 OutputCoordinator output_coordinator =
     OutputCoordinator(&system_data, &communicator, &digital_sender);
 ASState as_state = ASState(&system_data, &communicator, &output_coordinator);
-TeensyTimerTool::PeriodicTimer watchdog_timer_;
 bool is_first_loop = true;
 void setup() {
   Serial.begin(9600);
   Communicator::_systemData = &system_data_copy;
   communicator.init();
   output_coordinator.init();
+  TimerScheduler::add("watchdog_toggle", DigitalSender::toggle_watchdog, WATCHDOG_TOGGLE_PERIOD_US,
+                      WATCHDOG_TOGGLE_PRIORITY, false);
   DEBUG_PRINT("Starting up...");
   delay(100);
   
 }
 
 void loop() {
+  PROFILE_STAGE(LOOP);
   if (is_first_loop) {
-    watchdog_timer_.begin([] { DigitalSender::toggle_watchdog(); }, 10'000);
+    TimerScheduler::enable(DigitalSender::toggle_watchdog);
     is_first_loop = false;
   }
-  digitalWrite(WD_SDC_CLOSE, HIGH);
-  digital_receiver.digital_reads();
-  noInterrupts();
-  system_data_copy.hardware_data_.master_sdc_closed_ = system_data.hardware_data_.master_sdc_closed_;
-  system_data = system_data_copy;
-  interrupts();
-
-  as_state.calculate_state();
+  DigitalSender::close_watchdog_sdc();  // only reaches the pin the first time
+  system_data_copy.tick(millis());  // before the inputs kick and read the deadlines
+  {
+    PROFILE_STAGE(DIGITAL_READS);
+    digital_receiver.digital_reads();
+  }
+  {
+    PROFILE_STAGE(CAN_RECEIVE);
+    Communicator::process_received();
+  }
+  {
+    // No interrupt handler reads or writes SystemData: the CAN FIFO interrupt only queues frames
+    // for process_received(), the wheel sensors fill the wheel_speed pulse rings and the timer
+    // tasks toggle WD_ALIVE or raise an EmergencyEvent. The copy needs no interrupt mask.
+    PROFILE_STAGE(SYSTEM_DATA_COPY);
+    system_data_copy.hardware_data_.master_sdc_closed_ = system_data.hardware_data_.master_sdc_closed_;
+    system_data = system_data_copy;
+  }
+  {
+    PROFILE_STAGE(CALCULATE_STATE);
+    as_state.calculate_state();
+  }
 
   uint8_t current_master_state = to_underlying(as_state.state_);
   uint8_t current_checkup_state = to_underlying(as_state._checkup_manager_.checkup_state_);
 
-  output_coordinator.process(current_master_state, current_checkup_state);
+  {
+    PROFILE_STAGE(OUTPUT_PROCESS);
+    output_coordinator.process(current_master_state, current_checkup_state);
+  }
+  {
+    // Frames queued this iteration, RES_ACTIVATE ahead of the status and debug frames
+    PROFILE_STAGE(CAN_TRANSMIT);
+    Communicator::process_transmit();
+  }
+  DEBUG_DRAIN();
 
-} 
\ No newline at end of file
+} 
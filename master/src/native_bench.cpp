@@ -0,0 +1,278 @@
+// Host micro-benchmarks for hot paths of the master firmware, native (Linux host) build only
+#ifdef NATIVE_BENCH
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <numeric>
+
+#include "../../CAN_dispatch.h"
+#include "../../CAN_messages.h"
+#include "../../debug_log.h"
+#include "../../moving_average.h"
+#include "../../running_median.h"
+#include "comm/communicator.hpp"
+#include "comm/utils.hpp"
+#include "model/systemData.hpp"
+
+std::size_t allocations = 0;  // counted by the replacement operator new below
+
+void *operator new(const std::size_t size) {
+  allocations++;
+  if (void *block = std::malloc(size == 0 ? 1 : size)) return block;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *block) noexcept { std::free(block); }
+void operator delete(void *block, std::size_t) noexcept { std::free(block); }
+
+namespace {
+
+constexpr int ITERATIONS = 10'000'000;
+
+volatile uint32_t sink;  // keeps the optimizer from dropping the measured work
+
+/**
+ * @brief Average time of one call to op(i), in nanoseconds
+ */
+template <class Op>
+double ns_per_op(Op &&op) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; i++) op(i);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+}
+
+void report(const char *name, const double hand_ns, const double generated_ns) {
+  printf("%-28s %8.2f ns %8.2f ns %7.2fx\n", name, hand_ns, generated_ns, hand_ns / generated_ns);
+}
+
+/**
+ * @brief The DBG_LOG_MSG_2 encoder as it was written before CAN_messages.h existed
+ */
+std::array<uint8_t, 8> hand_debug_message_2(const SystemData &data) {
+  return {DBG_LOG_MSG_2,
+          static_cast<uint8_t>((data.failure_detection_.dc_voltage_ >> 24) & 0xFF),
+          static_cast<uint8_t>((data.failure_detection_.dc_voltage_ >> 16) & 0xFF),
+          static_cast<uint8_t>((data.failure_detection_.dc_voltage_ >> 8) & 0xFF),
+          static_cast<uint8_t>(data.failure_detection_.dc_voltage_ & 0xFF),
+          static_cast<uint8_t>(data.hardware_data_.pneumatic_line_pressure_1_ & 0x01),
+          static_cast<uint8_t>(data.hardware_data_.pneumatic_line_pressure_2_ & 0x01),
+          static_cast<uint8_t>(data.hardware_data_.master_sdc_closed_ & 0x01)};
+}
+
+void bench_can_codec() {
+  SystemData data;
+  printf("\nCAN codec (hand-written vs generated from conf.dbc)\n");
+
+  report("encode DBG_LOG_MSG_2",
+         ns_per_op([&](const int i) {
+           data.failure_detection_.dc_voltage_ = i;
+           sink = hand_debug_message_2(data)[2];
+         }),
+         ns_per_op([&](const int i) {
+           data.failure_detection_.dc_voltage_ = i;
+           sink = create_debug_message_2(data)[2];
+         }));
+
+  uint8_t buf[8] = {BAMOCAR_BATTERY_VOLTAGE_CODE, 0, 0};
+  report("decode bamocar dc voltage",
+         ns_per_op([&](const int i) {
+           buf[1] = static_cast<uint8_t>(i);
+           sink = static_cast<unsigned>((buf[2] << 8) | buf[1]);
+         }),
+         ns_per_op([&](const int i) {
+           buf[1] = static_cast<uint8_t>(i);
+           sink = can_db::BamocarTx::M235::unpack(buf).dc_voltage;
+         }));
+}
+
+uint32_t handled[6];
+
+// Same out-of-line work behind both dispatchers, like the real callbacks: only the lookup differs
+[[gnu::noinline]] void on_as_cu(const CAN_message_t &msg) { handled[0] += msg.buf[0]; }
+[[gnu::noinline]] void on_res_state(const CAN_message_t &msg) { handled[1] += msg.buf[0]; }
+[[gnu::noinline]] void on_res_ready(const CAN_message_t &msg) { handled[2] += msg.buf[0]; }
+[[gnu::noinline]] void on_bamocar(const CAN_message_t &msg) { handled[3] += msg.buf[0]; }
+[[gnu::noinline]] void on_steering(const CAN_message_t &msg) { handled[4] += msg.buf[0]; }
+[[gnu::noinline]] void on_dash(const CAN_message_t &msg) { handled[5] += msg.buf[0]; }
+
+/**
+ * @brief The switch Communicator::parse_message used before the dispatch table
+ */
+void switch_dispatch(const CAN_message_t &msg) {
+  switch (msg.id) {
+    case AS_CU_ID:
+      on_as_cu(msg);
+      break;
+    case RES_STATE:
+      on_res_state(msg);
+      break;
+    case RES_READY:
+      on_res_ready(msg);
+      break;
+    case BAMO_RESPONSE_ID:
+      on_bamocar(msg);
+      break;
+    case STEERING_ID:
+      on_steering(msg);
+      break;
+    case DASH_ID:
+      on_dash(msg);
+      break;
+    default:
+      break;
+  }
+}
+
+constexpr auto bench_table = can_dispatch::make_table<void (*)(const CAN_message_t &)>({
+    {AS_CU_ID, false, on_as_cu},
+    {RES_STATE, false, on_res_state},
+    {RES_READY, false, on_res_ready},
+    {BAMO_RESPONSE_ID, false, on_bamocar},
+    {STEERING_ID, true, on_steering},
+    {DASH_ID, false, on_dash},
+});
+
+void bench_can_dispatch() {
+  // Frames in the proportions they arrive in on the car: the inverter and steering dominate
+  std::array<CAN_message_t, 64> frames{};
+  constexpr std::array<std::pair<uint32_t, bool>, 8> mix = {{{BAMO_RESPONSE_ID, false},
+                                                            {STEERING_ID, true},
+                                                            {BAMO_RESPONSE_ID, false},
+                                                            {RES_STATE, false},
+                                                            {STEERING_ID, true},
+                                                            {AS_CU_ID, false},
+                                                            {DASH_ID, false},
+                                                            {BAMO_RESPONSE_ID, false}}};
+  for (std::size_t i = 0; i < frames.size(); i++) {
+    frames[i].id = mix[(i * 5 + i / 8) % mix.size()].first;  // not a fixed period
+    frames[i].flags.extended = mix[(i * 5 + i / 8) % mix.size()].second;
+    frames[i].buf[0] = static_cast<uint8_t>(i);
+  }
+  printf("\nCAN receive dispatch (switch vs constexpr table)\n");
+  report("dispatch per frame",
+         ns_per_op([&](const int i) { switch_dispatch(frames[i & 63]); }),
+         ns_per_op([&](const int i) {
+           if (const auto *handler = bench_table.find(frames[i & 63])) (*handler)(frames[i & 63]);
+         }));
+  sink = handled[0] + handled[3];
+}
+
+void bench_can_receive_isr() {
+  SystemData data;
+  Communicator communicator(&data);
+  communicator.init();
+  SpscQueue<CAN_message_t, RX_QUEUE_CAPACITY> queue;  // what receive_isr() pushes into
+  CAN_message_t msg;
+  msg.id = BAMO_RESPONSE_ID;
+  msg.len = 3;
+  msg.buf[0] = BAMOCAR_BATTERY_VOLTAGE_CODE;
+
+  printf("\nCAN receive interrupt (decode in the ISR vs queue for loop())\n");
+  report("time in FIFO interrupt",
+         ns_per_op([&](const int i) {
+           msg.buf[1] = static_cast<uint8_t>(i);
+           Communicator::parse_message(msg);
+         }),
+         ns_per_op([&](const int i) {
+           msg.buf[1] = static_cast<uint8_t>(i);
+           queue.push(msg);
+           if ((i & 63) == 63) queue.reset();  // loop() drains in between, outside the ISR
+         }));
+  sink = data.failure_detection_.dc_voltage_ + queue.size();
+}
+
+void bench_debug_log() {
+  SystemData data;
+  printf("\nDebug log call (String building, Serial not counted, vs tokenized ring)\n");
+  report("hydraulic pressure line",
+         ns_per_op([&](const int i) {
+           data.hardware_data_._hydraulic_line_pressure = i;
+           const String line = "Hydraulic Pressure: " +
+                               String(data.hardware_data_._hydraulic_line_pressure) + " - " +
+                               String(data.hardware_data_.hydraulic_line_front_pressure);
+           sink = line.length();
+         }),
+         ns_per_op([&](const int i) {
+           data.hardware_data_._hydraulic_line_pressure = i;
+           DEBUG_LOG("Hydraulic Pressure: {} - {}", data.hardware_data_._hydraulic_line_pressure,
+                     data.hardware_data_.hydraulic_line_front_pressure);
+           if ((i & 63) == 63) debug_log::ring.reset();  // drained at idle time, outside the call
+         }));
+  sink = debug_log::ring.pending();
+}
+
+void bench_moving_average() {
+  std::deque<int> queue;
+  MovingAverage<uint16_t, BRAKE_READINGS_SAMPLES> average;  // what DigitalReceiver keeps
+  printf("\nBrake sensor moving average per sample (std::deque vs MovingAverage)\n");
+  const std::size_t allocations_before = allocations;
+  const double deque_ns = ns_per_op([&](const int i) {
+    queue.push_front(i & 1023);  // insert_value_queue + average_queue as they were
+    if (queue.size() > BRAKE_READINGS_SAMPLES) queue.pop_back();
+    const double sum = std::accumulate(queue.begin(), queue.end(), 0);
+    sink = static_cast<int>(sum / queue.size());
+  });
+  const std::size_t deque_allocations = allocations - allocations_before;
+  const double ring_ns = ns_per_op([&](const int i) {
+    average.add(static_cast<uint16_t>(i & 1023));
+    sink = average.average();
+  });
+  report("add + average", deque_ns, ring_ns);
+  printf("%-28s %11zu %11zu\n", "heap allocations", deque_allocations,
+         allocations - allocations_before - deque_allocations);
+}
+
+/**
+ * @brief The deque mean against the median and the Hampel-filtered mean now in front of the
+ * brake light thresholds, on a noisy ADC signal
+ */
+void bench_running_median() {
+  const auto noisy = [](const int i) {
+    return static_cast<uint16_t>(300 + ((static_cast<uint32_t>(i) * 2654435761U) >> 28));
+  };
+  std::deque<int> queue;
+  RunningMedian<uint16_t, BRAKE_READINGS_SAMPLES> median;
+  HampelFilter<uint16_t, BRAKE_READINGS_SAMPLES> outliers{BRAKE_OUTLIER_MIN_DEVIATION};
+  MovingAverage<uint16_t, BRAKE_READINGS_SAMPLES> average;
+  printf("\nBrake sensor filters per sample (std::deque mean vs order statistics)\n");
+  const std::size_t allocations_before = allocations;
+  const double deque_ns = ns_per_op([&](const int i) {
+    queue.push_front(noisy(i));
+    if (queue.size() > BRAKE_READINGS_SAMPLES) queue.pop_back();
+    const double sum = std::accumulate(queue.begin(), queue.end(), 0);
+    sink = static_cast<int>(sum / queue.size());
+  });
+  const std::size_t deque_allocations = allocations - allocations_before;
+  const double median_ns = ns_per_op([&](const int i) {
+    median.add(noisy(i));
+    sink = median.median();
+  });
+  const double hampel_ns = ns_per_op([&](const int i) {
+    average.add(outliers.add(noisy(i)));  // DigitalReceiver::read_brake_sensor
+    sink = average.average();
+  });
+  report("add + median", deque_ns, median_ns);
+  report("Hampel + average", deque_ns, hampel_ns);
+  printf("%-28s %11zu %11zu\n", "heap allocations", deque_allocations,
+         allocations - allocations_before - deque_allocations);
+}
+
+}  // namespace
+
+/**
+ * @brief Prints ns/op for each benchmark, `pio run -e native_bench` then run the program
+ */
+int main() {
+  printf("%-28s %11s %11s %8s\n", "", "before", "after", "speedup");
+  bench_can_codec();
+  bench_can_dispatch();
+  bench_can_receive_isr();
+  bench_debug_log();
+  bench_moving_average();
+  bench_running_median();
+  return 0;
+}
+#endif
@@ -0,0 +1,50 @@
+// Entry point of the native (Linux host) build, replaces the Teensy core main()
+#ifdef NATIVE
+#include <Arduino.h>
+#include <comm/communicator.hpp>
+#include <embedded/outputShadow.hpp>
+#include <hostProfiler.h>
+#include <loopProfiler.hpp>
+#include <timerScheduler.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+void setup();
+void loop();
+
+/**
+ * @brief Runs setup() once and loop() a fixed number of times, then prints the timing report
+ * @details Usage: program [iterations] [step_us]. Timer callbacks are serviced before every
+ * iteration, which is where their interrupts would have landed on the Teensy. With step_us the
+ * clock is virtual and advances exactly that much per iteration, so hours of car time run in
+ * seconds; without it the firmware sees real time.
+ */
+int main(int argc, char **argv) {
+  const unsigned long iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10'000;
+  const unsigned long step_us = argc > 2 ? strtoul(argv[2], nullptr, 10) : 0;
+
+  if (step_us > 0) native_hal::use_manual_clock();
+  setup();
+
+  uint64_t previous_start_ns = 0;
+  for (unsigned long i = 0; i < iterations; i++) {
+    if (step_us > 0) native_hal::advance_us(step_us);
+    native_hal::service_timers();
+    const uint64_t start_ns = native_hal::steady_ns();
+    if (previous_start_ns != 0) native_hal::stage("loop_period").add(start_ns - previous_start_ns);
+    previous_start_ns = start_ns;
+    loop();  // times itself as the "loop" stage
+  }
+
+  printf("\n%lu loop iterations, %.3f s of firmware time\n", iterations, millis() / 1e3);
+  native_hal::print_stage_report(stdout);
+  printf("\n");
+  print_loop_profile(stdout);
+  printf("\n");
+  print_timer_tasks(stdout);
+  print_output_shadow(stdout);
+  print_can_transmit(stdout);
+  return 0;
+}
+#endif
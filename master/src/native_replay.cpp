@@ -0,0 +1,53 @@
+// CAN trace replay through Communicator::parse_message on the native (Linux host) build
+#ifdef NATIVE_REPLAY
+#include <Arduino.h>
+#include <canReplay.h>
+
+#include "comm/communicator.hpp"
+#include "model/systemData.hpp"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+/**
+ * @brief Replays a candump/ASC trace and prints how SystemData evolved and the decode throughput
+ * @details Usage: program <trace> [--realtime] [--quiet]. --quiet drops the timeline, leaving
+ * only parsing, queueing and parse_message() in the measured path.
+ */
+int main(int argc, char **argv) {
+  native_hal::ReplayOptions options;
+  if (!native_hal::parse_replay_args(argc, argv, options)) return 1;
+  FILE *trace = fopen(options.path, "rb");
+  if (trace == nullptr) {
+    perror(options.path);
+    return 1;
+  }
+
+  communicator.init();
+  options.after_frame = [] {  // as loop() does, once per frame
+    system_data.tick(millis());
+    Communicator::process_received();
+  };
+
+  native_hal::StateTimeline timeline;
+  timeline.add("ts_on", [] -> int64_t { return system_data.failure_detection_.ts_on_; });
+  timeline.add("dc_voltage", [] -> int64_t { return system_data.failure_detection_.dc_voltage_; });
+  timeline.add("emergency_signal",
+               [] -> int64_t { return system_data.failure_detection_.emergency_signal_; });
+  timeline.add("component_timed_out", [] -> int64_t {
+    return system_data.failure_detection_.has_any_component_timed_out();
+  });
+  timeline.add("radio_quality",
+               [] -> int64_t { return system_data.failure_detection_.radio_quality_; });
+  timeline.add("r2d", [] -> int64_t { return system_data.r2d_logics_.r2d; });
+  timeline.add("mission_finished", [] -> int64_t { return system_data.mission_finished_; });
+  timeline.add("hydraulic_front",
+               [] -> int64_t { return system_data.hardware_data_.hydraulic_line_front_pressure; });
+
+  const auto stats = native_hal::replay_trace(trace, options, *native_hal::can_bus(CAN3),
+                                              options.timeline ? &timeline : nullptr);
+  fclose(trace);
+  native_hal::print_replay_stats(stats, stdout);
+  return 0;
+}
+#endif
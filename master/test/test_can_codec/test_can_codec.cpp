@@ -0,0 +1,160 @@
+// Generated CAN_messages.h codecs against the hand-written encoders they replaced
+#include <array>
+#include <cstdint>
+
+#include "../../CAN_messages.h"
+#include "comm/utils.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+
+/**
+ * @brief create_debug_message_1 before it was generated from conf.dbc
+ */
+std::array<uint8_t, 8> legacy_debug_message_1(const SystemData &data, const uint8_t state,
+                                              const uint8_t state_checkup) {
+  const uint8_t byte5 = (data.failure_detection_.emergency_signal_ << 7) |
+                        (data.hardware_data_.pneumatic_line_pressure_ << 6) |
+                        (data.r2d_logics_.expired(R2DTimer::ENGAGE_EBS) << 5) |
+                        (data.r2d_logics_.expired(R2DTimer::RELEASE_EBS) << 4) |
+                        (data.failure_detection_.steer_dead_ << 3) |
+                        (data.failure_detection_.pc_dead_ << 2) |
+                        (data.failure_detection_.inversor_dead_ << 1) |
+                        data.failure_detection_.res_dead_;
+  const uint8_t byte6 = (data.hardware_data_.asms_on_ << 7) | (data.failure_detection_.ts_on_ << 6) |
+                        (data.hardware_data_.tsms_sdc_closed_ << 5) | (state_checkup & 0x0F);
+  const int pressure = data.hardware_data_._hydraulic_line_pressure;
+  return {DBG_LOG_MSG,
+          static_cast<uint8_t>((pressure >> 24) & 0xFF),
+          static_cast<uint8_t>((pressure >> 16) & 0xFF),
+          static_cast<uint8_t>((pressure >> 8) & 0xFF),
+          static_cast<uint8_t>(pressure & 0xFF),
+          byte5,
+          byte6,
+          static_cast<uint8_t>((to_underlying(data.mission_) & 0x0F) | ((state & 0x0F) << 4))};
+}
+
+/**
+ * @brief create_debug_message_2 before it was generated from conf.dbc
+ */
+std::array<uint8_t, 8> legacy_debug_message_2(const SystemData &data) {
+  const unsigned voltage = data.failure_detection_.dc_voltage_;
+  return {DBG_LOG_MSG_2,
+          static_cast<uint8_t>((voltage >> 24) & 0xFF),
+          static_cast<uint8_t>((voltage >> 16) & 0xFF),
+          static_cast<uint8_t>((voltage >> 8) & 0xFF),
+          static_cast<uint8_t>(voltage & 0xFF),
+          static_cast<uint8_t>(data.hardware_data_.pneumatic_line_pressure_1_ & 0x01),
+          static_cast<uint8_t>(data.hardware_data_.pneumatic_line_pressure_2_ & 0x01),
+          static_cast<uint8_t>(data.hardware_data_.master_sdc_closed_ & 0x01)};
+}
+
+void setUp() { system_data = SystemData(); }
+
+void tearDown() {}
+
+/**
+ * @brief Every flag, field and state combination encodes exactly as the hand-written version
+ */
+void test_debug_messages_match_legacy_encoding() {
+  uint32_t seed = 0x1234'5678;
+  auto next = [&seed] {
+    seed = seed * 1'103'515'245 + 12'345;  // any deterministic sequence will do
+    return seed >> 8;
+  };
+  for (int i = 0; i < 2000; i++) {
+    const uint32_t bits = next();
+    auto &hardware = system_data.hardware_data_;
+    auto &failure = system_data.failure_detection_;
+    failure.emergency_signal_ = bits & 1 << 0;
+    hardware.pneumatic_line_pressure_ = bits & 1 << 1;
+    failure.steer_dead_ = bits & 1 << 2;
+    failure.pc_dead_ = bits & 1 << 3;
+    failure.inversor_dead_ = bits & 1 << 4;
+    failure.res_dead_ = bits & 1 << 5;
+    hardware.asms_on_ = bits & 1 << 6;
+    failure.ts_on_ = bits & 1 << 7;
+    hardware.tsms_sdc_closed_ = bits & 1 << 8;
+    hardware.pneumatic_line_pressure_1_ = bits & 1 << 9;
+    hardware.pneumatic_line_pressure_2_ = bits & 1 << 10;
+    hardware.master_sdc_closed_ = bits & 1 << 11;
+    hardware._hydraulic_line_pressure = static_cast<int>(next());
+    failure.dc_voltage_ = next();
+    system_data.mission_ = static_cast<Mission>(next() % 7);
+    const auto state = static_cast<uint8_t>(next() % 6);
+    const auto checkup = static_cast<uint8_t>(next() % 16);
+
+    const auto expected_1 = legacy_debug_message_1(system_data, state, checkup);
+    const auto actual_1 = create_debug_message_1(system_data, state, checkup);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_1.data(), actual_1.data(), 8);
+    const auto expected_2 = legacy_debug_message_2(system_data);
+    const auto actual_2 = create_debug_message_2(system_data);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_2.data(), actual_2.data(), 8);
+  }
+}
+
+/**
+ * @brief unpack(pack(x)) == x, checked at compile time for a Motorola and an Intel layout
+ */
+constexpr bool debug_message_round_trips() {
+  can_db::MasterMsgs::M52 msg;
+  msg.hydraulic_line_pressure = 0xDEAD'BEEF;
+  msg.pc_dead = true;
+  msg.checkup_state = 0x0A;
+  msg.asms_on_log = true;
+  msg.master_state_log = 5;
+  const auto buf = msg.pack();
+  const auto back = can_db::MasterMsgs::M52::unpack(buf.data());
+  return can_db::MasterMsgs::mux(buf.data()) == DBG_LOG_MSG &&
+         back.hydraulic_line_pressure == 0xDEAD'BEEF && back.pc_dead && !back.res_dead &&
+         back.checkup_state == 0x0A && back.asms_on_log && back.master_state_log == 5;
+}
+static_assert(debug_message_round_trips());
+
+constexpr bool dc_voltage_round_trips() {
+  can_db::BamocarTx::M235 msg;
+  msg.dc_voltage = 0xABCD;
+  const auto buf = msg.pack();
+  return buf[0] == BAMOCAR_BATTERY_VOLTAGE_CODE && buf[1] == 0xCD && buf[2] == 0xAB &&
+         can_db::BamocarTx::M235::unpack(buf.data()).dc_voltage == 0xABCD;
+}
+static_assert(dc_voltage_round_trips());
+
+/**
+ * @brief Signed signals keep their sign through pack()/unpack()
+ */
+void test_signed_signals_round_trip() {
+  can_db::DvDrivingDynamics1 msg;
+  msg.Steering_angle_target = -100;
+  msg.Motor_moment_actual = -7;
+  msg.Speed_actual = 200;
+  const auto buf = msg.pack();
+  TEST_ASSERT_EQUAL_HEX8(0x9C, buf[3]);
+  const auto back = can_db::DvDrivingDynamics1::unpack(buf.data());
+  TEST_ASSERT_EQUAL_INT8(-100, back.Steering_angle_target);
+  TEST_ASSERT_EQUAL_INT8(-7, back.Motor_moment_actual);
+  TEST_ASSERT_EQUAL_UINT8(200, back.Speed_actual);
+  TEST_ASSERT_EQUAL_FLOAT(-50.0f, back.Steering_angle_target_physical());
+}
+
+/**
+ * @brief The IDs and lengths come from CAN_IDs.h and the DBC
+ */
+void test_ids_and_lengths() {
+  TEST_ASSERT_EQUAL_HEX32(MASTER_ID, can_db::MasterMsgs::ID);
+  TEST_ASSERT_EQUAL_HEX32(BAMO_RESPONSE_ID, can_db::BamocarTx::ID);
+  TEST_ASSERT_EQUAL_HEX32(BMS_THERMISTOR_ID, can_db::BmsThermistorId::ID);
+  TEST_ASSERT_TRUE(can_db::BmsThermistorId::EXTENDED);
+  TEST_ASSERT_FALSE(can_db::MasterMsgs::EXTENDED);
+  TEST_ASSERT_EQUAL_UINT8(8, can_db::MasterMsgs::M52::LEN);
+  TEST_ASSERT_EQUAL_UINT8(3, can_db::BamocarTx::M235::LEN);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_debug_messages_match_legacy_encoding);
+  RUN_TEST(test_signed_signals_round_trip);
+  RUN_TEST(test_ids_and_lengths);
+  return UNITY_END();
+}
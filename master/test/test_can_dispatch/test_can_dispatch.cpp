@@ -0,0 +1,91 @@
+// Compile-time CAN dispatch table and the FIFO filters built from it, native build
+#include "../../CAN_dispatch.h"
+#include "comm/communicator.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+bool receive(const uint32_t id, std::initializer_list<uint8_t> data, const bool extended = false) {
+  CAN_message_t msg;
+  msg.id = id;
+  msg.flags.extended = extended;
+  msg.len = data.size();
+  std::copy(data.begin(), data.end(), msg.buf);
+  const bool accepted = native_hal::can_bus(CAN3)->receive(msg);
+  Communicator::process_received();
+  return accepted;
+}
+
+void setUp() {
+  native_hal::reset();
+  system_data = SystemData();
+  communicator.init();
+}
+
+void tearDown() {}
+
+int dummy_calls = 0;
+void count_a(int weight) { dummy_calls += weight; }
+void count_b(int weight) { dummy_calls += 10 * weight; }
+
+constexpr auto dummy_table = can_dispatch::make_table<void (*)(int)>({
+    {0x700, false, count_a},
+    {0x123, false, count_b},
+    {0x123, true, count_a},
+});
+
+/**
+ * @brief Routes are sorted at compile time and looked up by ID and frame format
+ */
+void test_table_lookup() {
+  static_assert(dummy_table.size() == 3);
+  static_assert(*dummy_table.find(0x700, false) == count_a);
+  static_assert(*dummy_table.find(0x123, false) == count_b);
+  static_assert(*dummy_table.find(0x123, true) == count_a);
+  static_assert(dummy_table.find(0x124, false) == nullptr);
+  static_assert(dummy_table.find(0x700, true) == nullptr);
+  dummy_calls = 0;
+  (*dummy_table.find(0x123, false))(2);
+  TEST_ASSERT_EQUAL(20, dummy_calls);
+}
+
+/**
+ * @brief The hardware accepts exactly the frames the table routes
+ */
+void test_filters_match_table() {
+  const auto *bus = native_hal::can_bus(CAN3);
+  TEST_ASSERT_TRUE(bus->reject_all);
+  TEST_ASSERT_EQUAL(receiveTable.size(), bus->filters.size());
+  for (const auto &filter : bus->filters) {
+    TEST_ASSERT_NOT_NULL(receiveTable.find(filter.id, filter.ide == EXT));
+  }
+  TEST_ASSERT_TRUE(receive(STEERING_ID, {0x00}, true));
+  TEST_ASSERT_FALSE(receive(STEERING_ID, {0x00}));  // only the extended frame is the steering
+  TEST_ASSERT_FALSE(receive(MISSION_FINISHED, {0x00}));  // payload codes, not IDs
+  TEST_ASSERT_FALSE(receive(AS_CU_EMERGENCY_SIGNAL, {0x00}));
+}
+
+/**
+ * @brief AS CU frames no longer fall through into the RES handler
+ */
+void test_as_cu_does_not_reach_res_callback() {
+  system_data.failure_detection_.radio_quality_ = 80;
+  TEST_ASSERT_TRUE(receive(AS_CU_ID, {PC_ALIVE}));
+  TEST_ASSERT_EQUAL(80, system_data.failure_detection_.radio_quality_);
+
+  TEST_ASSERT_TRUE(receive(AS_CU_ID, {MISSION_FINISHED}));
+  TEST_ASSERT_TRUE(system_data.mission_finished_);
+
+  TEST_ASSERT_TRUE(receive(RES_STATE, {0x01, 0, 0, 0x80, 0, 0, 55, 0}));
+  TEST_ASSERT_EQUAL(55, system_data.failure_detection_.radio_quality_);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_table_lookup);
+  RUN_TEST(test_filters_match_table);
+  RUN_TEST(test_as_cu_does_not_reach_res_callback);
+  return UNITY_END();
+}
@@ -0,0 +1,108 @@
+// Trace parsing and replay into Communicator::parse_message on the native build
+#include <canReplay.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include "comm/communicator.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+bool parse(const char *line, native_hal::TraceFrame &frame) {
+  return native_hal::parse_candump_line(line, line + strlen(line), frame);
+}
+
+void test_candump_log_line() {
+  native_hal::TraceFrame frame;
+  TEST_ASSERT_TRUE(parse("(1436509052.249713) can0 181#EBD007", frame));
+  TEST_ASSERT_EQUAL_UINT64(1436509052249713ULL, frame.timestamp_us);
+  TEST_ASSERT_EQUAL_HEX32(0x181, frame.msg.id);
+  TEST_ASSERT_FALSE(frame.msg.flags.extended);
+  TEST_ASSERT_EQUAL_UINT8(3, frame.msg.len);
+  TEST_ASSERT_EQUAL_HEX8(0xEB, frame.msg.buf[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x07, frame.msg.buf[2]);
+
+  TEST_ASSERT_TRUE(parse("(0.5) can0 0000295D#", frame));
+  TEST_ASSERT_TRUE(frame.msg.flags.extended);
+  TEST_ASSERT_EQUAL_UINT8(0, frame.msg.len);
+
+  TEST_ASSERT_FALSE(parse("(0.5) can0 123##0112233", frame));  // CAN FD
+}
+
+void test_candump_console_line() {
+  native_hal::TraceFrame frame;
+  TEST_ASSERT_TRUE(parse("  can1  400   [1]  41", frame));
+  TEST_ASSERT_EQUAL_UINT64(0, frame.timestamp_us);
+  TEST_ASSERT_EQUAL_HEX32(AS_CU_ID, frame.msg.id);
+  TEST_ASSERT_EQUAL_HEX8(PC_ALIVE, frame.msg.buf[0]);
+  TEST_ASSERT_FALSE(parse("  can1  400   [2]  41", frame));  // DLC does not match the data
+}
+
+void test_asc_line() {
+  const char line[] = "   12.000500 1  295Dx           Rx   d 2 01 02";
+  native_hal::TraceFrame frame;
+  TEST_ASSERT_TRUE(native_hal::parse_asc_line(line, line + strlen(line), frame));
+  TEST_ASSERT_EQUAL_UINT64(12000500, frame.timestamp_us);
+  TEST_ASSERT_EQUAL_HEX32(STEERING_ID, frame.msg.id);
+  TEST_ASSERT_TRUE(frame.msg.flags.extended);
+  TEST_ASSERT_EQUAL_UINT8(2, frame.msg.len);
+
+  const char error[] = "   12.000600 1  ErrorFrame";
+  TEST_ASSERT_FALSE(native_hal::parse_asc_line(error, error + strlen(error), frame));
+}
+
+/**
+ * @brief Trace timestamps drive the clock, so DC_VOLTAGE_HOLD elapses in recorded time
+ */
+void test_replay_updates_system_data() {
+  char trace[] =
+      "date Mon Oct 1 10:00:00 2024\n"
+      "base hex  timestamps absolute\n"
+      "   0.000000 1  181             Rx   d 3 EB D0 07\n"
+      "   0.500000 1  181             Rx   d 3 EB D0 07\n"
+      "   0.600000 1  300             Rx   d 2 31 03\n"
+      "   1.000000 1  181             Rx   d 3 EB D0 07\n"
+      "   1.100000 1  400             Rx   d 1 42";
+  FILE *file = fmemopen(trace, strlen(trace), "r");
+  native_hal::ReplayOptions options;
+  options.after_frame = [] {  // as loop() does: deadlines move, then the frame is decoded
+    system_data.tick(millis());
+    Communicator::process_received();
+  };
+  native_hal::StateTimeline timeline;
+  timeline.add("ts_on", [] -> int64_t { return system_data.failure_detection_.ts_on_; });
+  FILE *timeline_out = fopen("/dev/null", "w");
+
+  const auto stats =
+      native_hal::replay_trace(file, options, *native_hal::can_bus(CAN3), &timeline, timeline_out);
+  fclose(file);
+  fclose(timeline_out);
+
+  TEST_ASSERT_EQUAL_UINT64(5, stats.frames);
+  TEST_ASSERT_EQUAL_UINT64(4, stats.delivered);  // MASTER_ID is not in the master's filters
+  TEST_ASSERT_EQUAL_UINT64(2, stats.skipped_lines);
+  TEST_ASSERT_EQUAL_UINT64(1'100'000, stats.trace_us);
+  TEST_ASSERT_EQUAL_UINT(2000, system_data.failure_detection_.dc_voltage_);
+  TEST_ASSERT_TRUE(system_data.failure_detection_.ts_on_);
+  TEST_ASSERT_TRUE(system_data.mission_finished_);
+}
+
+void setUp() {
+  native_hal::reset();
+  system_data = SystemData();
+  communicator.init();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_candump_log_line);
+  RUN_TEST(test_candump_console_line);
+  RUN_TEST(test_asc_line);
+  RUN_TEST(test_replay_updates_system_data);
+  return UNITY_END();
+}
@@ -0,0 +1,200 @@
+// Prioritized, coalescing CAN transmit queue of the Communicator, on the native HAL bus and on a
+// simulated controller that drains a few frames per millisecond
+#include <Arduino.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+
+#include "../../can_tx_queue.h"
+#include "comm/communicator.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+native_hal::SimulatedCanBus &bus() { return *native_hal::can_bus(CAN3); }
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  system_data = SystemData();
+  communicator.init();
+  bus().tx_log.clear();
+  bus().tx_full = false;
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+/**
+ * @brief RES_ACTIVATE leaves first even when queued after status and debug frames, then status,
+ * then debug
+ */
+void test_priority_order() {
+  Communicator::publish_loop_profile();
+  Communicator::publish_status(3, 1, 80, true);
+  Communicator::publish_rpm();
+  Communicator::res_ready_callback();
+
+  Communicator::process_transmit(1);
+  TEST_ASSERT_EQUAL(1, bus().tx_log.size());
+  TEST_ASSERT_EQUAL_HEX(RES_ACTIVATE, bus().tx_log[0].id);
+
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+  TEST_ASSERT_EQUAL(3 + LOOP_STAGE_COUNT, bus().tx_log.size());
+  // status in the order queued
+  TEST_ASSERT_EQUAL_HEX8(MASTER_STATUS_MSG, bus().tx_log[1].buf[0]);
+  TEST_ASSERT_EQUAL_HEX8(MASTER_WHEELS_MSG, bus().tx_log[2].buf[0]);
+  for (std::size_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    TEST_ASSERT_EQUAL_HEX8(DBG_PROFILE_MSG, bus().tx_log[3 + i].buf[0]);
+    TEST_ASSERT_EQUAL(i, bus().tx_log[3 + i].buf[1]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(3 + LOOP_STAGE_COUNT, Communicator::tx_queue().stats().sent);
+}
+
+/**
+ * @brief While the controller refuses frames, a status signal keeps one frame with its latest
+ * value, and process_transmit() returns without waiting
+ */
+void test_status_frames_coalesce() {
+  bus().tx_full = true;
+  const uint32_t start_us = micros();
+  for (uint8_t soc = 50; soc < 60; soc++) {
+    Communicator::publish_status(soc % 4, 1, soc, true);
+    Communicator::publish_rpm();
+    Communicator::process_transmit();
+  }
+  TEST_ASSERT_EQUAL_UINT32(start_us, micros());  // no delay() between attempts
+  TEST_ASSERT_EQUAL(0, bus().tx_log.size());
+  TEST_ASSERT_EQUAL(2, Communicator::tx_queue().pending(can_tx::Priority::STATUS));
+  const can_tx::Stats &stats = Communicator::tx_queue().stats();
+  TEST_ASSERT_EQUAL_UINT32(9 * 2, stats.coalesced);
+  TEST_ASSERT_EQUAL_UINT32(10, stats.retries);
+
+  bus().tx_full = false;
+  Communicator::process_transmit();
+  TEST_ASSERT_EQUAL(2, bus().tx_log.size());
+  TEST_ASSERT_EQUAL_HEX8(MASTER_STATUS_MSG, bus().tx_log[0].buf[0]);
+  const auto status = can_db::MasterMsgs::M56::unpack(bus().tx_log[0].buf);
+  TEST_ASSERT_EQUAL_UINT8(59, status.lv_soc);
+  TEST_ASSERT_EQUAL_UINT8(59 % 4, status.master_state);
+  TEST_ASSERT_EQUAL_HEX8(MASTER_WHEELS_MSG, bus().tx_log[1].buf[0]);
+}
+
+/**
+ * @brief A full class refuses new frames without touching the others, and debug frames past
+ * their window are dropped instead of sent late
+ */
+void test_queue_full_and_stale_frames() {
+  bus().tx_full = true;
+  for (int i = 0; i < 3; i++) Communicator::publish_loop_profile();
+  TEST_ASSERT_EQUAL(TX_QUEUE_DEPTH, Communicator::tx_queue().pending(can_tx::Priority::DIAGNOSTIC));
+  TEST_ASSERT_EQUAL_UINT32(3 * LOOP_STAGE_COUNT - TX_QUEUE_DEPTH,
+                           Communicator::tx_queue().stats().queue_full);
+  TEST_ASSERT_EQUAL_UINT32(TX_QUEUE_DEPTH,
+                           Communicator::tx_queue().high_water_mark(can_tx::Priority::DIAGNOSTIC));
+  TEST_ASSERT_EQUAL(0, Communicator::send_message(2, std::array<uint8_t, 2>{1, NODE_ID},
+                                                  RES_ACTIVATE));
+
+  native_hal::advance_ms(1001);
+  bus().tx_full = false;
+  Communicator::process_transmit(1);
+  TEST_ASSERT_EQUAL_HEX(RES_ACTIVATE, bus().tx_log[0].id);
+  Communicator::process_transmit(1);  // a dropped frame takes no bus time, nor budget
+  TEST_ASSERT_EQUAL(1, bus().tx_log.size());  // only RES_ACTIVATE, it has no age limit
+  TEST_ASSERT_EQUAL(0, Communicator::tx_queue().pending());
+  TEST_ASSERT_EQUAL_UINT32(TX_QUEUE_DEPTH, Communicator::tx_queue().stats().dropped);
+}
+
+/**
+ * @brief A CAN controller with a 16-frame in-order transmit buffer, like FlexCAN_T4's
+ * TX_SIZE_16, draining one frame every 125 us, about 8 frames of a 1 Mbit/s bus per millisecond
+ */
+struct InOrderController {
+  std::deque<CAN_message_t> buffer;
+  uint32_t res_sent_us = UINT32_MAX;
+
+  int write(const CAN_message_t &msg) {
+    if (buffer.size() == 16) return 0;
+    buffer.push_back(msg);
+    return 1;
+  }
+
+  void run_until(const uint32_t now_us) {
+    for (uint32_t t = sent_us_ + 125; t <= now_us && !buffer.empty(); t += 125) {
+      if (buffer.front().id == RES_ACTIVATE && res_sent_us == UINT32_MAX) res_sent_us = t;
+      buffer.pop_front();
+      sent_us_ = t;
+    }
+    if (buffer.empty()) sent_us_ = now_us;
+  }
+
+private:
+  uint32_t sent_us_ = 0;
+};
+
+/**
+ * @brief One loop's burst: the 1 s debug frames landing with the status frames, then RES_READY
+ */
+std::deque<CAN_message_t> burst() {
+  std::deque<CAN_message_t> frames;
+  const auto add = [&frames](const uint32_t id, const uint8_t type, const uint8_t index) {
+    CAN_message_t msg;
+    msg.id = id;
+    msg.len = 8;
+    msg.buf[0] = type;
+    msg.buf[1] = index;
+    frames.push_back(msg);
+  };
+  for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) add(MASTER_ID, DBG_PROFILE_MSG, i);
+  for (uint8_t i = 0; i < FailureDetection::HEARTBEAT_COUNT; i++) {
+    add(MASTER_ID, DBG_HEARTBEAT_MSG, i);
+  }
+  add(MASTER_ID, DBG_LOG_MSG, 0);
+  add(MASTER_ID, DBG_LOG_MSG_2, 0);
+  add(MASTER_ID, MASTER_STATUS_MSG, 0);
+  add(MASTER_ID, MASTER_WHEELS_MSG, 0);
+  add(RES_ACTIVATE, 0x01, NODE_ID);
+  return frames;
+}
+
+/**
+ * @brief Time from RES_READY to RES_ACTIVATE on the bus behind a debug burst, writing every frame
+ * as it is produced against going through the queue with a 1 ms loop
+ */
+void test_res_activate_latency_behind_debug_burst() {
+  InOrderController direct;
+  uint32_t direct_refused = 0;
+  for (const CAN_message_t &msg : burst()) direct_refused += direct.write(msg) == 1 ? 0 : 1;
+  direct.run_until(10'000);
+
+  InOrderController queued;
+  can_tx::TxQueue<txRules.size(), TX_QUEUE_DEPTH> queue{txRules};
+  for (const CAN_message_t &msg : burst()) queue.enqueue(msg, 0);
+  for (uint32_t now_us = 0; now_us <= 10'000; now_us += 1000) {
+    queued.run_until(now_us);
+    queue.service(queued, now_us / 1000, TX_FRAMES_PER_LOOP);
+  }
+  queued.run_until(10'000);
+
+  char message[128];
+  snprintf(message, sizeof(message),
+           "RES_ACTIVATE after %d us with direct writes (%u frames refused), %u us queued",
+           direct.res_sent_us == UINT32_MAX ? -1 : static_cast<int>(direct.res_sent_us),
+           direct_refused, queued.res_sent_us);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, direct.res_sent_us);  // refused behind the burst, lost
+  TEST_ASSERT_LESS_THAN(1000, queued.res_sent_us);  // first in the first millisecond
+  TEST_ASSERT_EQUAL(0, queue.pending());  // and the burst still goes out
+  TEST_ASSERT_EQUAL_UINT32(0, queue.stats().queue_full + queue.stats().dropped);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_priority_order);
+  RUN_TEST(test_status_frames_coalesce);
+  RUN_TEST(test_queue_full_and_stale_frames);
+  RUN_TEST(test_res_activate_latency_behind_debug_burst);
+  return UNITY_END();
+}
@@ -1,188 +1,139 @@
-#include <unity.h>
+// Decoding of the frames the master receives through Communicator::parse_message(), on the
+// manually advanced clock of the native build. The packed wheel speed and hydraulic line frames
+// are covered by test_frame_packing
+#include <Arduino.h>
+
+#include <algorithm>
+#include <initializer_list>
 
 #include "comm/communicator.hpp"
-#include "model/systemDiagnostics.hpp"
-
-#define BAMOCAR_VDC_HIGH 0x11
-#define BAMOCAR_VDC_LOW 0x01
-#define RES_READY_TRUE 0x01
-#define RADIO_QUALITY_0 0x00
-#define RADIO_QUALITY_100 0x64
-#define RES_EMG_0 0x00
-#define RES_EMG_3 0x00
-#define RES_OK_0 0x01
-#define RES_OK_3 0x80
+#include "model/systemData.hpp"
+#include "unity.h"
+
+constexpr uint8_t RADIO_QUALITY_0 = 0x00;
+constexpr uint8_t RADIO_QUALITY_100 = 0x64;
+constexpr uint8_t RES_GO_SWITCH = 0x02;  // byte 0, emergency stop 1 pressed
+constexpr uint8_t RES_OK_0 = 0x01;       // byte 0, emergency stop 1 released
+constexpr uint8_t RES_OK_3 = 0x80;       // byte 3, emergency stop 2 released
+constexpr uint8_t RES_SIGNAL_LOSS = 0x40;  // byte 7
+constexpr uint16_t DC_VOLTAGE_HIGH = DC_THRESHOLD + 100;
+constexpr uint16_t DC_VOLTAGE_LOW = DC_THRESHOLD - 100;
+constexpr uint32_t FRAME_PERIOD_MS = 10;
 
 SystemData sd;
 Communicator communicator(&sd);
-CAN_message_t msg;
 
-/**
- * @brief Test if the message wheel rpm message is
- * created correctly for a 0.0 rpm value
- *
- */
-void wss_message_zero_rpm(void) {
-  std::array<uint8_t, 5> msg;
-  create_left_wheel_msg(msg, 0.0);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[1]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[2]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[3]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[4]);
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  sd = SystemData();
+  EmergencyEvent::clear();
 }
 
-/**
- * @brief Test if the message wheel rpm message is
- * created correctly for a large rpm value
- *
- */
-void wss_message_high_rpm(void) {
-  std::array<uint8_t, 5> msg;
-  create_left_wheel_msg(msg, 1002.1231213);
-  TEST_ASSERT_EQUAL_HEX8(0x74, msg[1]);
-  TEST_ASSERT_EQUAL_HEX8(0x87, msg[2]);
-  TEST_ASSERT_EQUAL_HEX8(0x01, msg[3]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[4]);
-}
+void tearDown() { native_hal::use_real_clock(); }
 
-/**
- * @brief Test if the message wheel rpm message is
- * created correctly for a negative rpm value
- *
- */
-void wss_message_negative_rpm(void) {
-  std::array<uint8_t, 5> msg;
-  create_left_wheel_msg(msg, -10.324);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[1]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[2]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[3]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[4]);
+void parse(const uint32_t id, std::initializer_list<uint8_t> data) {
+  CAN_message_t msg;
+  msg.id = id;
+  msg.len = data.size();
+  std::copy(data.begin(), data.end(), msg.buf);
+  Communicator::parse_message(msg);
 }
 
 /**
- * @brief Test if the message wheel rpm message is
- * created correctly for a small rpm value
- *
+ * @brief Lets `ms` pass and ticks the model deadlines, as the next loop() would
  */
-void wss_message_small_rpm(void) {
-  std::array<uint8_t, 5> msg;
-  create_left_wheel_msg(msg, 0.324235235);
-  TEST_ASSERT_EQUAL_HEX8(0x20, msg[1]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[2]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[3]);
-  TEST_ASSERT_EQUAL_HEX8(0x00, msg[4]);
+void wait_ms(const uint32_t ms) {
+  native_hal::advance_ms(ms);
+  sd.tick(millis());
 }
 
-/**
- * @brief Tests if the messages from C1 are correctly
- * parsed for Hydraulic Brake Pressure and Right Wheel Rpm's
- */
-void test_c1(void) {
-  msg.id = C1_ID;
-  msg.len = 5;
-  msg.buf[0] = HYDRAULIC_LINE;
-  msg.buf[1] = 0x01;
-  msg.buf[2] = 0x01;
-  msg.buf[3] = 0x00;
-  msg.buf[4] = 0x00;
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(257, sd.hardware_data_._hydraulic_line_pressure);
-
-  msg.buf[0] = RIGHT_WHEEL_CODE;
-  msg.buf[1] = 0x00;
-  msg.buf[2] = 0x08;
-  communicator.parse_message(msg);
-
-  if (sd.hardware_data_._right_wheel_rpm == 20.48)
-    TEST_PASS();
-  else
-    TEST_FAIL();
+void send_dc_voltage(const uint16_t dc_voltage) {
+  parse(BAMO_RESPONSE_ID, {BAMOCAR_BATTERY_VOLTAGE_CODE, static_cast<uint8_t>(dc_voltage & 0xFF),
+                           static_cast<uint8_t>(dc_voltage >> 8)});
 }
 
 /**
- * @brief Tests if the messages from Bamocar are correctly
- * parsed and the Tractive System State is matching received info
+ * @brief The Bamocar turns the tractive system off with BTB_READY low, and its DC bus voltage
+ * turns it on or off once it stayed on one side of DC_THRESHOLD long enough
  */
 void test_bamocar(void) {
-  sd = SystemData();  // reset ready timestamp
   sd.failure_detection_.ts_on_ = true;
-
-  msg.id = BAMO_RESPONSE_ID;
-  msg.len = 4;
-  msg.buf[0] = BTB_READY;
-  msg.buf[1] = 0x00;
-  msg.buf[2] = 0x00;
-  msg.buf[3] = 0x00;
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(false, sd.failure_detection_.ts_on_);
-
-  msg.buf[1] = RES_READY_TRUE;
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(false, sd.failure_detection_.ts_on_);
-
-  msg.buf[0] = VDC_BUS;
-  msg.buf[2] = BAMOCAR_VDC_HIGH;
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(true, sd.failure_detection_.ts_on_);
-
-  msg.buf[2] = BAMOCAR_VDC_LOW;
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(false, sd.failure_detection_.ts_on_);
+  parse(BAMO_RESPONSE_ID, {BTB_READY, 0x00, 0x00, 0x00});
+  TEST_ASSERT_FALSE(sd.failure_detection_.ts_on_);
+  parse(BAMO_RESPONSE_ID, {BTB_READY, 0x01, 0x00, 0x00});
+  TEST_ASSERT_FALSE(sd.failure_detection_.ts_on_);
+
+  // the hold timer runs from the construction of the model
+  for (uint32_t ms = 0; ms + FRAME_PERIOD_MS < DC_VOLTAGE_HOLD; ms += FRAME_PERIOD_MS) {
+    send_dc_voltage(DC_VOLTAGE_HIGH);
+    TEST_ASSERT_FALSE(sd.failure_detection_.ts_on_);
+    wait_ms(FRAME_PERIOD_MS);
+  }
+  wait_ms(FRAME_PERIOD_MS);
+  send_dc_voltage(DC_VOLTAGE_HIGH);
+  TEST_ASSERT_TRUE(sd.failure_detection_.ts_on_);
+  TEST_ASSERT_EQUAL(DC_VOLTAGE_HIGH, sd.failure_detection_.dc_voltage_);
+
+  // a short drop is ridden through, DC_VOLTAGE_TIMEOUT below the threshold is not
+  for (uint32_t ms = 0; ms + FRAME_PERIOD_MS < DC_VOLTAGE_TIMEOUT; ms += FRAME_PERIOD_MS) {
+    wait_ms(FRAME_PERIOD_MS);
+    send_dc_voltage(DC_VOLTAGE_LOW);
+    TEST_ASSERT_TRUE(sd.failure_detection_.ts_on_);
+  }
+  wait_ms(FRAME_PERIOD_MS);
+  send_dc_voltage(DC_VOLTAGE_LOW);
+  TEST_ASSERT_FALSE(sd.failure_detection_.ts_on_);
+  TEST_ASSERT_FALSE(sd.failure_detection_.expired(FailureTimer::INVERTER));
 }
 
 /**
- * @brief Tests if the messages from RES are correctly
- * parsed for R2D and Emergency activations, aswell as
- * for the radio quality indicator
+ * @brief The RES GO is only accepted READY_TIMEOUT_MS after entering READY, the radio quality is
+ * stored and the emergency stop raises an EmergencyEvent
  */
 void test_res_state(void) {
-  msg.id = RES_STATE;
-  msg.len = 8;
-  msg.buf[0] = 0x02;  // Assuming emergency signals are set
-  msg.buf[1] = 0x00;
-  msg.buf[2] = 0x00;
-  msg.buf[3] = 0x80;
-  msg.buf[4] = 0x00;
-  msg.buf[5] = 0x00;
-  msg.buf[6] = RADIO_QUALITY_0;  // radio quality
-  msg.buf[7] = 0x00;
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(false, sd.r2d_logics_.r2d);
-  TEST_ASSERT_EQUAL(0, sd.failure_detection_.radio_quality);
-
-  // wait ready timeout
-  Metro time{READY_TIMEOUT_MS};
-  while (!time.check()) {
+  sd.r2d_logics_.enter_ready_state();
+  parse(RES_STATE, {RES_GO_SWITCH, 0x00, 0x00, RES_OK_3, 0x00, 0x00, RADIO_QUALITY_0, 0x00});
+  TEST_ASSERT_FALSE(sd.r2d_logics_.r2d);
+  TEST_ASSERT_EQUAL(RADIO_QUALITY_0, sd.failure_detection_.radio_quality_);
+
+  wait_ms(READY_TIMEOUT_MS);
+  parse(RES_STATE, {RES_GO_SWITCH, 0x00, 0x00, RES_OK_3, 0x00, 0x00, RADIO_QUALITY_100, 0x00});
+  TEST_ASSERT_TRUE(sd.r2d_logics_.r2d);
+  TEST_ASSERT_EQUAL(RADIO_QUALITY_100, sd.failure_detection_.radio_quality_);
+
+  parse(RES_STATE, {RES_OK_0, 0x00, 0x00, RES_OK_3, 0x00, 0x00, RADIO_QUALITY_100, 0x00});
+  TEST_ASSERT_FALSE(sd.failure_detection_.emergency_signal_);
+  TEST_ASSERT_FALSE(EmergencyEvent::pending());
+
+  parse(RES_STATE, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, RADIO_QUALITY_100, 0x00});
+  TEST_ASSERT_TRUE(sd.failure_detection_.emergency_signal_);
+  TEST_ASSERT_TRUE(EmergencyEvent::pending());
+}
+
+/**
+ * @brief Frames flagged as signal loss do not count as RES heartbeats
+ */
+void test_res_signal_loss(void) {
+  for (uint32_t ms = 0; ms < 2 * RES_TIMESTAMP_TIMEOUT; ms += FRAME_PERIOD_MS) {
+    parse(RES_STATE, {RES_OK_0, 0x00, 0x00, RES_OK_3, 0x00, 0x00, RADIO_QUALITY_100, 0x00});
+    wait_ms(FRAME_PERIOD_MS);
   }
+  TEST_ASSERT_FALSE(sd.failure_detection_.expired(FailureTimer::RES));
 
-  msg.buf[6] = RADIO_QUALITY_100;  // def radio quality 100
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(true, sd.r2d_logics_.r2d);
-  TEST_ASSERT_EQUAL(100, sd.failure_detection_.radio_quality);
-
-  // RES ok
-  msg.buf[0] = RES_OK_0;
-  msg.buf[3] = RES_OK_3;  // def emg bits
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(false, sd.failure_detection_.emergencySignal);
-
-  // RES Emergency
-  msg.buf[0] = RES_EMG_0;
-  msg.buf[3] = RES_EMG_3;  // def emg bits
-  communicator.parse_message(msg);
-  TEST_ASSERT_EQUAL(true, sd.failure_detection_.emergencySignal);
+  for (uint32_t ms = 0; ms < RES_TIMESTAMP_TIMEOUT; ms += FRAME_PERIOD_MS) {
+    parse(RES_STATE,
+          {RES_OK_0, 0x00, 0x00, RES_OK_3, 0x00, 0x00, RADIO_QUALITY_0, RES_SIGNAL_LOSS});
+    wait_ms(FRAME_PERIOD_MS);
+  }
+  TEST_ASSERT_TRUE(sd.failure_detection_.expired(FailureTimer::RES));
+  TEST_ASSERT_FALSE(sd.failure_detection_.emergency_signal_);
 }
 
-void setUp() {}
-
 int main(void) {
   UNITY_BEGIN();
-  RUN_TEST(wss_message_zero_rpm);
-  RUN_TEST(wss_message_high_rpm);
-  RUN_TEST(wss_message_negative_rpm);
-  RUN_TEST(wss_message_small_rpm);
-  RUN_TEST(test_c1);
   RUN_TEST(test_bamocar);
   RUN_TEST(test_res_state);
+  RUN_TEST(test_res_signal_loss);
   return UNITY_END();
-}
\ No newline at end of file
+}
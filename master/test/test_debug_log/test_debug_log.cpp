@@ -0,0 +1,167 @@
+// Tokenized DEBUG_LOG records, the ring they wait in and what drain() sends
+#include <Arduino.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../../debug_log.h"
+#include "loopProfiler.hpp"
+#include "unity.h"
+
+/**
+ * @brief Stands in for Serial, keeps the bytes drain() writes
+ */
+struct Capture {
+  std::vector<uint8_t> bytes;
+  size_t write(const uint8_t *buffer, const size_t size) {
+    bytes.insert(bytes.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+enum class Gear : uint8_t { PARK, DRIVE };
+
+template <class T>
+T read_at(const std::vector<uint8_t> &bytes, const size_t offset) {
+  T value;
+  memcpy(&value, &bytes[offset], sizeof(T));
+  return value;
+}
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  debug_log::ring.reset();
+}
+
+void tearDown() {}
+
+/**
+ * @brief FNV-1a reference values, the decoder hashes the literals the same way
+ */
+void test_format_ids() {
+  TEST_ASSERT_EQUAL_HEX32(0x811C9DC5U, debug_log::id_of(""));
+  TEST_ASSERT_EQUAL_HEX32(0xE40C292CU, debug_log::id_of("a"));
+  TEST_ASSERT_EQUAL_HEX32(0xBF9CF968U, debug_log::id_of("foobar"));
+  TEST_ASSERT_EQUAL_UINT32(3, debug_log::placeholders("Pressure: {} - {:x} {yes|no}"));
+}
+
+/**
+ * @brief One record: start byte, length, ID, micros() and the tagged arguments
+ */
+void test_record_layout() {
+  native_hal::advance_us(1234);
+  const auto now = static_cast<uint32_t>(micros());
+  DEBUG_LOG("Hydraulic Pressure: {} - {} {} {} {}", int16_t{-5}, 300U, 1.5F, true, Gear::DRIVE);
+
+  Capture serial;
+  debug_log::ring.drain(serial, 1024);
+  const std::vector<uint8_t> &bytes = serial.bytes;
+  TEST_ASSERT_EQUAL_UINT32(2 + 8 + 5 + 5 + 5 + 2 + 5, bytes.size());
+  TEST_ASSERT_EQUAL_HEX8(debug_log::FRAME_START, bytes[0]);
+  TEST_ASSERT_EQUAL_UINT8(bytes.size() - 2, bytes[1]);
+  TEST_ASSERT_EQUAL_HEX32(debug_log::id_of("Hydraulic Pressure: {} - {} {} {} {}"),
+                          read_at<uint32_t>(bytes, 2));
+  TEST_ASSERT_EQUAL_UINT32(now, read_at<uint32_t>(bytes, 6));
+  TEST_ASSERT_EQUAL_UINT8('i', bytes[10]);
+  TEST_ASSERT_EQUAL_INT32(-5, read_at<int32_t>(bytes, 11));
+  TEST_ASSERT_EQUAL_UINT8('u', bytes[15]);
+  TEST_ASSERT_EQUAL_UINT32(300, read_at<uint32_t>(bytes, 16));
+  TEST_ASSERT_EQUAL_UINT8('f', bytes[20]);
+  TEST_ASSERT_EQUAL_FLOAT(1.5F, read_at<float>(bytes, 21));
+  TEST_ASSERT_EQUAL_UINT8('b', bytes[25]);
+  TEST_ASSERT_EQUAL_UINT8(1, bytes[26]);
+  TEST_ASSERT_EQUAL_UINT8('u', bytes[27]);
+  TEST_ASSERT_EQUAL_UINT32(1, read_at<uint32_t>(bytes, 28));
+  TEST_ASSERT_EQUAL_UINT32(0, debug_log::ring.pending());
+}
+
+/**
+ * @brief drain() only sends whole records that fit the budget and keeps the rest for later
+ */
+void test_drain_budget() {
+  DEBUG_LOG("first {}", 1);
+  DEBUG_LOG("second {}", 2);
+  constexpr size_t RECORD = 2 + 8 + 5;
+
+  Capture serial;
+  TEST_ASSERT_EQUAL_UINT32(0, debug_log::ring.drain(serial, RECORD - 1));
+  TEST_ASSERT_EQUAL_UINT32(RECORD, debug_log::ring.drain(serial, RECORD + 3));
+  TEST_ASSERT_EQUAL_HEX32(debug_log::id_of("first {}"), read_at<uint32_t>(serial.bytes, 2));
+  TEST_ASSERT_EQUAL_UINT32(RECORD, debug_log::ring.pending());
+  TEST_ASSERT_EQUAL_UINT32(RECORD, debug_log::ring.drain(serial, 1024));
+  TEST_ASSERT_EQUAL_HEX32(debug_log::id_of("second {}"),
+                          read_at<uint32_t>(serial.bytes, RECORD + 2));
+}
+
+/**
+ * @brief A full ring drops and counts, the count goes out first once there is room again, and
+ * records that wrap around the end of the buffer come out whole
+ */
+void test_overflow_and_wrap() {
+  constexpr size_t RECORD = 2 + 8 + 5;
+  const uint32_t fits = debug_log::RING_SIZE / RECORD;
+  for (uint32_t i = 0; i < fits + 10; i++) DEBUG_LOG("fill {}", i);
+  TEST_ASSERT_EQUAL_UINT32(10, debug_log::ring.dropped());
+  TEST_ASSERT_EQUAL_UINT32(fits * RECORD, debug_log::ring.pending());
+
+  Capture serial;
+  debug_log::ring.drain(serial, 1024);
+  TEST_ASSERT_EQUAL_HEX32(debug_log::DROPPED_ID, read_at<uint32_t>(serial.bytes, 2));
+  TEST_ASSERT_EQUAL_UINT32(10, read_at<uint32_t>(serial.bytes, 11));
+  TEST_ASSERT_EQUAL_UINT32(0, debug_log::ring.dropped());
+
+  serial.bytes.clear();
+  debug_log::ring.drain(serial, debug_log::RING_SIZE);
+  for (uint32_t i = 0; i < 3; i++) DEBUG_LOG("wrapped {}", 1000 + i);
+  serial.bytes.clear();
+  debug_log::ring.drain(serial, 1024);
+  TEST_ASSERT_EQUAL_UINT32(3 * RECORD, serial.bytes.size());
+  for (uint32_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_HEX8(debug_log::FRAME_START, serial.bytes[i * RECORD]);
+    TEST_ASSERT_EQUAL_HEX32(debug_log::id_of("wrapped {}"),
+                            read_at<uint32_t>(serial.bytes, i * RECORD + 2));
+    TEST_ASSERT_EQUAL_UINT32(1000 + i, read_at<uint32_t>(serial.bytes, i * RECORD + 11));
+  }
+}
+
+/**
+ * @brief One DEBUG_LOG call with two arguments costs at most LOG_CALL_CYCLES profiler_cycles()
+ * @details The manual clock freezes micros(), so the timestamp source is not counted. Calls are
+ * timed in batches that fit the ring, which is reset between them as the drain would empty it,
+ * and the cheapest of LOG_CALL_PASSES batches counts. On the host profiler_cycles() are
+ * nanoseconds of an optimized build (pio test builds with -Og), not Teensy cycles.
+ */
+void test_call_cost() {
+  constexpr uint32_t LOG_CALL_CYCLES = 48;  // "a few dozen"
+  constexpr uint32_t LOG_CALL_PASSES = 200;
+  constexpr uint32_t BATCH = 128;  // 20-byte records, 2.5 KiB of the ring
+  volatile int32_t pressure = 0;
+  volatile uint32_t limit = 0;
+  uint32_t best = UINT32_MAX;
+  for (uint32_t pass = 0; pass < LOG_CALL_PASSES; pass++) {
+    debug_log::ring.reset();
+    const uint32_t start = profiler_cycles();
+    for (uint32_t i = 0; i < BATCH; i++) DEBUG_LOG("Pressure: {} (limit {})", pressure, limit);
+    best = std::min(best, profiler_cycles() - start);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, debug_log::ring.dropped());
+
+  char message[64];
+  snprintf(message, sizeof(message), "%.1f profiler cycles per DEBUG_LOG call",
+           static_cast<double>(best) / BATCH);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_OR_EQUAL(LOG_CALL_CYCLES * BATCH, best);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_format_ids);
+  RUN_TEST(test_record_layout);
+  RUN_TEST(test_drain_budget);
+  RUN_TEST(test_overflow_and_wrap);
+  RUN_TEST(test_call_cost);
+  return UNITY_END();
+}
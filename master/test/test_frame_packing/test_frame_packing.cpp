@@ -0,0 +1,151 @@
+// Status and wheel frames packed by tools/frame_planner.py: what the master puts on the bus, what
+// it reads back from the dash and the bus load against the one-signal-per-frame layout
+#include <Arduino.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#include "../../CAN_messages.h"
+#include "comm/communicator.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+native_hal::SimulatedCanBus &bus() { return *native_hal::can_bus(CAN3); }
+
+void setUp() {
+  native_hal::reset();
+  system_data = SystemData();
+  communicator.init();
+  bus().tx_log.clear();
+  bus().tx_full = false;
+}
+
+void tearDown() {}
+
+/**
+ * @brief Worst-case bits of a standard data frame with `bytes` of payload, bit stuffing included,
+ * as frame_bits() in tools/frame_planner.py
+ */
+constexpr unsigned frame_bits(const unsigned bytes) {
+  const unsigned stuffed = 34 + 8 * bytes;
+  return stuffed + 13 + (stuffed - 1) / 4;
+}
+
+/**
+ * @brief State, mission, ASMS and SOC go out in one frame, and the dash's decoder reads them back
+ */
+void test_status_frame_round_trip() {
+  Communicator::publish_status(5, 7, 100, true);
+  Communicator::publish_status(2, 3, 64, false);  // latest value wins
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+
+  TEST_ASSERT_EQUAL(1, bus().tx_log.size());
+  const CAN_message_t &frame = bus().tx_log[0];
+  TEST_ASSERT_EQUAL_HEX(MASTER_ID, frame.id);
+  TEST_ASSERT_EQUAL(3, frame.len);
+  TEST_ASSERT_EQUAL_HEX8(MASTER_STATUS_MSG, frame.buf[0]);
+  const auto status = can_db::MasterMsgs::M56::unpack(frame.buf);
+  TEST_ASSERT_EQUAL_UINT8(2, status.master_state);
+  TEST_ASSERT_EQUAL_UINT8(3, status.mission);
+  TEST_ASSERT_FALSE(status.asms_on);
+  TEST_ASSERT_EQUAL_UINT8(64, status.lv_soc);
+}
+
+/**
+ * @brief Both rear wheels in one frame, in hundredths of an RPM, clamped to the signal range
+ */
+void test_wheel_frame_round_trip() {
+  system_data.hardware_data_._left_wheel_rpm = 1234.567;
+  system_data.hardware_data_._right_wheel_rpm = 2999.99;
+  Communicator::publish_rpm();
+  system_data.hardware_data_._left_wheel_rpm = -3;
+  system_data.hardware_data_._right_wheel_rpm = 4500;
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+  Communicator::publish_rpm();
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+
+  TEST_ASSERT_EQUAL(2, bus().tx_log.size());
+  TEST_ASSERT_EQUAL(6, bus().tx_log[0].len);
+  TEST_ASSERT_EQUAL_HEX8(MASTER_WHEELS_MSG, bus().tx_log[0].buf[0]);
+  auto wheels = can_db::MasterMsgs::M57::unpack(bus().tx_log[0].buf);
+  TEST_ASSERT_EQUAL_UINT32(123457, wheels.rl_rpm);
+  TEST_ASSERT_EQUAL_UINT32(299999, wheels.rr_rpm);
+  TEST_ASSERT_FLOAT_WITHIN(0.01, 1234.57, wheels.rl_rpm_physical());
+
+  wheels = can_db::MasterMsgs::M57::unpack(bus().tx_log[1].buf);
+  TEST_ASSERT_EQUAL_UINT32(0, wheels.rl_rpm);
+  TEST_ASSERT_EQUAL_UINT32(300000, wheels.rr_rpm);
+}
+
+/**
+ * @brief The hydraulic line pressure comes in the dash's wheel and brake frame, its pedal frame
+ * leaves it alone
+ */
+void test_dash_frame_decoding() {
+  can_db::DashMsgs::M80 dash;
+  dash.fr_rpm = 52000;
+  dash.fl_rpm = 51000;
+  dash.hydraulic_line = 1023;
+  CAN_message_t msg;
+  msg.id = DASH_ID;
+  msg.len = dash.LEN;
+  const auto payload = dash.pack();
+  std::copy(payload.begin(), payload.end(), msg.buf);
+  TEST_ASSERT_TRUE(bus().receive(msg));
+  Communicator::process_received();
+  TEST_ASSERT_EQUAL(1023, system_data.hardware_data_.hydraulic_line_front_pressure);
+
+  can_db::DashMsgs::M81 pedals;
+  pedals.apps_higher = 900;
+  const auto pedal_payload = pedals.pack();
+  std::copy(pedal_payload.begin(), pedal_payload.end(), msg.buf);
+  msg.len = pedals.LEN;
+  TEST_ASSERT_TRUE(bus().receive(msg));
+  Communicator::process_received();
+  TEST_ASSERT_EQUAL(1023, system_data.hardware_data_.hydraulic_line_front_pressure);
+}
+
+/**
+ * @brief Every packed frame fits 8 bytes, and both boards' periodic frames take less of the bus
+ * than one frame per signal did
+ */
+void test_bus_load_reduction() {
+  using Master = can_db::MasterMsgs;
+  using Dash = can_db::DashMsgs;
+  static_assert(Master::M56::LEN <= 8 && Master::M57::LEN <= 8);
+  static_assert(Dash::M80::LEN <= 8 && Dash::M81::LEN <= 8);
+
+  // bits per second: frame bits * 1000 / period in ms
+  // state, mission, SOC and ASMS, then the two wheels
+  const double master_before = 4 * frame_bits(2) * 1000.0 / PROCESS_INTERVAL +
+                               2 * frame_bits(5) * 1000.0 / SLOWER_PROCESS_INTERVAL;
+  const double master_after = frame_bits(Master::M56::LEN) * 1000.0 / PROCESS_INTERVAL +
+                              frame_bits(Master::M57::LEN) * 1000.0 / SLOWER_PROCESS_INTERVAL;
+  // wheels, the hydraulic line on its own 165 ms period, APPS and the driving state
+  const double dash_before = 2 * frame_bits(5) * 1000.0 / RPM_MSG_PERIOD_MS +
+                             frame_bits(3) * 1000.0 / 165 +
+                             2 * frame_bits(5) * 1000.0 / APPS_MSG_PERIOD_MS +
+                             frame_bits(3) * 1000.0 / APPS_MSG_PERIOD_MS;
+  const double dash_after = frame_bits(Dash::M80::LEN) * 1000.0 / RPM_MSG_PERIOD_MS +
+                            frame_bits(Dash::M81::LEN) * 1000.0 / APPS_MSG_PERIOD_MS;
+
+  char message[128];
+  snprintf(message, sizeof(message), "master %.0f -> %.0f bit/s, dash %.0f -> %.0f bit/s",
+           master_before, master_after, dash_before, dash_after);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(master_after < master_before / 2);
+  TEST_ASSERT_TRUE(dash_after < dash_before / 2);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_status_frame_round_trip);
+  RUN_TEST(test_wheel_frame_round_trip);
+  RUN_TEST(test_dash_frame_decoding);
+  RUN_TEST(test_bus_load_reduction);
+  return UNITY_END();
+}
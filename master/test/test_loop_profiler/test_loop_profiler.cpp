@@ -0,0 +1,97 @@
+// Loop stage histograms and their DBG_PROFILE_MSG export, native build
+#include "comm/communicator.hpp"
+#include "loopProfiler.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+void setUp() {
+  native_hal::reset();
+  native_hal::can_bus(CAN3)->tx_log.clear();
+  LoopProfiler::reset();
+}
+
+void tearDown() {}
+
+void test_histogram_buckets_and_percentiles() {
+  CycleHistogram histogram;
+  TEST_ASSERT_EQUAL_UINT32(0, histogram.percentile(990));
+  for (int i = 0; i < 98; i++) histogram.add(100);  // bucket [64, 128)
+  histogram.add(1000);                              // bucket [512, 1024)
+  histogram.add(5000);                              // bucket [4096, 8192)
+
+  TEST_ASSERT_EQUAL_UINT32(100, histogram.count());
+  TEST_ASSERT_EQUAL_UINT32(98, histogram.bucket(7));
+  TEST_ASSERT_EQUAL_UINT32(1, histogram.bucket(10));
+  TEST_ASSERT_EQUAL_UINT32(5000, histogram.max());
+  TEST_ASSERT_EQUAL_UINT32((98 * 100 + 1000 + 5000) / 100, histogram.mean());
+  TEST_ASSERT_EQUAL_UINT32(127, histogram.percentile(500));
+  TEST_ASSERT_EQUAL_UINT32(1023, histogram.percentile(990));
+  TEST_ASSERT_EQUAL_UINT32(5000, histogram.percentile(1000));  // capped at the maximum
+}
+
+/**
+ * @brief The window restarts when published, the since-boot histogram keeps everything
+ */
+void test_window_and_total() {
+  LoopProfiler::record(LoopStage::CALCULATE_STATE, 3000);
+  LoopProfiler::start_window();
+  LoopProfiler::record(LoopStage::CALCULATE_STATE, 40);
+  LoopProfiler::record(LoopStage::CALCULATE_STATE, 60);
+
+  const CycleHistogram window = LoopProfiler::window(LoopStage::CALCULATE_STATE);
+  TEST_ASSERT_EQUAL_UINT32(2, window.count());
+  TEST_ASSERT_EQUAL_UINT32(60, window.max());
+  TEST_ASSERT_EQUAL_UINT32(50, window.mean());
+  TEST_ASSERT_EQUAL_UINT32(3, LoopProfiler::total(LoopStage::CALCULATE_STATE).count());
+  TEST_ASSERT_EQUAL_UINT32(3000, LoopProfiler::total(LoopStage::CALCULATE_STATE).max());
+}
+
+void test_probe_times_its_scope() {
+  {
+    const LoopProbe probe(LoopStage::DIGITAL_READS);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, LoopProfiler::total(LoopStage::DIGITAL_READS).count());
+  TEST_ASSERT_EQUAL_UINT32(0, LoopProfiler::total(LoopStage::LOOP).count());
+}
+
+/**
+ * @brief One frame per stage on MASTER_ID, decodable with the conf.dbc layout
+ */
+void test_publish_on_can() {
+  for (int i = 0; i < 99; i++) LoopProfiler::record(LoopStage::OUTPUT_PROCESS, 1000);  // 1 us
+  LoopProfiler::record(LoopStage::OUTPUT_PROCESS, 70'000'000);  // 70 ms, saturates
+
+  Communicator::publish_loop_profile();
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+  const auto &tx_log = native_hal::can_bus(CAN3)->tx_log;
+  TEST_ASSERT_EQUAL(LOOP_STAGE_COUNT, tx_log.size());
+  for (std::size_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    TEST_ASSERT_EQUAL_HEX(MASTER_ID, tx_log[i].id);
+    TEST_ASSERT_EQUAL_HEX8(DBG_PROFILE_MSG, tx_log[i].buf[0]);
+    TEST_ASSERT_EQUAL(i, tx_log[i].buf[1]);
+  }
+  const auto frame = can_db::MasterMsgs::M54::unpack(
+      tx_log[static_cast<std::size_t>(LoopStage::OUTPUT_PROCESS)].buf);
+  TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, frame.profile_max_us);
+  TEST_ASSERT_EQUAL_UINT16(10, frame.profile_p99_us);  // 1000 ns bucket bound is 1023 ns
+  TEST_ASSERT_FLOAT_WITHIN(0.05, 1.0, frame.profile_p99_us_physical());
+
+  Communicator::publish_loop_profile();  // new window, nothing recorded in it
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+  const auto empty = can_db::MasterMsgs::M54::unpack(
+      tx_log[LOOP_STAGE_COUNT + static_cast<std::size_t>(LoopStage::OUTPUT_PROCESS)].buf);
+  TEST_ASSERT_EQUAL_UINT16(0, empty.profile_max_us);
+  TEST_ASSERT_EQUAL_UINT16(0, empty.profile_mean_us);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_histogram_buckets_and_percentiles);
+  RUN_TEST(test_window_and_total);
+  RUN_TEST(test_probe_times_its_scope);
+  RUN_TEST(test_publish_on_can);
+  return UNITY_END();
+}
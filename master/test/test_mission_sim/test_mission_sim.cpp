@@ -0,0 +1,391 @@
+// Full autonomous mission on the native build, driven by the manually advanced HAL clock
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+#include "comm/communicator.hpp"
+#include "embedded/digitalReceiver.hpp"
+#include "embedded/digitalSender.hpp"
+#include "logic/outputCoordinator.hpp"
+#include "logic/stateLogic.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+constexpr unsigned SIM_STEP_MS = 1;           // simulated time per loop iteration
+constexpr unsigned HEARTBEAT_PERIOD_MS = 20;  // PC, steering, inverter and RES frames
+constexpr unsigned SIM_TIMEOUT_MS = 20'000;   // give up if a stage never completes
+constexpr uint16_t SIM_DC_VOLTAGE = 2000;     // above DC_THRESHOLD, so TS turns on
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+DigitalSender digital_sender = DigitalSender();
+OutputCoordinator output_coordinator =
+    OutputCoordinator(&system_data, &communicator, &digital_sender);
+ASState as_state = ASState(&system_data, &communicator, &output_coordinator);
+
+uint32_t sim_ms = 0;         // simulated time spent in the current test
+uint8_t res_buttons = 0x01;  // RES byte 0: emergency stop released, GO not pressed
+bool res_connected = true;   // the RES radio link, its frames stop when false
+uint32_t last_res_ms = 0;    // sim_ms of the last RES frame
+
+void receive(const uint32_t id, std::initializer_list<uint8_t> data, const bool extended = false) {
+  CAN_message_t msg;
+  msg.id = id;
+  msg.flags.extended = extended;
+  msg.len = data.size();
+  std::copy(data.begin(), data.end(), msg.buf);
+  native_hal::can_bus(CAN3)->receive(msg);
+  Communicator::process_received();
+}
+
+/**
+ * @brief Frames every healthy car sends periodically, DC bus above the TS threshold
+ */
+void send_heartbeats() {
+  receive(AS_CU_ID, {PC_ALIVE});
+  receive(STEERING_ID, {0x00}, true);
+  receive(BAMO_RESPONSE_ID,
+          {BAMOCAR_BATTERY_VOLTAGE_CODE, SIM_DC_VOLTAGE & 0xFF, SIM_DC_VOLTAGE >> 8});
+  if (!res_connected) return;
+  receive(RES_STATE, {res_buttons, 0, 0, 0x80, 0, 0, 100, 0});
+  last_res_ms = sim_ms;
+}
+
+/**
+ * @brief Time passes, CAN traffic arrives and the outputs update, as in one loop() iteration
+ */
+void tick() {
+  native_hal::advance_ms(SIM_STEP_MS);
+  system_data.tick(millis());
+  sim_ms += SIM_STEP_MS;
+  if (sim_ms % HEARTBEAT_PERIOD_MS == 0) send_heartbeats();
+  output_coordinator.process(to_underlying(as_state.state_),
+                             to_underlying(as_state._checkup_manager_.checkup_state_));
+}
+
+void step() {
+  tick();
+  as_state.calculate_state();
+}
+
+template <class Predicate>
+bool step_until(Predicate done, void (*iteration)() = step) {
+  const uint32_t deadline = sim_ms + SIM_TIMEOUT_MS;
+  while (!done()) {
+    if (sim_ms >= deadline) return false;
+    iteration();
+  }
+  return true;
+}
+
+/**
+ * @brief OFF -> READY, following the AS_OFF branch of calculate_state()
+ * @details should_stay_manual_driving() is currently hard-wired to true, so calculate_state()
+ * never leaves MANUAL on its own; the initial checkup is run through the CheckupManager instead.
+ */
+bool run_off_to_ready() {
+  communicator.reset_r2d();
+  const bool checkup_done = step_until(
+      [] {
+        return !as_state._checkup_manager_.should_stay_off() &&
+               as_state._checkup_manager_.should_go_ready_from_off();
+      },
+      tick);
+  if (!checkup_done) return false;
+  output_coordinator.enter_ready_state();
+  as_state.state_ = State::AS_READY;
+  return true;
+}
+
+/**
+ * @brief Timings of the TICK edge between two states
+ */
+const EdgeStats &edge_stats(const State from, const State to) {
+  std::size_t row = 0;
+  while (ASState::TRANSITIONS[row].from != from || ASState::TRANSITIONS[row].to != to ||
+         ASState::TRANSITIONS[row].event != ASEvent::TICK) {
+    row++;
+  }
+  return as_state.state_machine_.stats(row);
+}
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  system_data = SystemData();
+  as_state.state_ = State::AS_OFF;
+  as_state.state_machine_.reset_stats();
+  EmergencyEvent::clear();
+  as_state._checkup_manager_.reset_checkup_state();
+  as_state._checkup_manager_.set_checkup_step_budget(CHECKUP_STEP_BUDGET);
+  communicator.init();
+  sim_ms = 0;
+  res_buttons = 0x01;
+  res_connected = true;
+  last_res_ms = 0;
+
+  system_data.hardware_data_.asms_on_ = true;
+  system_data.hardware_data_.asats_pressed_ = true;
+  system_data.hardware_data_.tsms_sdc_closed_ = true;
+  system_data.hardware_data_.pneumatic_line_pressure_ = true;
+  system_data.hardware_data_._hydraulic_line_pressure = HYDRAULIC_BRAKE_THRESHOLD;
+  system_data.hardware_data_.hydraulic_line_front_pressure = HYDRAULIC_BRAKE_THRESHOLD;
+}
+
+void tearDown() {
+  TimerScheduler::reset();
+  native_hal::use_real_clock();
+}
+
+/**
+ * @brief OFF -> READY -> DRIVING -> FINISHED in simulated time, with the RES GO ignored
+ * until READY_TIMEOUT_MS has elapsed
+ */
+void test_full_mission() {
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  const uint32_t ready_at_ms = sim_ms;
+
+  res_buttons = 0x03;  // GO switch on, keeps being sent until the car accepts it
+  TEST_ASSERT_TRUE(step_until([] { return as_state.state_ == State::AS_DRIVING; }));
+  TEST_ASSERT_GREATER_OR_EQUAL(READY_TIMEOUT_MS, sim_ms - ready_at_ms);
+  TEST_ASSERT_LESS_OR_EQUAL(READY_TIMEOUT_MS + HEARTBEAT_PERIOD_MS, sim_ms - ready_at_ms);
+  const EdgeStats &go = edge_stats(State::AS_READY, State::AS_DRIVING);
+  TEST_ASSERT_EQUAL_UINT32(1, go.trigger.count);
+  TEST_ASSERT_LESS_OR_EQUAL(SIM_STEP_MS * 1000, go.trigger.last_us);  // the GO's own iteration
+  TEST_ASSERT_GREATER_OR_EQUAL(READY_TIMEOUT_MS * 1000 - SIM_STEP_MS * 1000, go.dwell.last_us);
+
+  for (int i = 0; i < 1000; i++) step();  // drive for a second
+  TEST_ASSERT_EQUAL(State::AS_DRIVING, as_state.state_);
+
+  receive(AS_CU_ID, {MISSION_FINISHED});
+  step();
+  TEST_ASSERT_EQUAL(State::AS_FINISHED, as_state.state_);
+
+  system_data.hardware_data_.asms_on_ = false;
+  step();
+  TEST_ASSERT_EQUAL(State::AS_OFF, as_state.state_);
+  TEST_ASSERT_EQUAL_UINT32(1, edge_stats(State::AS_DRIVING, State::AS_FINISHED).dwell.count);
+  TEST_ASSERT_EQUAL_UINT32(3, as_state.state_machine_.taken());
+}
+
+/**
+ * @brief CPU time of one OFF -> READY -> DRIVING run from a fresh setUp(), in microseconds
+ * @details Thread CPU time rather than wall time, the runs that the scheduler preempts do not
+ * count the time the test process spent waiting.
+ */
+long long timed_mission_us() {
+  tearDown();
+  setUp();
+  timespec start{};
+  timespec end{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  res_buttons = 0x03;
+  TEST_ASSERT_TRUE(step_until([] { return as_state.state_ == State::AS_DRIVING; }));
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+  return (end.tv_sec - start.tv_sec) * 1'000'000LL + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/**
+ * @brief The same mission must run at least 1000 times faster than it would on the car
+ * @details The first run warms the caches and the allocator up and is discarded. Up to
+ * TIMED_RUNS more follow until one is under the bound and the best one is compared, so a stretch
+ * of host noise fails the test only if it lasts through every run.
+ */
+void test_mission_runs_faster_than_real_time() {
+  constexpr int TIMED_RUNS = 20;
+  timed_mission_us();
+  long long wall_us = timed_mission_us();
+  int runs = 1;
+  for (; runs < TIMED_RUNS && wall_us >= static_cast<long long>(sim_ms); runs++) {
+    wall_us = std::min(wall_us, timed_mission_us());
+  }
+
+  char message[80];
+  snprintf(message, sizeof(message), "%lu ms simulated in %lld us (best of %d)",
+           static_cast<unsigned long>(sim_ms), wall_us, runs);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_THAN(static_cast<long long>(sim_ms), wall_us);  // sim_ms * 1000 us / 1000
+}
+
+/**
+ * @brief Stepping through every satisfied checkup state in one loop() reaches READY sooner than
+ * one state per loop(), and the timeline shows where the time went. A step that drives an output
+ * still ends the loop(), so each EBS valve configuration is held while the inputs are read.
+ */
+void test_checkup_runs_to_completion() {
+  as_state._checkup_manager_.set_checkup_step_budget(1);
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  const uint32_t one_step_ms = sim_ms;
+
+  setUp();
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  char message[80];
+  snprintf(message, sizeof(message), "OFF -> READY in %lu ms, %lu ms one state per loop",
+           static_cast<unsigned long>(sim_ms), static_cast<unsigned long>(one_step_ms));
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_THAN(one_step_ms, sim_ms);
+
+  using CheckupState = CheckupManager::CheckupState;
+  const auto &timeline = as_state._checkup_manager_.checkup_timeline();
+  const auto at = [&](const CheckupState state) { return timeline[to_underlying(state)]; };
+  TEST_ASSERT_TRUE(at(CheckupState::CLOSE_SDC).visited);
+  TEST_ASSERT_EQUAL_UINT32(0, at(CheckupState::CLOSE_SDC).dwell_us);
+  TEST_ASSERT_TRUE(at(CheckupState::CHECKUP_COMPLETE).visited);
+  TEST_ASSERT_EQUAL_UINT32(at(CheckupState::WAIT_FOR_TS).entered_us +
+                               at(CheckupState::WAIT_FOR_TS).dwell_us,
+                           at(CheckupState::EBS_CHECKS).entered_us);
+  // TS is checked in the loop() after CLOSE_SDC, not in the one that closed it
+  TEST_ASSERT_GREATER_OR_EQUAL(SIM_STEP_MS * 1000, at(CheckupState::WAIT_FOR_TS).dwell_us);
+
+  // valve writes of one step share a timestamp, the next configuration comes a loop() later
+  unsigned configurations = 0;
+  uint64_t configured_us = 0;
+  for (const native_hal::OutputWrite &write : native_hal::output_log) {
+    if (write.pin != EBS_VALVE_REAR_PIN && write.pin != EBS_VALVE_FRONT_PIN) continue;
+    if (configurations > 0 && write.us == configured_us) continue;
+    if (configurations > 0) {
+      TEST_ASSERT_GREATER_OR_EQUAL(SIM_STEP_MS * 1000, write.us - configured_us);
+    }
+    configurations++;
+    configured_us = write.us;
+  }
+  TEST_ASSERT_EQUAL_UINT(3, configurations);  // rear off, front off, both on
+  TEST_ASSERT_GREATER_OR_EQUAL(3 * SIM_STEP_MS * 1000, at(CheckupState::EBS_CHECKS).dwell_us);
+}
+
+/**
+ * @brief A RES emergency stop in DRIVING is acted on by the calculate_state() of the iteration
+ * that received it, not at the next emergency timer tick
+ */
+void test_emergency_reaction_latency() {
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  res_buttons = 0x03;
+  TEST_ASSERT_TRUE(step_until([] { return as_state.state_ == State::AS_DRIVING; }));
+  for (int i = 0; i < 100; i++) step();
+
+  tick();
+  const uint64_t start_ns = native_hal::steady_ns();
+  receive(RES_STATE, {0x00, 0, 0, 0x00, 0, 0, 100, 0});  // emergency stop pressed
+  as_state.calculate_state();
+  const uint64_t reaction_ns = native_hal::steady_ns() - start_ns;
+  TEST_ASSERT_EQUAL(State::AS_EMERGENCY, as_state.state_);
+  TEST_ASSERT_FALSE(EmergencyEvent::pending());
+
+  std::size_t row = 0;
+  while (ASState::TRANSITIONS[row].from != State::AS_DRIVING ||
+         ASState::TRANSITIONS[row].event != ASEvent::EMERGENCY_CHECK) {
+    row++;
+  }
+  const EdgeStats &emergency = as_state.state_machine_.stats(row);
+  TEST_ASSERT_EQUAL_UINT32(1, emergency.trigger.count);
+  TEST_ASSERT_EQUAL_UINT32(0, emergency.trigger.last_us);  // same iteration, no simulated time
+
+  char message[80];
+  snprintf(message, sizeof(message), "RES frame -> enter_emergency_state() in %llu ns on the host",
+           static_cast<unsigned long long>(reaction_ns));
+  TEST_MESSAGE(message);
+}
+
+/**
+ * @brief Frames stop arriving: the component timestamps expire after exactly their timeout
+ */
+void test_heartbeat_timeout_in_virtual_time() {
+  send_heartbeats();
+  native_hal::advance_ms(COMPONENT_TIMESTAMP_TIMEOUT - 1);
+  system_data.tick(millis());
+  system_data.failure_detection_.kick(FailureTimer::RES);
+  TEST_ASSERT_FALSE(system_data.failure_detection_.has_any_component_timed_out());
+  native_hal::advance_ms(1);
+  system_data.tick(millis());
+  TEST_ASSERT_TRUE(system_data.failure_detection_.has_any_component_timed_out());
+  TEST_ASSERT_TRUE(system_data.failure_detection_.pc_dead_);
+  TEST_ASSERT_FALSE(system_data.failure_detection_.res_dead_);
+}
+
+/**
+ * @brief The RES link drops in READY: its deadline expires on the first tick of the wheel past
+ * RES_TIMESTAMP_TIMEOUT, the emergency check interrupt raises an EmergencyEvent and the next
+ * calculate_state() takes the car to EMERGENCY
+ */
+void test_res_loss_in_ready() {
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  // started by the AS_OFF row that run_off_to_ready() goes around
+  TimerScheduler::add("emergency_check", ASState::emergency_check_task,
+                      EMERGENCY_CHECK_INTERVAL_US, EMERGENCY_CHECK_PRIORITY);
+  for (int i = 0; i < 100; i++) step();
+  TEST_ASSERT_EQUAL(State::AS_READY, as_state.state_);
+
+  res_connected = false;
+  TEST_ASSERT_TRUE(step_until([] { return system_data.failure_detection_.res_dead_; }, tick));
+  TEST_ASSERT_EQUAL_UINT32(RES_TIMESTAMP_TIMEOUT, sim_ms - last_res_ms);
+  TEST_ASSERT_FALSE(system_data.failure_detection_.pc_dead_);
+  TEST_ASSERT_TRUE(step_until([] { return EmergencyEvent::pending(); }, tick));
+  TEST_ASSERT_EQUAL(State::AS_READY, as_state.state_);  // the interrupt left the table to loop()
+  step();
+  TEST_ASSERT_EQUAL(State::AS_EMERGENCY, as_state.state_);
+  TEST_ASSERT_LESS_OR_EQUAL(RES_TIMESTAMP_TIMEOUT + EMERGENCY_CHECK_INTERVAL_US / 1000 + SIM_STEP_MS,
+                            sim_ms - last_res_ms);
+}
+
+/**
+ * @brief The EBS release deadline started by the GO moves with SystemData::tick() only: time
+ * passing without a tick leaves it running
+ */
+void test_release_ebs_deadline_follows_ticks() {
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  res_buttons = 0x03;
+  TEST_ASSERT_TRUE(step_until([] { return as_state.state_ == State::AS_DRIVING; }));
+  TEST_ASSERT_FALSE(system_data.r2d_logics_.expired(R2DTimer::RELEASE_EBS));
+
+  native_hal::advance_ms(RELEASE_EBS_TIMEOUT_MS);
+  TEST_ASSERT_FALSE(system_data.r2d_logics_.expired(R2DTimer::RELEASE_EBS));
+  system_data.tick(millis());
+  TEST_ASSERT_TRUE(system_data.r2d_logics_.expired(R2DTimer::RELEASE_EBS));
+}
+
+/**
+ * @brief Every interrupt handler of the master runs for a second of READY and SystemData does not
+ * change a byte, which is what lets loop() copy it without masking interrupts
+ */
+void test_interrupts_leave_system_data_alone() {
+  TEST_ASSERT_TRUE(run_off_to_ready());
+  TimerScheduler::add("emergency_check", ASState::emergency_check_task,
+                      EMERGENCY_CHECK_INTERVAL_US, EMERGENCY_CHECK_PRIORITY);
+  TimerScheduler::add("watchdog_toggle", DigitalSender::toggle_watchdog, WATCHDOG_TOGGLE_PERIOD_US,
+                      WATCHDOG_TOGGLE_PRIORITY);
+  const DigitalReceiver digital_receiver(&system_data);  // attaches the wheel sensor interrupts
+  system_data.hardware_data_.tsms_sdc_closed_ = false;  // an emergency only loop() may act on
+
+  std::array<unsigned char, sizeof(SystemData)> before{};
+  std::memcpy(before.data(), static_cast<const void *>(&system_data), sizeof(SystemData));
+  for (unsigned ms = 1; ms <= 1000; ms++) {
+    native_hal::advance_ms(1);  // timer tasks
+    native_hal::set_digital_input(RR_WSS, ms % 2);
+    native_hal::set_digital_input(RL_WSS, ms % 2);
+    if (ms % HEARTBEAT_PERIOD_MS == 0) {  // FIFO interrupt only, decoding is loop()'s
+      CAN_message_t msg;
+      msg.id = RES_STATE;
+      msg.len = 8;
+      msg.buf[0] = res_buttons;
+      native_hal::can_bus(CAN3)->receive(msg);
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(
+      0, std::memcmp(before.data(), static_cast<const void *>(&system_data), sizeof(SystemData)));
+  TEST_ASSERT_TRUE(EmergencyEvent::pending());
+  Communicator::process_received();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_mission);
+  RUN_TEST(test_mission_runs_faster_than_real_time);
+  RUN_TEST(test_checkup_runs_to_completion);
+  RUN_TEST(test_emergency_reaction_latency);
+  RUN_TEST(test_heartbeat_timeout_in_virtual_time);
+  RUN_TEST(test_res_loss_in_ready);
+  RUN_TEST(test_release_ebs_deadline_follows_ticks);
+  RUN_TEST(test_interrupts_leave_system_data_alone);
+  return UNITY_END();
+}
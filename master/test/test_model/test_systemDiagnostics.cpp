@@ -1,3 +1,6 @@
+#include <chrono>
+
+#include "metro.h"
 #include "model/systemDiagnostics.hpp"
 #include "unity.h"
 
@@ -5,15 +8,51 @@ void test_hasAnyComponentTimedOut(void) {
   FailureDetection fd;
   TEST_ASSERT_FALSE(fd.has_any_component_timed_out());
   delay(COMPONENT_TIMESTAMP_TIMEOUT + 1);
+  fd.tick(millis());
   TEST_ASSERT_TRUE(fd.has_any_component_timed_out());
 }
 
-void setUp(void) {}
+#ifdef NATIVE
+/**
+ * @brief The RES timeout, the shortest heartbeat, reached by busy-waiting as loop() does, on the
+ * 1000x clock
+ */
+void test_hasAnyComponentTimedOut_scaledClock(void) {
+  native_hal::use_scaled_clock(1000);
+  const auto start = std::chrono::steady_clock::now();
+  Metro res_timeout{RES_TIMESTAMP_TIMEOUT};  // started no later than the wheel
+  FailureDetection fd;
+  const uint32_t start_ms = fd.deadlines_.now_ms();
+  while (!fd.has_any_component_timed_out()) {
+    fd.tick(millis());
+  }
+  TEST_ASSERT_TRUE(fd.expired(FailureTimer::RES));
+  TEST_ASSERT_TRUE(fd.deadlines_.now_ms() - start_ms >= RES_TIMESTAMP_TIMEOUT);
+  TEST_ASSERT_TRUE(res_timeout.checkWithoutReset());
+  const auto wall_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  TEST_ASSERT_LESS_THAN(RES_TIMESTAMP_TIMEOUT / 10, wall_ms);
+}
+#endif
+
+void setUp(void) {
+#ifdef NATIVE
+  native_hal::use_manual_clock();  // delay() advances the clock instead of sleeping
+#endif
+}
 
-void tearDown(void) {}
+void tearDown(void) {
+#ifdef NATIVE
+  native_hal::use_real_clock();
+#endif
+}
 
 int main() {
   UNITY_BEGIN();
   RUN_TEST(test_hasAnyComponentTimedOut);
+#ifdef NATIVE
+  RUN_TEST(test_hasAnyComponentTimedOut_scaledClock);
+#endif
   return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+// MovingAverage against the std::deque helpers it replaced on both boards
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <numeric>
+
+#include "../../moving_average.h"
+#include "unity.h"
+
+/**
+ * @brief insert_value_queue + average_queue as they were
+ */
+template <class T>
+T legacy_average(std::deque<T> &queue, const T value, const std::size_t window) {
+  queue.push_front(value);
+  if (queue.size() > window) queue.pop_back();
+  const double sum = std::accumulate(queue.begin(), queue.end(), 0);
+  return static_cast<T>(sum / queue.size());
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_empty_and_filling() {
+  MovingAverage<int, 5> average;
+  TEST_ASSERT_EQUAL_INT(0, average.average());
+  TEST_ASSERT_FALSE(average.full());
+
+  average.add(10);
+  TEST_ASSERT_EQUAL_INT(10, average.average());
+  average.add(21);
+  TEST_ASSERT_EQUAL_INT(15, average.average());  // 31 / 2, truncated
+  TEST_ASSERT_EQUAL_UINT32(2, average.size());
+
+  for (int i = 0; i < 3; i++) average.add(0);
+  TEST_ASSERT_TRUE(average.full());
+  TEST_ASSERT_EQUAL_INT(6, average.average());
+  average.add(0);  // the 10 leaves the window
+  TEST_ASSERT_EQUAL_INT(4, average.average());
+  TEST_ASSERT_EQUAL_INT(21, average.sum());
+
+  average.clear();
+  TEST_ASSERT_EQUAL_INT(0, average.average());
+  TEST_ASSERT_EQUAL_UINT32(0, average.size());
+}
+
+/**
+ * @brief Same results as the deque helpers for ADC-like and signed sequences
+ */
+void test_matches_legacy_helpers() {
+  srand(7);
+  MovingAverage<uint16_t, 5> apps;
+  std::deque<uint16_t> apps_queue;
+  MovingAverage<int, 5> brake;
+  std::deque<int> brake_queue;
+  for (int i = 0; i < 10'000; i++) {
+    const auto reading = static_cast<uint16_t>(rand() % 1024);
+    apps.add(reading);
+    TEST_ASSERT_EQUAL_UINT16(legacy_average<uint16_t>(apps_queue, reading, 5), apps.average());
+
+    const int signed_reading = rand() % 2001 - 1000;
+    brake.add(signed_reading);
+    TEST_ASSERT_EQUAL_INT(legacy_average<int>(brake_queue, signed_reading, 5), brake.average());
+  }
+}
+
+/**
+ * @brief The running sum stays exact over many wraps of the ring at the largest sample values
+ */
+void test_running_sum_stays_exact() {
+  MovingAverage<uint16_t, 8> average;
+  for (int i = 0; i < 100'000; i++) average.add(static_cast<uint16_t>(i % 3 == 0 ? 65535 : i));
+  int32_t expected = 0;
+  for (int i = 100'000 - 8; i < 100'000; i++) expected += i % 3 == 0 ? 65535 : (i & 0xFFFF);
+  TEST_ASSERT_EQUAL_INT32(expected, average.sum());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_and_filling);
+  RUN_TEST(test_matches_legacy_helpers);
+  RUN_TEST(test_running_sum_stays_exact);
+  return UNITY_END();
+}
@@ -0,0 +1,141 @@
+// Change-only output writes through OutputShadow, checked against the native HAL's write log
+#include <Arduino.h>
+
+#include <cstddef>
+
+#include "comm/communicator.hpp"
+#include "embedded/digitalSender.hpp"
+#include "embedded/outputShadow.hpp"
+#include "logic/outputCoordinator.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  system_data = SystemData();
+  OutputShadow::invalidate();
+  OutputShadow::reset_stats();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+void assert_write(const std::size_t index, const int pin, const int value, const bool analog) {
+  TEST_ASSERT_LESS_THAN(native_hal::output_log.size(), index);
+  const native_hal::OutputWrite &write = native_hal::output_log[index];
+  TEST_ASSERT_EQUAL(pin, write.pin);
+  TEST_ASSERT_EQUAL(value, write.value);
+  TEST_ASSERT_EQUAL(analog, write.analog);
+}
+
+/**
+ * @brief A value the pin already has never reaches it, digital and analog kept apart
+ */
+void test_only_changes_are_written() {
+  DigitalSender digital_sender;  // drives the EBS valves
+  native_hal::output_log.clear();
+  OutputShadow::reset_stats();
+  for (int i = 0; i < 10; i++) DigitalSender::close_watchdog_sdc();
+  DigitalSender::open_sdc();
+  DigitalSender::open_sdc();
+  DigitalSender::close_sdc();
+  digital_sender.turn_on_blue();
+  digital_sender.turn_on_blue();
+  DigitalSender::turn_off_assi();
+  DigitalSender::activate_ebs();
+
+  TEST_ASSERT_EQUAL(6, native_hal::output_log.size());
+  assert_write(0, WD_SDC_CLOSE, HIGH, false);
+  assert_write(1, CLOSE_SDC, LOW, false);
+  assert_write(2, CLOSE_SDC, HIGH, false);
+  assert_write(3, ASSI_BLUE_PIN, 1023, true);
+  assert_write(4, ASSI_YELLOW_PIN, LOW, true);
+  assert_write(5, ASSI_BLUE_PIN, LOW, true);
+  TEST_ASSERT_EQUAL_UINT32(6, OutputShadow::writes());
+  TEST_ASSERT_EQUAL_UINT32(9 + 1 + 1 + 2, OutputShadow::skipped());
+
+  OutputShadow::invalidate();  // e.g. after pinMode(), the next write goes through again
+  DigitalSender::close_watchdog_sdc();
+  TEST_ASSERT_EQUAL(7, native_hal::output_log.size());
+}
+
+/**
+ * @brief Staged levels reach the pins on commit, only the last one and only if it changed
+ */
+void test_staged_outputs_commit_together() {
+  DigitalSender digital_sender;
+  native_hal::output_log.clear();
+  digital_sender.turn_on_brake_light();
+  digital_sender.bspd_error();
+  digital_sender.turn_off_brake_light();
+  TEST_ASSERT_EQUAL(0, native_hal::output_log.size());
+
+  DigitalSender::apply_staged_outputs();
+  TEST_ASSERT_EQUAL(2, native_hal::output_log.size());
+  assert_write(0, SDC_BSPD_OUT, HIGH, false);  // in OUTPUT_PINS order
+  assert_write(1, BRAKE_LIGHT, LOW, false);
+
+  digital_sender.bspd_error();
+  DigitalSender::apply_staged_outputs();
+  DigitalSender::apply_staged_outputs();
+  TEST_ASSERT_EQUAL(2, native_hal::output_log.size());
+}
+
+/**
+ * @brief The OutputCoordinator writes the brake light, BSPD and SDC once, not every loop()
+ */
+void test_coordinator_writes_on_change() {
+  DigitalSender digital_sender;
+  OutputCoordinator output_coordinator(&system_data, &communicator, &digital_sender);
+  system_data.hardware_data_.tsms_sdc_closed_ = true;
+  system_data.hardware_data_._hydraulic_line_pressure = 0;
+  native_hal::output_log.clear();
+
+  for (int i = 0; i < 100; i++) output_coordinator.process(to_underlying(State::AS_OFF), 0);
+  TEST_ASSERT_EQUAL(2, native_hal::output_log.size());
+  assert_write(0, SDC_BSPD_OUT, LOW, false);
+  assert_write(1, BRAKE_LIGHT, LOW, false);
+
+  system_data.hardware_data_._hydraulic_line_pressure = BRAKE_PRESSURE_LOWER_THRESHOLD;
+  system_data.hardware_data_.tsms_sdc_closed_ = false;
+  for (int i = 0; i < 100; i++) output_coordinator.process(to_underlying(State::AS_OFF), 0);
+  TEST_ASSERT_EQUAL(5, native_hal::output_log.size());
+  assert_write(2, CLOSE_SDC, LOW, false);  // dash_ats_update() runs first, immediate
+  assert_write(3, SDC_BSPD_OUT, HIGH, false);
+  assert_write(4, BRAKE_LIGHT, HIGH, false);
+}
+
+/**
+ * @brief An interrupt that lands between a write's digitalWrite() and its shadow update still
+ * gets its own level onto the pin, as the watchdog toggle needs against loop()
+ */
+void test_interrupt_inside_write_keeps_its_level() {
+  OutputShadow::write(WD_ALIVE, LOW);
+  native_hal::output_log.clear();
+  native_hal::on_output_write = [](const native_hal::OutputWrite &write) {
+    if (write.pin == WD_ALIVE && write.value == HIGH) {
+      native_hal::run_isr([] { OutputShadow::write(WD_ALIVE, LOW); });
+    }
+  };
+  OutputShadow::write(WD_ALIVE, HIGH);
+  native_hal::on_output_write = nullptr;
+
+  TEST_ASSERT_EQUAL(2, native_hal::output_log.size());
+  assert_write(0, WD_ALIVE, HIGH, false);
+  assert_write(1, WD_ALIVE, LOW, false);  // held back until the write was done
+  TEST_ASSERT_EQUAL(LOW, native_hal::digital_output(WD_ALIVE));
+  OutputShadow::write(WD_ALIVE, HIGH);  // the shadow knows the pin is LOW
+  TEST_ASSERT_EQUAL(3, native_hal::output_log.size());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_only_changes_are_written);
+  RUN_TEST(test_staged_outputs_commit_together);
+  RUN_TEST(test_coordinator_writes_on_change);
+  RUN_TEST(test_interrupt_inside_write_keeps_its_level);
+  return UNITY_END();
+}
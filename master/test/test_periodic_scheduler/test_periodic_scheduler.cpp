@@ -0,0 +1,134 @@
+// Cooperative rate-monotonic scheduler of the periodic CAN publishers, on the manual HAL clock
+#include <Arduino.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "../../periodic_scheduler.h"
+#include "comm/communicator.hpp"
+#include "embedded/digitalSender.hpp"
+#include "logic/outputCoordinator.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+struct Log {
+  std::string runs;
+  uint32_t slow_us = 0;  ///< How long the "slow" job pretends to take
+};
+
+using Job = PeriodicJob<void (*)(Log &)>;
+
+constexpr std::array<Job, 3> JOBS = {{
+    {"fast", 20, 0, [](Log &log) { log.runs += 'f'; }},
+    {"medium", 30, 0, [](Log &log) { log.runs += 'm'; }},
+    {"slow", 50, 5,
+     [](Log &log) {
+       log.runs += 's';
+       native_hal::clock_state.manual_us += log.slow_us;
+     }},
+}};
+
+static_assert(rate_monotonic_order(JOBS));
+static_assert(min_release_gap_ms(JOBS) == 0);  // fast and medium meet every 60 ms
+constexpr std::array<Job, 2> SPREAD = {{{"a", 200, 0, nullptr}, {"b", 500, 25, nullptr}}};
+static_assert(min_release_gap_ms(SPREAD) == 25);
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+/**
+ * @brief Releases stay on their grid whatever the loop period, the jitter is what the loop adds
+ */
+void test_releases_do_not_drift() {
+  CooperativeScheduler<void (*)(Log &), 3> scheduler{JOBS};
+  Log log;
+  scheduler.start();
+  for (int i = 0; i < 10'000; i++) {
+    native_hal::advance_us(i % 2 == 0 ? 3000 : 4000);  // a loop of 3.5 ms on average
+    scheduler.run(log);
+  }
+  // 35 s, releases at 0 ms and every period after, at 5 ms and every period after for slow
+  TEST_ASSERT_EQUAL_UINT32(1751, scheduler.stats(0).runs);
+  TEST_ASSERT_EQUAL_UINT32(1167, scheduler.stats(1).runs);
+  TEST_ASSERT_EQUAL_UINT32(700, scheduler.stats(2).runs);
+  TEST_ASSERT_LESS_THAN(4000, scheduler.stats(0).max_jitter_us);
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(0).overruns);
+}
+
+/**
+ * @brief With a budget of one job per call the shortest period goes first, the other waits
+ */
+void test_budget_defers_by_priority() {
+  CooperativeScheduler<void (*)(Log &), 3> scheduler{JOBS};
+  Log log;
+  scheduler.start();
+  TEST_ASSERT_EQUAL_UINT32(2, scheduler.run(log));
+  native_hal::advance_ms(60);  // all three due
+  TEST_ASSERT_EQUAL_UINT32(1, scheduler.run(log, 1));
+  native_hal::advance_ms(1);
+  TEST_ASSERT_EQUAL_UINT32(1, scheduler.run(log, 1));
+  native_hal::advance_ms(1);
+  TEST_ASSERT_EQUAL_UINT32(1, scheduler.run(log, 1));
+  TEST_ASSERT_EQUAL_STRING("fmfms", log.runs.c_str());
+  TEST_ASSERT_EQUAL_UINT32(1000, scheduler.stats(1).max_jitter_us);
+  TEST_ASSERT_EQUAL_UINT32(2, scheduler.stats(0).overruns);  // 20 and 40 ms were never run
+}
+
+/**
+ * @brief A job that runs past its next release is an overrun
+ */
+void test_overrun() {
+  CooperativeScheduler<void (*)(Log &), 3> scheduler{JOBS};
+  Log log;
+  log.slow_us = 60'000;
+  scheduler.start();
+  scheduler.run(log);
+  native_hal::advance_ms(5);
+  scheduler.run(log);
+  TEST_ASSERT_EQUAL_STRING("fms", log.runs.c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, scheduler.stats(2).overruns);
+  TEST_ASSERT_EQUAL_UINT32(60'000, scheduler.stats(2).max_run_us);
+  scheduler.reset_stats();
+  TEST_ASSERT_EQUAL_UINT32(0, scheduler.stats(2).runs);
+}
+
+/**
+ * @brief The OutputCoordinator publishers never share a loop() iteration
+ */
+void test_publishers_are_spread() {
+  SystemData system_data;
+  Communicator communicator(&system_data);
+  DigitalSender digital_sender;
+  OutputCoordinator output_coordinator(&system_data, &communicator, &digital_sender);
+  communicator.init();
+  output_coordinator.init();
+
+  uint32_t most_per_loop = 0;
+  uint32_t runs = 0;
+  for (int i = 0; i < 5000; i++) {  // 5 s of 1 ms loops
+    native_hal::advance_ms(1);
+    output_coordinator.process(0, 0);
+    uint32_t total = 0;
+    for (std::size_t job = 0; job < OutputCoordinator::PUBLISHER_COUNT; job++) {
+      total += output_coordinator.publishers_.stats(job).runs;
+    }
+    most_per_loop = std::max(most_per_loop, total - runs);
+    runs = total;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, most_per_loop);
+  TEST_ASSERT_EQUAL_UINT32(26 + 2 * 10 + 2 * 5, runs);  // status is released at 0 ms too
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_releases_do_not_drift);
+  RUN_TEST(test_budget_defers_by_priority);
+  RUN_TEST(test_overrun);
+  RUN_TEST(test_publishers_are_spread);
+  return UNITY_END();
+}
@@ -0,0 +1,125 @@
+// RunningMedian and HampelFilter against a sorted copy of the window
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "../../running_median.h"
+#include "unity.h"
+
+/**
+ * @brief Median of a copy of the window, the mean of the middle two when even, truncated
+ */
+template <class T>
+int64_t reference_median(std::vector<T> window) {
+  std::sort(window.begin(), window.end());
+  const std::size_t middle = window.size() / 2;
+  if (window.size() % 2 != 0) return window[middle];
+  return (static_cast<int64_t>(window[middle - 1]) + window[middle]) / 2;
+}
+
+template <class T>
+int64_t reference_deviation(const std::vector<T> &window) {
+  const int64_t center = reference_median(window);
+  std::vector<int64_t> deviations;
+  for (const T value : window) deviations.push_back(std::abs(value - center));
+  return reference_median(deviations);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_empty_and_filling() {
+  RunningMedian<uint16_t, 5> median;
+  TEST_ASSERT_EQUAL_UINT16(0, median.median());
+  TEST_ASSERT_EQUAL_INT32(0, median.deviation());
+
+  median.add(40);
+  TEST_ASSERT_EQUAL_UINT16(40, median.median());
+  median.add(11);
+  TEST_ASSERT_EQUAL_UINT16(25, median.median());  // (11 + 40) / 2, truncated
+  median.add(1000);
+  TEST_ASSERT_EQUAL_UINT16(40, median.median());
+  TEST_ASSERT_EQUAL_INT32(29, median.deviation());  // |11 - 40|, 0, |1000 - 40|
+  TEST_ASSERT_FALSE(median.full());
+
+  median.clear();
+  TEST_ASSERT_EQUAL_UINT32(0, median.size());
+  TEST_ASSERT_EQUAL_UINT16(0, median.value());
+}
+
+/**
+ * @brief Odd and even windows over random sequences with many repeated values, signed and not
+ */
+void test_matches_sorted_window() {
+  srand(11);
+  RunningMedian<uint16_t, 5> odd;
+  RunningMedian<int32_t, 8> even;
+  std::deque<uint16_t> odd_window;
+  std::deque<int32_t> even_window;
+  for (int i = 0; i < 20'000; i++) {
+    const auto reading = static_cast<uint16_t>(rand() % 64);
+    odd.add(reading);
+    odd_window.push_back(reading);
+    if (odd_window.size() > 5) odd_window.pop_front();
+    const std::vector<uint16_t> odd_copy(odd_window.begin(), odd_window.end());
+    TEST_ASSERT_EQUAL_INT32(reference_median(odd_copy), odd.median());
+    TEST_ASSERT_EQUAL_INT32(reference_deviation(odd_copy), odd.deviation());
+
+    const int32_t signed_reading = rand() % 2001 - 1000;
+    even.add(signed_reading);
+    even_window.push_back(signed_reading);
+    if (even_window.size() > 8) even_window.pop_front();
+    const std::vector<int32_t> even_copy(even_window.begin(), even_window.end());
+    TEST_ASSERT_EQUAL_INT32(reference_median(even_copy), even.median());
+    TEST_ASSERT_EQUAL_INT32(reference_deviation(even_copy), even.deviation());
+  }
+}
+
+/**
+ * @brief Single spikes are replaced by the median, noise within min_deviation and a real step
+ * pass through
+ */
+void test_hampel_rejects_spikes() {
+  HampelFilter<uint16_t, 5> filter{20};
+  for (int i = 0; i < 10; i++) {
+    TEST_ASSERT_EQUAL_UINT16(300 + i % 3, filter.add(static_cast<uint16_t>(300 + i % 3)));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, filter.rejected());
+
+  TEST_ASSERT_EQUAL_UINT16(301, filter.add(1023));  // ADC spike
+  TEST_ASSERT_EQUAL_UINT16(301, filter.add(0));     // and its opposite
+  TEST_ASSERT_EQUAL_UINT32(2, filter.rejected());
+  TEST_ASSERT_EQUAL_UINT16(315, filter.add(315));  // within min_deviation of the median
+
+  // a step to 600 shows up once it is the median of the window
+  filter.clear();
+  for (int i = 0; i < 5; i++) filter.add(300);
+  TEST_ASSERT_EQUAL_UINT16(300, filter.add(600));
+  TEST_ASSERT_EQUAL_UINT16(300, filter.add(600));
+  TEST_ASSERT_EQUAL_UINT16(600, filter.add(600));
+  TEST_ASSERT_EQUAL_UINT16(600, filter.value());
+}
+
+/**
+ * @brief A noisy signal whose spread is well above min_deviation is left alone
+ */
+void test_hampel_keeps_wide_noise() {
+  HampelFilter<uint16_t, 7> filter{2};
+  const uint16_t pattern[] = {400, 430, 370, 415, 385, 440, 360};
+  for (int round = 0; round < 10; round++) {
+    for (const uint16_t reading : pattern) TEST_ASSERT_EQUAL_UINT16(reading, filter.add(reading));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, filter.rejected());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_and_filling);
+  RUN_TEST(test_matches_sorted_window);
+  RUN_TEST(test_hampel_rejects_spikes);
+  RUN_TEST(test_hampel_keeps_wide_noise);
+  return UNITY_END();
+}
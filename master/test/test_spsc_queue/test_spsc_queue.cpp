@@ -0,0 +1,120 @@
+// SPSC queue between the CAN interrupt and loop(), with a producer thread standing in for the ISR
+#include <atomic>
+#include <thread>
+
+#include "comm/communicator.hpp"
+#include "comm/spscQueue.hpp"
+#include "model/systemData.hpp"
+#include "unity.h"
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+void setUp() {
+  native_hal::reset();
+  system_data = SystemData();
+  communicator.init();
+}
+
+void tearDown() {}
+
+void test_fifo_order_and_counters() {
+  SpscQueue<int, 4> queue;
+  int item = 0;
+  TEST_ASSERT_FALSE(queue.pop(item));
+  for (int i = 1; i <= 4; i++) TEST_ASSERT_TRUE(queue.push(i));
+  TEST_ASSERT_FALSE(queue.push(5));
+  TEST_ASSERT_EQUAL_UINT32(1, queue.overflows());
+  TEST_ASSERT_EQUAL_UINT32(4, queue.high_water_mark());
+
+  TEST_ASSERT_TRUE(queue.pop(item));
+  TEST_ASSERT_EQUAL(1, item);
+  TEST_ASSERT_TRUE(queue.push(6));  // wraps around
+  for (const int expected : {2, 3, 4, 6}) {
+    TEST_ASSERT_TRUE(queue.pop(item));
+    TEST_ASSERT_EQUAL(expected, item);
+  }
+  TEST_ASSERT_TRUE(queue.empty());
+  TEST_ASSERT_EQUAL_UINT32(4, queue.high_water_mark());
+}
+
+/**
+ * @brief A producer thread pushes frames as fast as it can while this thread drains them: every
+ * frame arrives once, in order, intact, or is counted as an overflow
+ */
+void test_concurrent_producer() {
+  constexpr uint32_t FRAMES = 2'000'000;
+  SpscQueue<CAN_message_t, 64> queue;
+  std::atomic<bool> done{false};
+
+  std::thread producer([&] {
+    CAN_message_t msg;
+    for (uint32_t i = 0; i < FRAMES; i++) {
+      msg.id = i & 0x7FF;
+      msg.len = 8;
+      for (int b = 0; b < 4; b++) msg.buf[b] = msg.buf[b + 4] = static_cast<uint8_t>(i >> 8 * b);
+      queue.push(msg);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t received = 0;
+  uint32_t last = 0;
+  bool in_order = true;
+  bool intact = true;
+  CAN_message_t msg;
+  while (!done.load(std::memory_order_acquire) || !queue.empty()) {
+    if (!queue.pop(msg)) continue;
+    const uint32_t sequence = msg.buf[0] | msg.buf[1] << 8 | msg.buf[2] << 16 | msg.buf[3] << 24;
+    intact &= (sequence & 0x7FF) == msg.id &&
+              sequence == static_cast<uint32_t>(msg.buf[4] | msg.buf[5] << 8 | msg.buf[6] << 16 |
+                                                msg.buf[7] << 24);
+    in_order &= received == 0 || sequence > last;
+    last = sequence;
+    received++;
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(intact);
+  TEST_ASSERT_TRUE(in_order);
+  TEST_ASSERT_EQUAL_UINT32(FRAMES, received + queue.overflows());
+  TEST_ASSERT_LESS_OR_EQUAL(64, queue.high_water_mark());
+}
+
+/**
+ * @brief The FIFO interrupt only queues, decoding waits for process_received()
+ */
+void test_communicator_defers_decoding() {
+  CAN_message_t msg;
+  msg.id = AS_CU_ID;
+  msg.len = 1;
+  msg.buf[0] = MISSION_FINISHED;
+  TEST_ASSERT_TRUE(native_hal::can_bus(CAN3)->receive(msg));
+  TEST_ASSERT_FALSE(system_data.mission_finished_);
+  TEST_ASSERT_EQUAL(1, Communicator::rx_queue().size());
+
+  Communicator::process_received();
+  TEST_ASSERT_TRUE(system_data.mission_finished_);
+  TEST_ASSERT_TRUE(Communicator::rx_queue().empty());
+}
+
+void test_communicator_counts_overflows() {
+  CAN_message_t msg;
+  msg.id = AS_CU_ID;
+  msg.len = 1;
+  msg.buf[0] = PC_ALIVE;
+  for (std::size_t i = 0; i < RX_QUEUE_CAPACITY + 3; i++) native_hal::can_bus(CAN3)->receive(msg);
+  TEST_ASSERT_EQUAL_UINT32(3, Communicator::rx_queue().overflows());
+  TEST_ASSERT_EQUAL_UINT32(RX_QUEUE_CAPACITY, Communicator::rx_queue().high_water_mark());
+  Communicator::process_received();
+  TEST_ASSERT_TRUE(Communicator::rx_queue().empty());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fifo_order_and_counters);
+  RUN_TEST(test_concurrent_producer);
+  RUN_TEST(test_communicator_defers_decoding);
+  RUN_TEST(test_communicator_counts_overflows);
+  return UNITY_END();
+}
@@ -0,0 +1,131 @@
+// The transition table engine behind ASState, on a small table of its own
+#include <Arduino.h>
+
+#include <array>
+#include <cstdint>
+
+#include "logic/stateMachine.hpp"
+#include "unity.h"
+
+enum class Light : uint8_t { RED, GREEN, YELLOW, BROKEN };
+enum class Tick : uint8_t { LOOP, FAULT };
+
+struct Lamp {
+  bool go = false;
+  bool stop = false;
+  bool faulty = false;
+  uint32_t go_us = 0;
+  int red_loops = 0;
+  int entered_green = 0;
+};
+
+using Row = Transition<Lamp, Light, Tick>;
+
+constexpr std::array<Row, 7> TABLE = {{
+    {Light::RED, Tick::LOOP, nullptr, [](Lamp &lamp) { lamp.red_loops++; }, Light::RED},
+    {Light::RED, Tick::LOOP, [](Lamp &lamp) { return lamp.go; },
+     [](Lamp &lamp) { lamp.entered_green++; }, Light::GREEN,
+     [](const Lamp &lamp) { return lamp.go_us; }},
+    {Light::RED, Tick::LOOP, [](Lamp &) { return true; }, nullptr, Light::YELLOW},
+    {Light::GREEN, Tick::LOOP, [](Lamp &lamp) { return lamp.stop; }, nullptr, Light::YELLOW},
+    {Light::YELLOW, Tick::LOOP, nullptr, nullptr, Light::RED},
+    {Light::GREEN, Tick::FAULT, [](Lamp &lamp) { return lamp.faulty; }, nullptr, Light::BROKEN},
+    {Light::BROKEN, Tick::LOOP, [](Lamp &) { return false; }, nullptr, Light::RED},
+}};
+
+static_assert(reachable_states(TABLE, Light::RED) == 0b1111);
+static_assert(reachable_states(TABLE, Light::YELLOW) == 0b1111);
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+/**
+ * @brief Internal rows run and evaluation goes on, the first enabled exit in table order wins
+ */
+void test_row_order() {
+  StateMachine<Lamp, Light, Tick, TABLE.size()> machine{TABLE};
+  Lamp lamp;
+  Light light = Light::RED;
+
+  lamp.go = true;
+  TEST_ASSERT_TRUE(machine.dispatch(light, lamp, Tick::LOOP));
+  TEST_ASSERT_EQUAL(Light::GREEN, light);  // row 1 before the always-true row 2
+  TEST_ASSERT_EQUAL(1, lamp.red_loops);
+  TEST_ASSERT_EQUAL(1, lamp.entered_green);
+
+  TEST_ASSERT_FALSE(machine.dispatch(light, lamp, Tick::LOOP));  // stop is false
+  TEST_ASSERT_FALSE(machine.dispatch(light, lamp, Tick::FAULT));
+  lamp.faulty = true;
+  TEST_ASSERT_TRUE(machine.dispatch(light, lamp, Tick::FAULT));  // only on its event
+  TEST_ASSERT_EQUAL(Light::BROKEN, light);
+  TEST_ASSERT_EQUAL_UINT32(2, machine.taken());
+  TEST_ASSERT_EQUAL_UINT8(5, machine.recent(0).row);
+  TEST_ASSERT_EQUAL_UINT8(1, machine.recent(1).row);
+}
+
+/**
+ * @brief Dwell time per edge, and the trigger latency only when the trigger happened while in
+ * the source state
+ */
+void test_edge_timing() {
+  StateMachine<Lamp, Light, Tick, TABLE.size()> machine{TABLE};
+  Lamp lamp;
+  Light light = Light::RED;
+
+  machine.dispatch(light, lamp, Tick::LOOP);  // RED -> YELLOW straight away
+  machine.dispatch(light, lamp, Tick::LOOP);  // YELLOW -> RED
+  native_hal::advance_us(700);
+  lamp.go_us = static_cast<uint32_t>(micros());
+  lamp.go = true;
+  native_hal::advance_us(300);
+  const auto left_red_us = static_cast<uint32_t>(micros());
+  machine.dispatch(light, lamp, Tick::LOOP);
+
+  const EdgeStats &red_to_green = machine.stats(1);
+  TEST_ASSERT_EQUAL_UINT32(1, red_to_green.dwell.count);
+  TEST_ASSERT_EQUAL_UINT32(1000, red_to_green.dwell.last_us);
+  TEST_ASSERT_EQUAL_UINT32(1, red_to_green.trigger.count);
+  TEST_ASSERT_EQUAL_UINT32(300, red_to_green.trigger.last_us);
+  TEST_ASSERT_EQUAL_UINT32(left_red_us, machine.recent(0).at_us);
+  TEST_ASSERT_EQUAL_UINT32(left_red_us, machine.entered_us());
+
+  // a GO from before the last time the light turned red is not what made it turn green
+  lamp.stop = true;
+  machine.dispatch(light, lamp, Tick::LOOP);
+  machine.dispatch(light, lamp, Tick::LOOP);
+  native_hal::advance_us(50);
+  machine.dispatch(light, lamp, Tick::LOOP);
+  TEST_ASSERT_EQUAL(Light::GREEN, light);
+  TEST_ASSERT_EQUAL_UINT32(2, red_to_green.dwell.count);
+  TEST_ASSERT_EQUAL_UINT32(50, red_to_green.dwell.min_us);
+  TEST_ASSERT_EQUAL_UINT32(525, red_to_green.dwell.mean_us());
+  TEST_ASSERT_EQUAL_UINT32(1, red_to_green.trigger.count);
+}
+
+/**
+ * @brief A state set from outside starts its dwell time at the next dispatch
+ */
+void test_state_set_from_outside() {
+  StateMachine<Lamp, Light, Tick, TABLE.size()> machine{TABLE};
+  Lamp lamp;
+  Light light = Light::GREEN;
+  native_hal::advance_us(5000);
+  machine.dispatch(light, lamp, Tick::LOOP);
+  light = Light::YELLOW;
+  native_hal::advance_us(10);
+  machine.dispatch(light, lamp, Tick::LOOP);
+  TEST_ASSERT_EQUAL(Light::RED, light);
+  TEST_ASSERT_EQUAL_UINT32(0, machine.stats(4).dwell.last_us);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_row_order);
+  RUN_TEST(test_edge_timing);
+  RUN_TEST(test_state_set_from_outside);
+  return UNITY_END();
+}
@@ -0,0 +1,103 @@
+// The single-timer scheduler behind every periodic interrupt task, on the manual HAL clock
+#include <Arduino.h>
+
+#include <cstdint>
+#include <string>
+
+#include "timerScheduler.hpp"
+#include "unity.h"
+
+std::string runs;  // which task ran, in order
+
+void fast() { runs += 'f'; }
+void slow() { runs += 's'; }
+void overrun() {
+  runs += 'o';
+  native_hal::clock_state.manual_us += 25'000;  // takes longer than its 20 ms period
+}
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  TimerScheduler::reset();
+  runs.clear();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+/**
+ * @brief One timer at the greatest common divisor of the periods, tasks released on the same
+ * tick run in priority order whatever order they were added in
+ */
+void test_priority_order_on_one_timer() {
+  TEST_ASSERT_TRUE(TimerScheduler::add("slow", slow, 30'000, 2));
+  TEST_ASSERT_TRUE(TimerScheduler::add("fast", fast, 20'000, 0));
+  TEST_ASSERT_EQUAL_UINT32(10'000, TimerScheduler::tick_us());
+  TEST_ASSERT_EQUAL_UINT32(1, native_hal::timers.size());
+
+  native_hal::advance_ms(60);
+  TEST_ASSERT_EQUAL_UINT32(6, TimerScheduler::ticks());
+  TEST_ASSERT_EQUAL_STRING("fsffs", runs.c_str());  // 20, 30, 40, then fast first at 60
+  TEST_ASSERT_EQUAL_UINT32(3, TimerScheduler::stats(fast)->releases);
+  TEST_ASSERT_EQUAL_UINT32(2, TimerScheduler::stats(slow)->releases);
+  TEST_ASSERT_EQUAL_UINT32(0, TimerScheduler::stats(slow)->max_lateness_us);
+
+  native_hal::advance_ms(600'000);  // no drift over ten minutes
+  TEST_ASSERT_EQUAL_UINT32(30'003, TimerScheduler::stats(fast)->releases);
+  TEST_ASSERT_EQUAL_UINT32(0, TimerScheduler::stats(fast)->deadline_misses);
+}
+
+/**
+ * @brief Disabling a task retunes the timer to the ones left, none left stops it
+ */
+void test_enable_and_disable() {
+  TimerScheduler::add("slow", slow, 30'000, 1);
+  TimerScheduler::add("fast", fast, 20'000, 0, false);
+  TEST_ASSERT_EQUAL_UINT32(30'000, TimerScheduler::tick_us());
+  TEST_ASSERT_FALSE(TimerScheduler::enabled(fast));
+
+  TimerScheduler::enable(fast);
+  TEST_ASSERT_EQUAL_UINT32(10'000, TimerScheduler::tick_us());
+  native_hal::advance_ms(20);
+  TimerScheduler::disable(fast);
+  native_hal::advance_ms(100);
+  TEST_ASSERT_EQUAL_UINT32(1, TimerScheduler::stats(fast)->releases);
+
+  TimerScheduler::disable(slow);
+  TEST_ASSERT_EQUAL_UINT32(0, TimerScheduler::tick_us());
+  TEST_ASSERT_EQUAL_UINT32(0, native_hal::timers.size());
+  TEST_ASSERT_NULL(TimerScheduler::stats(overrun));
+}
+
+/**
+ * @brief Releases lost while interrupts were off, and a task running past its next release,
+ * count as deadline misses
+ */
+void test_deadline_misses() {
+  TimerScheduler::add("fast", fast, 10'000, 0);
+  TimerScheduler::add("overrun", overrun, 20'000, 1);
+
+  noInterrupts();
+  native_hal::advance_ms(35);  // the 10, 20 and 30 ms ticks are held off
+  interrupts();
+  native_hal::service_timers();
+  TEST_ASSERT_EQUAL_UINT32(1, TimerScheduler::stats(fast)->releases);
+  TEST_ASSERT_EQUAL_UINT32(2, TimerScheduler::stats(fast)->deadline_misses);  // 10 and 20 ms
+  TEST_ASSERT_EQUAL_UINT32(5'000, TimerScheduler::stats(fast)->max_lateness_us);
+  // overrun: its 20 ms release started 15 ms late, which is in time, but ran until 60 ms
+  TEST_ASSERT_EQUAL_UINT32(1, TimerScheduler::stats(overrun)->releases);
+  TEST_ASSERT_EQUAL_UINT32(1, TimerScheduler::stats(overrun)->deadline_misses);
+  TEST_ASSERT_EQUAL_UINT32(15'000, TimerScheduler::stats(overrun)->max_lateness_us);
+
+  TimerScheduler::reset_stats();
+  TEST_ASSERT_EQUAL_UINT32(0, TimerScheduler::stats(overrun)->deadline_misses);
+  TEST_ASSERT_EQUAL_UINT32(0, TimerScheduler::stats(overrun)->execution.count());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_priority_order_on_one_timer);
+  RUN_TEST(test_enable_and_disable);
+  RUN_TEST(test_deadline_misses);
+  return UNITY_END();
+}
@@ -0,0 +1,185 @@
+// Timing wheel behind the heartbeats and R2D timestamps, and their DBG_HEARTBEAT_MSG export, on
+// the manual HAL clock
+#include <Arduino.h>
+
+#include <cstdint>
+
+#include "comm/communicator.hpp"
+#include "model/systemData.hpp"
+#include "model/timingWheel.hpp"
+#include "unity.h"
+
+using Wheel = TimingWheel<3>;
+constexpr uint32_t SHORT = 0, MEDIUM = 1, LONG = 2;
+
+SystemData system_data;
+Communicator communicator = Communicator(&system_data);
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+  system_data = SystemData();
+  communicator.init();
+  native_hal::can_bus(CAN3)->tx_log.clear();
+}
+
+void receive(const uint32_t id) {
+  CAN_message_t msg;
+  msg.id = id;
+  msg.len = 1;
+  native_hal::can_bus(CAN3)->receive(msg);
+  Communicator::process_received();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+/**
+ * @brief A timer expires on the first tick at or after its timeout, the tick reports it once
+ */
+void test_expiry_is_an_event() {
+  Wheel wheel{{100, 500, 5000}};  // 5 s is several turns of the 1024 ms wheel
+  for (uint32_t ms = 1; ms < 100; ms++) TEST_ASSERT_EQUAL_UINT32(0, wheel.tick(ms));
+  TEST_ASSERT_EQUAL_UINT32(1U << SHORT, wheel.tick(100));
+  TEST_ASSERT_EQUAL_UINT32(0, wheel.tick(101));
+  TEST_ASSERT_TRUE(wheel.expired(SHORT));
+
+  TEST_ASSERT_EQUAL_UINT32(1U << MEDIUM, wheel.tick(4999));  // one tick across many slots
+  TEST_ASSERT_EQUAL_UINT32(1U << LONG, wheel.tick(5000));
+  TEST_ASSERT_EQUAL_UINT32(0b111, wheel.expired());
+  TEST_ASSERT_EQUAL_UINT32(1, wheel.stats(LONG).expirations);
+}
+
+/**
+ * @brief Kicking restarts the timeout from the last tick and clears the expiry
+ */
+void test_kick_restarts() {
+  Wheel wheel{{100, 500, 5000}};
+  for (uint32_t ms = 10; ms <= 10'000; ms += 10) {
+    wheel.tick(ms);
+    wheel.kick(LONG);
+    if (ms % 90 == 0) wheel.kick(SHORT);
+  }
+  TEST_ASSERT_FALSE(wheel.expired(LONG));
+  TEST_ASSERT_FALSE(wheel.expired(SHORT));
+  TEST_ASSERT_EQUAL_UINT32(0, wheel.stats(SHORT).expirations);
+  TEST_ASSERT_TRUE(wheel.expired(MEDIUM));
+
+  wheel.kick(MEDIUM);
+  TEST_ASSERT_FALSE(wheel.expired(MEDIUM));
+  TEST_ASSERT_EQUAL_UINT32(1U << SHORT, wheel.tick(10'499));  // last kicked at 9990 ms
+  TEST_ASSERT_EQUAL_UINT32(1U << MEDIUM, wheel.tick(10'500));
+}
+
+/**
+ * @brief consume() is Metro::check(): the next expiry is a timeout after the previous deadline
+ */
+void test_consume_keeps_the_grid() {
+  Wheel wheel{{100, 500, 5000}};
+  TEST_ASSERT_FALSE(wheel.consume(SHORT));
+  wheel.tick(130);
+  TEST_ASSERT_TRUE(wheel.consume(SHORT));
+  TEST_ASSERT_FALSE(wheel.consume(SHORT));
+  TEST_ASSERT_EQUAL_UINT32(1U << SHORT, wheel.tick(200));
+
+  wheel.tick(450);  // deadlines at 200, 300 and 400 went by: expired until consumed up to now
+  TEST_ASSERT_TRUE(wheel.consume(SHORT));
+  TEST_ASSERT_TRUE(wheel.consume(SHORT));
+  TEST_ASSERT_TRUE(wheel.consume(SHORT));
+  TEST_ASSERT_FALSE(wheel.consume(SHORT));
+  TEST_ASSERT_EQUAL_UINT32(1U << SHORT | 1U << MEDIUM, wheel.tick(500));
+}
+
+/**
+ * @brief The longest gap and the kicks that came close to the timeout are kept per timer
+ */
+void test_gap_statistics() {
+  Wheel wheel{{100, 500, 5000}};
+  wheel.tick(50);
+  wheel.kick(SHORT);
+  wheel.tick(140);  // 90 ms, past 80 % of the timeout
+  wheel.kick(SHORT);
+  wheel.tick(220);
+  wheel.kick(SHORT);
+  TEST_ASSERT_EQUAL_UINT32(90, wheel.stats(SHORT).max_gap_ms);
+  TEST_ASSERT_EQUAL_UINT32(1, wheel.stats(SHORT).near_misses);
+
+  wheel.tick(400);  // expired at 320 ms, seen at 400
+  wheel.kick(SHORT);
+  TEST_ASSERT_EQUAL_UINT32(180, wheel.stats(SHORT).max_gap_ms);
+  TEST_ASSERT_EQUAL_UINT32(1, wheel.stats(SHORT).near_misses);
+  TEST_ASSERT_EQUAL_UINT32(1, wheel.stats(SHORT).expirations);
+}
+
+/**
+ * @brief The model's heartbeats: one mask read answers for all components
+ */
+void test_failure_detection() {
+  FailureDetection failure;
+  native_hal::advance_ms(COMPONENT_TIMESTAMP_TIMEOUT);
+  failure.tick(millis());
+  TEST_ASSERT_TRUE(failure.has_any_component_timed_out());
+  TEST_ASSERT_TRUE(failure.steer_dead_ && failure.pc_dead_ && failure.inversor_dead_);
+
+  for (const FailureTimer timer : {FailureTimer::PC, FailureTimer::STEERING,
+                                   FailureTimer::INVERTER, FailureTimer::RES}) {
+    failure.kick(timer);
+  }
+  TEST_ASSERT_FALSE(failure.has_any_component_timed_out());
+  native_hal::advance_ms(RES_TIMESTAMP_TIMEOUT);
+  failure.tick(millis());
+  TEST_ASSERT_TRUE(failure.res_dead_);
+  TEST_ASSERT_FALSE(failure.pc_dead_);
+  TEST_ASSERT_TRUE(failure.expired(FailureTimer::DC_VOLTAGE_DROP));  // not a component
+}
+
+/**
+ * @brief One frame per node on MASTER_ID with the alive bitmask and the arrival statistics of the
+ * window, decodable with the conf.dbc layout
+ */
+void test_heartbeat_frames() {
+  for (uint32_t ms = 1; ms <= 1000; ms++) {
+    native_hal::advance_ms(1);
+    system_data.tick(millis());
+    if (ms % 100 == 0 && ms != 500) receive(DASH_ID);  // one frame late
+    if (ms % 150 == 0) receive(CELL_TEMPS_BASE_ID);
+  }
+  Communicator::publish_heartbeats();
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+  const auto &tx_log = native_hal::can_bus(CAN3)->tx_log;
+  TEST_ASSERT_EQUAL(FailureDetection::HEARTBEAT_COUNT, tx_log.size());
+  for (std::size_t i = 0; i < FailureDetection::HEARTBEAT_COUNT; i++) {
+    TEST_ASSERT_EQUAL_HEX(MASTER_ID, tx_log[i].id);
+    TEST_ASSERT_EQUAL_HEX8(DBG_HEARTBEAT_MSG, tx_log[i].buf[0]);
+    TEST_ASSERT_EQUAL(i, tx_log[i].buf[1]);
+  }
+  const auto dash = can_db::MasterMsgs::M55::unpack(tx_log[to_underlying(FailureTimer::DASH)].buf);
+  TEST_ASSERT_EQUAL_HEX8(0b110000, dash.heartbeat_alive);  // only dash and cells sent anything
+  TEST_ASSERT_EQUAL_UINT16(200, dash.heartbeat_max_gap_ms);
+  TEST_ASSERT_EQUAL_UINT16(111, dash.heartbeat_mean_period_ms);  // 9 gaps over 1 s
+  TEST_ASSERT_EQUAL_UINT8(100, dash.heartbeat_jitter_ms);
+  const auto cells =
+      can_db::MasterMsgs::M55::unpack(tx_log[to_underlying(FailureTimer::CELLS)].buf);
+  TEST_ASSERT_EQUAL_UINT16(150, cells.heartbeat_mean_period_ms);
+  TEST_ASSERT_EQUAL_UINT8(0, cells.heartbeat_jitter_ms);
+  const auto pc = can_db::MasterMsgs::M55::unpack(tx_log[to_underlying(FailureTimer::PC)].buf);
+  TEST_ASSERT_EQUAL_UINT16(COMPONENT_TIMESTAMP_TIMEOUT, pc.heartbeat_max_gap_ms);  // at expiry
+  TEST_ASSERT_EQUAL_UINT16(0, pc.heartbeat_mean_period_ms);
+
+  Communicator::publish_heartbeats();  // new window, nothing received in it
+  Communicator::process_transmit(TX_QUEUE_DEPTH);
+  const auto empty = can_db::MasterMsgs::M55::unpack(
+      tx_log[FailureDetection::HEARTBEAT_COUNT + to_underlying(FailureTimer::DASH)].buf);
+  TEST_ASSERT_EQUAL_UINT16(0, empty.heartbeat_max_gap_ms);
+  TEST_ASSERT_EQUAL_UINT16(0, empty.heartbeat_mean_period_ms);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_expiry_is_an_event);
+  RUN_TEST(test_kick_restarts);
+  RUN_TEST(test_consume_keeps_the_grid);
+  RUN_TEST(test_gap_statistics);
+  RUN_TEST(test_failure_detection);
+  RUN_TEST(test_heartbeat_frames);
+  return UNITY_END();
+}
@@ -0,0 +1,218 @@
+// Vertical-counter debouncing of the DigitalReceiver inputs, checked against the scalar debounce()
+// on noisy bit streams, and its cost against the per-pin path it replaces
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "model/systemData.hpp"  // before digitalReceiver.hpp, which uses it undeclared
+
+#include "embedded/digitalReceiver.hpp"
+#include "embedded/verticalDebouncer.hpp"
+#include "loopProfiler.hpp"
+#include "unity.h"
+
+SystemData system_data;
+
+void setUp() {
+  native_hal::reset();
+  system_data = SystemData();
+  EmergencyEvent::clear();
+}
+
+void tearDown() {}
+
+/**
+ * @brief Contact bounce and EMI bursts as seen on the logic analyzer, one sample per loop()
+ */
+constexpr std::array<const char *, 6> RECORDED = {
+    "0000101101111111111111010000000000010000000111111",  // switch closing then opening
+    "1111111011111111101111111111110000000000000000000",  // single-sample glitches then a drop
+    "0101010101010101010101111110101010101010000001111",  // chatter around a marginal level
+    "0000000000001100000000000111000000000011110000000",  // bursts of growing length
+    "1111111111110000111111111100000111111111000000111",  // bursts on a high line
+    "0011001100110011001100110011111111111111110000000",  // periodic noise, then a real change
+};
+
+/**
+ * @brief debounce() on every channel of `samples`, in the layout VerticalDebouncer uses
+ */
+template <std::size_t CHANNELS>
+struct ScalarDebouncer {
+  std::array<bool, CHANNELS> state{};
+  std::array<unsigned int, CHANNELS> counter{};
+  std::array<uint8_t, CHANNELS> thresholds;
+
+  uint32_t update(const uint32_t sample) {
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < CHANNELS; i++) {
+      debounce((sample >> i & 1U) != 0, state[i], counter[i], thresholds[i]);
+      if (state[i]) mask |= uint32_t{1} << i;
+    }
+    return mask;
+  }
+};
+
+/**
+ * @brief Every channel, each with its own threshold, follows debounce() sample by sample
+ */
+void test_recorded_streams_match_debounce() {
+  for (uint8_t base = 1; base <= 7; base++) {
+    std::array<uint8_t, RECORDED.size()> thresholds{};
+    for (std::size_t i = 0; i < thresholds.size(); i++) {
+      thresholds[i] = static_cast<uint8_t>((base + i) % 7 + 1);
+    }
+    VerticalDebouncer<RECORDED.size()> vertical{thresholds};
+    ScalarDebouncer<RECORDED.size()> scalar{{}, {}, thresholds};
+    uint32_t previous = 0;
+    for (std::size_t t = 0; t < std::strlen(RECORDED[0]); t++) {
+      uint32_t sample = 0;
+      for (std::size_t i = 0; i < RECORDED.size(); i++) {
+        if (RECORDED[i][t] == '1') sample |= uint32_t{1} << i;
+      }
+      const uint32_t changed = vertical.update(sample);
+      const uint32_t expected = scalar.update(sample);
+      TEST_ASSERT_EQUAL_HEX32(expected, vertical.state());
+      TEST_ASSERT_EQUAL_HEX32(expected ^ previous, changed);
+      previous = expected;
+    }
+  }
+}
+
+/**
+ * @brief All 32 channels on a long pseudo-random stream of bursts, all thresholds
+ */
+void test_random_bursts_match_debounce() {
+  std::array<uint8_t, 32> thresholds{};
+  for (std::size_t i = 0; i < thresholds.size(); i++) thresholds[i] = static_cast<uint8_t>(i % 8);
+  VerticalDebouncer<32> vertical{thresholds};
+  ScalarDebouncer<32> scalar{{}, {}, thresholds};
+  uint32_t seed = 12345;
+  uint32_t level = 0;
+  for (int t = 0; t < 100'000; t++) {
+    seed = seed * 1664525U + 1013904223U;
+    if ((seed >> 24) < 8) level = ~level;          // a real change now and then
+    const uint32_t noise = seed & (seed << 7) & (seed << 13);  // sparse flipped bits
+    vertical.update(level ^ noise);
+    TEST_ASSERT_EQUAL_HEX32(scalar.update(level ^ noise), vertical.state());
+  }
+}
+
+/**
+ * @brief A channel flips on exactly its threshold-th consecutive differing sample, an agreeing
+ * sample starts it over
+ */
+void test_per_channel_thresholds() {
+  VerticalDebouncer<3> debouncer{{2, 5, 7}};
+  for (unsigned n = 1; n <= 7; n++) {
+    const uint32_t changed = debouncer.update(0b111);
+    const uint32_t expected = (n == 2 ? 0b001U : 0) | (n == 5 ? 0b010U : 0) | (n == 7 ? 0b100U : 0);
+    TEST_ASSERT_EQUAL_HEX32(expected, changed);
+  }
+  TEST_ASSERT_EQUAL_HEX32(0b111, debouncer.state());
+
+  debouncer.update(0);
+  debouncer.update(0b111);  // agrees again: the counts restart
+  for (int n = 0; n < 4; n++) debouncer.update(0);
+  TEST_ASSERT_EQUAL_HEX32(0b110, debouncer.state());
+  debouncer.set_threshold(2, 1);  // the count of channel 1 is left alone
+  TEST_ASSERT_EQUAL_HEX32(0b110, debouncer.update(0));
+}
+
+void set_inputs(const bool asms, const bool asats_pressed, const bool sdc, const bool ebs1,
+                const bool ebs2) {
+  native_hal::set_digital_input(ASMS_IN_PIN, asms);
+  native_hal::set_digital_input(ASATS, !asats_pressed);
+  native_hal::set_digital_input(SDC_TSMS_STATE_PIN, sdc);
+  native_hal::set_digital_input(EBS_SENSOR1, ebs1);
+  native_hal::set_digital_input(EBS_SENSOR2, ebs2);
+}
+
+/**
+ * @brief DigitalReceiver keeps the old per-input behaviour: raw EBS sensors, debounced AND of
+ * both, inverted ASATS and an EmergencyEvent when ASMS or the SDC open
+ */
+void test_digital_receiver_inputs() {
+  DigitalReceiver receiver(&system_data);
+  const HardwareData &hardware = system_data.hardware_data_;
+  set_inputs(true, true, true, true, false);
+  for (int i = 1; i < CHANGE_COUNTER_LIMIT; i++) receiver.digital_reads();
+  TEST_ASSERT_FALSE(hardware.asms_on_);
+  TEST_ASSERT_TRUE(hardware.pneumatic_line_pressure_2_);
+  TEST_ASSERT_FALSE(hardware.pneumatic_line_pressure_1_);
+  receiver.digital_reads();
+  TEST_ASSERT_TRUE(hardware.asms_on_ && hardware.asats_pressed_ && hardware.tsms_sdc_closed_);
+  TEST_ASSERT_FALSE(hardware.pneumatic_line_pressure_);  // only one sensor high
+  TEST_ASSERT_FALSE(EmergencyEvent::pending());
+
+  set_inputs(true, false, false, true, true);
+  for (int i = 1; i < CHANGE_COUNTER_LIMIT; i++) receiver.digital_reads();
+  TEST_ASSERT_TRUE(hardware.tsms_sdc_closed_);
+  TEST_ASSERT_FALSE(EmergencyEvent::pending());
+  receiver.digital_reads();
+  TEST_ASSERT_FALSE(hardware.tsms_sdc_closed_);
+  TEST_ASSERT_FALSE(hardware.asats_pressed_);
+  TEST_ASSERT_TRUE(hardware.pneumatic_line_pressure_);
+  TEST_ASSERT_TRUE(EmergencyEvent::pending());
+}
+
+/**
+ * @brief Cost of the debounce step alone on the same pre-read samples of the DigitalReceiver
+ * inputs: one debounce() per input against one VerticalDebouncer::update() for all of them.
+ * profiler_cycles() counts CPU cycles on the Teensy and ns on the host. The best of several passes
+ * is compared, so a pass the host preempted does not decide it. Reading the pins is left out,
+ * the native InputSnapshot still calls digitalRead() per pin
+ */
+void test_cycle_count_against_per_pin() {
+  constexpr std::size_t CHANNELS = DigitalReceiver::INPUT_COUNT;
+  constexpr int SAMPLES = 4'096;
+  constexpr int PASSES = 8;
+  static std::array<uint32_t, SAMPLES> raw{};
+  static std::array<std::array<bool, CHANNELS>, SAMPLES> bits{};
+  for (int t = 0; t < SAMPLES; t++) {
+    const uint32_t noise = static_cast<uint32_t>(t) * 2654435761U >> 25;
+    raw[t] = (noise ^ (t / 50 % 2 != 0 ? ~0U : 0U)) & ((1U << CHANNELS) - 1);
+    for (std::size_t i = 0; i < CHANNELS; i++) bits[t][i] = (raw[t] >> i & 1U) != 0;
+  }
+
+  uint32_t per_pin_cycles = UINT32_MAX, vertical_cycles = UINT32_MAX;
+  for (int pass = 0; pass < PASSES; pass++) {
+    std::array<bool, CHANNELS> state{};
+    std::array<unsigned int, CHANNELS> counter{};
+    VerticalDebouncer<CHANNELS> vertical{DigitalReceiver::DEBOUNCE_THRESHOLDS};
+
+    uint32_t start = profiler_cycles();
+    for (const auto &sample : bits) {
+      for (std::size_t i = 0; i < CHANNELS; i++) debounce(sample[i], state[i], counter[i]);
+    }
+    per_pin_cycles = std::min(per_pin_cycles, profiler_cycles() - start);
+    start = profiler_cycles();
+    for (const uint32_t sample : raw) vertical.update(sample);
+    vertical_cycles = std::min(vertical_cycles, profiler_cycles() - start);
+
+    uint32_t expected = 0;
+    for (std::size_t i = 0; i < CHANNELS; i++) {
+      if (state[i]) expected |= uint32_t{1} << i;
+    }
+    TEST_ASSERT_EQUAL_HEX32(expected, vertical.state());
+  }
+  char message[96];
+  snprintf(message, sizeof(message), "debounce per sample: per pin %.1f, vertical %.1f (cycles or ns)",
+           static_cast<double>(per_pin_cycles) / SAMPLES,
+           static_cast<double>(vertical_cycles) / SAMPLES);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_LESS_THAN(per_pin_cycles, vertical_cycles);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_recorded_streams_match_debounce);
+  RUN_TEST(test_random_bursts_match_debounce);
+  RUN_TEST(test_per_channel_thresholds);
+  RUN_TEST(test_digital_receiver_inputs);
+  RUN_TEST(test_cycle_count_against_per_pin);
+  return UNITY_END();
+}
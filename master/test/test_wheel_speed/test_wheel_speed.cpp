@@ -0,0 +1,216 @@
+// Multi-pulse wheel speed engine on generated encoder pulse trains: accuracy from 0 to 2000 RPM,
+// stall detection and CPU cost against the last-interval formula it replaces
+#include <Arduino.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include "../../wheel_speed.h"
+#include "model/systemData.hpp"  // before digitalReceiver.hpp, which uses it undeclared
+
+#include "embedded/digitalReceiver.hpp"
+#include "loopProfiler.hpp"
+#include "unity.h"
+
+using Sensor = DigitalReceiver::WheelSpeedSensor;
+
+void setUp() {
+  native_hal::reset();
+  native_hal::use_manual_clock();
+}
+
+void tearDown() { native_hal::use_real_clock(); }
+
+/**
+ * @brief Encoder edges of a wheel turning at a set speed, with the imperfections of the car: teeth
+ * up to 2 % off their nominal angle and up to 20 us of interrupt latency, in whole micros()
+ */
+class PulseTrain {
+public:
+  /**
+   * @param rpm_at speed in RPM at a time in us
+   */
+  template <class Speed>
+  explicit PulseTrain(Speed rpm_at) {
+    double angle = 0;  // in teeth
+    uint32_t tooth = 1;  // the first edge is one tooth in
+    uint32_t seed = 1;
+    for (double t = 0; t < DURATION_US; t += 1.0) {
+      angle += rpm_at(t) * PULSES_PER_ROTATION / 60e6;
+      const double edge = tooth + TOOTH_ERROR[tooth % TOOTH_ERROR.size()];
+      if (angle < edge) continue;
+      seed = seed * 1664525U + 1013904223U;
+      edges_[count_++] = static_cast<uint32_t>(t) + (seed >> 27) % 21;
+      tooth++;
+    }
+  }
+
+  static constexpr double DURATION_US = 2e6;
+
+  /**
+   * @brief Feeds the pulses up to `now_us` to `sensor`, as their interrupt would
+   */
+  template <class Sink>
+  void play_until(const uint32_t now_us, Sink &&sink) {
+    while (next_ < count_ && edges_[next_] <= now_us) sink(edges_[next_++]);
+  }
+
+private:
+  static constexpr std::array<double, 8> TOOTH_ERROR = {0.0, 0.02, -0.015, 0.01,
+                                                        -0.02, 0.005, 0.015, -0.01};
+  std::array<uint32_t, 4'000> edges_{};  ///< 2 s at 2000 RPM is 3200 pulses
+  std::size_t count_ = 0;
+  std::size_t next_ = 0;
+};
+
+/**
+ * @brief The last-interval RPM computed in read_rpm() before, with its double division
+ */
+struct LastInterval {
+  uint32_t last = 0;
+  uint32_t second_to_last = 0;
+
+  void add_pulse(const uint32_t us) {
+    second_to_last = last;
+    last = us;
+  }
+
+  [[nodiscard]] double rpm(const uint32_t now) const {
+    if (now - last > LIMIT_RPM_INTERVAL || last == second_to_last) return 0;
+    return 60.0 / ((last - second_to_last) * 1e-6 * PULSES_PER_ROTATION);
+  }
+};
+
+Sensor make_sensor() {
+  return {WHEEL_SPEED_WINDOW_US, WHEEL_SPEED_MAX_PULSES, LIMIT_RPM_INTERVAL};
+}
+
+/**
+ * @brief Worst error of both methods at constant speed, sampled every 1 ms loop after 0.5 s
+ */
+void test_accuracy_from_0_to_2000_rpm() {
+  for (const double rpm : {0.0, 30.0, 100.0, 250.0, 500.0, 1000.0, 1500.0, 2000.0}) {
+    PulseTrain train([rpm](double) { return rpm; });
+    Sensor sensor = make_sensor();
+    LastInterval old;
+    double engine_error = 0, old_error = 0;
+    for (uint32_t now = 0; now < PulseTrain::DURATION_US; now += 1000) {
+      train.play_until(now, [&](const uint32_t us) {
+        sensor.add_pulse(us);
+        old.add_pulse(us);
+      });
+      const double engine_rpm = sensor.centi_rpm(now) / 100.0;
+      if (now < 500'000) continue;
+      engine_error = std::fmax(engine_error, std::fabs(engine_rpm - rpm));
+      old_error = std::fmax(old_error, std::fabs(old.rpm(now) - rpm));
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "%4.0f RPM: worst error %6.2f, last interval %6.2f RPM", rpm,
+             engine_error, old_error);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(engine_error <= old_error);
+    if (rpm >= 250) TEST_ASSERT_TRUE(engine_error < rpm * 0.01);
+  }
+}
+
+/**
+ * @brief Averaging adapts to the speed: the window holds few pulses at a crawl, many at speed
+ */
+void test_adaptive_window() {
+  for (const auto &[rpm, intervals] : {std::pair{30.0, 1U}, std::pair{250.0, 8U},
+                                       std::pair{2000.0, unsigned{WHEEL_SPEED_MAX_PULSES}}}) {
+    PulseTrain train([rpm](double) { return rpm; });
+    Sensor sensor = make_sensor();
+    train.play_until(1'500'000, [&](const uint32_t us) { sensor.add_pulse(us); });
+    sensor.centi_rpm(1'500'000);
+    TEST_ASSERT_UINT32_WITHIN(1, intervals, sensor.averaged());
+  }
+}
+
+/**
+ * @brief A wheel that stops reads less and less, then 0 and stalled after LIMIT_RPM_INTERVAL
+ */
+void test_stall_detection() {
+  PulseTrain train([](const double t) { return t < 1e6 ? 1000.0 : 0.0; });
+  Sensor sensor = make_sensor();
+  TEST_ASSERT_EQUAL_UINT32(0, sensor.centi_rpm(0));
+  TEST_ASSERT_TRUE(sensor.stalled());
+  uint32_t previous = UINT32_MAX;
+  uint32_t last_pulse = 0;
+  for (uint32_t now = 0; now < PulseTrain::DURATION_US; now += 1000) {
+    train.play_until(now, [&](const uint32_t us) {
+      sensor.add_pulse(us);
+      last_pulse = us;
+    });
+    const uint32_t centi_rpm = sensor.centi_rpm(now);
+    if (now > 1'010'000) {  // past the last pulse
+      TEST_ASSERT_TRUE(centi_rpm <= previous);  // monotonic decay, no held value
+      TEST_ASSERT_EQUAL(now - last_pulse > LIMIT_RPM_INTERVAL, sensor.stalled());
+    }
+    previous = centi_rpm;
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, previous);
+  TEST_ASSERT_TRUE(sensor.stalled());
+}
+
+/**
+ * @brief The pulse interrupts of DigitalReceiver fill the rings read by read_rpm()
+ */
+void test_receiver_wheel_pulses() {
+  SystemData system_data;
+  DigitalReceiver receiver(&system_data);
+  const uint32_t before = DigitalReceiver::wheel_speed_rr.pulses();
+  for (int i = 0; i < 10; i++) {
+    native_hal::advance_us(10'000);
+    native_hal::set_digital_input(RR_WSS, HIGH);
+    native_hal::set_digital_input(RR_WSS, LOW);
+  }
+  TEST_ASSERT_EQUAL_UINT32(before + 10, DigitalReceiver::wheel_speed_rr.pulses());
+  receiver.digital_reads();
+  TEST_ASSERT_FLOAT_WITHIN(0.01, 60.0 / (0.01 * PULSES_PER_ROTATION),
+                           system_data.hardware_data_.rr_wheel_rpm);
+}
+
+/**
+ * @brief Time per loop() read with profiler_cycles(), CPU cycles on the Teensy and ns on the
+ * host, at 2000 RPM with a 1 kHz loop: the engine divides only when a pulse arrived
+ */
+void test_cpu_cost() {
+  PulseTrain train([](double) { return 2000.0; });
+  Sensor sensor = make_sensor();
+  LastInterval old;
+  volatile float sink = 0;
+  uint32_t engine_cycles = 0, old_cycles = 0;
+  constexpr uint32_t LOOP_US = 100;  // loop() runs much faster than the pulses come
+  constexpr int BATCH = 16;          // reads timed together, to outweigh the clock reads
+  for (uint32_t now = 0; now < PulseTrain::DURATION_US; now += LOOP_US) {
+    train.play_until(now, [&](const uint32_t us) {
+      sensor.add_pulse(us);
+      old.add_pulse(us);
+    });
+    uint32_t start = profiler_cycles();
+    for (int i = 0; i < BATCH; i++) sink = static_cast<float>(old.rpm(now + i));
+    old_cycles += profiler_cycles() - start;
+    start = profiler_cycles();
+    for (int i = 0; i < BATCH; i++) sink = sensor.centi_rpm(now + i) * 0.01f;
+    engine_cycles += profiler_cycles() - start;
+  }
+  constexpr double READS = PulseTrain::DURATION_US / LOOP_US * BATCH;
+  char message[96];
+  snprintf(message, sizeof(message), "per read: engine %.1f, last interval %.1f (cycles or ns)",
+           engine_cycles / READS, old_cycles / READS);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(sink > 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_accuracy_from_0_to_2000_rpm);
+  RUN_TEST(test_adaptive_window);
+  RUN_TEST(test_stall_detection);
+  RUN_TEST(test_receiver_wheel_pulses);
+  RUN_TEST(test_cpu_cost);
+  return UNITY_END();
+}
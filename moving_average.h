@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Mean of the last N integer samples, kept in a fixed ring with a running sum
+ * @details add() replaces the oldest sample and adjusts the sum, average() is one division, so
+ * both are O(1) and nothing is allocated. Until N samples have arrived the mean is over those
+ * seen so far, 0 before the first one, and it truncates toward zero like the std::deque helpers
+ * it replaces.
+ */
+template <class T, std::size_t N>
+class MovingAverage {
+  static_assert(std::is_integral_v<T>, "a running floating-point sum drifts, use integers");
+  static_assert(N > 0, "the window needs at least one sample");
+  static_assert(sizeof(T) > 2 || N <= 32768, "the sum of 16-bit samples must fit in 32 bits");
+
+public:
+  /// 32 bits as long as that cannot overflow, a 64-bit division is a library call on the Teensy
+  using Sum = std::conditional_t<(sizeof(T) <= 2), int32_t, int64_t>;
+
+  void add(const T value) {
+    if (count_ == N) {
+      sum_ -= buffer_[next_];
+    } else {
+      count_++;
+    }
+    buffer_[next_] = value;
+    sum_ += value;
+    next_ = next_ + 1 == N ? 0 : next_ + 1;
+  }
+
+  [[nodiscard]] T average() const {
+    return count_ == 0 ? T{0} : static_cast<T>(sum_ / static_cast<Sum>(count_));
+  }
+
+  [[nodiscard]] T value() const { return average(); }
+  [[nodiscard]] Sum sum() const { return sum_; }
+  [[nodiscard]] std::size_t size() const { return count_; }
+  [[nodiscard]] bool full() const { return count_ == N; }
+  [[nodiscard]] static constexpr std::size_t capacity() { return N; }
+
+  void clear() {
+    sum_ = 0;
+    count_ = 0;
+    next_ = 0;
+  }
+
+private:
+  std::array<T, N> buffer_{};
+  Sum sum_ = 0;
+  std::size_t count_ = 0;
+  std::size_t next_ = 0;  ///< Slot the next sample goes into, the oldest one once full
+};
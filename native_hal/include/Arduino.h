@@ -0,0 +1,249 @@
+#pragma once
+
+/**
+ * @file Arduino.h
+ * @brief Host replacement for the subset of the Teensy Arduino core used by the boards
+ * @details Pins, interrupts and time are backed by native_hal so the simulator and the tests
+ * can drive them. Only what the firmware actually calls is provided.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "hostProfiler.h"
+#include "nativeHal.h"
+
+#define LOW 0
+#define HIGH 1
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define OUTPUT_OPENDRAIN 4
+#define INPUT_DISABLE 5
+
+#define FALLING 2
+#define RISING 3
+#define CHANGE 4
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+inline uint32_t micros() { return static_cast<uint32_t>(native_hal::now_us()); }
+
+inline uint32_t millis() { return static_cast<uint32_t>(native_hal::now_us() / 1000); }
+
+inline void delayMicroseconds(const uint32_t us) {
+  if (native_hal::clock_state.mode == native_hal::ClockMode::MANUAL) {
+    native_hal::advance_us(us);
+    return;
+  }
+  const uint64_t end = native_hal::now_us() + us;
+  while (native_hal::now_us() < end) {
+    native_hal::service_timers();
+    std::this_thread::yield();
+  }
+}
+
+inline void delay(const uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+inline void yield() {}
+
+inline void pinMode(const uint8_t pin, const uint8_t mode) {
+  if (native_hal::valid_pin(pin)) native_hal::pins[pin].mode = mode;
+}
+
+inline void digitalWrite(const uint8_t pin, const uint8_t val) {
+  if (!native_hal::valid_pin(pin)) return;
+  native_hal::pins[pin].digital = val ? 1 : 0;
+  const native_hal::OutputWrite write{native_hal::now_us(), pin, val ? 1 : 0, false};
+  native_hal::output_log.push_back(write);
+  if (native_hal::on_output_write) native_hal::on_output_write(write);
+}
+
+inline uint8_t digitalRead(const uint8_t pin) {
+  return native_hal::valid_pin(pin) ? native_hal::pins[pin].digital : 0;
+}
+
+inline int analogRead(const uint8_t pin) {
+  return native_hal::valid_pin(pin) ? native_hal::pins[pin].analog : 0;
+}
+
+inline void analogWrite(const uint8_t pin, const int val) {
+  if (!native_hal::valid_pin(pin)) return;
+  native_hal::pins[pin].analog_out = val;
+  const native_hal::OutputWrite write{native_hal::now_us(), pin, val, true};
+  native_hal::output_log.push_back(write);
+  if (native_hal::on_output_write) native_hal::on_output_write(write);
+}
+
+inline void analogReadResolution(unsigned) {}
+
+inline int digitalPinToInterrupt(const uint8_t pin) { return pin; }
+
+inline void attachInterrupt(const uint8_t pin, native_hal::isr_t function, const int mode) {
+  if (!native_hal::valid_pin(pin)) return;
+  native_hal::pins[pin].isr = function;
+  native_hal::pins[pin].isr_mode = mode;
+}
+
+inline void detachInterrupt(const uint8_t pin) {
+  if (native_hal::valid_pin(pin)) native_hal::pins[pin].isr = nullptr;
+}
+
+namespace native_hal {
+inline uint64_t interrupts_disabled_since_ns = 0;
+}
+
+/**
+ * @brief Every noInterrupts() ... interrupts() window is timed as the "interrupts_disabled" stage
+ * @details Interrupts raised inside the window run when interrupts() ends it.
+ */
+inline void noInterrupts() {
+  if (native_hal::interrupts_enabled) {
+    native_hal::interrupts_disabled_since_ns = native_hal::steady_ns();
+  }
+  native_hal::interrupts_enabled = false;
+}
+
+inline void interrupts() {
+  if (!native_hal::interrupts_enabled) {
+    native_hal::stage("interrupts_disabled")
+        .add(native_hal::steady_ns() - native_hal::interrupts_disabled_since_ns);
+  }
+  native_hal::interrupts_enabled = true;
+  native_hal::run_pending_isrs();
+}
+
+template <class A, class B>
+constexpr auto min(A a, B b) -> decltype(a < b ? a : b) {
+  return b < a ? b : a;
+}
+
+template <class A, class B>
+constexpr auto max(A a, B b) -> decltype(a < b ? a : b) {
+  return a < b ? b : a;
+}
+
+template <class T, class L, class H>
+constexpr T constrain(T amt, L low, H high) {
+  return amt < low ? low : (amt > high ? high : amt);
+}
+
+inline long map(const long x, const long in_min, const long in_max, const long out_min,
+                const long out_max) {
+  if (in_max == in_min) return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/**
+ * @brief Minimal Arduino String, enough for the debug message concatenations
+ */
+class String : public std::string {
+public:
+  String() = default;
+  String(const char *str) : std::string(str) {}
+  String(const std::string &str) : std::string(str) {}
+  String(const char c) : std::string(1, c) {}
+  String(const bool value) : std::string(value ? "1" : "0") {}
+  String(const double value, const int decimals = 2) : std::string(format_float(value, decimals)) {}
+  String(const float value, const int decimals = 2) : String(static_cast<double>(value), decimals) {}
+
+  template <class T>
+    requires std::is_integral_v<T>
+  String(const T value, const int base = DEC) : std::string(format_int(value, base)) {}
+
+  [[nodiscard]] const char *c_str() const { return std::string::c_str(); }
+
+private:
+  static std::string format_float(const double value, const int decimals) {
+    char out[64];
+    snprintf(out, sizeof(out), "%.*f", decimals, value);
+    return out;
+  }
+
+  template <class T>
+  static std::string format_int(T value, const int base) {
+    if (base == DEC) return std::to_string(value);
+    std::string out;
+    auto magnitude = static_cast<unsigned long long>(value);
+    do {
+      out.insert(out.begin(), "0123456789ABCDEF"[magnitude % base]);
+      magnitude /= base;
+    } while (magnitude != 0);
+    return out;
+  }
+};
+
+inline String operator+(const String &lhs, const String &rhs) {
+  return String(static_cast<const std::string &>(lhs) + static_cast<const std::string &>(rhs));
+}
+
+inline String operator+(const String &lhs, const char *rhs) { return lhs + String(rhs); }
+
+inline String operator+(const char *lhs, const String &rhs) { return String(lhs) + rhs; }
+
+/**
+ * @brief USB serial printed to stdout
+ */
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  void flush() { std::cout.flush(); }
+  int available() { return 0; }
+  int availableForWrite() { return 4096; }
+  int read() { return -1; }
+  size_t write(const uint8_t byte) {
+    std::cout.put(static_cast<char>(byte));
+    return 1;
+  }
+  size_t write(const char *str) {
+    std::cout << str;
+    return strlen(str);
+  }
+  size_t write(const uint8_t *buffer, const size_t size) {
+    std::cout.write(reinterpret_cast<const char *>(buffer), static_cast<std::streamsize>(size));
+    return size;
+  }
+
+  template <class T>
+  size_t print(const T &value) {
+    const String text(value);
+    std::cout << text;
+    return text.size();
+  }
+  template <class T>
+  size_t print(const T &value, const int format) {
+    const String text(value, format);
+    std::cout << text;
+    return text.size();
+  }
+  size_t println() {
+    std::cout << '\n';
+    return 1;
+  }
+  template <class T>
+  size_t println(const T &value) {
+    return print(value) + println();
+  }
+  template <class T>
+  size_t println(const T &value, const int format) {
+    return print(value, format) + println();
+  }
+
+  explicit operator bool() const { return true; }
+};
+
+inline HostSerial Serial;
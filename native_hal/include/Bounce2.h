@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * @file Bounce2.h
+ * @brief Host replacement for the Bounce2 button debouncer (stable-interval mode)
+ */
+
+#include <cstdint>
+
+#include "Arduino.h"
+
+class Bounce {
+public:
+  void attach(const int pin, const int mode) {
+    pinMode(pin, mode);
+    attach(pin);
+  }
+
+  void attach(const int pin) {
+    pin_ = pin;
+    stable_ = unstable_ = digitalRead(pin_);
+    changed_ = false;
+    last_change_ms_ = millis();
+  }
+
+  void interval(const uint16_t interval_ms) { interval_ms_ = interval_ms; }
+
+  bool update() {
+    changed_ = false;
+    const bool reading = digitalRead(pin_);
+    if (reading != unstable_) {
+      unstable_ = reading;
+      last_change_ms_ = millis();
+    } else if (reading != stable_ && millis() - last_change_ms_ >= interval_ms_) {
+      stable_ = reading;
+      changed_ = true;
+    }
+    return changed_;
+  }
+
+  [[nodiscard]] bool read() const { return stable_; }
+  [[nodiscard]] bool changed() const { return changed_; }
+  [[nodiscard]] bool fell() const { return changed_ && !stable_; }
+  [[nodiscard]] bool rose() const { return changed_ && stable_; }
+
+private:
+  int pin_ = 0;
+  uint16_t interval_ms_ = 10;
+  bool stable_ = false;
+  bool unstable_ = false;
+  bool changed_ = false;
+  uint32_t last_change_ms_ = 0;
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+/**
+ * @file FlexCAN_T4.h
+ * @brief Host replacement for the FlexCAN_T4 library
+ * @details Keeps the same types, enums and member functions the boards use. Frames written by
+ * the firmware are appended to a log and frames injected with receive() go through the FIFO
+ * filters before reaching the onReceive() callback, in simulated interrupt context.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "nativeHal.h"
+
+typedef struct CAN_message_t {
+  uint32_t id = 0;
+  uint16_t timestamp = 0;
+  uint8_t idhit = 0;
+  struct {
+    bool extended = 0;
+    bool remote = 0;
+    bool overrun = 0;
+    bool reserved = 0;
+  } flags;
+  uint8_t len = 8;
+  uint8_t buf[8] = {0};
+  int8_t mb = 0;
+  uint8_t bus = 0;
+  bool seq = 0;
+} CAN_message_t;
+
+typedef enum CAN_DEV_TABLE {
+  CAN0 = 0,
+  CAN1 = 0x401D0000,
+  CAN2 = 0x401D4000,
+  CAN3 = 0x401D8000
+} CAN_DEV_TABLE;
+
+typedef enum FLEXCAN_RXQUEUE_TABLE {
+  RX_SIZE_2 = 2,
+  RX_SIZE_4 = 4,
+  RX_SIZE_8 = 8,
+  RX_SIZE_16 = 16,
+  RX_SIZE_32 = 32,
+  RX_SIZE_64 = 64,
+  RX_SIZE_128 = 128,
+  RX_SIZE_256 = 256,
+  RX_SIZE_512 = 512,
+  RX_SIZE_1024 = 1024
+} FLEXCAN_RXQUEUE_TABLE;
+
+typedef enum FLEXCAN_TXQUEUE_TABLE {
+  TX_SIZE_2 = 2,
+  TX_SIZE_4 = 4,
+  TX_SIZE_8 = 8,
+  TX_SIZE_16 = 16,
+  TX_SIZE_32 = 32,
+  TX_SIZE_64 = 64,
+  TX_SIZE_128 = 128,
+  TX_SIZE_256 = 256,
+  TX_SIZE_512 = 512,
+  TX_SIZE_1024 = 1024
+} FLEXCAN_TXQUEUE_TABLE;
+
+typedef enum FLEXCAN_RFFN_TABLE {
+  RFFN_8 = 0,
+  RFFN_16,
+  RFFN_24,
+  RFFN_32,
+  RFFN_40,
+  RFFN_48,
+  RFFN_56,
+  RFFN_64,
+  RFFN_72,
+  RFFN_80,
+  RFFN_88,
+  RFFN_96,
+  RFFN_104,
+  RFFN_112,
+  RFFN_120,
+  RFFN_128
+} FLEXCAN_RFFN_TABLE;
+
+typedef enum FLEXCAN_MAILBOX { MB0 = 0, MB63 = 63, FIFO = 99 } FLEXCAN_MAILBOX;
+
+typedef enum FLEXCAN_IDE { NONE = 0, EXT = 1, RTR = 2, STD = 3, INACTIVE } FLEXCAN_IDE;
+
+typedef enum FLEXCAN_FLTEN { ACCEPT_ALL = 0, REJECT_ALL = 1 } FLEXCAN_FLTEN;
+
+typedef void (*_MB_ptr)(const CAN_message_t &msg);
+
+namespace native_hal {
+
+/**
+ * @brief Bus state shared by every FlexCAN_T4 instantiation
+ */
+class SimulatedCanBus {
+public:
+  struct Filter {
+    uint8_t index;
+    uint32_t id;
+    FLEXCAN_IDE ide;
+  };
+
+  std::vector<CAN_message_t> tx_log;  ///< Every frame accepted by write(), oldest first
+  bool tx_full = false;  ///< write() refuses every frame, as with all transmit buffers taken
+  std::vector<Filter> filters;
+  bool reject_all = false;
+  bool fifo_enabled = false;
+  uint32_t baud_rate = 0;
+  _MB_ptr callback = nullptr;
+
+  /**
+   * @brief Whether the FIFO filters let a frame through
+   */
+  [[nodiscard]] bool accepts(const CAN_message_t &msg) const {
+    if (!reject_all) return true;
+    for (const auto &filter : filters) {
+      if (filter.id == msg.id && (filter.ide == EXT) == msg.flags.extended) return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Delivers a frame as if it arrived on the bus
+   * @return true if the frame passed the filters and reached the callback
+   */
+  bool receive(const CAN_message_t &msg) {
+    if (!accepts(msg) || callback == nullptr) return false;
+    run_isr([this, msg] { callback(msg); });  // a copy, masked interrupts run later
+    return true;
+  }
+};
+
+/**
+ * @brief Most recently constructed controller of each bus, for tests to inject frames into
+ */
+inline SimulatedCanBus *can_buses[4] = {nullptr, nullptr, nullptr, nullptr};
+
+constexpr int bus_index(const CAN_DEV_TABLE bus) {
+  return bus == CAN1 ? 1 : bus == CAN2 ? 2 : bus == CAN3 ? 3 : 0;
+}
+
+inline SimulatedCanBus *can_bus(const CAN_DEV_TABLE bus) { return can_buses[bus_index(bus)]; }
+
+}  // namespace native_hal
+
+template <CAN_DEV_TABLE _bus, FLEXCAN_RXQUEUE_TABLE _rxSize = RX_SIZE_16,
+          FLEXCAN_TXQUEUE_TABLE _txSize = TX_SIZE_16>
+class FlexCAN_T4 : public native_hal::SimulatedCanBus {
+public:
+  FlexCAN_T4() { native_hal::can_buses[native_hal::bus_index(_bus)] = this; }
+
+  void begin() {}
+  void setBaudRate(const uint32_t baud) { baud_rate = baud; }
+  void setRFFN(FLEXCAN_RFFN_TABLE) {}
+  void enableFIFO(const bool status = 1) { fifo_enabled = status; }
+  void enableFIFOInterrupt(bool = 1) {}
+  void setMaxMB(uint8_t) {}
+  void mailboxStatus() {}
+  void events() {}
+
+  void setFIFOFilter(const FLEXCAN_FLTEN input) {
+    reject_all = input == REJECT_ALL;
+    filters.clear();
+  }
+
+  bool setFIFOFilter(const uint8_t filter, const uint32_t id1, const FLEXCAN_IDE ide,
+                     FLEXCAN_IDE = NONE) {
+    filters.push_back({filter, id1, ide});
+    return true;
+  }
+
+  void onReceive(FLEXCAN_MAILBOX, const _MB_ptr handler) { callback = handler; }
+  void onReceive(const _MB_ptr handler) { callback = handler; }
+
+  int write(const CAN_message_t &msg) {
+    if (tx_full) return 0;
+    tx_log.push_back(msg);
+    return 1;
+  }
+
+  int read(CAN_message_t &) { return 0; }
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+/**
+ * @file TeensyTimerTool.h
+ * @brief Host replacement for the TeensyTimerTool periodic timers
+ * @details Running timers are registered in native_hal and fire from native_hal::service_timers(),
+ * which the host simulator calls between loop() iterations.
+ */
+
+#include <cstdint>
+#include <functional>
+
+#include "nativeHal.h"
+
+namespace TeensyTimerTool {
+
+using callback_t = std::function<void()>;
+
+enum class errorCode { OK = 0, notImplemented = -30, notInitialized = -29 };
+
+class PeriodicTimer {
+public:
+  PeriodicTimer() = default;
+  PeriodicTimer(const PeriodicTimer &) {}  // copies do not inherit the running hardware timer
+  PeriodicTimer &operator=(const PeriodicTimer &) { return *this; }
+  ~PeriodicTimer() { native_hal::stop_timer(this); }
+
+  errorCode begin(callback_t callback, const uint32_t period_us, const bool start = true) {
+    callback_ = std::move(callback);
+    period_us_ = period_us;
+    if (start) this->start();
+    return errorCode::OK;
+  }
+
+  errorCode start() {
+    if (!callback_) return errorCode::notInitialized;
+    native_hal::start_timer(this, callback_, period_us_);
+    return errorCode::OK;
+  }
+
+  errorCode stop() {
+    native_hal::stop_timer(this);
+    return errorCode::OK;
+  }
+
+  errorCode setPeriod(const uint32_t period_us) {
+    period_us_ = period_us;
+    return errorCode::OK;
+  }
+
+private:
+  callback_t callback_;
+  uint32_t period_us_ = 0;
+};
+
+}  // namespace TeensyTimerTool
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "canTrace.h"
+#include "nativeHal.h"
+
+/**
+ * @brief Replays a recorded CAN trace into a board's receive path
+ * @details Frames go through SimulatedCanBus::receive(), so the board's FIFO filters and
+ * onReceive() callback see them exactly as on the car. By default the trace runs as fast as it can
+ * be parsed on the manual clock, which is moved to every frame's timestamp so the firmware's
+ * Metro/elapsedMillis timeouts behave as they did on track. With original timing the clock is
+ * real and frames are delivered at their recorded pace.
+ */
+namespace native_hal {
+
+struct ReplayOptions {
+  const char *path = nullptr;
+  bool original_timing = false;
+  bool timeline = true;
+  void (*after_frame)() = nullptr;  ///< Runs after every frame, e.g. a board's deferred decoding
+};
+
+/**
+ * @brief Parses `program <trace> [--realtime] [--quiet]`
+ */
+inline bool parse_replay_args(const int argc, char **argv, ReplayOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--realtime") == 0) {
+      options.original_timing = true;
+    } else if (strcmp(argv[i], "--quiet") == 0) {
+      options.timeline = false;
+    } else if (options.path == nullptr) {
+      options.path = argv[i];
+    } else {
+      return false;
+    }
+  }
+  if (options.path != nullptr) return true;
+  fprintf(stderr, "usage: %s <candump or ASC trace> [--realtime] [--quiet]\n", argv[0]);
+  return false;
+}
+
+/**
+ * @brief Prints a line every time one of the registered values changes
+ */
+class StateTimeline {
+public:
+  using Probe = int64_t (*)();
+
+  void add(const char *name, const Probe probe) { fields_.push_back({name, probe, probe()}); }
+
+  void sample(const uint64_t trace_us, FILE *out) {
+    for (auto &field : fields_) {
+      const int64_t value = field.probe();
+      if (value == field.last) continue;
+      fprintf(out, "%12.6f  %-24s %lld -> %lld\n", static_cast<double>(trace_us) / 1e6, field.name,
+              static_cast<long long>(field.last), static_cast<long long>(value));
+      field.last = value;
+    }
+  }
+
+private:
+  struct Field {
+    const char *name;
+    Probe probe;
+    int64_t last;
+  };
+  std::vector<Field> fields_;
+};
+
+struct ReplayStats {
+  uint64_t frames = 0;
+  uint64_t delivered = 0;  ///< Passed the FIFO filters
+  uint64_t bytes = 0;
+  uint64_t skipped_lines = 0;
+  uint64_t trace_us = 0;  ///< Time span covered by the trace
+  double wall_s = 0;
+};
+
+/**
+ * @brief Feeds every frame of the trace to the bus, sampling the timeline after each one
+ */
+inline ReplayStats replay_trace(FILE *file, const ReplayOptions &options, SimulatedCanBus &bus,
+                                StateTimeline *timeline, FILE *out = stdout) {
+  ReplayStats stats;
+  CanTraceReader reader(file);
+  TraceFrame frame;
+  bool first = true;
+  uint64_t first_us = 0;
+  uint64_t previous_us = 0;
+  const auto wall_start = std::chrono::steady_clock::now();
+
+  if (options.original_timing) {
+    use_real_clock();
+  } else {
+    use_manual_clock();
+  }
+
+  while (reader.next(frame)) {
+    if (first) {
+      first_us = previous_us = frame.timestamp_us;
+      first = false;
+    }
+    const uint64_t trace_us = std::max(frame.timestamp_us, first_us) - first_us;
+    if (options.original_timing) {
+      std::this_thread::sleep_until(wall_start + std::chrono::microseconds(trace_us));
+      service_timers();
+    } else if (frame.timestamp_us > previous_us) {
+      advance_us(frame.timestamp_us - previous_us);
+    }
+    previous_us = std::max(previous_us, frame.timestamp_us);
+
+    stats.frames++;
+    if (bus.receive(frame.msg)) stats.delivered++;
+    if (options.after_frame != nullptr) options.after_frame();
+    if (bus.tx_log.size() > 4096) bus.tx_log.clear();  // replies are not replayed anywhere
+    if (timeline != nullptr) timeline->sample(trace_us, out);
+  }
+
+  const auto wall_time = std::chrono::steady_clock::now() - wall_start;
+  stats.wall_s = std::chrono::duration<double>(wall_time).count();
+  stats.bytes = reader.bytes();
+  stats.skipped_lines = reader.skipped();
+  stats.trace_us = previous_us - first_us;
+  return stats;
+}
+
+inline void print_replay_stats(const ReplayStats &stats, FILE *out) {
+  const double wall_s = stats.wall_s > 0 ? stats.wall_s : 1e-9;
+  fprintf(out, "\n%llu frames (%llu accepted by the filters, %llu lines skipped)\n",
+          static_cast<unsigned long long>(stats.frames),
+          static_cast<unsigned long long>(stats.delivered),
+          static_cast<unsigned long long>(stats.skipped_lines));
+  fprintf(out, "%.3f s of traffic replayed in %.3f s (%.1fx)\n", stats.trace_us / 1e6,
+          stats.wall_s, stats.trace_us / 1e6 / wall_s);
+  fprintf(out, "%.0f frames/s, %.1f MiB/s\n", stats.frames / wall_s,
+          stats.bytes / wall_s / (1024.0 * 1024.0));
+}
+
+}  // namespace native_hal
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "FlexCAN_T4.h"
+
+/**
+ * @brief Streaming reader for recorded CAN traffic
+ * @details Understands the formats our loggers produce:
+ * - candump log files: `(1436509052.249713) can0 123#DEADBEEF`, `12345678#...` for extended IDs
+ * - candump console output: `(1436509052.249713) can0  123   [4]  DE AD BE EF`, timestamp optional
+ * - Vector ASC: `   0.012345 1  123   Rx   d 4 DE AD BE EF`, `1234567x` for extended IDs
+ *
+ * The file is read through a fixed buffer and parsed in place, so replaying a multi-GB endurance
+ * log does not allocate per frame. Lines that are not data frames (headers, error frames, CAN FD,
+ * comments) are counted and skipped.
+ */
+namespace native_hal {
+
+struct TraceFrame {
+  uint64_t timestamp_us = 0;  ///< As recorded, 0 when the log has no timestamps
+  CAN_message_t msg;
+};
+
+namespace trace_detail {
+
+inline bool is_space(const char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+inline const char *skip_spaces(const char *p, const char *end) {
+  while (p < end && is_space(*p)) p++;
+  return p;
+}
+
+inline const char *skip_token(const char *p, const char *end) {
+  while (p < end && !is_space(*p)) p++;
+  return p;
+}
+
+inline int hex_value(const char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * @brief Parses an unsigned number in the given base, advancing p
+ * @return number of digits read, 0 if there was no number
+ */
+inline int parse_unsigned(const char *&p, const char *end, uint32_t &value, const int base = 16) {
+  int digits = 0;
+  value = 0;
+  while (p < end) {
+    const int digit = hex_value(*p);
+    if (digit < 0 || digit >= base) break;
+    value = value * base + digit;
+    p++;
+    digits++;
+  }
+  return digits;
+}
+
+/**
+ * @brief Parses "seconds.fraction" into microseconds, advancing p
+ */
+inline bool parse_seconds(const char *&p, const char *end, uint64_t &us) {
+  uint64_t seconds = 0;
+  int digits = 0;
+  while (p < end && *p >= '0' && *p <= '9') {
+    seconds = seconds * 10 + (*p++ - '0');
+    digits++;
+  }
+  if (digits == 0) return false;
+  uint64_t fraction = 0;
+  int fraction_digits = 0;
+  if (p < end && *p == '.') {
+    p++;
+    while (p < end && *p >= '0' && *p <= '9') {
+      if (fraction_digits < 6) {
+        fraction = fraction * 10 + (*p - '0');
+        fraction_digits++;
+      }
+      p++;
+    }
+  }
+  while (fraction_digits++ < 6) fraction *= 10;
+  us = seconds * 1'000'000 + fraction;
+  return true;
+}
+
+/**
+ * @brief Parses up to 8 data bytes, either packed ("DEADBEEF") or separated ("DE AD BE EF")
+ */
+inline bool parse_data(const char *p, const char *end, CAN_message_t &msg, const int expected_len,
+                       const bool separated) {
+  int len = 0;
+  while (len < 8) {
+    if (separated) p = skip_spaces(p, end);
+    if (p + 1 >= end) break;
+    const int high = hex_value(p[0]);
+    const int low = hex_value(p[1]);
+    if (high < 0 || low < 0) break;
+    msg.buf[len++] = static_cast<uint8_t>(high << 4 | low);
+    p += 2;
+  }
+  if (expected_len >= 0 && len != expected_len) return false;
+  msg.len = static_cast<uint8_t>(len);
+  return true;
+}
+
+}  // namespace trace_detail
+
+/**
+ * @brief Parses one candump line (log or console format)
+ */
+inline bool parse_candump_line(const char *p, const char *end, TraceFrame &frame) {
+  using namespace trace_detail;
+  frame = TraceFrame{};
+  p = skip_spaces(p, end);
+  if (p < end && *p == '(') {
+    p++;
+    if (!parse_seconds(p, end, frame.timestamp_us) || p >= end || *p != ')') return false;
+    p++;
+  }
+  p = skip_token(skip_spaces(p, end), end);  // interface name
+  p = skip_spaces(p, end);
+
+  uint32_t id = 0;
+  const int id_digits = parse_unsigned(p, end, id);
+  if (id_digits == 0 || id_digits > 8) return false;
+  frame.msg.id = id;
+  frame.msg.flags.extended = id_digits > 3;
+
+  if (p < end && *p == '#') {  // log format: ID#DATA, ID#R for remote frames, ID##.. is CAN FD
+    p++;
+    if (p < end && *p == '#') return false;
+    if (p < end && (*p == 'R' || *p == 'r')) {
+      frame.msg.flags.remote = true;
+      frame.msg.len = 0;
+      return true;
+    }
+    return parse_data(p, end, frame.msg, -1, false);
+  }
+
+  p = skip_spaces(p, end);  // console format: ID  [LEN]  DATA
+  if (p >= end || *p != '[') return false;
+  p++;
+  uint32_t len = 0;
+  if (parse_unsigned(p, end, len, 10) == 0 || len > 8 || p >= end || *p != ']') return false;
+  p++;
+  const char *data = skip_spaces(p, end);
+  if (data + 6 <= end && strncmp(data, "remote", 6) == 0) {
+    frame.msg.flags.remote = true;
+    frame.msg.len = static_cast<uint8_t>(len);
+    return true;
+  }
+  return parse_data(data, end, frame.msg, static_cast<int>(len), true);
+}
+
+/**
+ * @brief Parses one Vector ASC data frame line
+ * @param hex_ids false after a "base dec" header
+ */
+inline bool parse_asc_line(const char *p, const char *end, TraceFrame &frame,
+                           const bool hex_ids = true) {
+  using namespace trace_detail;
+  frame = TraceFrame{};
+  p = skip_spaces(p, end);
+  if (!parse_seconds(p, end, frame.timestamp_us)) return false;
+  p = skip_token(skip_spaces(p, end), end);  // channel
+  p = skip_spaces(p, end);
+
+  uint32_t id = 0;
+  if (parse_unsigned(p, end, id, hex_ids ? 16 : 10) == 0) return false;  // also skips ErrorFrame
+  frame.msg.id = id;
+  if (p < end && (*p == 'x' || *p == 'X')) {
+    frame.msg.flags.extended = true;
+    p++;
+  }
+  if (p < end && !is_space(*p)) return false;
+
+  p = skip_token(skip_spaces(p, end), end);  // Rx / Tx
+  p = skip_spaces(p, end);
+  if (p >= end) return false;
+  if (*p == 'r' || *p == 'R') {
+    frame.msg.flags.remote = true;
+    frame.msg.len = 0;
+    return true;
+  }
+  if (*p != 'd' && *p != 'D') return false;
+  p = skip_spaces(p + 1, end);
+  uint32_t len = 0;
+  if (parse_unsigned(p, end, len) == 0 || len > 8) return false;  // DLC is a single hex digit
+  return parse_data(p, end, frame.msg, static_cast<int>(len), true);
+}
+
+/**
+ * @brief Reads frames from a trace file one at a time, detecting the format per line
+ */
+class CanTraceReader {
+public:
+  explicit CanTraceReader(FILE *file) : file_(file) {}
+
+  /**
+   * @brief Reads the next data frame
+   * @return false at the end of the file
+   */
+  bool next(TraceFrame &frame) {
+    const char *line = nullptr;
+    const char *end = nullptr;
+    while (next_line(line, end)) {
+      if (parse_line(line, end, frame)) return true;
+      skipped_++;
+    }
+    return false;
+  }
+
+  [[nodiscard]] uint64_t bytes() const { return bytes_; }
+  [[nodiscard]] uint64_t lines() const { return lines_; }
+  [[nodiscard]] uint64_t skipped() const { return skipped_; }
+
+private:
+  static constexpr size_t BUFFER_SIZE = 1 << 16;  ///< Also the longest line accepted
+
+  FILE *file_;
+  char buffer_[BUFFER_SIZE];
+  size_t start_ = 0;
+  size_t fill_ = 0;
+  bool eof_ = false;
+  bool hex_ids_ = true;
+  uint64_t bytes_ = 0;
+  uint64_t lines_ = 0;
+  uint64_t skipped_ = 0;
+
+  bool parse_line(const char *line, const char *end, TraceFrame &frame) {
+    const char *p = trace_detail::skip_spaces(line, end);
+    if (p >= end) return false;
+    if (*p == '(') return parse_candump_line(p, end, frame);
+    if (*p >= '0' && *p <= '9') return parse_asc_line(p, end, frame, hex_ids_);
+    if (end - p >= 8 && strncmp(p, "base dec", 8) == 0) hex_ids_ = false;
+    if (end - p >= 8 && strncmp(p, "base hex", 8) == 0) hex_ids_ = true;
+    // Anything else is either an ASC header or candump console output without timestamps
+    return parse_candump_line(p, end, frame);
+  }
+
+  bool next_line(const char *&line, const char *&end) {
+    while (true) {
+      const auto *newline =
+          static_cast<const char *>(memchr(buffer_ + start_, '\n', fill_ - start_));
+      if (newline != nullptr) {
+        line = buffer_ + start_;
+        end = newline;
+        start_ = newline - buffer_ + 1;
+        lines_++;
+        return true;
+      }
+      if (eof_) {
+        if (start_ == fill_) return false;
+        line = buffer_ + start_;  // last line without a newline
+        end = buffer_ + fill_;
+        start_ = fill_;
+        lines_++;
+        return true;
+      }
+      if (start_ == 0 && fill_ == BUFFER_SIZE) {  // overlong line, drop what we have
+        fill_ = 0;
+        skipped_++;
+      }
+      memmove(buffer_, buffer_ + start_, fill_ - start_);
+      fill_ -= start_;
+      start_ = 0;
+      const size_t read = fread(buffer_ + fill_, 1, BUFFER_SIZE - fill_, file_);
+      bytes_ += read;
+      fill_ += read;
+      if (read == 0) eof_ = true;
+    }
+  }
+};
+
+}  // namespace native_hal
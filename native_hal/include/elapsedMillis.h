@@ -0,0 +1,58 @@
+#pragma once
+
+/**
+ * @file elapsedMillis.h
+ * @brief Host replacement for the Teensy core elapsedMillis/elapsedMicros counters
+ */
+
+#include <cstdint>
+
+#include "Arduino.h"
+
+class elapsedMillis {
+public:
+  elapsedMillis() : ms_(millis()) {}
+  elapsedMillis(const unsigned long val) : ms_(millis() - val) {}
+
+  operator unsigned long() const { return millis() - ms_; }
+
+  elapsedMillis &operator=(const unsigned long val) {
+    ms_ = millis() - val;
+    return *this;
+  }
+  elapsedMillis &operator-=(const unsigned long val) {
+    ms_ += val;
+    return *this;
+  }
+  elapsedMillis &operator+=(const unsigned long val) {
+    ms_ -= val;
+    return *this;
+  }
+
+private:
+  unsigned long ms_;
+};
+
+class elapsedMicros {
+public:
+  elapsedMicros() : us_(micros()) {}
+  elapsedMicros(const unsigned long val) : us_(micros() - val) {}
+
+  operator unsigned long() const { return micros() - us_; }
+
+  elapsedMicros &operator=(const unsigned long val) {
+    us_ = micros() - val;
+    return *this;
+  }
+  elapsedMicros &operator-=(const unsigned long val) {
+    us_ += val;
+    return *this;
+  }
+  elapsedMicros &operator+=(const unsigned long val) {
+    us_ -= val;
+    return *this;
+  }
+
+private:
+  unsigned long us_;
+};
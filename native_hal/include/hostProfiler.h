@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Wall-clock timing of named loop stages in the native build
+ * @details Stages are registered the first time a ScopedStage with that name runs, so the report
+ * lists them in execution order. Times are host nanoseconds: compare them between commits on the
+ * same machine, not against the Teensy.
+ */
+namespace native_hal {
+
+struct StageStats {
+  const char *name;
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t min_ns = UINT64_MAX;
+  uint64_t max_ns = 0;
+
+  void add(const uint64_t ns) {
+    count++;
+    total_ns += ns;
+    min_ns = std::min(min_ns, ns);
+    max_ns = std::max(max_ns, ns);
+  }
+
+  [[nodiscard]] double mean_ns() const {
+    return count == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(count);
+  }
+};
+
+inline std::vector<StageStats> stage_stats;
+
+inline StageStats &stage(const char *name) {
+  for (auto &stats : stage_stats) {
+    if (strcmp(stats.name, name) == 0) return stats;
+  }
+  stage_stats.push_back({name});
+  return stage_stats.back();
+}
+
+inline uint64_t steady_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Adds the lifetime of the object to the named stage
+ */
+class ScopedStage {
+public:
+  explicit ScopedStage(const char *name) : name_(name), start_ns_(steady_ns()) {}
+  ~ScopedStage() { stage(name_).add(steady_ns() - start_ns_); }
+
+private:
+  const char *name_;
+  uint64_t start_ns_;
+};
+
+/**
+ * @brief Prints one line per stage: name, samples, mean, min and max in microseconds
+ */
+inline void print_stage_report(FILE *out) {
+  fprintf(out, "%-24s %10s %10s %10s %10s\n", "stage", "count", "mean_us", "min_us", "max_us");
+  for (const auto &stats : stage_stats) {
+    fprintf(out, "%-24s %10llu %10.3f %10.3f %10.3f\n", stats.name,
+            static_cast<unsigned long long>(stats.count), stats.mean_ns() / 1e3,
+            stats.count == 0 ? 0.0 : stats.min_ns / 1e3, stats.max_ns / 1e3);
+  }
+}
+
+}  // namespace native_hal
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Simulated Teensy hardware used by the native (Linux host) build
+ * @details Everything the Arduino core, FlexCAN_T4, TeensyTimerTool and Bounce2 shims need to
+ * share lives here: pin levels, attached pin interrupts, the interrupt enable flag and the list
+ * of running periodic timers. Tests and the host simulator use the same functions to drive
+ * inputs and inspect outputs, so the firmware itself compiles unchanged.
+ */
+namespace native_hal {
+
+constexpr int PIN_COUNT = 64;  ///< Teensy 4.1 has 55 pins, round up
+
+using isr_t = void (*)();
+
+struct PinState {
+  uint8_t mode = 0;
+  uint8_t digital = 0;
+  int analog = 0;
+  int analog_out = 0;
+  isr_t isr = nullptr;
+  int isr_mode = 0;
+};
+
+inline std::array<PinState, PIN_COUNT> pins{};
+
+/**
+ * @brief One digitalWrite() or analogWrite(), as the pin driver saw it
+ */
+struct OutputWrite {
+  uint64_t us;
+  uint8_t pin;
+  int value;  ///< Level, or duty when analog
+  bool analog;
+};
+
+inline std::vector<OutputWrite> output_log;  ///< Every output write since reset(), oldest first
+/**
+ * @brief Called after every output write, so a test can interrupt the firmware right there
+ */
+inline std::function<void(const OutputWrite &)> on_output_write;
+inline bool interrupts_enabled = true;
+inline unsigned isr_depth = 0;  ///< > 0 while a simulated interrupt handler is running
+inline std::vector<std::function<void()>> pending_isrs;  ///< Raised while interrupts were masked
+
+/**
+ * @brief Clock backing millis()/micros() on the host
+ * @details SCALED runs at `scale` times wall-clock speed (1 = real time, the default). MANUAL only
+ * moves when advance_us() is called, which makes simulations deterministic and as fast as the CPU
+ * allows. Switching mode continues from the current time, so Metros never see time go backwards.
+ */
+enum class ClockMode { SCALED, MANUAL };
+
+struct ClockState {
+  ClockMode mode = ClockMode::SCALED;
+  double scale = 1.0;
+  uint64_t base_virtual_us = 0;  ///< Virtual time when the current mode/scale was selected
+  uint64_t base_real_us = 0;     ///< Wall-clock time when the current mode/scale was selected
+  uint64_t manual_us = 0;        ///< Current time in MANUAL mode
+};
+
+inline ClockState clock_state;
+
+/**
+ * @brief Wall-clock microseconds since the host program started
+ */
+inline uint64_t real_us() {
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               start)
+      .count();
+}
+
+/**
+ * @brief Current simulated time in microseconds, the source of millis() and micros()
+ */
+inline uint64_t now_us() {
+  if (clock_state.mode == ClockMode::MANUAL) return clock_state.manual_us;
+  return clock_state.base_virtual_us +
+         static_cast<uint64_t>(static_cast<double>(real_us() - clock_state.base_real_us) *
+                               clock_state.scale);
+}
+
+/**
+ * @brief Lets time flow at `scale` times wall-clock speed, e.g. 1000 for busy-waiting tests
+ */
+inline void use_scaled_clock(const double scale) {
+  clock_state.base_virtual_us = now_us();
+  clock_state.base_real_us = real_us();
+  clock_state.scale = scale;
+  clock_state.mode = ClockMode::SCALED;
+}
+
+inline void use_real_clock() { use_scaled_clock(1.0); }
+
+/**
+ * @brief Freezes time, from now on it only moves through advance_us()/advance_ms()/delay()
+ */
+inline void use_manual_clock() {
+  clock_state.manual_us = now_us();
+  clock_state.mode = ClockMode::MANUAL;
+}
+
+inline bool valid_pin(const int pin) { return pin >= 0 && pin < PIN_COUNT; }
+
+/**
+ * @brief Runs a handler the way the hardware would: in interrupt context, or once interrupts()
+ * unmasks interrupts when they are masked
+ */
+template <class Handler>
+void run_isr(Handler &&handler) {
+  if (!interrupts_enabled) {
+    pending_isrs.emplace_back(std::forward<Handler>(handler));
+    return;
+  }
+  isr_depth++;
+  handler();
+  isr_depth--;
+}
+
+/**
+ * @brief Runs the handlers held back while interrupts were masked, oldest first
+ */
+inline void run_pending_isrs() {
+  while (interrupts_enabled && !pending_isrs.empty()) {
+    const std::function<void()> handler = std::move(pending_isrs.front());
+    pending_isrs.erase(pending_isrs.begin());
+    run_isr(handler);
+  }
+}
+
+/**
+ * @brief Sets the level seen by digitalRead(), firing the attached interrupt on a matching edge
+ */
+inline void set_digital_input(const int pin, const uint8_t level) {
+  if (!valid_pin(pin)) return;
+  PinState &state = pins[pin];
+  const uint8_t previous = state.digital;
+  state.digital = level ? 1 : 0;
+  if (state.isr == nullptr || previous == state.digital) return;
+  const bool rising = state.digital == 1;
+  // RISING = 3, FALLING = 2, CHANGE = 4 in the Teensy core
+  if ((state.isr_mode == 3 && rising) || (state.isr_mode == 2 && !rising) || state.isr_mode == 4) {
+    run_isr(state.isr);
+  }
+}
+
+/**
+ * @brief Sets the value returned by analogRead()
+ */
+inline void set_analog_input(const int pin, const int value) {
+  if (valid_pin(pin)) pins[pin].analog = value;
+}
+
+/**
+ * @brief Level last written to an output with digitalWrite()
+ */
+inline uint8_t digital_output(const int pin) { return valid_pin(pin) ? pins[pin].digital : 0; }
+
+/**
+ * @brief Duty last written to an output with analogWrite()
+ */
+inline int analog_output(const int pin) { return valid_pin(pin) ? pins[pin].analog_out : 0; }
+
+/**
+ * @brief A running TeensyTimerTool timer, serviced by service_timers()
+ */
+struct TimerSlot {
+  const void *owner;
+  std::function<void()> callback;
+  uint64_t period_us;
+  uint64_t next_due_us;
+};
+
+inline std::vector<TimerSlot> timers;
+
+inline void stop_timer(const void *owner) {
+  std::erase_if(timers, [owner](const TimerSlot &slot) { return slot.owner == owner; });
+}
+
+inline void start_timer(const void *owner, std::function<void()> callback,
+                        const uint64_t period_us) {
+  stop_timer(owner);
+  timers.push_back({owner, std::move(callback), std::max<uint64_t>(period_us, 1),
+                    now_us() + std::max<uint64_t>(period_us, 1)});
+}
+
+/**
+ * @brief Fires every timer whose period elapsed, as the timer interrupt would have
+ * @details The host has no preemption, so the simulator calls this between loop() iterations
+ * (and delay() calls it while waiting). A timer that fell several periods behind fires once.
+ */
+inline void service_timers() {
+  if (!interrupts_enabled) return;
+  const uint64_t now = now_us();
+  for (std::size_t i = 0; i < timers.size(); i++) {
+    if (now < timers[i].next_due_us) continue;
+    timers[i].next_due_us = now + timers[i].period_us;
+    const auto callback = timers[i].callback;  // the callback may restart or stop timers
+    run_isr(callback);
+  }
+}
+
+/**
+ * @brief Moves simulated time forward, firing timers at their exact deadlines on the way
+ */
+inline void advance_us(const uint64_t us) {
+  const uint64_t target = now_us() + us;
+  if (clock_state.mode == ClockMode::SCALED) {
+    clock_state.base_virtual_us += us;
+    service_timers();
+    return;
+  }
+  while (interrupts_enabled) {
+    uint64_t next_due = target + 1;
+    for (const auto &slot : timers) next_due = std::min(next_due, slot.next_due_us);
+    if (next_due > target) break;
+    clock_state.manual_us = std::max(clock_state.manual_us, next_due);
+    service_timers();
+  }
+  clock_state.manual_us = target;
+}
+
+inline void advance_ms(const uint64_t ms) { advance_us(ms * 1000); }
+
+/**
+ * @brief Puts every simulated peripheral back to power-on state (time keeps its current value)
+ */
+inline void reset() {
+  pins = {};
+  output_log.clear();
+  on_output_write = nullptr;
+  interrupts_enabled = true;
+  isr_depth = 0;
+  pending_isrs.clear();
+  timers.clear();
+}
+
+}  // namespace native_hal
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+
+/**
+ * @brief A job of a CooperativeScheduler: `handler` runs every `period_ms`, the first time
+ * `phase_ms` after start()
+ * @details `handler` is called with the scheduler's context, so it can be a plain function or
+ * captureless lambda taking the context, or a member function of it.
+ */
+template <class Handler>
+struct PeriodicJob {
+  const char *name;
+  uint32_t period_ms;
+  uint32_t phase_ms;
+  Handler handler;
+};
+
+/**
+ * @brief How well a job kept to its release times
+ */
+struct JobStats {
+  uint32_t runs = 0;
+  uint32_t overruns = 0;       ///< Releases skipped, or finished after the next one was due
+  uint32_t max_jitter_us = 0;  ///< Worst start after the release time
+  uint64_t total_jitter_us = 0;
+  uint32_t max_run_us = 0;
+
+  [[nodiscard]] uint32_t mean_jitter_us() const {
+    return runs == 0 ? 0 : static_cast<uint32_t>(total_jitter_us / runs);
+  }
+};
+
+/**
+ * @brief True when the jobs are listed shortest period first, the rate-monotonic priority order
+ */
+template <class Handler, std::size_t N>
+constexpr bool rate_monotonic_order(const std::array<PeriodicJob<Handler>, N> &jobs) {
+  for (std::size_t i = 1; i < N; i++) {
+    if (jobs[i].period_ms < jobs[i - 1].period_ms) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Closest two releases of different jobs ever get, in milliseconds
+ * @details Releases of jobs a and b differ by phase_a - phase_b plus any multiple of
+ * gcd(period_a, period_b), so that difference folded into [0, gcd / 2] is how close they get,
+ * without walking the hyperperiod. 0 means two jobs are released on the same millisecond.
+ */
+template <class Handler, std::size_t N>
+constexpr uint32_t min_release_gap_ms(const std::array<PeriodicJob<Handler>, N> &jobs) {
+  uint32_t gap = UINT32_MAX;
+  for (std::size_t i = 0; i < N; i++) {
+    for (std::size_t j = i + 1; j < N; j++) {
+      const uint32_t g = std::gcd(jobs[i].period_ms, jobs[j].period_ms);
+      const uint32_t d = (jobs[i].phase_ms % g + g - jobs[j].phase_ms % g) % g;
+      gap = std::min(gap, std::min(d, g - d));
+    }
+  }
+  return gap;
+}
+
+/**
+ * @brief Runs periodic jobs from loop(), highest rate first, and measures how late they start
+ * @details Every job has a fixed release grid, start() plus its phase plus multiples of its
+ * period, so releases do not drift with the loop period the way a Metro reset on check does.
+ * run() starts the released jobs in table order, which is expected to be rate-monotonic; at most
+ * `budget` of them per call, the rest wait for the next call and their jitter shows it. A
+ * release is an overrun when the job could not start before its next release or finished after
+ * it.
+ */
+template <class Handler, std::size_t N>
+class CooperativeScheduler {
+public:
+  using Job = PeriodicJob<Handler>;
+  using Table = std::array<Job, N>;
+
+  explicit constexpr CooperativeScheduler(const Table &jobs) : jobs_(&jobs) {}
+
+  /**
+   * @brief Puts every job's first release at its phase from now, run() does it if not done yet
+   */
+  void start() {
+    const auto now = static_cast<uint32_t>(micros());
+    for (std::size_t i = 0; i < N; i++) next_release_us_[i] = now + (*jobs_)[i].phase_ms * 1000;
+    started_ = true;
+  }
+
+  /**
+   * @return Number of jobs run
+   */
+  template <class Context>
+  std::size_t run(Context &context, const std::size_t budget = N) {
+    if (!started_) start();
+    const auto now = static_cast<uint32_t>(micros());
+    std::size_t ran = 0;
+    for (std::size_t i = 0; i < N && ran < budget; i++) {
+      if (static_cast<int32_t>(now - next_release_us_[i]) < 0) continue;
+      const Job &job = (*jobs_)[i];
+      JobStats &stats = stats_[i];
+      const uint32_t period_us = job.period_ms * 1000;
+      const uint32_t skipped = (now - next_release_us_[i]) / period_us;
+      stats.overruns += skipped;
+      const uint32_t release_us = next_release_us_[i] + skipped * period_us;
+      next_release_us_[i] = release_us + period_us;
+
+      const auto start_us = static_cast<uint32_t>(micros());
+      std::invoke(job.handler, context);
+      const auto end_us = static_cast<uint32_t>(micros());
+      stats.runs++;
+      stats.max_jitter_us = std::max(stats.max_jitter_us, start_us - release_us);
+      stats.total_jitter_us += start_us - release_us;
+      stats.max_run_us = std::max(stats.max_run_us, end_us - start_us);
+      if (end_us - release_us > period_us) stats.overruns++;
+      ran++;
+    }
+    return ran;
+  }
+
+  [[nodiscard]] const Table &jobs() const { return *jobs_; }
+  [[nodiscard]] const JobStats &stats(const std::size_t job) const { return stats_[job]; }
+
+  void reset_stats() { stats_ = {}; }
+
+private:
+  const Table *jobs_;
+  bool started_ = false;
+  std::array<uint32_t, N> next_release_us_{};
+  std::array<JobStats, N> stats_{};
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Median of the last N integer samples, kept in a ring plus a sorted copy of the window
+ * @details add() finds the slot of the sample leaving the window and of the one entering it by
+ * binary search, O(log N) comparisons, then slides the entries between the two by one: a single
+ * memmove of at most N values, cheaper than keeping two heaps for the short windows used on the
+ * boards. Nothing is allocated. Until N samples have arrived the median is over those seen so
+ * far, 0 before the first one. With an even count it is the mean of the two middle samples,
+ * truncated like MovingAverage.
+ */
+template <class T, std::size_t N>
+class RunningMedian {
+  static_assert(std::is_integral_v<T> && sizeof(T) <= 4, "integer samples of up to 32 bits");
+  static_assert(N > 0, "the window needs at least one sample");
+
+public:
+  /// Holds a sum or difference of two samples without overflowing
+  using Wide = std::conditional_t<(sizeof(T) <= 2), int32_t, int64_t>;
+
+  void add(const T value) {
+    T* const begin = sorted_.data();
+    T* const end = begin + count_;
+    if (count_ < N) {
+      T* const slot = std::upper_bound(begin, end, value);
+      std::move_backward(slot, end, end + 1);
+      *slot = value;
+      count_++;
+    } else {
+      T* const oldest = std::lower_bound(begin, end, ring_[next_]);
+      if (value < *oldest) {
+        T* const slot = std::upper_bound(begin, oldest, value);
+        std::move_backward(slot, oldest, oldest + 1);
+        *slot = value;
+      } else {
+        T* const slot = std::upper_bound(oldest + 1, end, value);
+        std::move(oldest + 1, slot, oldest);
+        *(slot - 1) = value;
+      }
+    }
+    ring_[next_] = value;
+    next_ = next_ + 1 == N ? 0 : next_ + 1;
+  }
+
+  [[nodiscard]] T median() const {
+    if (count_ == 0) return T{0};
+    const std::size_t middle = count_ / 2;
+    if (count_ % 2 != 0) return sorted_[middle];
+    return static_cast<T>((static_cast<Wide>(sorted_[middle - 1]) + sorted_[middle]) / 2);
+  }
+
+  /**
+   * @brief Median absolute deviation of the window from its median, in O(N)
+   * @details The deviations of the samples below the median grow walking left from the middle
+   * of the sorted window and those above it walking right, so merging the two walks visits them
+   * in order and stops halfway.
+   */
+  [[nodiscard]] Wide deviation() const {
+    if (count_ == 0) return 0;
+    const Wide center = median();
+    std::size_t left = count_ / 2;  // one past the next sample below the median
+    std::size_t right = count_ / 2;
+    Wide previous = 0;
+    Wide current = 0;
+    for (std::size_t visited = 0; visited <= count_ / 2; visited++) {
+      previous = current;
+      const bool take_left =
+          right == count_ || (left > 0 && center - sorted_[left - 1] <= sorted_[right] - center);
+      current = take_left ? center - sorted_[--left] : sorted_[right++] - center;
+    }
+    return count_ % 2 != 0 ? current : (previous + current) / 2;
+  }
+
+  [[nodiscard]] T value() const { return median(); }
+  [[nodiscard]] std::size_t size() const { return count_; }
+  [[nodiscard]] bool full() const { return count_ == N; }
+  [[nodiscard]] static constexpr std::size_t capacity() { return N; }
+
+  void clear() {
+    count_ = 0;
+    next_ = 0;
+  }
+
+private:
+  std::array<T, N> ring_{};    ///< Samples in arrival order
+  std::array<T, N> sorted_{};  ///< The same samples in ascending order, first size() are valid
+  std::size_t count_ = 0;
+  std::size_t next_ = 0;  ///< Slot the next sample goes into, the oldest one once full
+};
+
+/**
+ * @brief Hampel outlier rejector: a sample further than `sigmas` standard deviations from the
+ * median of the last N samples is replaced by that median
+ * @details The standard deviation is estimated as 1.4826 times the median absolute deviation,
+ * which a single spike cannot inflate the way it inflates a mean. The window keeps the raw
+ * samples, so a real step is let through as soon as it makes up half of the window.
+ * `min_deviation` keeps a quiet, quantised signal, whose deviation is 0, from rejecting every
+ * change of one ADC count.
+ */
+template <class T, std::size_t N>
+class HampelFilter {
+public:
+  explicit constexpr HampelFilter(const T min_deviation, const uint8_t sigmas = 3)
+      : min_deviation_(min_deviation), sigmas_(sigmas) {}
+
+  /**
+   * @brief Feeds a raw sample
+   * @return The sample, or the window median when it is an outlier
+   */
+  T add(const T value) {
+    window_.add(value);
+    const T center = window_.median();
+    int64_t distance = static_cast<int64_t>(value) - center;
+    distance = distance < 0 ? -distance : distance;
+    // most samples are within min_deviation, only the others pay for the deviation walk;
+    // 1.4826 is 1518 / 1024, compared without dividing
+    const bool outlier =
+        distance > min_deviation_ &&
+        distance * 1024 > static_cast<int64_t>(sigmas_) * 1518 * window_.deviation();
+    value_ = outlier ? center : value;
+    rejected_ += outlier ? 1 : 0;
+    return value_;
+  }
+
+  [[nodiscard]] T value() const { return value_; }
+  [[nodiscard]] uint32_t rejected() const { return rejected_; }
+  [[nodiscard]] const RunningMedian<T, N>& window() const { return window_; }
+  [[nodiscard]] std::size_t size() const { return window_.size(); }
+  [[nodiscard]] bool full() const { return window_.full(); }
+  [[nodiscard]] static constexpr std::size_t capacity() { return N; }
+
+  void clear() {
+    window_.clear();
+    value_ = T{0};
+    rejected_ = 0;
+  }
+
+private:
+  RunningMedian<T, N> window_;
+  T value_ = T{0};
+  uint32_t rejected_ = 0;  ///< Samples replaced since the last clear()
+  T min_deviation_;
+  uint8_t sigmas_;
+};
@@ -2,8 +2,12 @@
 
 #include <FlexCAN_T4.h>
 
+#include <algorithm>
+
 #include "Arduino.h"
 #include "../../CAN_IDs.h"
+#include "../../CAN_messages.h"
+#include "../../can_tx_queue.h"
 // System Configuration
 constexpr uint8_t TOTAL_BOARDS = 6;
 constexpr uint16_t TEMP_SENSOR_READ_INTERVAL = 95;
@@ -11,7 +15,7 @@ constexpr int8_t NO_ERROR_RESET_THRESHOLD = 50;
 constexpr uint16_t ANALOG_MAX = 1023;
 constexpr uint16_t ANALOG_MIN = 0;
 constexpr int ERROR_SIGNAL = 35;
-constexpr uint8_t MAX_RETRIES = 3;
+constexpr unsigned TX_FRAMES_PER_LOOP = 4;  // handed to the controller per loop() call
 constexpr uint8_t MAX_NUM_ERRORS = 3;
 constexpr unsigned long LOOP_INTERVAL = 10; 
 // Voltage and Resistor Configuration
@@ -61,7 +65,7 @@ int8_t safe_temperature_cast(float temp);
 void send_can_max_min_avg_temperatures();
 void show_temperatures();
 void code_reset();
-bool send_can_message(CAN_message_t& msg);
+bool send_can_message(const CAN_message_t& msg);
 
 // Functions specific to master board
 #if THIS_IS_MASTER
@@ -77,12 +81,14 @@ bool check_master_timeout();
 void can_receive_from_master(const CAN_message_t& msg);
 #endif
 
+// Tokenized logging, decode the USB output with tools/log_decoder.py
 #if DEBUG_ENABLED
-  #define DEBUG_PRINT(x) Serial.print(x)
-  #define DEBUG_PRINTLN(x) Serial.println(x)
-  #define DEBUG_WRITE(x) Serial.write(x)
+  #include "../../debug_log.h"
+  #define DEBUG_PRINT(...) DEBUG_LOG(__VA_ARGS__)
+  #define DEBUG_PRINTLN(...) DEBUG_LOG(__VA_ARGS__)
+  #define DEBUG_DRAIN() debug_log::drain_to_serial()
 #else
-  #define DEBUG_PRINT(x)
-  #define DEBUG_PRINTLN(x)
-  #define DEBUG_WRITE(x)
+  #define DEBUG_PRINT(...)
+  #define DEBUG_PRINTLN(...)
+  #define DEBUG_DRAIN()
 #endif
\ No newline at end of file
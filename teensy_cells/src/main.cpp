@@ -2,6 +2,16 @@
 
 FlexCAN_T4<CAN2, RX_SIZE_256, TX_SIZE_16> can1;  // todo
 
+// Transmit classes, see can_tx_queue.h. The BMS limits the current on the thermistor frame and the
+// master watches the summary as this board's heartbeat, both latest-value-wins; the per-cell
+// chunks are for logging only
+constexpr std::array<can_tx::Rule, 3> TX_RULES = {{
+    {can_db::BmsThermistorId::ID, can_tx::ANY_TYPE, can_tx::Priority::SAFETY, true, 0},
+    {CELL_TEMPS_BASE_ID + BOARD_ID, can_tx::ANY_TYPE, can_tx::Priority::STATUS, true, 0},
+    {ALL_TEMPS_ID + BOARD_ID, can_tx::ANY_TYPE, can_tx::Priority::DIAGNOSTIC, false, 100},
+}};
+can_tx::TxQueue<TX_RULES.size(), 8> tx_queue{TX_RULES};
+
 const u_int8_t pin_ntc_temp[NTC_SENSOR_COUNT] = {A4,  A5,  A6, A7, A8,  A9,  A2,  A3, A10, A11,
                                                  A12, A13, A0, A1, A17, A16, A15, A14};  // T! A13
 
@@ -36,9 +46,8 @@ bool check_master_timeout() {
   }
 
   if (current_time - last_master_message_time > MAX_TEMP_DELAY_MS) {
-    // DEBUG_PRINT("Timeout: No data from master for ");
-    // DEBUG_PRINT((current_time - last_master_message_time));
-    // DEBUG_PRINTLN("ms");
+    // DEBUG_PRINTLN("Timeout: No data from master for {}ms",
+    //               current_time - last_master_message_time);
     return true;
   }
 
@@ -49,43 +58,26 @@ void debug_helper() {
   DEBUG_PRINTLN("----------- DEBUG HELPER -----------");
 
   // --- General Info ---
-  DEBUG_PRINT("THIS_IS_MASTER: ");
-  DEBUG_PRINTLN(THIS_IS_MASTER ? "true" : "false");
-  DEBUG_PRINT("BOARD_ID: ");
-  DEBUG_PRINTLN(BOARD_ID);
-  DEBUG_PRINT("Current millis(): ");
-  DEBUG_PRINTLN(millis());
+  DEBUG_PRINTLN("THIS_IS_MASTER: {true|false}", THIS_IS_MASTER);
+  DEBUG_PRINTLN("BOARD_ID: {}", BOARD_ID);
+  DEBUG_PRINTLN("Current millis(): {}", millis());
 
   // --- Error and State Info ---
-  DEBUG_PRINT("error_count: ");
-  DEBUG_PRINTLN(error_count);
-  DEBUG_PRINT("no_error_iterations: ");
-  DEBUG_PRINTLN(no_error_iterations);
+  DEBUG_PRINTLN("error_count: {}", error_count);
+  DEBUG_PRINTLN("no_error_iterations: {}", no_error_iterations);
 
   // --- CAN Info ---
-  DEBUG_PRINT("Last CAN message received time: ");
-  DEBUG_PRINTLN(last_message_received_time);
+  DEBUG_PRINTLN("Last CAN message received time: {}", last_message_received_time);
   // Note: Actual current baud rate isn't stored directly in a global variable after setup.
   // We can print the configured rates.
-  DEBUG_PRINT("CAN_BAUD_RATE_1M ?: ");
-  DEBUG_PRINTLN(baud_1M ? "ye" : "no");
+  DEBUG_PRINTLN("CAN_BAUD_RATE_1M ?: {ye|no}", baud_1M);
 
   // --- Board Specific Temperature Data (for the current board) ---
   DEBUG_PRINTLN("--- Current Board Temperature Data ---");
-  DEBUG_PRINT("Board ID [");
-  DEBUG_PRINT(BOARD_ID);
-  DEBUG_PRINT("] Min Temp: ");
-  DEBUG_PRINTLN(board_temps[BOARD_ID].temp_data.min_temp);
-  DEBUG_PRINT("Board ID [");
-  DEBUG_PRINT(BOARD_ID);
-  DEBUG_PRINT("] Max Temp: ");
-  DEBUG_PRINTLN(board_temps[BOARD_ID].temp_data.max_temp);
-  DEBUG_PRINT("Board ID [");
-  DEBUG_PRINT(BOARD_ID);
-  DEBUG_PRINT("] Avg Temp: ");
-  DEBUG_PRINTLN(board_temps[BOARD_ID].temp_data.avg_temp);
-  DEBUG_PRINT("Board ID:");
-  DEBUG_PRINTLN(BOARD_ID);
+  DEBUG_PRINTLN("Board ID [{}] Min Temp: {}", BOARD_ID, board_temps[BOARD_ID].temp_data.min_temp);
+  DEBUG_PRINTLN("Board ID [{}] Max Temp: {}", BOARD_ID, board_temps[BOARD_ID].temp_data.max_temp);
+  DEBUG_PRINTLN("Board ID [{}] Avg Temp: {}", BOARD_ID, board_temps[BOARD_ID].temp_data.avg_temp);
+  DEBUG_PRINTLN("Board ID:{}", BOARD_ID);
 
 #if THIS_IS_MASTER
   // --- Master Specific Info ---
@@ -98,37 +90,25 @@ void debug_helper() {
   for (uint8_t i = 0; i < TOTAL_BOARDS; i++) {
     if (i == BOARD_ID && THIS_IS_MASTER) {  // Master's own data is already printed above
       // Or if you want to show it in this loop specifically for master:
-      // DEBUG_PRINT("Board (Master) ["); DEBUG_PRINT(i); DEBUG_PRINT("] Own Data - Min: ");
-      // DEBUG_PRINT(board_temps[i].temp_data.min_temp); DEBUG_PRINT(", Max: ");
-      // DEBUG_PRINT(board_temps[i].temp_data.max_temp); DEBUG_PRINT(", Avg: ");
-      // DEBUG_PRINT(board_temps[i].temp_data.avg_temp); DEBUG_PRINT(", Last Update: ");
-      // DEBUG_PRINTLN(board_temps[i].last_update_ms);
+      // DEBUG_PRINTLN("Board (Master) [{}] Own Data - Min: {}, Max: {}, Avg: {}, Last Update: {}",
+      //               i, board_temps[i].temp_data.min_temp, board_temps[i].temp_data.max_temp,
+      //               board_temps[i].temp_data.avg_temp, board_temps[i].last_update_ms);
       continue;
     }
-    DEBUG_PRINT("Board [");
-    DEBUG_PRINT(i);
-    DEBUG_PRINT("] Min: ");
-    DEBUG_PRINT(board_temps[i].temp_data.min_temp);
-    DEBUG_PRINT(", Max: ");
-    DEBUG_PRINT(board_temps[i].temp_data.max_temp);
-    DEBUG_PRINT(", Avg: ");
-    DEBUG_PRINT(board_temps[i].temp_data.avg_temp);
-    DEBUG_PRINT(", HasComm: ");
-    DEBUG_PRINT(board_temps[i].has_communicated ? "Y" : "N");
-    DEBUG_PRINT(", LastUpdate: ");
-    DEBUG_PRINTLN(board_temps[i].last_update_ms);
+    DEBUG_PRINTLN("Board [{}] Min: {}, Max: {}, Avg: {}, HasComm: {Y|N}, LastUpdate: {}", i,
+                  board_temps[i].temp_data.min_temp, board_temps[i].temp_data.max_temp,
+                  board_temps[i].temp_data.avg_temp, board_temps[i].has_communicated,
+                  board_temps[i].last_update_ms);
   }
 #else
   // --- Slave Specific Info ---
   DEBUG_PRINTLN("--- Slave Specific Debug Info ---");
-  DEBUG_PRINT("Last message received from master at: ");
-  DEBUG_PRINTLN(last_master_message_time);
-  DEBUG_PRINT("Master has communicated: ");
-  DEBUG_PRINTLN(master_has_communicated ? "Yes" : "No");
+  DEBUG_PRINTLN("Last message received from master at: {}", last_master_message_time);
+  DEBUG_PRINTLN("Master has communicated: {Yes|No}", master_has_communicated);
 #endif
 
   DEBUG_PRINTLN("--------- END DEBUG HELPER ---------");
-  DEBUG_PRINTLN();  // Add a blank line for readability
+  DEBUG_PRINTLN("");  // Add a blank line for readability
 }
 
 float read_ntc_temperature(const int analog_value) {
@@ -183,19 +163,15 @@ bool check_temperature_timeouts() {
     if (!board.has_communicated) {
       // Allow 2 seconds on startup before considering it a timeout
       if (current_time > 10000) { // estava 15000 tem que se meter menos que 1seg
-        // DEBUG_PRINT("Timeout: No data ever received from board ");
-        // DEBUG_PRINTLN(board_id);
+        // DEBUG_PRINTLN("Timeout: No data ever received from board {}", board_id);
         timeout_detected = true;
       }
       continue;
     }
 
     if (current_time - board.last_update_ms > MAX_TEMP_DELAY_MS) {
-      // DEBUG_PRINT("Timeout: Stale data from board ");
-      // DEBUG_PRINT(board_id);
-      // DEBUG_PRINT(", last update was ");
-      // DEBUG_PRINT((current_time - board.last_update_ms));
-      // DEBUG_PRINTLN("ms ago");
+      // DEBUG_PRINTLN("Timeout: Stale data from board {}, last update was {}ms ago", board_id,
+      //               current_time - board.last_update_ms);
       timeout_detected = true;
     }
   }
@@ -217,16 +193,9 @@ int8_t safe_temperature_cast(const float temp) {
   return result;
 }
 
-bool send_can_message(CAN_message_t& msg) {
-  for (uint8_t attempt = 0; attempt < MAX_RETRIES; attempt++) {
-    if (can1.write(msg) == 1) {
-      return true;
-    }
-    DEBUG_PRINTLN("CAN send failed, retrying...");
-    delay(5);  // Short delay before retry
-  }
-  DEBUG_PRINTLN("CAN send failed after retries");
-  return false;
+bool send_can_message(const CAN_message_t& msg) {
+  // Written by tx_queue.service() in loop(), retried there if the controller is full
+  return tx_queue.enqueue(msg, millis()) != can_tx::Result::FULL;
 }
 
 void send_can_max_min_avg_temperatures() {
@@ -247,7 +216,7 @@ void send_can_max_min_avg_temperatures() {
   if (send_can_message(msg)) {
     // DEBUG_PRINTLN("Sent CAN message with min, max, and avg temperatures");
   } else {
-    DEBUG_PRINTLN("Failed to send CAN message");
+    DEBUG_PRINTLN("CAN transmit queue full");
   }
 }
 void send_to_bms(const TemperatureData& global_data) {
@@ -266,34 +235,33 @@ void send_to_bms(const TemperatureData& global_data) {
     avg_temp = TEMPERATURE_MAX_C;
   }
   send_timer = 0;
+  can_db::BmsThermistorId thermistor;
+  thermistor.thermistor_module_number = THERMISTOR_MODULE_NUMBER;
+  thermistor.min_temp = min_temp;
+  thermistor.max_temp = max_temp;
+  thermistor.avg_temp = avg_temp;
+  thermistor.number_of_thermistors = NUMBER_OF_THERMISTORS;
+  thermistor.highest_thermistor_id = HIGHEST_THERMISTOR_ID;
+  thermistor.lowest_thermistor_id = LOWEST_THERMISTOR_ID;
+  thermistor.checksum = static_cast<uint8_t>(min_temp) + static_cast<uint8_t>(max_temp) +
+                        static_cast<uint8_t>(avg_temp) + NUMBER_OF_THERMISTORS +
+                        HIGHEST_THERMISTOR_ID + LOWEST_THERMISTOR_ID + CHECKSUM_CONSTANT +
+                        MSG_LENGTH;
+  const auto payload = thermistor.pack();
   CAN_message_t msg;
-  msg.id = BMS_THERMISTOR_ID;
-  msg.flags.extended = true;
-  msg.len = 8;
-  msg.buf[0] = THERMISTOR_MODULE_NUMBER;
-  msg.buf[1] = min_temp;
-  msg.buf[2] = max_temp;
-  msg.buf[3] = avg_temp;
-  msg.buf[4] = NUMBER_OF_THERMISTORS;
-  msg.buf[5] = HIGHEST_THERMISTOR_ID;
-  msg.buf[6] = LOWEST_THERMISTOR_ID;
-  msg.buf[7] = msg.buf[1] + msg.buf[2] + msg.buf[3] + msg.buf[4] + msg.buf[5] + msg.buf[6] +
-               CHECKSUM_CONSTANT + MSG_LENGTH;
-  can1.write(msg);
+  msg.id = can_db::BmsThermistorId::ID;
+  msg.flags.extended = can_db::BmsThermistorId::EXTENDED;
+  msg.len = payload.size();
+  std::copy(payload.begin(), payload.end(), msg.buf);
+  send_can_message(msg);
   // According to documentation we might need to send message to another id as well, although last
   // year only this one was used and worked fine
 }
 
 void show_temperatures() {
-  DEBUG_WRITE("\033[2J");  // Clear screen
-  DEBUG_WRITE("\033[H");   // Home cursor
   DEBUG_PRINTLN("----------- Temperaturas -----------");
   for (int i = 0; i < NTC_SENSOR_COUNT; i++) {
-    DEBUG_PRINT("CELL ");
-    DEBUG_PRINT(i + 1);
-    DEBUG_PRINT(": ");
-    DEBUG_PRINT(cell_temps[i]);
-    DEBUG_PRINTLN("°C");
+    DEBUG_PRINTLN("CELL {}: {}°C", i + 1, cell_temps[i]);
   }
 }
 
@@ -304,8 +272,7 @@ void code_reset() {
 
 #if !THIS_IS_MASTER
 void can_receive_from_master(const CAN_message_t& msg) {
-  DEBUG_PRINT("RECIEIVED FROM ID: ");
-  Serial.println(msg.id, HEX);
+  DEBUG_PRINTLN("RECIEIVED FROM ID: {:x}", msg.id);
   if (msg.id == CELL_TEMPS_BASE_ID) {
     last_master_message_time = millis();
     master_has_communicated = true;
@@ -316,16 +283,13 @@ void can_receive_from_master(const CAN_message_t& msg) {
 #endif
 
 void can_snifflas(const CAN_message_t& msg) {
-  // DEBUG_PRINT("Received CAN message with ID: ");
-  // Serial.println(msg.id, HEX);
+  // DEBUG_PRINTLN("Received CAN message with ID: {:x}", msg.id);
   if (msg.id >= CELL_TEMPS_BASE_ID && msg.id < CELL_TEMPS_BASE_ID + TOTAL_BOARDS && msg.len == 4) {
     uint8_t board_from_id = msg.id - CELL_TEMPS_BASE_ID;
     uint8_t board_from_buf = msg.buf[0];
     if (board_from_id != board_from_buf) {
-      DEBUG_PRINT("Warning: Board ID mismatch - ID from message: ");
-      DEBUG_PRINT(board_from_id);
-      DEBUG_PRINT(", ID from payload: ");
-      DEBUG_PRINTLN(board_from_buf);
+      DEBUG_PRINTLN("Warning: Board ID mismatch - ID from message: {}, ID from payload: {}",
+                    board_from_id, board_from_buf);
       return;
     }
 
@@ -336,8 +300,7 @@ void can_snifflas(const CAN_message_t& msg) {
       board_temps[board_from_id].has_communicated = true;
       board_temps[board_from_id].last_update_ms = millis();
     } else {
-      DEBUG_PRINT("Error: Invalid board ID: ");
-      DEBUG_PRINTLN(board_from_id);
+      DEBUG_PRINTLN("Error: Invalid board ID: {}", board_from_id);
     }
   }
   last_message_received_time = millis();
@@ -365,9 +328,7 @@ void calculate_global_stats(TemperatureData& global_data) {
 }
 
 void initialize_can(uint32_t baudRate) {
-  DEBUG_PRINT("Initializing CAN at ");
-  DEBUG_PRINT(baudRate);
-  DEBUG_PRINTLN(" baud...");
+  DEBUG_PRINTLN("Initializing CAN at {} baud...", baudRate);
 
   can1.begin();
   can1.setBaudRate(baudRate);
@@ -433,8 +394,7 @@ void send_can_all_temps() {
     if (send_can_message(msg)) {
       // DEBUG_PRINTLN("Sent CAN message chunk with temperatures");
     } else {
-      DEBUG_PRINT("Failed to send CAN message chunk ");
-      DEBUG_PRINTLN(msg_index);
+      DEBUG_PRINTLN("CAN transmit queue full, chunk {} refused", msg_index);
     }
   }
 }
@@ -520,6 +480,7 @@ void loop() {
     send_can_max_min_avg_temperatures();
     send_can_all_temps();
   }
+  tx_queue.service(can1, millis(), TX_FRAMES_PER_LOOP);
   if (no_error_iterations >= NO_ERROR_RESET_THRESHOLD) {
     error_count = 0;
     no_error_iterations = 0;
@@ -530,4 +491,5 @@ void loop() {
     show_temperatures();
     debug_timer = 0;
   }
+  DEBUG_DRAIN();
 }
\ No newline at end of file
@@ -4,22 +4,36 @@
 
 #include <cstdint>
 
+#include "../../CAN_dispatch.h"
+#include "../../can_tx_queue.h"
+#include "../../periodic_scheduler.h"
 #include "data_struct.hpp"
 // #include "spi/SPI_MSTransfer_T4.h"
 
 class CanCommHandler {
 public:
-  CanCommHandler(SystemData& system_data, volatile SystemVolatileData& volatile_updatable_data,
+  CanCommHandler(SystemData& system_data, VolatileSnapshot<SystemVolatileData>& volatile_data,
                  SystemVolatileData& volatile_updated_data/*, SPI_MSTransfer_T4<&SPI>& display_spi*/);
 
   void setup();
   bool init_bamocar();
   void reset_bamocar_init();
   void stop_bamocar();
+  /**
+   * @brief Sends at most one of the periodic frames due, see publish_jobs, and the inverter mode
+   * when it changed
+   */
   void write_messages();
   void send_torque(int torque);
+  /**
+   * @brief Writes the frames queued since the last call, most urgent first, once per loop after
+   * the state machine queued its torque command
+   */
+  void transmit();
 
 private:
+  static constexpr unsigned TX_FRAMES_PER_LOOP = 8;  ///< Of about 80 a 10 ms loop carries
+
   BamocarState bamocar_state = CLEAR_ERRORS;
   unsigned long state_start_time = millis();
   unsigned long last_action_time = 0;
@@ -28,28 +42,50 @@ private:
   static void can_snifflas(const CAN_message_t& msg);
   void handle_can_message(const CAN_message_t& msg);
 
+  using ReceiveHandler = void (CanCommHandler::*)(const uint8_t* msg_data, uint8_t len);
+  /**
+   * @brief Frames handled by handle_can_message(), also the FIFO filters set up in setup()
+   */
+  static const can_dispatch::DispatchTable<ReceiveHandler, 4> receive_table;
+
+  using PublishHandler = void (CanCommHandler::*)();
+  /**
+   * @brief Periodic frames, shortest period first, phased apart so they go out on different loops
+   */
+  static const std::array<PeriodicJob<PublishHandler>, 2> publish_jobs;
+  CooperativeScheduler<PublishHandler, 2> publishers{publish_jobs};
+
   void bms_callback(const uint8_t* str, uint8_t len);
+  void bms_errors_callback(const uint8_t* msg_data, uint8_t len);
   void bamocar_callback(const uint8_t* msg_data, uint8_t len);
   void master_callback(const uint8_t* msg_data, uint8_t len);
 
   SystemData& data;
-  volatile SystemVolatileData& updatable_data;
+  VolatileSnapshot<SystemVolatileData>& volatile_data;
+  SystemVolatileData& updatable_data;  ///< volatile_data.writable(), published after each frame
   SystemVolatileData& updated_data;
 
   // SPI_MSTransfer_T4<&SPI>& display_spi;
 
   FlexCAN_T4<CAN2, RX_SIZE_256, TX_SIZE_16> can1;
+  /**
+   * @brief Transmit class of every frame the dash sends, see can_tx_queue.h
+   */
+  static const std::array<can_tx::Rule, 5> tx_rules;
+  can_tx::TxQueue<5> tx_queue{tx_rules};
   elapsedMillis can_timer;
-  elapsedMillis rpm_timer;        // Timer for RPM messages
-  elapsedMillis hydraulic_timer;  // Timer for brake messages
-  elapsedMillis apps_timer;       // Timer for APPS messages
   volatile bool transmission_enabled = false;
   volatile bool btb_ready = false;
 
+  void send(const CAN_message_t& msg);
   void send_bamo_requests();
-  void write_rpm();
-  void write_apps();
-  void write_dash_state();
-  void write_hydraulic_line();
+  /**
+   * @brief Front wheel speeds and the hydraulic line pressure, one DASH_WHEELS_BRAKE_MSG frame
+   */
+  void write_wheels_brake();
+  /**
+   * @brief Both APPS, the driving state and implausibility, one DASH_PEDALS_STATE_MSG frame
+   */
+  void write_pedals_state();
   void write_inverter_mode(SwitchMode switch_mode);
 };
\ No newline at end of file
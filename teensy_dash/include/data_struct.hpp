@@ -2,7 +2,10 @@
 #include <Arduino.h>
 #include <elapsedMillis.h>
 
-#include <deque>
+#include "../../moving_average.h"
+#include "../../running_median.h"
+#include "io_settings.hpp"
+#include "volatile_snapshot.hpp"
 
 enum class State { IDLE, INITIALIZING_DRIVING, DRIVING, INITIALIZING_AS_DRIVING, AS_DRIVING };
 
@@ -64,15 +67,26 @@ struct SystemData {
   bool emergency_buzzer_active = false;
   unsigned long emergency_buzzer_start_time;
   bool emergency_buzzer_state = false;
-  std::deque<uint16_t> apps_higher_readings;
-  std::deque<uint16_t> apps_lower_readings;
+  // ADC spikes are replaced by the window median before they reach the averages
+  HampelFilter<uint16_t, config::apps::SAMPLES> apps_higher_outliers{
+      config::apps::OUTLIER_MIN_DEVIATION};
+  HampelFilter<uint16_t, config::apps::SAMPLES> apps_lower_outliers{
+      config::apps::OUTLIER_MIN_DEVIATION};
+  MovingAverage<uint16_t, config::apps::SAMPLES> apps_higher_readings;
+  MovingAverage<uint16_t, config::apps::SAMPLES> apps_lower_readings;
   float fr_rpm = 0;
   float fl_rpm = 0;
-  std::deque<uint16_t> brake_readings;
+  HampelFilter<uint16_t, config::apps::SAMPLES> brake_outliers{
+      config::brake::OUTLIER_MIN_DEVIATION};
+  MovingAverage<uint16_t, config::apps::SAMPLES> brake_readings;
 
   elapsedMillis r2d_brake_timer = 0;
 };
 
+/**
+ * @brief Data written from the CAN interrupts, read in loop() through a
+ * VolatileSnapshot
+ */
 struct SystemVolatileData {
   bool TSOn = false;
   uint8_t as_state = 0;
@@ -85,28 +99,4 @@ struct SystemVolatileData {
   uint8_t max_temp = 0;
   uint16_t error_bitmap = 0;
   uint16_t warning_bitmap = 0;
-
-  unsigned long last_wheel_pulse_fr = 0;
-  unsigned long second_to_last_wheel_pulse_fr = 0;
-  unsigned long last_wheel_pulse_fl = 0;
-  unsigned long second_to_last_wheel_pulse_fl = 0;
 };
-
-inline void copy_volatile_data(SystemVolatileData& dest, volatile SystemVolatileData const& src) {
-  noInterrupts();
-  dest.TSOn = src.TSOn;
-  dest.as_state = src.as_state;
-  dest.asms_on = src.asms_on;
-  dest.brake_pressure = src.brake_pressure;
-  dest.speed = src.speed;
-  dest.soc = src.soc;
-  dest.last_wheel_pulse_fr = src.last_wheel_pulse_fr;
-  dest.second_to_last_wheel_pulse_fr = src.second_to_last_wheel_pulse_fr;
-  dest.last_wheel_pulse_fl = src.last_wheel_pulse_fl;
-  dest.second_to_last_wheel_pulse_fl = src.second_to_last_wheel_pulse_fl;
-  dest.motor_current = src.motor_current;
-  dest.min_temp = src.min_temp;
-  dest.max_temp = src.max_temp;
-  dest.error_bitmap = src.error_bitmap;
-  interrupts();
-}
\ No newline at end of file
@@ -3,11 +3,12 @@
 
 #include <cstdint>
 
+#include "../../wheel_speed.h"
 #include "data_struct.hpp"
 
 class IOManager {
 public:
-  IOManager(SystemData& system_data, volatile SystemVolatileData& volatile_updatable_data,
+  IOManager(SystemData& system_data, VolatileSnapshot<SystemVolatileData>& volatile_data,
             SystemVolatileData& volatile_updated_data);
 
   void setup();
@@ -16,7 +17,7 @@ public:
   void play_r2d_sound() const;
   void play_buzzer(uint8_t duration_seconds) const;
   void play_emergency_buzzer() const;
-  void calculate_rpm() const;
+  void calculate_rpm();
   void manage_ats() const;
   void read_rotative_switch() const;
   void read_hydraulic_pressure() const;
@@ -24,9 +25,14 @@ public:
 
 private:
   SystemData& data;
-  volatile SystemVolatileData& updatable_data;
+  VolatileSnapshot<SystemVolatileData>& volatile_data;
   SystemVolatileData& updated_data;
   inline static IOManager* instance = nullptr;
+  using WheelSpeedSensor = WheelSpeed<config::wheel::PULSES_PER_ROTATION>;
+  WheelSpeedSensor fr_wheel_speed{config::wheel::SPEED_WINDOW_US, config::wheel::SPEED_MAX_PULSES,
+                                  config::wheel::LIMIT_RPM_INTERVAL};  ///< micros() of the pulses
+  WheelSpeedSensor fl_wheel_speed{config::wheel::SPEED_WINDOW_US, config::wheel::SPEED_MAX_PULSES,
+                                  config::wheel::LIMIT_RPM_INTERVAL};
   void update_buzzer() const;
   static void read_pins_handle_leds();
   Bounce r2d_button = Bounce();
@@ -75,6 +75,7 @@ constexpr uint8_t MAX_ERROR_PERCENT = 10;
 constexpr uint16_t MAX_ERROR_ABS = UPPER_BOUND_APPS_HIGHER * MAX_ERROR_PERCENT / 100;
 
 constexpr uint8_t SAMPLES = 5;
+constexpr uint16_t OUTLIER_MIN_DEVIATION = 15;  // ADC counts a reading may stray unrejected
 constexpr uint16_t BRAKE_BLOCK_THRESHOLD = 210;
 constexpr uint32_t IMPLAUSIBLE_TIMEOUT_MS = 500; // Time to set implausibility flag back to false
 constexpr uint32_t BRAKE_PLAUSIBILITY_TIMEOUT_MS = 500;
@@ -83,11 +84,14 @@ constexpr uint32_t BRAKE_PLAUSIBILITY_TIMEOUT_MS = 500;
 namespace brake {
 constexpr uint16_t BLOCK_THRESHOLD = 220;
 constexpr uint16_t PRESSURE_THRESHOLD = 250;
+constexpr uint16_t OUTLIER_MIN_DEVIATION = 20;
 }  // namespace brake
 
 namespace wheel {
 constexpr uint32_t LIMIT_RPM_INTERVAL = 500'000;
 constexpr uint8_t PULSES_PER_ROTATION = 48;
+constexpr uint32_t SPEED_WINDOW_US = 40'000;  ///< Pulses within this much are averaged
+constexpr uint32_t SPEED_MAX_PULSES = 16;     ///< Intervals averaged at most at speed
 }  // namespace wheel
 
 namespace r2d {
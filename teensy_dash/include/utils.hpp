@@ -1,31 +1,29 @@
 #pragma once
 #include <array>
 #include <cstdint>
-#include <deque>
 
 #include "data_struct.hpp"
 
+// Tokenized logging, decode the USB output with tools/log_decoder.py
 #ifdef DEBUG_PRINTS
-#define DEBUG_PRINT(x) Serial.print(x)
-#define DEBUG_PRINTLN(x) Serial.println(x);Serial.flush()
+#include "../../debug_log.h"
+#define DEBUG_PRINT(...) DEBUG_LOG(__VA_ARGS__)
+#define DEBUG_PRINTLN(...) DEBUG_LOG(__VA_ARGS__)
+#define DEBUG_DRAIN() debug_log::drain_to_serial()
 #else
-#define DEBUG_PRINT(x)
-#define DEBUG_PRINTLN(x)
+#define DEBUG_PRINT(...)
+#define DEBUG_PRINTLN(...)
+#define DEBUG_DRAIN()
 #endif
 
-// Add values to the front of the queue and remove from back if necessary
-void insert_value_queue(uint16_t value, std::deque<uint16_t>& queue);
-
-// Calculate the average of values in a queue
-uint16_t average_queue(const std::deque<uint16_t>& queue);
-
 // Check if data sequence matches expected pattern
 bool check_sequence(const uint8_t* data, const std::array<uint8_t, 3>& expected);
 
 /**
- * Converts RPM float value to a 4-byte representation
+ * Converts an RPM value to the raw unit of the packed wheel frames, WHEEL_PRECISION RPM,
+ * clamped to the 0 to WHEEL_RPM_MAX range their signals hold
  * @param rpm The RPM value to convert
  */
-std::array<uint8_t, 4> rpm_to_bytes(float rpm);
+uint32_t wheel_centi_rpm(float rpm);
 
 InverterModeParams get_inverter_mode_config(SwitchMode switch_mode);
\ No newline at end of file
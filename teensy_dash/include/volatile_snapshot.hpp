@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Struct filled by interrupt handlers and copied whole by loop(), without masking
+ * interrupts
+ * @details The handlers write the interrupt side copy (writable()) and publish() it into one of
+ * two buffers, alternating, each publish bumping a generation counter. read() copies the buffer of
+ * the last generation: the next publish writes the other buffer, so the copy is only retried if
+ * two publishes land while it runs. Every field is copied, nothing has to be listed by hand.
+ *
+ * Writers are the interrupt handlers of one core and may preempt each other: a handler that
+ * interrupts another one's publish() only marks the data dirty, and the interrupted publish()
+ * copies again before returning.
+ * @tparam T trivially copyable struct
+ */
+template <typename T>
+class VolatileSnapshot {
+  static_assert(std::is_trivially_copyable_v<T>, "VolatileSnapshot copies T word by word");
+
+public:
+  VolatileSnapshot() {
+    store(buffers[0], pending);
+    store(buffers[1], pending);
+  }
+
+  /**
+   * @brief Interrupt side copy, only touched from interrupt handlers, publish() when done
+   */
+  T& writable() { return pending; }
+
+  /**
+   * @brief Makes the current writable() state the one read() returns
+   */
+  void publish() {
+    dirty.store(true);
+    while (dirty.load() && !publishing.exchange(true)) {
+      const uint32_t next = published.load(std::memory_order_relaxed) + 1;
+      started.store(next, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      // A nested handler may change pending mid-copy, the buffer is not visible yet so copy again
+      while (dirty.exchange(false)) store(buffers[next & 1], pending);
+      published.store(next, std::memory_order_release);
+      publishing.store(false);
+    }
+  }
+
+  /**
+   * @brief Changes the interrupt side copy and publishes it
+   */
+  template <typename Update>
+  void update(Update&& update) {
+    update(pending);
+    publish();
+  }
+
+  /**
+   * @brief Copy of the last published state, never torn, from the main loop
+   */
+  [[nodiscard]] T read() const {
+    while (true) {
+      const uint32_t generation = published.load(std::memory_order_acquire);
+      const T value = load(buffers[generation & 1]);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      // Publish generation + 1 writes the other buffer, generation + 2 may have overwritten this one
+      if (started.load(std::memory_order_relaxed) - generation < 2) return value;
+    }
+  }
+
+  /**
+   * @brief Number of publishes so far, unchanged means read() would return the same state
+   */
+  [[nodiscard]] uint32_t generation() const { return published.load(std::memory_order_acquire); }
+
+private:
+  static constexpr std::size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+  using Buffer = std::array<std::atomic<uint32_t>, WORDS>;
+
+  T pending{};
+  std::array<Buffer, 2> buffers{};
+  std::atomic<uint32_t> started{0};    ///< Generation of the last publish that began writing
+  std::atomic<uint32_t> published{0};  ///< Generation of the last complete publish
+  std::atomic<bool> publishing{false};
+  std::atomic<bool> dirty{false};
+
+  static void store(Buffer& buffer, const T& value) {
+    std::array<uint32_t, WORDS> words{};
+    memcpy(words.data(), static_cast<const void*>(&value), sizeof(T));
+    for (std::size_t i = 0; i < WORDS; i++) buffer[i].store(words[i], std::memory_order_relaxed);
+  }
+
+  static T load(const Buffer& buffer) {
+    std::array<uint32_t, WORDS> words{};
+    for (std::size_t i = 0; i < WORDS; i++) words[i] = buffer[i].load(std::memory_order_relaxed);
+    T value;
+    // T may have default member initializers, which only the void* view lets memcpy overwrite
+    memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+    return value;
+  }
+};
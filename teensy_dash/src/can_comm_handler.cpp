@@ -1,18 +1,51 @@
 #include "can_comm_handler.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <utils.hpp>
 
 #include "../../CAN_IDs.h"
+#include "../../CAN_messages.h"
 #include "io_settings.hpp"
 
+constexpr can_dispatch::DispatchTable<CanCommHandler::ReceiveHandler, 4>
+    CanCommHandler::receive_table = can_dispatch::make_table<ReceiveHandler>({
+        {BMS_THERMISTOR_ID, true, &CanCommHandler::bms_callback},
+        {BMS_ERRORS_ID, false, &CanCommHandler::bms_errors_callback},
+        {BAMO_RESPONSE_ID, false, &CanCommHandler::bamocar_callback},
+        {MASTER_ID, false, &CanCommHandler::master_callback},
+    });
+
+// Signal layout packed by tools/frame_planner.py, see tools/frame_plan.txt
+constexpr std::array<PeriodicJob<CanCommHandler::PublishHandler>, 2>
+    CanCommHandler::publish_jobs = {{
+        {"wheels_brake", RPM_MSG_PERIOD_MS, 0, &CanCommHandler::write_wheels_brake},
+        {"pedals_state", APPS_MSG_PERIOD_MS, 25, &CanCommHandler::write_pedals_state},
+    }};
+
+// Torque is latest-value-wins: a command still waiting is replaced, never sent stale after it.
+// Disabling the drive goes before anything else queued with it
+constexpr std::array<can_tx::Rule, 5> CanCommHandler::tx_rules = {{
+    {BAMO_COMMAND_ID, TORQUE_COMMAND_BAMO_BYTE, can_tx::Priority::CONTROL, true, 0},
+    {BAMO_COMMAND_ID, BAMOCAR_DISABLE_CODE, can_tx::Priority::SAFETY, false, 0},
+    {BAMO_COMMAND_ID, can_tx::ANY_TYPE, can_tx::Priority::CONTROL, false, 0},
+    {DASH_ID, DASH_WHEELS_BRAKE_MSG, can_tx::Priority::STATUS, true, 0},
+    {DASH_ID, DASH_PEDALS_STATE_MSG, can_tx::Priority::STATUS, true, 0},
+}};
+
+static_assert(can_db::DashMsgs::M80::MUX == DASH_WHEELS_BRAKE_MSG &&
+                  can_db::DashMsgs::M81::MUX == DASH_PEDALS_STATE_MSG &&
+                  can_db::MasterMsgs::M56::MUX == MASTER_STATUS_MSG,
+              "CAN_IDs.h disagrees with the layout tools/frame_planner.py wrote to conf.dbc");
+
 CanCommHandler::CanCommHandler(SystemData& system_data,
-                               volatile SystemVolatileData& volatile_updatable_data,
+                               VolatileSnapshot<SystemVolatileData>& volatile_data,
                                SystemVolatileData& volatile_updated_data/*,
                                SPI_MSTransfer_T4<&SPI>& display_spi*/)
     : data(system_data),
-      updatable_data(volatile_updatable_data),
+      volatile_data(volatile_data),
+      updatable_data(volatile_data.writable()),
       updated_data(volatile_updated_data)/*,
       display_spi(display_spi)*/ {
   static_callback = [this](const CAN_message_t& msg) { this->handle_can_message(msg); };
@@ -24,16 +57,22 @@ void CanCommHandler::setup() {
   can1.setBaudRate(1'000'000);
   can1.enableFIFO();
   can1.enableFIFOInterrupt();
-  can1.setFIFOFilter(REJECT_ALL);
-  can1.setFIFOFilter(0, BMS_THERMISTOR_ID, EXT);
-  can1.setFIFOFilter(1, BAMO_RESPONSE_ID, STD);
-  can1.setFIFOFilter(2, MASTER_ID, STD);
+  receive_table.program_filters(can1);
   can1.onReceive(can_snifflas);
   delay(100);
 
   send_bamo_requests();
+  publishers.start();
 }
 
+void CanCommHandler::send(const CAN_message_t& msg) {
+  if (tx_queue.enqueue(msg, millis()) == can_tx::Result::FULL) {
+    DEBUG_PRINTLN("CAN transmit queue full, frame 0x{:x} refused", msg.id);
+  }
+}
+
+void CanCommHandler::transmit() { tx_queue.service(can1, millis(), TX_FRAMES_PER_LOOP); }
+
 void CanCommHandler::send_bamo_requests() {
   constexpr CAN_message_t disable = {.id = BAMO_COMMAND_ID, .len = 3, .buf = {0x51, 0x04, 0x00}};
 
@@ -51,12 +90,12 @@ void CanCommHandler::send_bamo_requests() {
   constexpr CAN_message_t motor_temperature_request = {
       .id = BAMO_COMMAND_ID, .len = 3, .buf = {0x3D, MOTOR_TEMPERATURE, 0xEF}};
   // Send all messages (don't exceed 8 requests)
-  can1.write(disable);
-  can1.write(dc_voltage_request);
-  can1.write(speed_actual_request);
-  can1.write(current_actual_request);
-  can1.write(logicmap_errors_request);
-  can1.write(motor_temperature_request);
+  send(disable);
+  send(dc_voltage_request);
+  send(speed_actual_request);
+  send(current_actual_request);
+  send(logicmap_errors_request);
+  send(motor_temperature_request);
 }
 
 void CanCommHandler::can_snifflas(const CAN_message_t& msg) {
@@ -66,89 +105,86 @@ void CanCommHandler::can_snifflas(const CAN_message_t& msg) {
 }
 void CanCommHandler::handle_can_message(const CAN_message_t& msg) {
   // DEBUG_PRINTLN("CAN INT");
-  switch (msg.id) {
-    case BMS_THERMISTOR_ID:
-      bms_callback(msg.buf, msg.len);
-      break;
-    case BAMO_RESPONSE_ID:
-      bamocar_callback(msg.buf, msg.len);
-      break;
-    case MASTER_ID:
-      master_callback(msg.buf, msg.len);
-      break;
-    case BMS_ERRORS_ID: {
-      // yves: estes são menos importantes mas se der mete tb
-      DEBUG_PRINTLN("BMS Error ID received - Raw msg data:");
-      for (uint8_t i = 0; i < msg.len; i++) {
-        DEBUG_PRINTLN("  msg_data[" + String(i) + "] = 0x" + String(msg.buf[i], HEX));
-      }
+  if (const ReceiveHandler* handler = receive_table.find(msg)) {
+    (this->*(*handler))(msg.buf, msg.len);
+    volatile_data.publish();
+  }
+}
 
-      // Handle DTC Status #1 (indices 0 and 1)
-      if (msg.len >= 2) {
-        uint16_t error_bitmap_1 = (msg.buf[1] << 8) | msg.buf[0];
-        DEBUG_PRINTLN("BMS ERRORS #1: 0x" + String(error_bitmap_1, HEX));
-        DEBUG_PRINTLN("DTC Status #1 error bits:");
-        DEBUG_PRINTLN("  Bit 1 (0x0001): P0A07 (Discharge Limit Enforcement Fault): " +
-                      String((error_bitmap_1 & (1 << 0)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 2 (0x0002): P0A08 (Charger Safety Relay Fault): " +
-                      String((error_bitmap_1 & (1 << 1)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 3 (0x0004): P0A09 (Internal Hardware Fault): " +
-                      String((error_bitmap_1 & (1 << 2)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 4 (0x0008): P0A0A (Internal Heatsink Thermistor Fault): " +
-                      String((error_bitmap_1 & (1 << 3)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 5 (0x0010): P0A0B (Internal Software Fault): " +
-                      String((error_bitmap_1 & (1 << 4)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 6 (0x0020): P0A0C (Highest Cell Voltage Too High Fault): " +
-                      String((error_bitmap_1 & (1 << 5)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 7 (0x0040): P0A0E (Lowest Cell Voltage Too Low Fault): " +
-                      String((error_bitmap_1 & (1 << 6)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 8 (0x0080): P0A10 (Pack Too Hot Fault): " +
-                      String((error_bitmap_1 & (1 << 7)) ? 1 : 0));
-      }
+// Runs in the CAN FIFO interrupt, like every receive_table handler. It was dead code before the
+// table programmed the FIFO filters, BMS_ERRORS_ID had no filter. It only reads the frame and
+// logs: DEBUG_PRINTLN copies into the debug_log ring, which takes writers from interrupts and
+// never blocks, Serial is only touched by DEBUG_DRAIN() in loop(). It writes no volatile data.
+void CanCommHandler::bms_errors_callback(const uint8_t* msg_data, const uint8_t len) {
+    // yves: estes são menos importantes mas se der mete tb
+    DEBUG_PRINTLN("BMS Error ID received - Raw msg data:");
+    for (uint8_t i = 0; i < len; i++) {
+      DEBUG_PRINTLN("  msg_data[{}] = 0x{:x}", i, msg_data[i]);
+    }
 
-      // Handle DTC Status #2 (indices 2 and 3)
-      if (msg.len >= 4) {
-        uint16_t error_bitmap_2 = (msg.buf[3] << 8) | msg.buf[2];
-        DEBUG_PRINTLN("BMS ERRORS #2: 0x" + String(error_bitmap_2, HEX));
-        DEBUG_PRINTLN("DTC Status #2 error bits:");
-        DEBUG_PRINTLN("  Bit 1 (0x0001): P0A1F (Internal Communication Fault): " +
-                      String((error_bitmap_2 & (1 << 0)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 2 (0x0002): P0A12 (Cell Balancing Stuck Off Fault): " +
-                      String((error_bitmap_2 & (1 << 1)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 3 (0x0004): P0A80 (Weak Cell Fault): " +
-                      String((error_bitmap_2 & (1 << 2)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 4 (0x0008): P0AFA (Low Cell Voltage Fault): " +
-                      String((error_bitmap_2 & (1 << 3)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 5 (0x0010): P0A04 (Open Wiring Fault): " +
-                      String((error_bitmap_2 & (1 << 4)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 6 (0x0020): P0AC0 (Current Sensor Fault): " +
-                      String((error_bitmap_2 & (1 << 5)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 7 (0x0040): P0A0D (Highest Cell Voltage Over 5V Fault): " +
-                      String((error_bitmap_2 & (1 << 6)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 8 (0x0080): P0A0F (Cell ASIC Fault): " +
-                      String((error_bitmap_2 & (1 << 7)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 9 (0x0100): P0A02 (Weak Pack Fault): " +
-                      String((error_bitmap_2 & (1 << 8)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 10 (0x0200): P0A81 (Fan Monitor Fault): " +
-                      String((error_bitmap_2 & (1 << 9)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 11 (0x0400): P0A9C (Thermistor Fault): " +
-                      String((error_bitmap_2 & (1 << 10)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 12 (0x0800): U0100 (External Communication Fault): " +
-                      String((error_bitmap_2 & (1 << 11)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 13 (0x1000): P0560 (Redundant Power Supply Fault): " +
-                      String((error_bitmap_2 & (1 << 12)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 14 (0x2000): P0AA6 (High Voltage Isolation Fault): " +
-                      String((error_bitmap_2 & (1 << 13)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 15 (0x4000): P0A05 (Input Power Supply Fault): " +
-                      String((error_bitmap_2 & (1 << 14)) ? 1 : 0));
-        DEBUG_PRINTLN("  Bit 16 (0x8000): P0A06 (Charge Limit Enforcement Fault): " +
-                      String((error_bitmap_2 & (1 << 15)) ? 1 : 0));
-      }
-    } break;
-    default:
-      break;
-  }
+    // Handle DTC Status #1 (indices 0 and 1)
+    if (len >= 2) {
+      uint16_t error_bitmap_1 = (msg_data[1] << 8) | msg_data[0];
+      DEBUG_PRINTLN("BMS ERRORS #1: 0x{:x}", error_bitmap_1);
+      DEBUG_PRINTLN("DTC Status #1 error bits:");
+      DEBUG_PRINTLN("  Bit 1 (0x0001): P0A07 (Discharge Limit Enforcement Fault): {}",
+                    (error_bitmap_1 & (1 << 0)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 2 (0x0002): P0A08 (Charger Safety Relay Fault): {}",
+                    (error_bitmap_1 & (1 << 1)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 3 (0x0004): P0A09 (Internal Hardware Fault): {}",
+                    (error_bitmap_1 & (1 << 2)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 4 (0x0008): P0A0A (Internal Heatsink Thermistor Fault): {}",
+                    (error_bitmap_1 & (1 << 3)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 5 (0x0010): P0A0B (Internal Software Fault): {}",
+                    (error_bitmap_1 & (1 << 4)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 6 (0x0020): P0A0C (Highest Cell Voltage Too High Fault): {}",
+                    (error_bitmap_1 & (1 << 5)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 7 (0x0040): P0A0E (Lowest Cell Voltage Too Low Fault): {}",
+                    (error_bitmap_1 & (1 << 6)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 8 (0x0080): P0A10 (Pack Too Hot Fault): {}",
+                    (error_bitmap_1 & (1 << 7)) ? 1 : 0);
+    }
+
+    // Handle DTC Status #2 (indices 2 and 3)
+    if (len >= 4) {
+      uint16_t error_bitmap_2 = (msg_data[3] << 8) | msg_data[2];
+      DEBUG_PRINTLN("BMS ERRORS #2: 0x{:x}", error_bitmap_2);
+      DEBUG_PRINTLN("DTC Status #2 error bits:");
+      DEBUG_PRINTLN("  Bit 1 (0x0001): P0A1F (Internal Communication Fault): {}",
+                    (error_bitmap_2 & (1 << 0)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 2 (0x0002): P0A12 (Cell Balancing Stuck Off Fault): {}",
+                    (error_bitmap_2 & (1 << 1)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 3 (0x0004): P0A80 (Weak Cell Fault): {}",
+                    (error_bitmap_2 & (1 << 2)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 4 (0x0008): P0AFA (Low Cell Voltage Fault): {}",
+                    (error_bitmap_2 & (1 << 3)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 5 (0x0010): P0A04 (Open Wiring Fault): {}",
+                    (error_bitmap_2 & (1 << 4)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 6 (0x0020): P0AC0 (Current Sensor Fault): {}",
+                    (error_bitmap_2 & (1 << 5)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 7 (0x0040): P0A0D (Highest Cell Voltage Over 5V Fault): {}",
+                    (error_bitmap_2 & (1 << 6)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 8 (0x0080): P0A0F (Cell ASIC Fault): {}",
+                    (error_bitmap_2 & (1 << 7)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 9 (0x0100): P0A02 (Weak Pack Fault): {}",
+                    (error_bitmap_2 & (1 << 8)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 10 (0x0200): P0A81 (Fan Monitor Fault): {}",
+                    (error_bitmap_2 & (1 << 9)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 11 (0x0400): P0A9C (Thermistor Fault): {}",
+                    (error_bitmap_2 & (1 << 10)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 12 (0x0800): U0100 (External Communication Fault): {}",
+                    (error_bitmap_2 & (1 << 11)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 13 (0x1000): P0560 (Redundant Power Supply Fault): {}",
+                    (error_bitmap_2 & (1 << 12)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 14 (0x2000): P0AA6 (High Voltage Isolation Fault): {}",
+                    (error_bitmap_2 & (1 << 13)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 15 (0x4000): P0A05 (Input Power Supply Fault): {}",
+                    (error_bitmap_2 & (1 << 14)) ? 1 : 0);
+      DEBUG_PRINTLN("  Bit 16 (0x8000): P0A06 (Charge Limit Enforcement Fault): {}",
+                    (error_bitmap_2 & (1 << 15)) ? 1 : 0);
+    }
 }
+
 void CanCommHandler::bms_callback(const uint8_t* msg_data, uint8_t len) {
   updatable_data.min_temp = msg_data[1];
   updatable_data.max_temp = msg_data[2];
@@ -191,12 +227,12 @@ void CanCommHandler::bamocar_callback(const uint8_t* const msg_data, const uint8
 
     case SPEED_ACTUAL:
       updatable_data.speed = message_value;
-      // DEBUG_PRINTLN("BAMOCAR SPEED: " + String(message_value));
+      // DEBUG_PRINTLN("BAMOCAR SPEED: {}", message_value);
       break;
     case CURRENT_ACTUAL:
       // yves: corrente para o display
       updatable_data.motor_current = message_value;
-      // DEBUG_PRINTLN("BAMOCAR CURRENT: " + String(message_value));
+      // DEBUG_PRINTLN("BAMOCAR CURRENT: {}", message_value);
       break;
 
     case LOGICMAP_ERRORS: {
@@ -218,41 +254,23 @@ void CanCommHandler::master_callback(const uint8_t* const msg_data, const uint8_
       updatable_data.brake_pressure = (msg_data[2] << 8) | msg_data[1];
       break;
 
-    case ASMS:
-      updatable_data.asms_on = msg_data[1];
-      break;
-
-    case SOC_MSG: {
-      updatable_data.soc = msg_data[1];
+    case MASTER_STATUS_MSG: {
+      const auto status = can_db::MasterMsgs::M56::unpack(msg_data);
+      updatable_data.asms_on = status.asms_on;
+      updatable_data.soc = status.lv_soc;
+      updatable_data.as_state = status.master_state;
     } break;
-    case STATE_MSG:
-      updatable_data.as_state = msg_data[1];
-      break;
     default:
       break;
   }
 }
 
 void CanCommHandler::write_messages() {
-  if (rpm_timer >= RPM_MSG_PERIOD_MS) {
-    write_rpm();
-    // write_bamocar_speed();
-    rpm_timer = 0;
-    // DEBUG_PRINTLN("RPM message sent");
-  }
-
-  if (hydraulic_timer >= HYDRAULIC_MSG_PERIOD_MS) {
-    write_hydraulic_line();
-    hydraulic_timer = 0;
-    // DEBUG_PRINTLN("Hydraulic line message sent");
-  }
-
-  if (apps_timer >= APPS_MSG_PERIOD_MS) {
-    write_apps();
-    write_dash_state();
-    apps_timer = 0;
-    // DEBUG_PRINTLN("APPS message sent");
-  }
+  static_assert(rate_monotonic_order(publish_jobs));
+  // 150 and 250 ms share a 50 ms grid and the phases are 25 ms apart, but a late loop can still
+  // find both due: one job is sent per call and the other follows on the next loop
+  static_assert(min_release_gap_ms(publish_jobs) >= 25);
+  publishers.run(*this, 1);
 
   const auto& current_mode = data.switch_mode;
   static auto previous_mode = SwitchMode::INVERTER_MODE_INIT;
@@ -262,70 +280,33 @@ void CanCommHandler::write_messages() {
   }
 }
 
-void CanCommHandler::write_dash_state() {
-  // Ensure boolean values are normalized to 0 or 1
-  auto normalize_bool = [](bool value) -> uint8_t { return value ? 1 : 0; };    
-
-  CAN_message_t dash_state;
-  dash_state.id = DASH_ID;
-  dash_state.len = 3;
-  dash_state.buf[0] = DRIVING_STATE;
-  dash_state.buf[1] = static_cast<uint8_t>(this->data.current_state);
-  dash_state.buf[2] = normalize_bool(this->data.implausibility);
-  this->can1.write(dash_state);
+void CanCommHandler::write_wheels_brake() {
+  can_db::DashMsgs::M80 frame;
+  frame.fr_rpm = wheel_centi_rpm(data.fr_rpm);
+  frame.fl_rpm = wheel_centi_rpm(data.fl_rpm);
+  frame.hydraulic_line = data.brake_readings.average();
+
+  CAN_message_t message;
+  message.id = DASH_ID;
+  message.len = frame.LEN;
+  const auto payload = frame.pack();
+  std::copy(payload.begin(), payload.end(), message.buf);
+  send(message);
 }
 
-void CanCommHandler::write_rpm() {
-  CAN_message_t rpm_message;
-  rpm_message.id = DASH_ID;
-  rpm_message.len = 5;
-
-  auto send_rpm = [this, &rpm_message](const uint8_t rpm_type, const float rpm_value) {
-    const auto rpm_bytes = rpm_to_bytes(rpm_value);
-    rpm_message.buf[0] = rpm_type;
-    rpm_message.buf[1] = rpm_bytes[0];
-    rpm_message.buf[2] = rpm_bytes[1];
-    rpm_message.buf[3] = rpm_bytes[2];
-    rpm_message.buf[4] = rpm_bytes[3];
-    this->can1.write(rpm_message);
-  };
-
-  send_rpm(FR_RPM, data.fr_rpm);
-  send_rpm(FL_RPM, data.fl_rpm);
-}
-
-void CanCommHandler::write_hydraulic_line() {
-  const uint16_t hydraulic_value = average_queue(data.brake_readings);
-  CAN_message_t hydraulic_message;
-  hydraulic_message.id = DASH_ID;
-  hydraulic_message.len = 3;
-
-  hydraulic_message.buf[0] = HYDRAULIC_LINE;
-  hydraulic_message.buf[1] = hydraulic_value & 0xFF;         // Lower byte
-  hydraulic_message.buf[2] = (hydraulic_value >> 8) & 0xFF;  // Upper byte
-
-  can1.write(hydraulic_message);
-}
-
-void CanCommHandler::write_apps() {
-  const int32_t apps_higher = average_queue(data.apps_higher_readings);
-  const int32_t apps_lower = average_queue(data.apps_lower_readings);
-
-  CAN_message_t apps_message;
-  apps_message.id = DASH_ID;
-  apps_message.len = 5;
-
-  auto send_apps = [this, &apps_message](const uint8_t apps_type, const int32_t apps_value) {
-    apps_message.buf[0] = apps_type;
-    apps_message.buf[1] = (apps_value >> 0) & 0xFF;
-    apps_message.buf[2] = (apps_value >> 8) & 0xFF;
-    apps_message.buf[3] = (apps_value >> 16) & 0xFF;
-    apps_message.buf[4] = (apps_value >> 24) & 0xFF;
-    can1.write(apps_message);
-  };
-
-  send_apps(APPS_HIGHER, apps_higher);
-  send_apps(APPS_LOWER, apps_lower);
+void CanCommHandler::write_pedals_state() {
+  can_db::DashMsgs::M81 frame;
+  frame.apps_higher = data.apps_higher_readings.average();
+  frame.apps_lower = data.apps_lower_readings.average();
+  frame.current_state = static_cast<uint8_t>(data.current_state);
+  frame.implausibility = data.implausibility;
+
+  CAN_message_t message;
+  message.id = DASH_ID;
+  message.len = frame.LEN;
+  const auto payload = frame.pack();
+  std::copy(payload.begin(), payload.end(), message.buf);
+  send(message);
 }
 
 void CanCommHandler::write_inverter_mode(const SwitchMode switch_mode) {
@@ -334,47 +315,12 @@ void CanCommHandler::write_inverter_mode(const SwitchMode switch_mode) {
 
   InverterModeParams params = get_inverter_mode_config(switch_mode);
 
-#ifdef DEBUG_PRINTS
-  auto mode_to_string = [](SwitchMode mode) -> const char* {
-    switch (mode) {
-      case SwitchMode::INVERTER_MODE_0:
-        return "MODE_0";
-      case SwitchMode::INVERTER_MODE_CAVALETES:
-        return "CAVALETES";
-      case SwitchMode::INVERTER_MODE_LIMITER:
-        return "LIMITER";
-      case SwitchMode::INVERTER_MODE_BRAKE_TEST:
-        return "BRAKE_TEST";
-      case SwitchMode::INVERTER_MODE_SKIDPAD:
-        return "SKIDPAD";
-      case SwitchMode::INVERTER_MODE_ENDURANCE:
-        return "ENDURANCE";
-      case SwitchMode::INVERTER_MODE_MAX_ATTACK:
-        return "MAX_ATTACK";
-      case SwitchMode::INVERTER_MODE_NULL:
-        return "NULL";
-      default:
-        return "UNKNOWN";
-    }
-  };
-
-  DEBUG_PRINT("Mode: ");
-  DEBUG_PRINT(mode_to_string(switch_mode));
-  DEBUG_PRINT(" | i_max: ");
-  DEBUG_PRINT(params.i_max_pk_percent);
-  DEBUG_PRINT("% | speed: ");
-  DEBUG_PRINT(params.speed_limit_percent);
-  DEBUG_PRINT("% | i_cont: ");
-  DEBUG_PRINT(params.i_cont_percent);
-  DEBUG_PRINT("% | s_acc: ");
-  DEBUG_PRINT(params.speed_ramp_acc);
-  DEBUG_PRINT(" | m_acc: ");
-  DEBUG_PRINT(params.moment_ramp_acc);
-  DEBUG_PRINT(" | s_brk: ");
-  DEBUG_PRINT(params.speed_ramp_brake);
-  DEBUG_PRINT(" | m_dec: ");
-  DEBUG_PRINTLN(params.moment_ramp_decc);
-#endif
+  DEBUG_PRINTLN("Mode: {MODE_0|CAVALETES|LIMITER|BRAKE_TEST|SKIDPAD|ENDURANCE|MAX_ATTACK|NULL|INIT}"
+                " | i_max: {}% | speed: {}% | i_cont: {}% | s_acc: {} | m_acc: {} | s_brk: {}"
+                " | m_dec: {}",
+                switch_mode, params.i_max_pk_percent, params.speed_limit_percent,
+                params.i_cont_percent, params.speed_ramp_acc, params.moment_ramp_acc,
+                params.speed_ramp_brake, params.moment_ramp_decc);
 
   int i_max_pk = map(params.i_max_pk_percent, 0, 100, 0, MAX_I_VALUE);
   int i_cont = map(params.i_cont_percent, 0, 100, 0, MAX_I_VALUE);
@@ -406,11 +352,11 @@ void CanCommHandler::write_inverter_mode(const SwitchMode switch_mode) {
   deccRamp_msg.buf[3] = params.moment_ramp_decc & 0xFF;         // Lower byte
   deccRamp_msg.buf[4] = (params.moment_ramp_decc >> 8) & 0xFF;  // Upper byte
 
-  can1.write(i_max_msg);
-  can1.write(speed_limit_msg);
-  can1.write(i_cont_msg);
-  can1.write(accRamp_msg);
-  can1.write(deccRamp_msg);
+  send(i_max_msg);
+  send(speed_limit_msg);
+  send(i_cont_msg);
+  send(accRamp_msg);
+  send(deccRamp_msg);
 }
 
 bool CanCommHandler::init_bamocar() {
@@ -438,13 +384,13 @@ bool CanCommHandler::init_bamocar() {
   switch (bamocar_state) {
     case CLEAR_ERRORS:
       DEBUG_PRINTLN("Clearing errors");
-      can1.write(clear_error_message);
+      send(clear_error_message);
       bamocar_state = CHECK_BTB;
       break;
     case CHECK_BTB:
       if (currentTime - last_action_time >= actionInterval) {
         DEBUG_PRINTLN("Checking BTB status");
-        can1.write(checkBTBStatus);
+        send(checkBTBStatus);
         last_action_time = currentTime;
       }
       if (btb_ready) {
@@ -459,14 +405,14 @@ bool CanCommHandler::init_bamocar() {
 
     case DISABLE:
       DEBUG_PRINTLN("Disabling");
-      can1.write(disable);
+      send(disable);
       bamocar_state = ENABLE_TRANSMISSION;
       break;
 
     case ENABLE_TRANSMISSION:
       if (currentTime - last_action_time >= actionInterval) {
         DEBUG_PRINTLN("Enabling transmission");
-        can1.write(enableTransmission);
+        send(enableTransmission);
         last_action_time = currentTime;
       }
       if (transmission_enabled) {
@@ -484,25 +430,23 @@ bool CanCommHandler::init_bamocar() {
     case ENABLE:
       if (!command_sent) {
         DEBUG_PRINTLN("Removing disable");
-        can1.write(removeDisable);
+        send(removeDisable);
         command_sent = true;
         bamocar_state = ACC_RAMP;
       }
       break;
 
     case ACC_RAMP:
-      DEBUG_PRINT("Transmitting acceleration ramp: ");
-      DEBUG_PRINT(rampAccRequest.buf[1] | (rampAccRequest.buf[2] << 8));
-      DEBUG_PRINTLN("ms");
-      can1.write(rampAccRequest);
+      DEBUG_PRINTLN("Transmitting acceleration ramp: {}ms",
+                    rampAccRequest.buf[1] | (rampAccRequest.buf[2] << 8));
+      send(rampAccRequest);
       bamocar_state = DEC_RAMP;
       break;
 
     case DEC_RAMP:
-      DEBUG_PRINT("Transmitting deceleration ramp: ");
-      DEBUG_PRINT(rampDecRequest.buf[1] | (rampDecRequest.buf[2] << 8));
-      DEBUG_PRINTLN("ms");
-      can1.write(rampDecRequest);
+      DEBUG_PRINTLN("Transmitting deceleration ramp: {}ms",
+                    rampDecRequest.buf[1] | (rampDecRequest.buf[2] << 8));
+      send(rampDecRequest);
       bamocar_state = INITIALIZED;
       break;
     case INITIALIZED:
@@ -524,7 +468,7 @@ void CanCommHandler::reset_bamocar_init() {
 void CanCommHandler::stop_bamocar() {
   constexpr CAN_message_t disable = {.id = BAMO_COMMAND_ID, .len = 3, .buf = {0x51, 0x04, 0x00}};
 
-  can1.write(disable);
+  send(disable);
 }
 
 void CanCommHandler::send_torque(const int torque) {
@@ -535,5 +479,5 @@ void CanCommHandler::send_torque(const int torque) {
   torque_message.buf[1] = torque & 0xFF;         // Lower byte
   torque_message.buf[2] = (torque >> 8) & 0xFF;  // Upper byte
 
-  can1.write(torque_message);
+  send(torque_message);
 }
\ No newline at end of file
@@ -3,10 +3,10 @@
 #include <io_settings.hpp>
 #include <utils.hpp>
 
-IOManager::IOManager(SystemData& system_data, volatile SystemVolatileData& volatile_updatable_data,
+IOManager::IOManager(SystemData& system_data, VolatileSnapshot<SystemVolatileData>& volatile_data,
                      SystemVolatileData& volatile_updated_data)
     : data(system_data),
-      updatable_data(volatile_updatable_data),
+      volatile_data(volatile_data),
       updated_data(volatile_updated_data) {
   instance = this;
 }
@@ -34,11 +34,11 @@ void IOManager::read_rotative_switch() const {
 }
 
 void IOManager::read_hydraulic_pressure() const {
-  insert_value_queue(analogRead(pins::analog::BRAKE_PRESSURE), data.brake_readings);
+  data.brake_readings.add(data.brake_outliers.add(analogRead(pins::analog::BRAKE_PRESSURE)));
 }
 
 void IOManager::update_R2D_timer() const {
-  if (average_queue(data.brake_readings) > config::brake::BLOCK_THRESHOLD) {
+  if (data.brake_readings.average() > config::brake::BLOCK_THRESHOLD) {
     data.r2d_brake_timer = 0;
   }
 }
@@ -48,14 +48,14 @@ void IOManager::manage_ats() const {
   static unsigned long ats_activated_time = 0;
 
   if (data.ats_pressed && !updated_data.asms_on && !ats_active) {
-    DEBUG_PRINT("ATS pressed, setting HIGH");
+    DEBUG_PRINTLN("ATS pressed, setting HIGH");
     data.ats_pressed = false;
     digitalWrite(pins::digital::ATS_OUT, HIGH);
     ats_active = true;
     ats_activated_time = millis();
   }
   if (ats_active && (millis() - ats_activated_time >= 1000)) {
-    DEBUG_PRINT("ATS HIGH duration elapsed, setting LOW");
+    DEBUG_PRINTLN("ATS HIGH duration elapsed, setting LOW");
     digitalWrite(pins::digital::ATS_OUT, LOW);
     ats_active = false;
   }
@@ -76,22 +76,10 @@ void IOManager::setup() {
 
   attachInterrupt(
       digitalPinToInterrupt(pins::encoder::FRONT_RIGHT_WHEEL),
-      []() {
-        instance->updatable_data.second_to_last_wheel_pulse_fr =
-            instance->updatable_data.last_wheel_pulse_fr;
-        instance->updatable_data.last_wheel_pulse_fr = micros();
-      },
-      RISING);
-
+      []() { instance->fr_wheel_speed.add_pulse(micros()); }, RISING);
   attachInterrupt(
       digitalPinToInterrupt(pins::encoder::FRONT_LEFT_WHEEL),
-      []() {
-        DEBUG_PRINTLN("Front left wheel pulse detected");
-        instance->updatable_data.second_to_last_wheel_pulse_fl =
-            instance->updatable_data.last_wheel_pulse_fl;
-        instance->updatable_data.last_wheel_pulse_fl = micros();
-      },
-      RISING);
+      []() { instance->fl_wheel_speed.add_pulse(micros()); }, RISING);
   r2d_button.attach(pins::digital::R2D, INPUT);
   r2d_button.interval(100);
   ats_button.attach(pins::digital::ATS, INPUT);
@@ -101,8 +89,10 @@ void IOManager::setup() {
 }
 
 void IOManager::read_apps() const {
-  insert_value_queue(analogRead(pins::analog::APPS_HIGHER), data.apps_higher_readings);
-  insert_value_queue(analogRead(pins::analog::APPS_LOWER), data.apps_lower_readings);
+  const uint16_t apps_higher = data.apps_higher_outliers.add(analogRead(pins::analog::APPS_HIGHER));
+  const uint16_t apps_lower = data.apps_lower_outliers.add(analogRead(pins::analog::APPS_LOWER));
+  data.apps_higher_readings.add(apps_higher);
+  data.apps_lower_readings.add(apps_lower);
   //print value
 }
 
@@ -112,7 +102,7 @@ void IOManager::play_buzzer(const uint8_t duration_seconds) const {
   data.buzzer_active = true;
   data.buzzer_start_time = millis();
   data.buzzer_duration_ms = duration_seconds * 1000;
-  DEBUG_PRINTLN("Playing buzzer for " + String(data.buzzer_duration_ms) + " ms");
+  DEBUG_PRINTLN("Playing buzzer for {} ms", data.buzzer_duration_ms);
   // tone(pins::output::BUZZER, config::buzzer::BUZZER_FREQUENCY);  // TODO(romain): tone has time
   //                                                                // limite maybe timer not needed
   digitalWrite(pins::output::BUZZER, HIGH);  // Use digitalWrite for buzzer
@@ -171,48 +161,9 @@ void IOManager::read_pins_handle_leds() {
   digitalWrite(pins::output::TS_LED, digitalRead(pins::digital::TS));
 }
 
-void IOManager::calculate_rpm() const {
-  constexpr float MICROSEC_TO_MIN = 60'000'000.0f;  // Convert μs to minutes
-  const unsigned long current_time = micros();
-
-  // Front right wheelLIMIT_RPM_INTERVAL
-  if (const unsigned long time_since_last_pulse_fr =
-          current_time - updated_data.last_wheel_pulse_fr;
-      time_since_last_pulse_fr > config::wheel::LIMIT_RPM_INTERVAL) {
-    // No recent pulses, wheel stopped
-    data.fr_rpm = 0.0f;
-  } else {
-    // Check if time_interval calculation would overflow
-    const unsigned long time_interval_fr =
-        (updated_data.last_wheel_pulse_fr >= updated_data.second_to_last_wheel_pulse_fr)
-            ? updated_data.last_wheel_pulse_fr - updated_data.second_to_last_wheel_pulse_fr
-            : 0;  // Handle overflow case
-    // Avoid division by zero
-    if (time_interval_fr > 0) {
-      data.fr_rpm = MICROSEC_TO_MIN /
-                    (static_cast<double>(time_interval_fr * config::wheel::PULSES_PER_ROTATION));
-    } else {
-      data.fr_rpm = 0.0f;  // Invalid interval
-    }
-  }
-
-  // Front left wheel (same logic)
-  if (const unsigned long time_since_last_pulse_fl =
-          current_time - updated_data.last_wheel_pulse_fl;
-      time_since_last_pulse_fl > config::wheel::LIMIT_RPM_INTERVAL) {
-    data.fl_rpm = 0.0f;
-  } else {
-    const unsigned long time_interval_fl =
-        (updated_data.last_wheel_pulse_fl >= updated_data.second_to_last_wheel_pulse_fl)
-            ? updated_data.last_wheel_pulse_fl - updated_data.second_to_last_wheel_pulse_fl
-            : 0;
-
-    if (time_interval_fl > 0) {
-      data.fl_rpm = (MICROSEC_TO_MIN /
-                     static_cast<double>(time_interval_fl * config::wheel::PULSES_PER_ROTATION));
-    } else {
-      data.fl_rpm = 0.0f;
-    }
-  }
-  // DEBUG_PRINTLN("FR RPM: " + String(data.fr_rpm) + ", FL RPM: " + String(data.fl_rpm));
+void IOManager::calculate_rpm() {
+  const auto now = static_cast<uint32_t>(micros());
+  data.fr_rpm = fr_wheel_speed.centi_rpm(now) * 0.01f;
+  data.fl_rpm = fl_wheel_speed.centi_rpm(now) * 0.01f;
+  // DEBUG_PRINTLN("FR RPM: {}, FL RPM: {}", data.fr_rpm, data.fl_rpm);
 }
\ No newline at end of file
@@ -10,10 +10,10 @@ LogicHandler::LogicHandler(SystemData& system_data, SystemVolatileData& current_
 bool LogicHandler::should_start_manual_driving() const {
   // DEBUG_PRINTLN("Checking if should start manual driving v8");
   // print var
-  // DEBUG_PRINTLN("R2D pressed: " + String(data.r2d_pressed));
-  // DEBUG_PRINTLN("TSOn: " + String(updated_data.TSOn));
+  // DEBUG_PRINTLN("R2D pressed: {}", data.r2d_pressed);
+  // DEBUG_PRINTLN("TSOn: {}", updated_data.TSOn);
   // print timer
-  // DEBUG_PRINTLN("R2D brake timer: " + String(data.r2d_brake_timer));
+  // DEBUG_PRINTLN("R2D brake timer: {}", data.r2d_brake_timer);
   // DEBUG_PRINTLN("R2D brake timer: " + String(data
   return (data.r2d_pressed && updated_data.TSOn && data.r2d_brake_timer < config::r2d::TIMEOUT_MS);
 }
@@ -73,7 +73,7 @@ uint16_t LogicHandler::apps_to_bamocar_value(const uint16_t apps_higher,
 
   torque_value =
       config::apps::MAX - torque_value;  // Invert the value to match Bamocar's expected input
-  // DEBUG_PRINTLN("Torque value before deadband: " + String(torque_value));
+  // DEBUG_PRINTLN("Torque value before deadband: {}", torque_value);
   if (torque_value <= config::apps::DEADBAND) {
     return 0;
   }
@@ -134,10 +134,10 @@ bool LogicHandler::check_apps_plausibility(const uint16_t apps_higher_avg,
 }
 
 int LogicHandler::calculate_torque() {
-  const uint16_t apps_higher_average = average_queue(data.apps_higher_readings);
-  const uint16_t apps_lower_average = average_queue(data.apps_lower_readings);
-  // DEBUG_PRINTLN("Apps Higher Average v2: " + String(apps_higher_average));
-  // DEBUG_PRINTLN("Apps Lower Average v2: " + String(apps_lower_average));
+  const uint16_t apps_higher_average = data.apps_higher_readings.average();
+  const uint16_t apps_lower_average = data.apps_lower_readings.average();
+  // DEBUG_PRINTLN("Apps Higher Average v2: {}", apps_higher_average);
+  // DEBUG_PRINTLN("Apps Lower Average v2: {}", apps_lower_average);
   if (!check_apps_plausibility(apps_higher_average, apps_lower_average)) {
     DEBUG_PRINTLN("Apps implausible, going idle");
     // DEBUG_PRINTLN("Apps implausible, going idle");
@@ -149,7 +149,7 @@ int LogicHandler::calculate_torque() {
 
   const uint16_t bamocar_value = apps_to_bamocar_value(apps_higher_average, apps_lower_average);
 
-  // DEBUG_PRINTLN("Bamocar value: " + String(bamocar_value));
+  // DEBUG_PRINTLN("Bamocar value: {}", bamocar_value);
 
   if (apps_timeout) {
     if (bamocar_value == 0) {  // Pedal released
@@ -11,13 +11,13 @@
 
 SystemData data;
 SystemVolatileData updated_data;
-volatile SystemVolatileData updatable_data;
+VolatileSnapshot<SystemVolatileData> volatile_data;
 elapsedMillis loop_timer;
 constexpr uint8_t MAIN_LOOP_INTERVAL = 10;
 
 SPI_MSTransfer_T4<&SPI> display_spi;
-IOManager io_manager(data, updatable_data, updated_data);
-CanCommHandler can_comm_handler(data, updatable_data, updated_data /*, display_spi*/);
+IOManager io_manager(data, volatile_data, updated_data);
+CanCommHandler can_comm_handler(data, volatile_data, updated_data /*, display_spi*/);
 LogicHandler logic_handler(data, updated_data);
 StateMachine state_machine(can_comm_handler, logic_handler, io_manager);
 SpiHandler spi_handler(display_spi);
@@ -43,12 +43,13 @@ void loop() {
     // Serial.println("chill");
     io_manager.manage();
     can_comm_handler.write_messages();
-    copy_volatile_data(updated_data, updatable_data);
+    updated_data = volatile_data.read();
     state_machine.update();
+    can_comm_handler.transmit();
     data.current_state = state_machine.get_state();
     spi_handler.handle_display_update(data, updated_data);
 
     loop_timer = 0;
-    Serial.flush();
   }
+  DEBUG_DRAIN();
 }
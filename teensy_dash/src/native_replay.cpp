@@ -0,0 +1,50 @@
+// CAN trace replay through CanCommHandler on the native (Linux host) build
+#ifdef NATIVE_REPLAY
+#include <Arduino.h>
+#include <canReplay.h>
+
+#include "can_comm_handler.hpp"
+#include "data_struct.hpp"
+
+SystemData system_data;
+VolatileSnapshot<SystemVolatileData> volatile_data;
+SystemVolatileData updated_data;
+CanCommHandler can_handler(system_data, volatile_data, updated_data);
+
+/**
+ * @brief Replays a candump/ASC trace and prints how the CAN-fed data evolved and the decode
+ * throughput
+ * @details Usage: program <trace> [--realtime] [--quiet]. --quiet drops the timeline, leaving
+ * only parsing and handle_can_message() in the measured path.
+ */
+int main(int argc, char **argv) {
+  native_hal::ReplayOptions options;
+  if (!native_hal::parse_replay_args(argc, argv, options)) return 1;
+  FILE *trace = fopen(options.path, "rb");
+  if (trace == nullptr) {
+    perror(options.path);
+    return 1;
+  }
+
+  can_handler.setup();
+
+  native_hal::StateTimeline timeline;
+  timeline.add("TSOn", [] -> int64_t { return volatile_data.read().TSOn; });
+  timeline.add("as_state", [] -> int64_t { return volatile_data.read().as_state; });
+  timeline.add("asms_on", [] -> int64_t { return volatile_data.read().asms_on; });
+  timeline.add("brake_pressure", [] -> int64_t { return volatile_data.read().brake_pressure; });
+  timeline.add("speed", [] -> int64_t { return volatile_data.read().speed; });
+  timeline.add("soc", [] -> int64_t { return volatile_data.read().soc; });
+  timeline.add("motor_current", [] -> int64_t { return volatile_data.read().motor_current; });
+  timeline.add("min_temp", [] -> int64_t { return volatile_data.read().min_temp; });
+  timeline.add("max_temp", [] -> int64_t { return volatile_data.read().max_temp; });
+  timeline.add("error_bitmap", [] -> int64_t { return volatile_data.read().error_bitmap; });
+  timeline.add("warning_bitmap", [] -> int64_t { return volatile_data.read().warning_bitmap; });
+
+  const auto stats = native_hal::replay_trace(trace, options, *native_hal::can_bus(CAN2),
+                                              options.timeline ? &timeline : nullptr);
+  fclose(trace);
+  native_hal::print_replay_stats(stats, stdout);
+  return 0;
+}
+#endif
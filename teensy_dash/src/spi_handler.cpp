@@ -19,7 +19,7 @@ void SpiHandler::handle_display_update(SystemData& data, const SystemVolatileDat
   if (fast_timer >= FAST_UPDATE_INTERVAL) {
     fast_timer = 0;
     // Fast updates (every loop iteration) - critical for pilot feedback
-    const uint16_t apps_higher = average_queue(data.apps_higher_readings);
+    const uint16_t apps_higher = data.apps_higher_readings.average();
     uint16_t torque_value = constrain(apps_higher, config::apps::MIN, config::apps::MAX);
     torque_value = config::apps::MAX - torque_value;
     uint16_t apps_percent = 0;
@@ -32,7 +32,7 @@ void SpiHandler::handle_display_update(SystemData& data, const SystemVolatileDat
     display_spi.transfer16(&apps_percent, 1, WIDGET_THROTTLE, millis() & 0xFFFF);
 
     // Hydraulic brake - fast for pilot feedback
-    const uint16_t hydraulic_value = average_queue(data.brake_readings);
+    const uint16_t hydraulic_value = data.brake_readings.average();
     display_spi.transfer16(&hydraulic_value, 1, WIDGET_BRAKE, millis() & 0xFFFF);
 
     // Speed - fast for pilot feedback
@@ -12,7 +12,7 @@ void StateMachine::update() {
 
   switch (current_state_) {
     case State::IDLE:
-      // DEBUG_PRINTLN("Torque from apps in IDLE: " + String(logic_handler.calculate_torque()));
+      // DEBUG_PRINTLN("Torque from apps in IDLE: {}", logic_handler.calculate_torque());
       // io_manager.play_emergency_buzzer();
 
       if (logic_handler.should_start_manual_driving()) {
@@ -53,7 +53,7 @@ void StateMachine::update() {
         can_handler.send_torque(0);
         break;
       }
-      // DEBUG_PRINTLN("Torque from apps: " + String(torque_from_apps));
+      // DEBUG_PRINTLN("Torque from apps: {}", torque_from_apps);
       if (torque_from_apps >= 0 && torque_from_apps <= config::bamocar::MAX) {
         can_handler.send_torque(
             torque_from_apps); /* VVVVVRRRRRRRRRRUUUUUUMMMMMMMMMMMMMMMMMMMMMMMm*/
@@ -91,8 +91,8 @@ void StateMachine::update() {
       break;
   }
   if (print_state_timer >= 700) {
-    // DEBUG_PRINTLN("Current state: " + String(static_cast<int>(current_state_)));
-    // DEBUG_PRINTLN("Current torque: " + String(torque_from_apps));
+    // DEBUG_PRINTLN("Current state: {}", static_cast<int>(current_state_));
+    // DEBUG_PRINTLN("Current torque: {}", torque_from_apps);
     print_state_timer = 0;
   }
 }
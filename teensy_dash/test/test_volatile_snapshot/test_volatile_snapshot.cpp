@@ -0,0 +1,101 @@
+// VolatileSnapshot of the interrupt-written dash data, with a writer thread standing in for the ISRs
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+
+#include "data_struct.hpp"
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_read_publish_generation() {
+  VolatileSnapshot<SystemVolatileData> snapshot;
+  TEST_ASSERT_EQUAL_UINT32(0, snapshot.generation());
+  TEST_ASSERT_FALSE(snapshot.read().TSOn);
+
+  snapshot.writable().max_temp = 42;
+  snapshot.writable().warning_bitmap = 0x0102;
+  TEST_ASSERT_EQUAL_UINT8(0, snapshot.read().max_temp);  // not published yet
+  snapshot.publish();
+  snapshot.update([](SystemVolatileData& data) { data.TSOn = true; });
+
+  const SystemVolatileData data = snapshot.read();
+  TEST_ASSERT_EQUAL_UINT8(42, data.max_temp);
+  TEST_ASSERT_EQUAL_UINT16(0x0102, data.warning_bitmap);  // every field, none listed by hand
+  TEST_ASSERT_TRUE(data.TSOn);
+  TEST_ASSERT_EQUAL_UINT32(2, snapshot.generation());
+}
+
+/**
+ * @brief A handler that interrupts another one's update publishes both changes
+ */
+void test_nested_update() {
+  VolatileSnapshot<SystemVolatileData> snapshot;
+  snapshot.update([&](SystemVolatileData& data) {
+    data.speed = 100;
+    snapshot.update([](SystemVolatileData& nested) { nested.soc = 7; });
+  });
+  const SystemVolatileData data = snapshot.read();
+  TEST_ASSERT_EQUAL(100, data.speed);
+  TEST_ASSERT_EQUAL_UINT8(7, data.soc);
+}
+
+/**
+ * @brief A writer thread publishes as fast as it can while this thread reads: every copy is one
+ * whole publish, never a mix of two
+ */
+void test_concurrent_writer_never_tears() {
+  constexpr int32_t PUBLISHES = 2'000'000;
+  VolatileSnapshot<SystemVolatileData> snapshot;
+  std::atomic<bool> done{false};
+
+  std::thread writer([&] {
+    for (int32_t i = 1; i <= PUBLISHES; i++) {
+      snapshot.update([i](SystemVolatileData& data) {
+        data.speed = i;
+        data.motor_current = -i;
+        data.brake_pressure = i * 3;
+        data.error_bitmap = static_cast<uint16_t>(i);
+        data.warning_bitmap = static_cast<uint16_t>(~i);
+        data.soc = static_cast<uint8_t>(i * 5);
+        data.min_temp = static_cast<uint8_t>(i * 7);
+      });
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t reads = 0;
+  int32_t last = 0;
+  bool intact = true;
+  bool monotonic = true;
+  while (!done.load(std::memory_order_acquire)) {
+    const SystemVolatileData data = snapshot.read();
+    const int32_t i = data.speed;
+    // speed 0 is the zeroed state from before the first publish, warning_bitmap is 0 there too
+    intact &= i == 0 || (data.motor_current == -i && data.brake_pressure == i * 3 &&
+                         data.error_bitmap == static_cast<uint16_t>(i) &&
+                         data.warning_bitmap == static_cast<uint16_t>(~i) &&
+                         data.soc == static_cast<uint8_t>(i * 5) &&
+                         data.min_temp == static_cast<uint8_t>(i * 7));
+    monotonic &= i >= last;
+    last = i;
+    reads++;
+  }
+  writer.join();
+
+  TEST_ASSERT_TRUE(intact);
+  TEST_ASSERT_TRUE(monotonic);
+  TEST_ASSERT_GREATER_THAN(0, reads);
+  TEST_ASSERT_EQUAL(PUBLISHES, snapshot.read().speed);
+  TEST_ASSERT_EQUAL_UINT32(PUBLISHES, snapshot.generation());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_read_publish_generation);
+  RUN_TEST(test_nested_update);
+  RUN_TEST(test_concurrent_writer_never_tears);
+  return UNITY_END();
+}
@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""Worst-case load and response time of every periodic frame on the vehicle CAN bus.
+
+Usage: python3 tools/bus_analyzer.py [bus_periods.txt] [conf.dbc] [--bitrate BPS]...
+
+The frames come from conf.dbc, their timing from the annotation file, one line per stream:
+
+    source <header>   constants the frame lines may use, path relative to the repository
+    frame <dbc message>[:<mux>] period=<ms> [deadline=<ms>] [jitter=<ms>] [count=<n>]
+                                [bytes=<payload>]
+
+Values are numbers or expressions of the constants in the sources (PROCESS_INTERVAL,
+LOOP_INTERVAL + 1...), so the analysis follows the firmware. The deadline defaults to the period;
+the jitter is how late after its release the frame may be queued, the loop period of its board
+for frames sent from loop(); count frames of the stream are released together; bytes overrides
+the payload length taken from the DBC, which is what the boards send: the DLC of plain messages,
+the bytes the signals of the multiplexer value use for multiplexed ones.
+
+For each bitrate (1 Mbit/s and 125 kbit/s by default) it prints every stream in priority order,
+lowest ID first, with its worst-case frame time C including bit stuffing and its worst-case
+response time R from the classic CAN response-time analysis, in the sufficient form of Davis et
+al. (2007):
+
+    w = max(B, C) + sum over higher priority k of ceil((w + J_k + bit) / T_k) * C_k
+    R = J + w + C
+
+B is the longest lower-priority frame, which cannot be preempted once it won arbitration.
+Streams sharing an ID delay each other, so they count as higher priority to one another. Streams
+with R above their deadline are flagged and the exit status is 1. DBC messages without a frame
+line are listed: event frames and nodes whose periods are not known here.
+
+The analysis assumes each node hands its frames to the controller in ID order, as the transmit
+queue of can_tx_queue.h does within a class, and that no frame is lost to an error.
+"""
+
+import math
+import os
+import re
+import sys
+from dataclasses import dataclass
+
+import dbc_codegen
+from frame_planner import frame_bits
+
+DEFAULT_BITRATES = (1_000_000, 125_000)
+EXTENDED_BASE_SHIFT = 18  # the top 11 bits of a 29-bit ID arbitrate against standard IDs
+
+
+@dataclass
+class Stream:
+    name: str
+    can_id: int
+    extended: bool
+    payload_bytes: int
+    period_ms: float
+    deadline_ms: float
+    jitter_ms: float
+    count: int
+
+    def priority(self):
+        """Arbitration order, lower first: a standard frame wins against an extended one with
+        the same 11-bit base ID through its RTR and IDE bits."""
+        if self.extended:
+            return (self.can_id >> EXTENDED_BASE_SHIFT, 1, self.can_id)
+        return (self.can_id, 0, 0)
+
+    def frame_ms(self, bitrate):
+        return frame_bits(self.payload_bytes, self.extended) * 1000 / bitrate
+
+
+CONSTANT_RE = re.compile(r"^\s*(?:static\s+)?constexpr\s+[\w:\s]+?\s+(\w+)\s*=\s*([^;{]+);")
+
+
+def read_constants(paths):
+    constants = {}
+    for path in paths:
+        with open(path, encoding="utf-8") as header:
+            for line in header:
+                match = CONSTANT_RE.match(line)
+                if not match:
+                    continue
+                try:
+                    value = evaluate(match[2], constants)
+                except Exception:  # arrays, strings and the like
+                    continue
+                if match[1] in constants and constants[match[1]] != value:
+                    print(f"warning: {match[1]} is {constants[match[1]]} and {value}, "
+                          f"using {value} from {path}", file=sys.stderr)
+                constants[match[1]] = value
+    return constants
+
+
+def evaluate(expression, constants):
+    value = eval(expression.replace("'", ""), {"__builtins__": {}}, dict(constants))  # noqa: S307
+    if not isinstance(value, (int, float)):
+        raise ValueError(f"'{expression}' is not a number")
+    return value
+
+
+def payload_bytes(message, mux):
+    if mux is None:
+        return message.dlc
+    mux_signal = message.multiplexer()
+    signals = [s for s in message.signals if s.mux == f"m{mux}" and not s.same_bits(mux_signal)]
+    if not signals and mux not in message.mux_values():
+        return None
+    return max([mux_signal.last_byte() + 1] + [s.last_byte() + 1 for s in signals])
+
+
+FIELD_RE = re.compile(r"^(period|deadline|jitter|count|bytes)=(.+)$")
+
+
+def parse_periods(path, messages, root):
+    """Returns the streams and the names of the DBC messages no frame line mentions."""
+    streams = []
+    sources = []
+    constants = {}
+    annotated = set()
+    with open(path, encoding="utf-8") as periods:
+        for number, line in enumerate(periods, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            where = f"{path}:{number}"
+            if fields[0] == "source" and len(fields) == 2:
+                sources.append(os.path.join(root, fields[1]))
+                constants = read_constants(sources)
+                continue
+            if fields[0] != "frame" or len(fields) < 3:
+                raise ValueError(f"{where}: cannot parse '{line.strip()}'")
+            name, _, mux_text = fields[1].partition(":")
+            message = messages.get(name)
+            if message is None:
+                raise ValueError(f"{where}: no message {name} in the DBC")
+            values = {}
+            for field in fields[2:]:
+                match = FIELD_RE.match(field)
+                if not match:
+                    raise ValueError(f"{where}: cannot parse '{field}'")
+                try:
+                    values[match[1]] = evaluate(match[2], constants)
+                except Exception as error:
+                    raise ValueError(f"{where}: {field}: {error}") from None
+            if "period" not in values:
+                raise ValueError(f"{where}: no period")
+            mux = int(evaluate(mux_text, constants)) if mux_text else None
+            if mux is not None and message.multiplexer() is None:
+                raise ValueError(f"{where}: {name} is not multiplexed")
+            size = int(values["bytes"]) if "bytes" in values else payload_bytes(message, mux)
+            if size is None:
+                raise ValueError(f"{where}: {name} has no mux 0x{mux:02X}, give its bytes=")
+            annotated.add(name)
+            streams.append(Stream(
+                name=name if mux is None else f"{name}:0x{mux:02X}",
+                can_id=message.can_id, extended=message.extended, payload_bytes=size,
+                period_ms=values["period"], deadline_ms=values.get("deadline", values["period"]),
+                jitter_ms=values.get("jitter", 0), count=int(values.get("count", 1))))
+    missing = [name for name in messages if name not in annotated]
+    return streams, missing
+
+
+def response_time(stream, streams, bitrate):
+    """Worst-case response time in ms, or None when the busy period passes the deadline."""
+    bit = 1000 / bitrate
+    own = stream.frame_ms(bitrate)
+    key = stream.priority()
+    higher = [s for s in streams if s is not stream and s.priority() <= key]
+    lower = [s.frame_ms(bitrate) for s in streams if s.priority() > key]
+    blocking = max(lower + [own])
+    w = blocking + (stream.count - 1) * own
+    while True:
+        interference = sum(math.ceil((w + s.jitter_ms + bit) / s.period_ms) * s.count *
+                           s.frame_ms(bitrate) for s in higher)
+        w_next = blocking + (stream.count - 1) * own + interference
+        if stream.jitter_ms + w_next + own > stream.deadline_ms:
+            return None
+        if math.isclose(w_next, w):
+            return stream.jitter_ms + w + own
+        w = w_next
+
+
+def utilization(streams, bitrate):
+    return sum(s.count * s.frame_ms(bitrate) / s.period_ms for s in streams)
+
+
+def analyze(periods_path, dbc_path, bitrates):
+    root = os.path.dirname(os.path.abspath(dbc_path))
+    messages = {m.name: m for m in dbc_codegen.parse_dbc(dbc_path)}
+    streams, missing = parse_periods(periods_path, messages, root)
+    streams.sort(key=Stream.priority)
+    misses = 0
+    for bitrate in bitrates:
+        load = utilization(streams, bitrate)
+        print(f"{bitrate // 1000} kbit/s: {len(streams)} streams, load {100 * load:.1f} %, "
+              f"{load * bitrate:.0f} bit/s")
+        print(f"  {'ID':>10}  {'frame':<28} {'bytes':>5} {'count':>5} {'T ms':>7} {'D ms':>7} "
+              f"{'J ms':>5} {'C us':>7} {'R ms':>8}")
+        for stream in streams:
+            response = None if load > 1 else response_time(stream, streams, bitrate)
+            flag = ""
+            if response is None:
+                flag = "  can miss its deadline"
+                misses += 1
+            identifier = f"0x{stream.can_id:08X}" if stream.extended else f"0x{stream.can_id:03X}"
+            print(f"  {identifier:>10}  {stream.name:<28} {stream.payload_bytes:>5} "
+                  f"{stream.count:>5} {stream.period_ms:>7g} {stream.deadline_ms:>7g} "
+                  f"{stream.jitter_ms:>5g} {1000 * stream.frame_ms(bitrate):>7.1f} "
+                  f"{'-' if response is None else f'{response:.3f}':>8}{flag}")
+        print()
+    if missing:
+        print(f"not annotated: {', '.join(missing)}")
+    return misses
+
+
+def main(argv):
+    bitrates = []
+    args = []
+    rest = iter(argv[1:])
+    for arg in rest:
+        if arg == "--bitrate":
+            bitrates.append(int(next(rest)))
+        else:
+            args.append(arg)
+    tools = os.path.dirname(os.path.abspath(__file__))
+    periods_path = args[0] if args else os.path.join(tools, "bus_periods.txt")
+    dbc_path = args[1] if len(args) > 1 else os.path.join(os.path.dirname(tools), "conf.dbc")
+    return 1 if analyze(periods_path, dbc_path, bitrates or DEFAULT_BITRATES) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""Generates CAN_messages.h, constexpr pack/unpack code for every message in conf.dbc.
+
+Usage: python3 tools/dbc_codegen.py [conf.dbc] [CAN_IDs.h] [CAN_messages.h]
+
+Every message becomes a struct in namespace can_db holding the raw signal values, with
+`pack()` returning the payload and `unpack(buf)` reading it back. Multiplexed messages get one
+nested struct per multiplexer value (`can_db::MasterMsgs::M52`). Each payload byte is written
+by a single expression of shifts and masks, so the compiler folds everything into the same
+instructions a hand-written encoder would produce.
+
+IDs are emitted as the matching constant from CAN_IDs.h when there is one, so the header breaks
+loudly if the two files drift apart.
+
+Also usable as a PlatformIO pre-script (extra_scripts = pre:../tools/dbc_codegen.py): the header
+is regenerated whenever conf.dbc or CAN_IDs.h is newer than it.
+"""
+
+import os
+import re
+import sys
+from dataclasses import dataclass, field
+
+EXTENDED_FLAG = 0x80000000
+VECTOR_INDEPENDENT_SIGNALS = "VECTOR__INDEPENDENT_SIG_MSG"
+
+
+@dataclass
+class Signal:
+    name: str
+    start: int
+    length: int
+    little_endian: bool
+    signed: bool
+    factor: float
+    offset: float
+    unit: str
+    mux: str  # "", "M" for the multiplexer or "m<value>"
+
+    def byte_segments(self):
+        """Yields (byte, lowest bit in byte, width, lowest value bit) for every byte the
+        signal touches."""
+        if self.little_endian:
+            first, last = self.start, self.start + self.length - 1
+            for byte in range(first // 8, last // 8 + 1):
+                low = max(first, byte * 8)
+                high = min(last, byte * 8 + 7)
+                yield byte, low - byte * 8, high - low + 1, low - first
+            return
+        # Motorola: start is the most significant bit, counting down within a byte and then
+        # continuing at bit 7 of the next byte
+        position = self.start
+        value_bit = self.length - 1
+        while value_bit >= 0:
+            byte = position // 8
+            top = position % 8
+            width = min(top + 1, value_bit + 1)
+            yield byte, top - width + 1, width, value_bit - width + 1
+            value_bit -= width
+            position = (byte + 1) * 8 + 7
+
+    def same_bits(self, other):
+        return (self.start, self.length, self.little_endian) == \
+            (other.start, other.length, other.little_endian)
+
+    def last_byte(self):
+        return max(byte for byte, _, _, _ in self.byte_segments())
+
+    def cpp_type(self):
+        if self.length == 1 and not self.signed:
+            return "bool"
+        for bits in (8, 16, 32, 64):
+            if self.length <= bits:
+                return f"{'int' if self.signed else 'uint'}{bits}_t"
+        raise ValueError(f"signal {self.name} is longer than 64 bits")
+
+    def unsigned_type(self):
+        return self.cpp_type().replace("int", "uint").replace("uuint", "uint").replace(
+            "bool", "uint8_t")
+
+    def type_bits(self):
+        return 8 if self.cpp_type() == "bool" else int(re.search(r"\d+", self.cpp_type())[0])
+
+
+@dataclass
+class Message:
+    frame_id: int
+    name: str
+    dlc: int
+    transmitter: str
+    signals: list = field(default_factory=list)
+
+    @property
+    def extended(self):
+        return bool(self.frame_id & EXTENDED_FLAG)
+
+    @property
+    def can_id(self):
+        return self.frame_id & ~EXTENDED_FLAG
+
+    def multiplexer(self):
+        return next((s for s in self.signals if s.mux == "M"), None)
+
+    def mux_values(self):
+        values = sorted({int(s.mux[1:]) for s in self.signals if s.mux.startswith("m")})
+        return values
+
+
+SIGNAL_RE = re.compile(
+    r'^\s*SG_\s+(\w+)\s*(M|m\d+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*'
+    r'\(([^,]+),([^)]+)\)\s*\[[^\]]*\]\s*"([^"]*)"')
+MESSAGE_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+
+
+def parse_dbc(path):
+    messages = []
+    with open(path, encoding="latin-1") as dbc:
+        for line in dbc:
+            message = MESSAGE_RE.match(line)
+            if message:
+                messages.append(Message(int(message[1]), message[2], int(message[3]),
+                                        message[4]))
+                continue
+            signal = SIGNAL_RE.match(line)
+            if signal and messages:
+                messages[-1].signals.append(Signal(
+                    name=signal[1], mux=signal[2] or "", start=int(signal[3]),
+                    length=int(signal[4]), little_endian=signal[5] == "1",
+                    signed=signal[6] == "-", factor=float(signal[7]), offset=float(signal[8]),
+                    unit=signal[9]))
+    return [m for m in messages if m.name != VECTOR_INDEPENDENT_SIGNALS]
+
+
+CONSTANT_RE = re.compile(r'^\s*constexpr\s+[\w:]+\s+(\w+)\s*=\s*([^;]+);')
+
+
+def parse_can_ids(path):
+    """Returns {value: [names]} for every integer constant in CAN_IDs.h, in file order."""
+    constants = {}
+    by_value = {}
+    with open(path, encoding="utf-8") as header:
+        for line in header:
+            match = CONSTANT_RE.match(line)
+            if not match:
+                continue
+            expression = match[2].replace("'", "")
+            try:
+                value = eval(expression, {"__builtins__": {}}, dict(constants))  # noqa: S307
+            except Exception:  # arrays, floats written as expressions we do not need
+                continue
+            if isinstance(value, int):
+                constants[match[1]] = value
+                by_value.setdefault(value, []).append(match[1])
+    return by_value
+
+
+def id_expression(message, can_ids):
+    names = can_ids.get(message.can_id, [])
+    if not names:
+        return f"0x{message.can_id:X}"
+    wanted = message.name.upper()
+    for name in names:
+        if name == wanted or name == wanted + "_ID":
+            return f"::{name}"
+    id_names = [name for name in names if name.endswith("_ID")]
+    return f"::{(id_names or names)[0]}"
+
+
+def pascal_case(name):
+    return "".join(part[:1].upper() + part[1:].lower() for part in name.split("_") if part)
+
+
+def number(value):
+    text = repr(float(value))
+    return text if "e" in text or "." in text else text + ".0"
+
+
+def pack_byte_expression(byte, signals, mux_value, mux_signal):
+    terms = []
+    if mux_signal is not None:
+        for seg_byte, low, width, value_low in mux_signal.byte_segments():
+            if seg_byte == byte:
+                chunk = (mux_value >> value_low) & ((1 << width) - 1)
+                terms.append(f"0x{chunk << low:02X}")
+    for signal in signals:
+        raw = signal.name if signal.cpp_type() == "bool" else (
+            f"static_cast<{signal.unsigned_type()}>({signal.name})" if signal.signed
+            else signal.name)
+        for seg_byte, low, width, value_low in signal.byte_segments():
+            if seg_byte != byte:
+                continue
+            term = f"({raw} >> {value_low})" if value_low else raw
+            if not (signal.cpp_type() == "bool" or (width == signal.type_bits() and
+                                                    value_low == 0 and width == 8)):
+                if width < 8 or value_low + width < signal.type_bits():
+                    term = f"({term} & 0x{(1 << width) - 1:X})"
+            if low:
+                term = f"({term} << {low})"
+            terms.append(term)
+    if not terms:
+        return None
+    if len(terms) == 1 and terms[0].startswith("(") and terms[0].endswith(")"):
+        return terms[0][1:-1]
+    return " | ".join(terms)
+
+
+def strip_parens(expression):
+    if not (expression.startswith("(") and expression.endswith(")")):
+        return expression
+    depth = 0
+    for index, char in enumerate(expression):
+        depth += {"(": 1, ")": -1}.get(char, 0)
+        if depth == 0 and index + 1 < len(expression):
+            return expression
+    return expression[1:-1]
+
+
+def unpack_expression(signal):
+    unsigned = signal.unsigned_type()
+    parts = []
+    for byte, low, width, value_low in signal.byte_segments():
+        term = f"buf[{byte}]"
+        if low:
+            term = f"(buf[{byte}] >> {low})"
+        if width < 8:
+            term = f"({term} & 0x{(1 << width) - 1:X})"
+        parts.append((term, value_low))
+    cpp_type = signal.cpp_type()
+    if len(parts) == 1 and parts[0][1] == 0:
+        raw = strip_parens(parts[0][0])
+        if cpp_type == "bool":
+            return f"({raw}) != 0" if " " in raw else f"{raw} != 0"
+    else:
+        raw = " | ".join(
+            f"(static_cast<{unsigned}>({strip_parens(term)}) << {value_low})" if value_low else
+            f"static_cast<{unsigned}>({strip_parens(term)})" for term, value_low in parts)
+        if cpp_type == "bool":
+            return f"({raw}) != 0"
+    raw = f"static_cast<{unsigned}>({raw})"
+    if not signal.signed:
+        return raw
+    bits = signal.type_bits()
+    if signal.length == bits:
+        return f"static_cast<{cpp_type}>({raw})"
+    shift = bits - signal.length  # sign extension through an arithmetic right shift
+    return (f"static_cast<{cpp_type}>(static_cast<{cpp_type}>(static_cast<{unsigned}>"
+            f"({raw} << {shift})) >> {shift})")
+
+
+def emit_struct(out, name, indent, signals, length, mux_signal=None, mux_value=None,
+                message=None, can_ids=None):
+    pad = " " * indent
+    out.append(f"{pad}struct {name} {{")
+    if message is not None:
+        out.append(f"{pad}  static constexpr uint32_t ID = {id_expression(message, can_ids)};")
+        out.append(f"{pad}  static constexpr bool EXTENDED = {str(message.extended).lower()};")
+    if mux_value is not None:
+        out.append(f"{pad}  static constexpr uint8_t MUX = 0x{mux_value:02X};")
+    out.append(f"{pad}  static constexpr uint8_t LEN = {length};")
+    if signals:
+        out.append("")
+    for signal in signals:
+        default = "false" if signal.cpp_type() == "bool" else "0"
+        unit = f"  ///< {signal.unit.strip()}" if signal.unit.strip() else ""
+        out.append(f"{pad}  {signal.cpp_type()} {signal.name} = {default};{unit}")
+    for signal in signals:
+        if signal.factor == 1 and signal.offset == 0:
+            continue
+        out.append("")
+        out.append(f"{pad}  [[nodiscard]] constexpr float {signal.name}_physical() const {{")
+        out.append(f"{pad}    return static_cast<float>({signal.name}) * {number(signal.factor)}f"
+                   f" + {number(signal.offset)}f;")
+        out.append(f"{pad}  }}")
+
+    out.append("")
+    out.append(f"{pad}  [[nodiscard]] constexpr std::array<uint8_t, LEN> pack() const {{")
+    bytes_out = []
+    for byte in range(length):
+        expression = pack_byte_expression(byte, signals, mux_value, mux_signal)
+        bytes_out.append(f"static_cast<uint8_t>({expression})" if expression else "0")
+    out.append(f"{pad}    return {{{', '.join(bytes_out)}}};" if len(bytes_out) <= 1 else
+               f"{pad}    return {{")
+    if len(bytes_out) > 1:
+        for index, expression in enumerate(bytes_out):
+            comma = "," if index + 1 < len(bytes_out) else ""
+            out.append(f"{pad}        {expression}{comma}")
+        out.append(f"{pad}    }};")
+    out.append(f"{pad}  }}")
+
+    out.append("")
+    out.append(f"{pad}  [[nodiscard]] static constexpr {name} unpack(const uint8_t *buf) {{")
+    if not signals:
+        out.append(f"{pad}    (void)buf;")
+    out.append(f"{pad}    {name} msg;")
+    for signal in signals:
+        out.append(f"{pad}    msg.{signal.name} = {unpack_expression(signal)};")
+    out.append(f"{pad}    return msg;")
+    out.append(f"{pad}  }}")
+    out.append(f"{pad}}};")
+
+
+def generate(messages, can_ids, source_name):
+    out = [
+        "#pragma once",
+        "",
+        f"// Generated by tools/dbc_codegen.py from {source_name}, do not edit by hand",
+        "",
+        "#include <array>",
+        "#include <cstdint>",
+        "",
+        '#include "CAN_IDs.h"',
+        "",
+        "/**",
+        " * @brief Raw signal values and constexpr pack()/unpack() for every message in the DBC",
+        " * @details LEN is the number of payload bytes the signals use, which is what the boards",
+        " * put on the bus. Multiplexed messages have one nested struct per multiplexer value.",
+        " */",
+        "namespace can_db {",
+        "",
+    ]
+    for message in messages:
+        name = pascal_case(message.name)
+        out.append(f"// {message.name}, sent by {message.transmitter}")
+        mux_signal = message.multiplexer()
+        if mux_signal is None:
+            length = max((s.last_byte() + 1 for s in message.signals), default=message.dlc)
+            emit_struct(out, name, 0, message.signals, max(length, 0), message=message,
+                        can_ids=can_ids)
+            out.append("")
+            continue
+        plain = [s for s in message.signals if s.mux == ""]
+        out.append(f"struct {name} {{")
+        out.append(f"  static constexpr uint32_t ID = {id_expression(message, can_ids)};")
+        out.append(f"  static constexpr bool EXTENDED = {str(message.extended).lower()};")
+        out.append("")
+        for value in message.mux_values():
+            # A signal sitting exactly on the multiplexer only names the value (AS_CU), skip it
+            signals = plain + [s for s in message.signals if s.mux == f"m{value}" and
+                               not s.same_bits(mux_signal)]
+            length = max([mux_signal.last_byte() + 1] + [s.last_byte() + 1 for s in signals])
+            emit_struct(out, f"M{value}", 2, signals, length, mux_signal, value)
+            out.append("")
+        out.append(f"  [[nodiscard]] static constexpr uint8_t mux(const uint8_t *buf) {{")
+        out.append(f"    return {unpack_expression(mux_signal)};")
+        out.append("  }")
+        out.append("};")
+        out.append("")
+    out.append("}  // namespace can_db")
+    out.append("")
+    return "\n".join(out)
+
+
+def overlapping_signals(message):
+    """Pairs of signals of the same frame layout that claim the same bit."""
+    owners = {}
+    clashes = []
+    for signal in message.signals:
+        for byte, low, width, _ in signal.byte_segments():
+            for bit in range(byte * 8 + low, byte * 8 + low + width):
+                for other in owners.get(bit, []):
+                    if "M" in (signal.mux, other.mux) and signal.same_bits(other):
+                        continue
+                    if signal.mux and other.mux and signal.mux != other.mux and \
+                            "M" not in (signal.mux, other.mux):
+                        continue
+                    if (other.name, signal.name) not in clashes:
+                        clashes.append((other.name, signal.name))
+                owners.setdefault(bit, []).append(signal)
+    return clashes
+
+
+def run(dbc_path, ids_path, header_path):
+    messages = parse_dbc(dbc_path)
+    for message in messages:
+        for first, second in overlapping_signals(message):
+            print(f"warning: {message.name}: {first} and {second} overlap", file=sys.stderr)
+    text = generate(messages, parse_can_ids(ids_path), os.path.basename(dbc_path))
+    previous = None
+    if os.path.exists(header_path):
+        with open(header_path, encoding="utf-8") as header:
+            previous = header.read()
+    if text != previous:
+        with open(header_path, "w", encoding="utf-8", newline="\n") as header:
+            header.write(text)
+    return len(messages)
+
+
+def main(argv):
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    dbc_path = argv[1] if len(argv) > 1 else os.path.join(root, "conf.dbc")
+    ids_path = argv[2] if len(argv) > 2 else os.path.join(root, "CAN_IDs.h")
+    header_path = argv[3] if len(argv) > 3 else os.path.join(root, "CAN_messages.h")
+    count = run(dbc_path, ids_path, header_path)
+    print(f"{header_path}: {count} messages")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
+else:
+    try:
+        Import("env")  # noqa: F821, running as a PlatformIO extra script
+        _root = os.path.join(env.subst("$PROJECT_DIR"), "..")  # noqa: F821
+        _sources = [os.path.join(_root, "conf.dbc"), os.path.join(_root, "CAN_IDs.h")]
+        _header = os.path.join(_root, "CAN_messages.h")
+        if not os.path.exists(_header) or max(map(os.path.getmtime, _sources)) > \
+                os.path.getmtime(_header):
+            run(_sources[0], _sources[1], _header)
+    except NameError:
+        pass
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""Packs periodic signals into as few CAN frames as the bus load allows, and rewrites conf.dbc.
+
+Usage: python3 tools/frame_planner.py [--write] [frame_plan.txt] [conf.dbc]
+
+The plan file lists the signals to pack, one per line, and the multiplexer values their
+frames may take on each message:
+
+    message <dbc message> <mux>...
+    signal  <name> <dbc message> <period_ms> <min> <max> <resolution>
+
+Each signal gets the fewest bits that hold (max - min) / resolution. Signals of the same period
+are packed first fit decreasing into the 7 bytes behind the multiplexer byte, then frames are
+merged while the merge fits and lowers the load, the merged frame being sent at the shorter
+period. Frames take the message's mux values in order, shortest period first, and signals keep
+their plan order inside a frame.
+
+The report compares the worst-case bus load of the layout now in conf.dbc against the plan, in
+bits/s at 1 Mbit/s. With --write the planned signals are replaced in conf.dbc, with the same
+unit and receivers, and CAN_messages.h is regenerated. The firmware then uses the new
+`can_db::<Message>::M<mux>` structs on both ends, see the CAN Messages section of README.md.
+"""
+
+import math
+import os
+import re
+import sys
+from dataclasses import dataclass, field
+
+import dbc_codegen
+
+PAYLOAD_BITS = 56  # an 8-byte frame minus the multiplexer byte
+MUX_BITS = 8
+BITRATE = 1_000_000
+
+
+def frame_bits(payload_bytes, extended=False):
+    """Worst-case bits on the wire of a data frame: SOF to CRC, which is bit stuffed with at
+    most one stuff bit per four bits after the first, then 13 bits of delimiters, ACK, end of
+    frame and interframe space."""
+    stuffed = (54 if extended else 34) + 8 * payload_bytes
+    return stuffed + 13 + (stuffed - 1) // 4
+
+
+@dataclass
+class PlannedSignal:
+    name: str
+    message: str
+    period_ms: float
+    minimum: float
+    maximum: float
+    resolution: float
+
+    @property
+    def bits(self):
+        steps = round((self.maximum - self.minimum) / self.resolution)
+        return max(1, math.ceil(math.log2(steps + 1)))
+
+
+@dataclass
+class Frame:
+    period_ms: float
+    signals: list = field(default_factory=list)
+    mux: int = None
+
+    @property
+    def bits(self):
+        return sum(signal.bits for signal in self.signals)
+
+    @property
+    def payload_bytes(self):
+        return (MUX_BITS + self.bits + 7) // 8
+
+    def load(self):
+        """Bits per second this frame puts on the bus."""
+        return frame_bits(self.payload_bytes) * 1000 / self.period_ms
+
+
+def parse_plan(path):
+    muxes = {}
+    signals = []
+    with open(path, encoding="utf-8") as plan:
+        for number, line in enumerate(plan, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            if fields[0] == "message" and len(fields) >= 3:
+                muxes[fields[1]] = [int(value, 0) for value in fields[2:]]
+            elif fields[0] == "signal" and len(fields) == 7:
+                signals.append(PlannedSignal(fields[1], fields[2], *map(float, fields[3:])))
+            else:
+                raise ValueError(f"{path}:{number}: cannot parse '{line.strip()}'")
+    return muxes, signals
+
+
+def pack(signals):
+    """First fit decreasing per period, then the merges that lower the load most."""
+    frames = []
+    for period in sorted({signal.period_ms for signal in signals}):
+        same_period = [s for s in signals if s.period_ms == period]
+        for signal in sorted(same_period, key=lambda s: -s.bits):
+            if signal.bits > PAYLOAD_BITS:
+                raise ValueError(f"{signal.name} needs {signal.bits} bits, a frame holds "
+                                 f"{PAYLOAD_BITS}")
+            target = next((f for f in frames if f.period_ms == period and
+                           f.bits + signal.bits <= PAYLOAD_BITS), None)
+            if target is None:
+                target = Frame(period)
+                frames.append(target)
+            target.signals.append(signal)
+    while True:
+        best = None
+        for i, first in enumerate(frames):
+            for second in frames[i + 1:]:
+                if first.bits + second.bits > PAYLOAD_BITS:
+                    continue
+                merged = Frame(min(first.period_ms, second.period_ms),
+                               first.signals + second.signals)
+                gain = first.load() + second.load() - merged.load()
+                if gain > 0 and (best is None or gain > best[0]):
+                    best = (gain, first, second, merged)
+        if best is None:
+            break
+        _, first, second, merged = best
+        frames[frames.index(first)] = merged
+        frames.remove(second)
+    order = {signal.name: index for index, signal in enumerate(signals)}
+    for frame in frames:
+        frame.signals.sort(key=lambda s: order[s.name])
+    frames.sort(key=lambda f: (f.period_ms, order[f.signals[0].name]))
+    return frames
+
+
+def current_frames(message, planned):
+    """The frames the planned signals of one message are sent in today, from the DBC."""
+    by_name = {signal.name: signal for signal in message.signals}
+    frames = {}
+    for signal in planned:
+        dbc_signal = by_name.get(signal.name)
+        if dbc_signal is None or not dbc_signal.mux.startswith("m"):
+            raise ValueError(f"{message.name}: no multiplexed signal {signal.name} in the DBC")
+        frame = frames.setdefault(dbc_signal.mux, Frame(signal.period_ms))
+        frame.period_ms = min(frame.period_ms, signal.period_ms)
+        frame.signals.append(signal)
+    planned_names = {signal.name for signal in planned}
+    for mux, frame in frames.items():
+        members = [s for s in message.signals if s.mux == mux]
+        others = [s.name for s in members if s.name not in planned_names]
+        if others:
+            raise ValueError(f"{message.name} {mux}: {', '.join(others)} not in the plan")
+        frame.mux = int(mux[1:])
+        frame.dbc_bytes = max(s.last_byte() + 1 for s in members)
+    return list(frames.values())
+
+
+def current_load(frames):
+    return sum(frame_bits(f.dbc_bytes) * 1000 / f.period_ms for f in frames)
+
+
+def layout(frame):
+    """(signal, start bit, length) of every signal, little endian behind the mux byte."""
+    start = MUX_BITS
+    for signal in frame.signals:
+        yield signal, start, signal.bits
+        start += signal.bits
+
+
+def number(value):
+    return f"{value:g}"
+
+
+SIGNAL_LINE_RE = re.compile(
+    r'^\s*SG_\s+(\w+)\s*(?:M|m\d+)?\s*:\s*\S+\s*\([^)]*\)\s*\[[^\]]*\]\s*("[^"]*")\s*(.*)$')
+
+
+def rewrite_dbc(path, message_name, frames):
+    """Replaces the planned signals of one message with their new layout, in place of the first
+    of them."""
+    with open(path, encoding="latin-1", newline="") as dbc:
+        lines = dbc.readlines()
+    newline = "\r\n" if lines and lines[0].endswith("\r\n") else "\n"
+    planned = {signal.name for frame in frames for signal in frame.signals}
+    in_message = False
+    insert_at = None
+    kept = []
+    originals = {}
+    for line in lines:
+        message = dbc_codegen.MESSAGE_RE.match(line)
+        if message:
+            in_message = message[2] == message_name
+        signal = SIGNAL_LINE_RE.match(line)
+        if in_message and signal and signal[1] in planned:
+            originals[signal[1]] = (signal[2], signal[3].strip())
+            if insert_at is None:
+                insert_at = len(kept)
+            continue
+        kept.append(line)
+    new_lines = []
+    for frame in frames:
+        for signal, start, length in layout(frame):
+            unit, receivers = originals[signal.name]
+            new_lines.append(
+                f" SG_ {signal.name} m{frame.mux} : {start}|{length}@1+ "
+                f"({number(signal.resolution)},{number(signal.minimum)}) "
+                f"[{number(signal.minimum)}|{number(signal.maximum)}] {unit}  {receivers}"
+                f"{newline}")
+    kept[insert_at:insert_at] = new_lines
+    with open(path, "w", encoding="latin-1", newline="") as dbc:
+        dbc.writelines(kept)
+
+
+def plan(plan_path, dbc_path, write):
+    muxes, signals = parse_plan(plan_path)
+    messages = {message.name: message for message in dbc_codegen.parse_dbc(dbc_path)}
+    total_before = total_after = 0
+    results = []
+    for message_name, values in muxes.items():
+        planned = [signal for signal in signals if signal.message == message_name]
+        before = current_frames(messages[message_name], planned)
+        frames = pack(planned)
+        if len(frames) > len(values):
+            raise ValueError(f"{message_name}: {len(frames)} frames, only {len(values)} mux "
+                             f"values in the plan")
+        taken = {int(s.mux[1:]) for s in messages[message_name].signals
+                 if s.mux.startswith("m") and s.name not in {p.name for p in planned}}
+        for frame, value in zip(frames, values):
+            if value in taken:
+                raise ValueError(f"{message_name}: mux 0x{value:02X} is used by another signal")
+            frame.mux = value
+        load_before, load_after = current_load(before), sum(f.load() for f in frames)
+        total_before += load_before
+        total_after += load_after
+        print(f"{message_name}: {len(before)} frames, {load_before:.0f} bit/s -> "
+              f"{len(frames)} frames, {load_after:.0f} bit/s")
+        for frame in frames:
+            fields = ", ".join(f"{s.name} {start}|{length}" for s, start, length in layout(frame))
+            print(f"  m{frame.mux} (0x{frame.mux:02X}) every {number(frame.period_ms)} ms, "
+                  f"{frame.payload_bytes} bytes: {fields}")
+        unchanged = sorted((f.mux, [s.name for s in f.signals]) for f in before) == \
+            sorted((f.mux, [s.name for s in f.signals]) for f in frames) and \
+            all(f.dbc_bytes == f.payload_bytes for f in before)
+        results.append((message_name, frames, unchanged))
+    print(f"total: {total_before:.0f} -> {total_after:.0f} bit/s, "
+          f"{100 * total_before / BITRATE:.3f} % -> {100 * total_after / BITRATE:.3f} % of "
+          f"{BITRATE // 1000} kbit/s")
+    if not write:
+        return
+    changed = [(name, frames) for name, frames, unchanged in results if not unchanged]
+    for message_name, frames in changed:
+        rewrite_dbc(dbc_path, message_name, frames)
+    if changed:
+        root = os.path.dirname(dbc_path)
+        dbc_codegen.run(dbc_path, os.path.join(root, "CAN_IDs.h"),
+                        os.path.join(root, "CAN_messages.h"))
+        print(f"{dbc_path}: rewrote {', '.join(name for name, _ in changed)}")
+    else:
+        print(f"{dbc_path}: already has this layout")
+
+
+def main(argv):
+    args = [arg for arg in argv[1:] if arg != "--write"]
+    tools = os.path.dirname(os.path.abspath(__file__))
+    plan_path = args[0] if args else os.path.join(tools, "frame_plan.txt")
+    dbc_path = args[1] if len(args) > 1 else os.path.join(os.path.dirname(tools), "conf.dbc")
+    plan(plan_path, dbc_path, "--write" in argv)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+"""Turns the binary DEBUG_LOG stream of the boards back into text, see debug_log.h.
+
+Usage: python3 tools/log_decoder.py [capture|-] [--source DIR]...
+       cat /dev/ttyACM0 | python3 tools/log_decoder.py
+
+The firmware sends the 32-bit FNV-1a hash of each format string instead of the string, so the
+decoder finds the strings the same way the compiler saw them: it scans the sources (master,
+teensy_dash and teensy_cells by default) for DEBUG_LOG, DEBUG_PRINT, DEBUG_PRINTLN and
+DEBUG_PRINT_VAR calls and hashes their literals. Decode against the revision that was flashed.
+
+Placeholders are Python format fields ({}, {:x}, {:.1f}) plus {a|b|...}: a bool argument picks
+the first text when true, an integer the text at its index. Bytes that are not part of a
+record, plain Serial.print output for instance, are passed through unchanged.
+"""
+
+import os
+import re
+import struct
+import sys
+
+FRAME_START = 0xA5
+DROPPED_ID = 0
+SOURCE_DIRS = ("master", "teensy_dash", "teensy_cells")
+SOURCE_SUFFIXES = (".cpp", ".hpp", ".h")
+
+# argument tag -> struct format, see debug_log::ArgType
+ARG_FORMATS = {
+    ord("b"): "<?",
+    ord("i"): "<i",
+    ord("u"): "<I",
+    ord("f"): "<f",
+    ord("I"): "<q",
+    ord("U"): "<Q",
+}
+
+LITERAL = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+CALL = re.compile(r'\bDEBUG_(?:LOG|PRINT|PRINTLN)\s*\(\s*((?:"(?:[^"\\\n]|\\.)*"\s*)+)')
+VAR_CALL = re.compile(r"\bDEBUG_PRINT_VAR\s*\(")
+ESCAPE = re.compile(r"\\(x[0-9a-fA-F]+|[0-7]{1,3}|.)")
+PLACEHOLDER = re.compile(r"\{([^{}]*)\}")
+SIMPLE_ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "a": "\a", "b": "\b", "f": "\f", "v": "\v"}
+
+
+def fnv1a(data):
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape(literal):
+    """Bytes of a C string literal: the UTF-8 of the source, escapes as single bytes."""
+    out = bytearray()
+    last = 0
+    for match in ESCAPE.finditer(literal):
+        out += literal[last:match.start()].encode("utf-8")
+        code = match.group(1)
+        if code[0] == "x":
+            out.append(int(code[1:], 16) & 0xFF)
+        elif code[0] in "01234567":
+            out.append(int(code, 8) & 0xFF)
+        else:
+            out += SIMPLE_ESCAPES.get(code, code).encode("utf-8")
+        last = match.end()
+    out += literal[last:].encode("utf-8")
+    return bytes(out)
+
+
+def call_argument(text, start):
+    """Text of the parenthesised argument list opening just before `start`."""
+    depth = 1
+    i = start
+    while i < len(text) and depth > 0:
+        literal = LITERAL.match(text, i)
+        if literal:
+            i = literal.end()
+            continue
+        depth += {"(": 1, ")": -1}.get(text[i], 0)
+        i += 1
+    return text[start:i - 1]
+
+
+def scan_sources(paths):
+    """Maps the ID of every format string found under `paths` to (format bytes, file:line)."""
+    formats = {}
+    for root in paths:
+        for directory, subdirs, files in os.walk(root):
+            subdirs[:] = sorted(d for d in subdirs if not d.startswith("."))
+            for name in sorted(files):
+                if name.endswith(SOURCE_SUFFIXES):
+                    scan_file(os.path.join(directory, name), formats)
+    return formats
+
+
+def is_definition(text, offset):
+    return text[text.rfind("\n", 0, offset) + 1:offset].lstrip().startswith("#")
+
+
+def scan_file(path, formats):
+    with open(path, encoding="utf-8", errors="replace") as source:
+        text = source.read()
+    found = []
+    for match in CALL.finditer(text):
+        if is_definition(text, match.start()):
+            continue
+        fmt = b"".join(unescape(m.group(1)) for m in LITERAL.finditer(match.group(1)))
+        found.append((match.start(), fmt))
+    for match in VAR_CALL.finditer(text):
+        if is_definition(text, match.start()):
+            continue
+        # #var is the expression with its whitespace runs folded into single spaces
+        expression = " ".join(call_argument(text, match.end()).split())
+        found.append((match.start(), (expression + " = {}").encode("utf-8")))
+    for offset, fmt in found:
+        format_id = fnv1a(fmt)
+        where = f"{os.path.relpath(path)}:{text.count(chr(10), 0, offset) + 1}"
+        previous = formats.get(format_id)
+        if previous is None:
+            formats[format_id] = (fmt, where)
+        elif previous[0] != fmt:
+            print(f"warning: {where} and {previous[1]} share ID {format_id:#010x}",
+                  file=sys.stderr)
+
+
+def parse_record(record):
+    """(id, micros, args) of a record without its two header bytes, None if malformed."""
+    if len(record) < 8:
+        return None
+    format_id, micros = struct.unpack_from("<II", record)
+    args, i = [], 8
+    while i < len(record):
+        layout = ARG_FORMATS.get(record[i])
+        if layout is None or i + 1 + struct.calcsize(layout) > len(record):
+            return None
+        args.append(struct.unpack_from(layout, record, i + 1)[0])
+        i += 1 + struct.calcsize(layout)
+    return format_id, micros, args
+
+
+def render(fmt, args):
+    values = iter(args)
+
+    def field(match):
+        value = next(values)
+        spec = match.group(1)
+        if "|" in spec:
+            choices = spec.split("|")
+            if isinstance(value, bool):
+                return choices[0] if value else choices[1]
+            return choices[value] if 0 <= value < len(choices) else str(value)
+        if spec.startswith(":"):
+            return format(value, spec[1:])
+        if isinstance(value, bool):
+            return str(int(value))
+        if isinstance(value, float):
+            return f"{value:.2f}"  # what Serial.print(float) showed
+        return str(value)
+
+    return PLACEHOLDER.sub(field, fmt)
+
+
+class Decoder:
+    """Finds the records in a byte stream fed in arbitrary chunks and writes one line each."""
+
+    def __init__(self, formats, out):
+        self.formats = formats
+        self.out = out
+        self.pending = b""
+
+    def feed(self, data):
+        buffer = self.pending + data
+        i = text_start = 0
+        while True:
+            i = buffer.find(FRAME_START, i)
+            if i < 0:
+                i = len(buffer)
+                break
+            if i + 2 > len(buffer) or i + 2 + buffer[i + 1] > len(buffer):
+                break  # maybe a record, wait for the rest of it
+            end = i + 2 + buffer[i + 1]
+            line = self.decode(buffer[i + 2:end])
+            if line is None:
+                i += 1
+                continue
+            self.passthrough(buffer[text_start:i])
+            self.out.write(line + "\n")
+            i = text_start = end
+        self.passthrough(buffer[text_start:i])
+        self.pending = buffer[i:]
+
+    def finish(self):
+        self.passthrough(self.pending)
+        self.pending = b""
+        self.out.flush()
+
+    def passthrough(self, data):
+        if data:
+            self.out.write(data.decode("utf-8", errors="replace"))
+
+    def decode(self, record):
+        parsed = parse_record(record)
+        if parsed is None:
+            return None
+        format_id, micros, args = parsed
+        if format_id == DROPPED_ID and len(args) == 1:
+            return f"{micros / 1e6:12.6f} <{args[0]} records dropped, the ring was full>"
+        known = self.formats.get(format_id)
+        if known is None:
+            return None
+        fmt = known[0].decode("utf-8", errors="replace")
+        if len(PLACEHOLDER.findall(fmt)) != len(args):
+            return None
+        return f"{micros / 1e6:12.6f} {known[1]} {render(fmt, args)}"
+
+
+def main(argv):
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    capture = "-"
+    sources = []
+    args = iter(argv[1:])
+    for arg in args:
+        if arg == "--source":
+            sources.append(next(args))
+        else:
+            capture = arg
+    formats = scan_sources(sources or [os.path.join(root, d) for d in SOURCE_DIRS])
+    decoder = Decoder(formats, sys.stdout)
+    stream = sys.stdin.buffer if capture == "-" else open(capture, "rb")
+    try:
+        while True:
+            chunk = stream.read1(4096)
+            if not chunk:
+                break
+            decoder.feed(chunk)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    decoder.finish()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Wheel speed from a ring of encoder pulse timestamps, in fixed point
+ * @details The pulse interrupt calls add_pulse() with the timestamp of the edge, micros() by
+ * default. The timestamps may come from any free-running 32-bit counter ticking
+ * TICKS_PER_SECOND times a second, so a timer input-capture interrupt can feed the edge time
+ * latched by the hardware instead, free of interrupt latency.
+ *
+ * centi_rpm() averages over the last pulses instead of the last interval only: as many as fit in
+ * the averaging window, at most max_pulses and at least one interval. At speed that is many
+ * pulses, at a crawl the last interval alone. The result is recomputed only when a new pulse
+ * arrived, with one integer division. Once the next pulse is a quarter of a period late, the
+ * speed is bounded by one pulse per time since the last, so it falls off smoothly when the wheel
+ * stops, and after the stall timeout it is 0 and stalled() is true.
+ *
+ * One interrupt handler writes, loop() reads: the reader copies the pulses it needs and checks
+ * that the writer did not lap them meanwhile, retrying if it did. Nothing is masked.
+ *
+ * @tparam PULSES_PER_ROTATION encoder teeth
+ * @tparam TICKS_PER_SECOND rate of the timestamps
+ * @tparam CAPACITY ring size, a power of two
+ */
+template <uint32_t PULSES_PER_ROTATION, uint32_t TICKS_PER_SECOND = 1'000'000,
+          std::size_t CAPACITY = 32>
+class WheelSpeed {
+  static_assert(CAPACITY >= 4 && (CAPACITY & (CAPACITY - 1)) == 0, "the index is a mask");
+  static_assert(PULSES_PER_ROTATION > 0);
+
+public:
+  /// centi-RPM for one pulse per tick, the numerator of every speed
+  static constexpr uint64_t SCALE = 6'000ULL * TICKS_PER_SECOND / PULSES_PER_ROTATION;
+
+  /**
+   * @param window_ticks averaging window, the pulses spanning at most this much are averaged
+   * @param max_pulses intervals averaged at most, up to CAPACITY / 2
+   * @param stall_ticks time without a pulse after which the wheel is stopped
+   */
+  WheelSpeed(const uint32_t window_ticks, const uint32_t max_pulses, const uint32_t stall_ticks)
+      : window_ticks_(window_ticks),
+        max_pulses_(max_pulses < 1 ? 1 : std::min<uint32_t>(max_pulses, CAPACITY / 2)),
+        stall_ticks_(stall_ticks) {}
+
+  /**
+   * @brief Records a pulse, from its interrupt handler
+   */
+  void add_pulse(const uint32_t timestamp) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    times_[head & (CAPACITY - 1)].store(timestamp, std::memory_order_relaxed);
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Speed at `now`, in hundredths of an RPM
+   */
+  uint32_t centi_rpm(const uint32_t now) {
+    const uint32_t head = head_.load(std::memory_order_acquire);
+    if (head < 2) return 0;  // no interval yet
+    if (head != cached_head_) update(head);
+    // A pulse that came in after `now` was sampled is no time since the last one
+    const uint32_t since_last = static_cast<int32_t>(now - last_) < 0 ? 0 : now - last_;
+    stalled_ = since_last > stall_ticks_;
+    if (stalled_) return 0;
+    if (since_last <= period_ + period_ / 4) return centi_rpm_;  // tooth spacing and jitter
+    return std::min(speed(1, since_last), centi_rpm_);  // no pulse for a while
+  }
+
+  /**
+   * @brief Whether the last centi_rpm() found no pulse within the stall timeout
+   */
+  [[nodiscard]] bool stalled() const { return stalled_; }
+
+  /**
+   * @brief Pulses recorded so far
+   */
+  [[nodiscard]] uint32_t pulses() const { return head_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Intervals the last speed was averaged over
+   */
+  [[nodiscard]] uint32_t averaged() const { return averaged_; }
+
+private:
+  const uint32_t window_ticks_;
+  const uint32_t max_pulses_;
+  const uint32_t stall_ticks_;
+  std::array<std::atomic<uint32_t>, CAPACITY> times_{};
+  std::atomic<uint32_t> head_{0};
+
+  uint32_t cached_head_ = 0;  ///< head_ the cached speed was computed at
+  uint32_t last_ = 0;         ///< Newest pulse at cached_head_
+  uint32_t period_ = 0;       ///< Mean interval at cached_head_
+  uint32_t centi_rpm_ = 0;
+  uint32_t averaged_ = 0;
+  bool stalled_ = true;
+
+  void update(uint32_t head) {
+    uint32_t last, span, intervals;
+    while (true) {
+      const uint32_t limit = head - 1 < max_pulses_ ? head - 1 : max_pulses_;
+      uint32_t oldest = head - 2;  // index of the oldest timestamp read
+      last = times_[(head - 1) & (CAPACITY - 1)].load(std::memory_order_relaxed);
+      span = last - times_[oldest & (CAPACITY - 1)].load(std::memory_order_relaxed);
+      intervals = 1;
+      while (intervals < limit) {
+        oldest--;
+        const uint32_t older = times_[oldest & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (last - older > window_ticks_) break;
+        span = last - older;
+        intervals++;
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint32_t now_head = head_.load(std::memory_order_relaxed);
+      if (now_head - oldest < CAPACITY) break;  // the writer has not reached the oldest slot read
+      head = now_head;
+    }
+
+    cached_head_ = head;
+    last_ = last;
+    averaged_ = intervals;
+    period_ = span / intervals;
+    centi_rpm_ = span == 0 ? 0 : speed(intervals, span);  // 0: two pulses on one timestamp
+  }
+
+  /**
+   * @brief centi-RPM of `intervals` pulse intervals in `ticks`, a 32-bit division whenever the
+   * numerator fits, a 64-bit one is a library call on the Teensy
+   */
+  static uint32_t speed(const uint32_t intervals, const uint32_t ticks) {
+    if constexpr (SCALE * (CAPACITY / 2) <= UINT32_MAX) {
+      return static_cast<uint32_t>(SCALE) * intervals / ticks;
+    } else {
+      return static_cast<uint32_t>(SCALE * intervals / ticks);
+    }
+  }
+};